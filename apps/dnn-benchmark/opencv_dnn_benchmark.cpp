@@ -0,0 +1,509 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+/*************************************************
+USAGE:
+./opencv_dnn_benchmark <manifest file> [-o=<output JSON file>] [--warmup=<N>] [--iterations=<N>]
+
+Manifest is a YAML, JSON or XML file which can be read by cv::FileStorage. Relative paths
+of models are resolved against the directory of the manifest:
+
+%YAML:1.0
+---
+warmup: 5
+iterations: 50
+models:
+   -
+      name: "resnet50"
+      model: "resnet50.onnx"
+      config: ""                    # [Optional] model configuration file
+      framework: ""                 # [Optional] model framework name
+      inputs:                       # type: float32 (default), float16, uint8, int8 or int32
+         - { name: "data", shape: [ 1, 3, 224, 224 ], type: "float32" }
+      backends: [ "opencv/cpu", "opencv/cpu_fp16" ]   # default: opencv/cpu
+      threads: [ 1, 4 ]             # default: number of threads set by default
+      batch: [ 1, 8 ]               # [Optional] replaces the first dimension of all the inputs
+
+Inputs are matched to inputs of the model by names, so their order doesn't matter. Names may be
+omitted for models with unnamed inputs. Empty shape [] means a scalar, which is passed as a single
+element blob and is not affected by the batch size. Inputs are filled with random values from [0, 1)
+for floating-point types and from [0, 10] for integer types.
+
+Every combination of backend, number of threads and batch size is benchmarked separately.
+The report contains latency percentiles, throughput, memory consumption and per-layer
+profile of the last iteration for every combination. Errors are reported in the "error"
+field, so a failed combination does not stop the benchmark.
+**************************************************/
+#include <opencv2/dnn.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+
+using namespace cv;
+using namespace dnn;
+
+
+struct BackendTarget
+{
+    std::string name;
+    int backend;
+    int target;
+};
+
+static BackendTarget parseBackendTarget(const std::string& name)
+{
+    static const struct { const char* name; int backend; int target; } backends[] = {
+        { "opencv/cpu", DNN_BACKEND_OPENCV, DNN_TARGET_CPU },
+        { "opencv/cpu_fp16", DNN_BACKEND_OPENCV, DNN_TARGET_CPU_FP16 },
+        { "opencv/opencl", DNN_BACKEND_OPENCV, DNN_TARGET_OPENCL },
+        { "opencv/opencl_fp16", DNN_BACKEND_OPENCV, DNN_TARGET_OPENCL_FP16 },
+        { "openvino/cpu", DNN_BACKEND_INFERENCE_ENGINE, DNN_TARGET_CPU },
+        { "openvino/opencl", DNN_BACKEND_INFERENCE_ENGINE, DNN_TARGET_OPENCL },
+        { "openvino/opencl_fp16", DNN_BACKEND_INFERENCE_ENGINE, DNN_TARGET_OPENCL_FP16 },
+        { "openvino/myriad", DNN_BACKEND_INFERENCE_ENGINE, DNN_TARGET_MYRIAD },
+        { "cuda/cuda", DNN_BACKEND_CUDA, DNN_TARGET_CUDA },
+        { "cuda/cuda_fp16", DNN_BACKEND_CUDA, DNN_TARGET_CUDA_FP16 },
+        { "vkcom/vulkan", DNN_BACKEND_VKCOM, DNN_TARGET_VULKAN },
+        { "timvx/npu", DNN_BACKEND_TIMVX, DNN_TARGET_NPU },
+        { "cann/npu", DNN_BACKEND_CANN, DNN_TARGET_NPU },
+    };
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+    {
+        if (name == backends[i].name)
+        {
+            BackendTarget bt = { name, backends[i].backend, backends[i].target };
+            return bt;
+        }
+    }
+    CV_Error(Error::StsBadArg, "Unknown backend/target pair: " + name);
+}
+
+struct ModelInput
+{
+    std::string name;
+    MatShape shape;  // empty for scalars
+    int type;
+};
+
+struct ModelEntry
+{
+    std::string name, model, config, framework;
+    std::vector<ModelInput> inputs;
+    std::vector<BackendTarget> backends;
+    std::vector<int> threads, batches;
+};
+
+struct BenchmarkResult
+{
+    std::vector<double> latencies;  // sorted, milliseconds
+    size_t weightsBytes, blobsBytes;
+    int64 arenaBytes, peakRSSBytes;
+    std::vector<LayerProfile> layers;
+};
+
+static std::string resolvePath(const std::string& path, const std::string& baseDir)
+{
+    if (path.empty() || baseDir.empty() || path[0] == '/' || path.find(':') != std::string::npos)
+        return path;
+    return utils::fs::join(baseDir, path);
+}
+
+static std::string checkFileExists(const std::string& fileName)
+{
+    if (fileName.empty() || utils::fs::exists(fileName))
+        return fileName;
+
+    CV_Error(Error::StsObjectNotFound, "File " + fileName + " was not found! "
+         "Please, specify a full path to the file.");
+}
+
+static int parseInputType(const std::string& name)
+{
+    static const struct { const char* name; int type; } types[] = {
+        { "float32", CV_32F },
+        { "float16", CV_16F },
+        { "uint8", CV_8U },
+        { "int8", CV_8S },
+        { "int32", CV_32S },
+    };
+    if (name.empty())
+        return CV_32F;
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        if (name == types[i].name)
+            return types[i].type;
+    }
+    CV_Error(Error::StsBadArg, "Unknown input type: " + name);
+}
+
+static std::vector<int> readInts(const FileNode& node)
+{
+    std::vector<int> values;
+    if (node.isSeq())
+        node >> values;
+    else if (node.isInt())
+        values.push_back((int)node);
+    return values;
+}
+
+static std::vector<ModelEntry> readManifest(const FileStorage& fs, const std::string& baseDir)
+{
+    std::vector<ModelEntry> entries;
+    FileNode models = fs["models"];
+    CV_Assert(models.isSeq());
+    for (FileNodeIterator it = models.begin(); it != models.end(); ++it)
+    {
+        const FileNode& node = *it;
+        ModelEntry entry;
+        entry.model = checkFileExists(resolvePath((std::string)node["model"], baseDir));
+        CV_Assert(!entry.model.empty());
+        entry.config = checkFileExists(resolvePath((std::string)node["config"], baseDir));
+        entry.framework = (std::string)node["framework"];
+        entry.name = node["name"].empty() ? entry.model : (std::string)node["name"];
+
+        FileNode inputs = node["inputs"];
+        for (FileNodeIterator inp = inputs.begin(); inp != inputs.end(); ++inp)
+        {
+            ModelInput input;
+            input.name = (std::string)(*inp)["name"];
+            if ((*inp)["shape"].isNone())
+                CV_Error(Error::StsBadArg, "Shape of input " + input.name + " of " + entry.name + " is not set");
+            input.shape = readInts((*inp)["shape"]);
+            input.type = parseInputType((std::string)(*inp)["type"]);
+            entry.inputs.push_back(input);
+        }
+        if (entry.inputs.empty())
+            CV_Error(Error::StsBadArg, "Inputs of " + entry.name + " are not set");
+
+        FileNode backends = node["backends"];
+        for (FileNodeIterator bt = backends.begin(); bt != backends.end(); ++bt)
+            entry.backends.push_back(parseBackendTarget((std::string)*bt));
+        if (entry.backends.empty())
+            entry.backends.push_back(parseBackendTarget("opencv/cpu"));
+
+        entry.threads = readInts(node["threads"]);
+        if (entry.threads.empty())
+            entry.threads.push_back(getNumThreads());
+
+        // 0 keeps shapes of the inputs as they are in the manifest
+        entry.batches = readInts(node["batch"]);
+        if (entry.batches.empty())
+            entry.batches.push_back(0);
+
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// Message without the source location: FileStorage escapes quotes of function names, which is not valid JSON
+static std::string errorMessage(const cv::Exception& e)
+{
+    return e.func.empty() ? e.err : e.func + ": " + e.err;
+}
+
+// Resets the peak resident set size of the process, so it is measured for every combination separately.
+static void resetPeakRSS()
+{
+#if defined(__linux__)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs.is_open())
+        clearRefs << "5";
+#endif
+}
+
+// Returns peak resident set size of the process in bytes or -1 if it is not available.
+static int64 getPeakRSS()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return (int64)std::atoll(line.c_str() + 6) * 1024;
+    }
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#if defined(__APPLE__)
+        return (int64)usage.ru_maxrss;
+#else
+        return (int64)usage.ru_maxrss * 1024;
+#endif
+    }
+#endif
+    return -1;
+}
+
+// Percentile of sorted values with linear interpolation between the closest ranks
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    CV_Assert(!sorted.empty());
+    double rank = p / 100.0 * (sorted.size() - 1);
+    size_t lo = (size_t)rank, hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+static Mat makeInputBlob(const ModelInput& input, int batch)
+{
+    MatShape shape = input.shape;
+    if (shape.empty())
+        shape.push_back(1);  // scalar
+    else if (batch > 0)
+        shape[0] = batch;
+    Mat blob(shape, CV_32F);
+    if (CV_MAT_DEPTH(input.type) == CV_32F || CV_MAT_DEPTH(input.type) == CV_16F)
+        randu(blob, 0.0f, 1.0f);
+    else
+        randu(blob, 0.0f, 10.0f);
+    blob.convertTo(blob, input.type);  // values are rounded for integer types
+    return blob;
+}
+
+// Sets inputs of the model by names. Inputs are named by the manifest only if the model has no named inputs.
+// Returns shapes of the inputs in order of inputs of the model.
+static std::vector<MatShape> setInputs(Net& net, const ModelEntry& entry, int batch)
+{
+    std::vector<String> names(entry.inputs.size());
+    for (size_t i = 0; i < entry.inputs.size(); i++)
+        names[i] = entry.inputs[i].name;
+
+    std::vector<String> modelNames = net.getInputsNames();
+    if (modelNames.empty())
+    {
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (names[i].empty())
+                names[i] = format("input%d", (int)i);
+        }
+        net.setInputsNames(names);
+        modelNames = names;
+    }
+    else if (names.size() != modelNames.size())
+    {
+        CV_Error(Error::StsBadArg, format("Model has %d inputs, manifest sets %d inputs",
+                                          (int)modelNames.size(), (int)names.size()));
+    }
+
+    std::vector<MatShape> shapes(modelNames.size());
+    std::vector<bool> isSet(modelNames.size(), false);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        std::vector<String>::const_iterator it = std::find(modelNames.begin(), modelNames.end(), names[i]);
+        if (it == modelNames.end())
+            CV_Error(Error::StsBadArg, "Model has no input \"" + names[i] + "\"");
+        const size_t idx = it - modelNames.begin();
+        if (isSet[idx])
+            CV_Error(Error::StsBadArg, "Input \"" + names[i] + "\" is set twice");
+        Mat blob = makeInputBlob(entry.inputs[i], batch);
+        net.setInput(blob, names[i]);
+        shapes[idx] = MatShape(blob.size.p, blob.size.p + blob.dims);
+        isSet[idx] = true;
+    }
+    return shapes;
+}
+
+static BenchmarkResult runBenchmark(Net& net, const ModelEntry& entry, int batch, int warmup, int iterations)
+{
+    BenchmarkResult result;
+    std::vector<MatShape> shapes = setInputs(net, entry, batch);
+
+    resetPeakRSS();
+    for (int i = 0; i < warmup; i++)
+        net.forward();
+
+    TickMeter tm;
+    for (int i = 0; i < iterations; i++)
+    {
+        tm.reset();
+        tm.start();
+        net.forward();
+        tm.stop();
+        result.latencies.push_back(tm.getTimeMilli());
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+
+    result.peakRSSBytes = getPeakRSS();
+    result.arenaBytes = net.getMemoryArenaSize();
+    net.getMemoryConsumption(shapes, result.weightsBytes, result.blobsBytes);
+    net.getLayersProfile(result.layers);
+    return result;
+}
+
+static void writeResult(FileStorage& fs, const BenchmarkResult& result, int batch)
+{
+    const std::vector<double>& latencies = result.latencies;
+    double mean = 0;
+    for (size_t i = 0; i < latencies.size(); i++)
+        mean += latencies[i];
+    mean /= latencies.size();
+
+    fs << "latency_ms" << "{"
+       << "min" << latencies.front()
+       << "mean" << mean
+       << "p50" << percentile(latencies, 50)
+       << "p90" << percentile(latencies, 90)
+       << "p95" << percentile(latencies, 95)
+       << "p99" << percentile(latencies, 99)
+       << "max" << latencies.back()
+       << "}";
+    fs << "throughput" << batch * 1000.0 / mean;  // samples per second
+
+    fs << "memory" << "{"
+       << "weights_bytes" << (int64_t)result.weightsBytes
+       << "blobs_bytes" << (int64_t)result.blobsBytes
+       << "arena_bytes" << (int64_t)result.arenaBytes
+       << "peak_rss_bytes" << (int64_t)result.peakRSSBytes
+       << "}";
+
+    fs << "layers" << "[";
+    for (size_t i = 0; i < result.layers.size(); i++)
+    {
+        const LayerProfile& p = result.layers[i];
+        fs << "{"
+           << "name" << p.name
+           << "type" << p.type
+           << "kernel" << p.kernel
+           << "time_ms" << p.time
+           << "flops" << (int64_t)p.flops
+           << "bytes" << (int64_t)p.bytes
+           << "gflops" << p.gflops
+           << "}";
+    }
+    fs << "]";
+}
+
+std::string benchmarkKeys =
+        "{ help h       |    | Print help message. }"
+        "{ @manifest    |    | Path to the manifest file with models to benchmark. }"
+        "{ output o     |    | [Optional] Path to the output JSON file. The report is printed to standard output if empty. }"
+        "{ warmup       | -1 | [Optional] Number of warmup iterations, overrides the value from the manifest. }"
+        "{ iterations i | -1 | [Optional] Number of measured iterations, overrides the value from the manifest. }";
+
+int main(int argc, const char** argv)
+{
+    CommandLineParser argParser(argc, argv, benchmarkKeys);
+    argParser.about("Use this tool to benchmark models listed in a manifest file with different backends, "
+                    "numbers of threads and batch sizes. The report is written in JSON format.");
+
+    if (argc == 1 || argParser.has("help"))
+    {
+        argParser.printMessage();
+        return 0;
+    }
+
+    std::string manifestPath = checkFileExists(argParser.get<std::string>("@manifest"));
+    std::string outputPath = argParser.get<std::string>("output");
+    int warmup = argParser.get<int>("warmup");
+    int iterations = argParser.get<int>("iterations");
+    if (!argParser.check())
+    {
+        argParser.printErrors();
+        return 1;
+    }
+    CV_Assert(!manifestPath.empty());
+
+    FileStorage manifest(manifestPath, FileStorage::READ);
+    CV_Assert(manifest.isOpened());
+    if (warmup < 0)
+        warmup = manifest["warmup"].empty() ? 5 : (int)manifest["warmup"];
+    if (iterations < 0)
+        iterations = manifest["iterations"].empty() ? 50 : (int)manifest["iterations"];
+    CV_CheckGT(iterations, 0, "Number of iterations must be positive");
+
+    size_t pos = manifestPath.find_last_of("/\\");
+    std::string baseDir = pos == std::string::npos ? std::string() : manifestPath.substr(0, pos);
+    std::vector<ModelEntry> entries = readManifest(manifest, baseDir);
+
+    const bool toStdout = outputPath.empty();
+    FileStorage report(toStdout ? "report.json" : outputPath,
+                       FileStorage::WRITE | FileStorage::FORMAT_JSON | (toStdout ? FileStorage::MEMORY : 0));
+    CV_Assert(report.isOpened());
+    report << "opencv_version" << CV_VERSION;
+    report << "warmup" << warmup << "iterations" << iterations;
+    report << "results" << "[";
+
+    const int defaultThreads = getNumThreads();
+    int failures = 0;
+    for (size_t m = 0; m < entries.size(); m++)
+    {
+        const ModelEntry& entry = entries[m];
+        for (size_t b = 0; b < entry.backends.size(); b++)
+        {
+            const BackendTarget& bt = entry.backends[b];
+            Net net;
+            std::string loadError;
+            try
+            {
+                net = readNet(entry.model, entry.config, entry.framework);
+                net.setPreferableBackend(bt.backend);
+                net.setPreferableTarget(bt.target);
+            }
+            catch (const cv::Exception& e)
+            {
+                loadError = errorMessage(e);
+            }
+
+            for (size_t t = 0; t < entry.threads.size(); t++)
+            {
+                for (size_t k = 0; k < entry.batches.size(); k++)
+                {
+                    const MatShape& firstShape = entry.inputs[0].shape;
+                    const int batch = entry.batches[k] > 0 ? entry.batches[k] : (firstShape.empty() ? 1 : firstShape[0]);
+                    std::cerr << entry.name << " " << bt.name << " threads=" << entry.threads[t]
+                              << " batch=" << batch << ": " << std::flush;
+
+                    std::string error = loadError;
+                    BenchmarkResult result;
+                    if (error.empty())
+                    {
+                        try
+                        {
+                            setNumThreads(entry.threads[t]);
+                            result = runBenchmark(net, entry, entry.batches[k], warmup, iterations);
+                        }
+                        catch (const cv::Exception& e)
+                        {
+                            error = errorMessage(e);
+                        }
+                        setNumThreads(defaultThreads);
+                    }
+
+                    report << "{";
+                    report << "model" << entry.name << "backend" << bt.name
+                           << "threads" << entry.threads[t] << "batch" << batch;
+                    if (error.empty())
+                    {
+                        writeResult(report, result, batch);
+                        std::cerr << "median " << percentile(result.latencies, 50) << " ms" << std::endl;
+                    }
+                    else
+                    {
+                        report << "error" << error;
+                        std::cerr << "FAILED" << std::endl;
+                        failures++;
+                    }
+                    report << "}";
+                }
+            }
+        }
+    }
+
+    report << "]";
+    if (toStdout)
+        std::cout << report.releaseAndGetString() << std::endl;
+    else
+        report.release();
+    return failures == 0 ? 0 : 2;
+}
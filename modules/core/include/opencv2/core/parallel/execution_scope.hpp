@@ -0,0 +1,67 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_PARALLEL_EXECUTION_SCOPE_HPP
+#define OPENCV_CORE_PARALLEL_EXECUTION_SCOPE_HPP
+
+#include "opencv2/core/cvdef.h"
+#include <memory>
+#include <vector>
+
+namespace cv { namespace parallel {
+
+/** @addtogroup core_parallel_backend
+ * @{
+ */
+
+/** @brief Limits `parallel_for_()` calls of the current thread by a number of threads and a set of CPUs.
+
+While the object exists, `parallel_for_()` calls of the current thread, including nested calls from
+the threads which process them, use at most @p numThreads threads and getNumThreads() returns this limit.
+The limit is shared by all these calls: it counts the current thread and the threads which process any of
+the calls at the same time.
+If @p cpus is not empty, the current thread and the threads which process its `parallel_for_()` calls
+are pinned to these CPUs. It allows to partition a host between several independent pipelines,
+for example one pipeline per NUMA node:
+
+@code
+    cv::parallel::ExecutionScope scope(8, cv::parallel::getNumaNodeCPUs(1));
+    // processing
+@endcode
+
+Scopes may be nested, the innermost one is used. The inner scope can't exceed the number of threads of
+the outer one, its threads are counted by the outer one too, and it gets CPUs of the outer one if @p cpus is empty. Scopes must be destroyed in reverse order
+by the thread which has created them.
+
+@note The number of threads is limited by the global setNumThreads() value. Limits above 1 thread and
+CPU affinity are supported by the built-in `pthreads` parallel framework, other frameworks run the calls
+sequentially if the limit is 1 thread and ignore other settings. CPU affinity is supported on Linux only.
+*/
+class CV_EXPORTS ExecutionScope
+{
+public:
+    /** @param numThreads maximal number of threads, 0 means no limit.
+     *  @param cpus indexes of CPUs to run on, empty vector means CPUs of the outer scope or any CPU.
+     */
+    explicit ExecutionScope(int numThreads, const std::vector<int>& cpus = std::vector<int>());
+    ~ExecutionScope();
+
+    struct Impl;
+protected:
+    std::shared_ptr<Impl> impl;
+
+private:
+    ExecutionScope(const ExecutionScope&); // disabled
+    ExecutionScope& operator=(const ExecutionScope&); // disabled
+};
+
+/** @brief Returns number of NUMA nodes of the host. Returns 1 if NUMA information is not available. */
+CV_EXPORTS int getNumaNodesCount();
+
+/** @brief Returns indexes of CPUs of a NUMA node. Returns empty vector if the node or NUMA information is not available. */
+CV_EXPORTS std::vector<int> getNumaNodeCPUs(int node);
+
+//! @}
+}}  // namespace
+#endif  // OPENCV_CORE_PARALLEL_EXECUTION_SCOPE_HPP
@@ -0,0 +1,60 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_EXTERNAL_BUFFER_HPP
+#define OPENCV_CORE_EXTERNAL_BUFFER_HPP
+
+#include "../mat.hpp"
+
+#include <functional>
+#include <memory>
+
+namespace cv { namespace utils {
+
+/** @brief Creates matrix header for external buffer with no copy, the buffer is released by the callback.
+
+Unlike Mat constructors for user data, the result takes part in reference counting: its copies, ROIs, reshaped
+headers and UMat objects created by Mat::getUMat() share the buffer, and @p release is called once by the thread
+which releases the last of them. If the matrix is empty, @p release is called before the function returns.
+If the function throws, @p release is not called and the buffer stays owned by the caller.
+
+Functions which fill output arrays allocated by the caller, like imdecode() with the destination matrix or
+dnn::blobFromImage() with the output blob, write into the buffer with no copy if its size and type are the expected
+ones. Otherwise the matrix is reallocated and the external buffer is released as usual.
+
+@param data Pointer to the buffer.
+@param dims Number of dimensions.
+@param sizes Array of dimension sizes.
+@param type Array type.
+@param release Callback which releases the buffer, exceptions thrown by it are logged and ignored.
+@param steps Array of ndims-1 steps in bytes as in Mat constructors for user data, continuous data if NULL.
+*/
+CV_EXPORTS Mat wrapExternalBuffer(void* data, int dims, const int* sizes, int type,
+                                  const std::function<void()>& release, const size_t* steps = 0);
+
+/** @overload
+@param data Pointer to the buffer.
+@param size 2D array size.
+@param type Array type.
+@param release Callback which releases the buffer.
+@param step Number of bytes each matrix row occupies, Mat::AUTO_STEP for continuous data.
+*/
+CV_EXPORTS Mat wrapExternalBuffer(void* data, Size size, int type,
+                                  const std::function<void()>& release, size_t step = Mat::AUTO_STEP);
+
+/** @overload
+The matrix and its copies hold a reference to @p owner of the buffer, for example a tensor of other library.
+@param owner Owner of the buffer.
+@param data Pointer to the buffer.
+@param dims Number of dimensions.
+@param sizes Array of dimension sizes.
+@param type Array type.
+@param steps Array of ndims-1 steps in bytes, continuous data if NULL.
+*/
+CV_EXPORTS Mat wrapExternalBuffer(const std::shared_ptr<void>& owner, void* data, int dims, const int* sizes, int type,
+                                  const size_t* steps = 0);
+
+}}  // namespace
+
+#endif  // OPENCV_CORE_EXTERNAL_BUFFER_HPP
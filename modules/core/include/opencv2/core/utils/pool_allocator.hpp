@@ -0,0 +1,55 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_POOL_ALLOCATOR_HPP
+#define OPENCV_CORE_POOL_ALLOCATOR_HPP
+
+#include "../cvdef.h"
+#include "allocator_stats.hpp"
+
+namespace cv {
+
+class MatAllocator;
+
+namespace utils {
+
+/** @brief Returns Mat allocator which reuses freed buffers.
+
+Freed buffers are kept in caches of the threads which free them, grouped by size classes with at most 25% of
+overhead, and are reused by the next allocations of the same size class in these threads. Buffers larger than
+64Mb are not cached. Total size of cached buffers is limited by `setMaxReservedSize()` of the allocator's
+BufferPoolController (`OPENCV_MAT_BUFFERPOOL_LIMIT` configuration parameter, 256Mb by default),
+`freeAllReservedBuffers()` releases cached buffers of all threads.
+
+The allocator may be set as the default one by Mat::setDefaultAllocator(), by the `OPENCV_MAT_BUFFERPOOL=1`
+configuration parameter or for the current thread only by MatAllocatorScope.
+*/
+CV_EXPORTS MatAllocator* getPoolMatAllocator();
+
+/** @brief Returns statistics of buffers allocated by getPoolMatAllocator(), cached buffers are not counted. */
+CV_EXPORTS AllocatorStatisticsInterface& getPoolMatAllocatorStatistics();
+
+/** @brief Sets the default allocator of Mat objects created by the current thread while the object exists.
+
+Scopes may be nested and must be destroyed in reverse order by the thread which has created them.
+Allocators of Mat objects created by other threads, including the threads which process `parallel_for_()`
+calls, are not changed.
+*/
+class CV_EXPORTS MatAllocatorScope
+{
+public:
+    explicit MatAllocatorScope(MatAllocator* allocator);
+    ~MatAllocatorScope();
+
+protected:
+    MatAllocator* prevAllocator;
+
+private:
+    MatAllocatorScope(const MatAllocatorScope&); // disabled
+    MatAllocatorScope& operator=(const MatAllocatorScope&); // disabled
+};
+
+}}  // namespace
+
+#endif  // OPENCV_CORE_POOL_ALLOCATOR_HPP
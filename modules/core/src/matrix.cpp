@@ -4,6 +4,11 @@
 
 #include "precomp.hpp"
 #include "bufferpool.impl.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/tls.hpp"
+
+#include <atomic>
 
 namespace cv {
 
@@ -179,15 +184,49 @@ public:
 static
 MatAllocator*& getDefaultAllocatorMatRef()
 {
-    static MatAllocator* g_matAllocator = Mat::getStdAllocator();
+    static MatAllocator* g_matAllocator = utils::getConfigurationParameterBool("OPENCV_MAT_BUFFERPOOL", false)
+        ? utils::getPoolMatAllocator() : Mat::getStdAllocator();
     return g_matAllocator;
 }
 
+struct MatAllocatorTLSData
+{
+    MatAllocatorTLSData() : allocator(NULL) {}
+    MatAllocator* allocator;  // allocator of the innermost MatAllocatorScope
+};
+
+static TLSData<MatAllocatorTLSData>& getMatAllocatorTLSData()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TLSData<MatAllocatorTLSData>, new TLSData<MatAllocatorTLSData>())
+}
+
+static std::atomic<int> g_matAllocatorScopes(0);  // number of MatAllocatorScope objects of all threads
+
 MatAllocator* Mat::getDefaultAllocator()
 {
+    if (g_matAllocatorScopes.load(std::memory_order_relaxed) > 0)
+    {
+        MatAllocator* allocator = getMatAllocatorTLSData().get()->allocator;
+        if (allocator)
+            return allocator;
+    }
     return getDefaultAllocatorMatRef();
 }
 
+utils::MatAllocatorScope::MatAllocatorScope(MatAllocator* allocator)
+{
+    MatAllocatorTLSData* data = getMatAllocatorTLSData().get();
+    prevAllocator = data->allocator;
+    data->allocator = allocator;
+    g_matAllocatorScopes++;
+}
+
+utils::MatAllocatorScope::~MatAllocatorScope()
+{
+    getMatAllocatorTLSData().get()->allocator = prevAllocator;
+    g_matAllocatorScopes--;
+}
+
 void Mat::setDefaultAllocator(MatAllocator* allocator)
 {
     getDefaultAllocatorMatRef() = allocator;
@@ -103,6 +103,47 @@ public:
 
 static MatOp_Cmp g_MatOp_Cmp;
 
+// Chain of element-wise operations computed in a single pass. a and b are the inputs,
+// c is the program (see FusedInstr) and flags is the type of the result.
+class MatOp_Fused CV_FINAL : public MatOp
+{
+public:
+    MatOp_Fused() {}
+    virtual ~MatOp_Fused() {}
+
+    bool elementWise(const MatExpr& /*expr*/) const CV_OVERRIDE { return true; }
+    void assign(const MatExpr& expr, Mat& m, int type=-1) const CV_OVERRIDE;
+
+    void roi(const MatExpr& expr, const Range& rowRange, const Range& colRange, MatExpr& res) const CV_OVERRIDE;
+    void diag(const MatExpr& expr, int d, MatExpr& res) const CV_OVERRIDE;
+
+    int type(const MatExpr& expr) const CV_OVERRIDE { return expr.flags; }
+
+    // These return false and don't change res if none of the operands is an element-wise operation
+    // or the operands can't be computed in single precision.
+    static bool makeExpr(MatExpr& res, int op, const MatExpr& e1, const MatExpr& e2, double scale=1, int arg=0);
+    static bool makeExpr(MatExpr& res, int op, const MatExpr& e, const Scalar& s, bool scalarFirst=false, int arg=0);
+    static bool makeExpr(MatExpr& res, int op, const MatExpr& e);
+};
+
+static MatOp_Fused g_MatOp_Fused;
+
+enum
+{
+    FUSED_LOAD = 0,  // pushes input 'arg'
+    FUSED_CONST,     // pushes per-channel constant 'v'
+    FUSED_ADD,       // binary operations pop 2 values and push the result
+    FUSED_SUB,
+    FUSED_MUL,
+    FUSED_DIV,       // x/0 = 0 if 'arg' is not 0
+    FUSED_MIN,
+    FUSED_MAX,
+    FUSED_ABSDIFF,
+    FUSED_CMP,       // 255 if the comparison 'arg' is true, 0 otherwise
+    FUSED_ABS,       // unary operations replace the top value
+    FUSED_SAT        // rounds and saturates the top value to the integer depth 'arg'
+};
+
 class MatOp_GEMM CV_FINAL : public MatOp
 {
 public:
@@ -212,6 +253,11 @@ static inline bool isSolve(const MatExpr& e) { return e.op == &g_MatOp_Solve; }
 //static inline bool isGEMM(const MatExpr& e) { return e.op == &g_MatOp_GEMM; }
 static inline bool isMatProd(const MatExpr& e) { return e.op == &g_MatOp_GEMM && (!e.c.data || e.beta == 0); }
 static inline bool isInitializer(const MatExpr& e) { return e.op == getGlobalMatOpInitializer(); }
+static inline bool isFused(const MatExpr& e) { return e.op == &g_MatOp_Fused; }
+// scaled sum which is computed by MatOp_AddEx without temporary matrices
+static inline bool isLinear(const MatExpr& e) { return isIdentity(e) || (isAddEx(e) && (!e.b.data || e.beta == 0)); }
+// operand of per-element multiplication or division which doesn't need a temporary matrix
+static inline bool isMulOperand(const MatExpr& e) { return isIdentity(e) || isScaled(e) || isReciprocal(e); }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -329,6 +375,9 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
     if( this == e2.op )
     {
+        if( !(isLinear(e1) && isLinear(e2)) && MatOp_Fused::makeExpr(res, FUSED_ADD, e1, e2) )
+            return;
+
         double alpha = 1, beta = 1;
         Scalar s;
         Mat m1, m2;
@@ -360,6 +409,9 @@ void MatOp::add(const MatExpr& expr1, const Scalar& s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( MatOp_Fused::makeExpr(res, FUSED_ADD, expr1, s) )
+        return;
+
     Mat m1;
     expr1.op->assign(expr1, m1);
     MatOp_AddEx::makeExpr(res, m1, Mat(), 1, 0, s);
@@ -372,6 +424,9 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
     if( this == e2.op )
     {
+        if( !(isLinear(e1) && isLinear(e2)) && MatOp_Fused::makeExpr(res, FUSED_SUB, e1, e2) )
+            return;
+
         double alpha = 1, beta = -1;
         Scalar s;
         Mat m1, m2;
@@ -403,6 +458,9 @@ void MatOp::subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( MatOp_Fused::makeExpr(res, FUSED_SUB, expr, s, true) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), -1, 0, s);
@@ -415,6 +473,9 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
 
     if( this == e2.op )
     {
+        if( !(isMulOperand(e1) && isMulOperand(e2)) && MatOp_Fused::makeExpr(res, FUSED_MUL, e1, e2, scale) )
+            return;
+
         Mat m1, m2;
 
         if( isReciprocal(e1) )
@@ -466,6 +527,9 @@ void MatOp::multiply(const MatExpr& expr, double s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( MatOp_Fused::makeExpr(res, FUSED_MUL, expr, Scalar::all(s)) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), s, 0);
@@ -478,6 +542,9 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
 
     if( this == e2.op )
     {
+        if( !(isMulOperand(e1) && isMulOperand(e2)) && MatOp_Fused::makeExpr(res, FUSED_DIV, e1, e2, scale) )
+            return;
+
         if( isReciprocal(e1) && isReciprocal(e2) )
             MatOp_Bin::makeExpr(res, '/', e2.a, e1.a, e1.alpha/e2.alpha);
         else
@@ -518,6 +585,9 @@ void MatOp::divide(double s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( MatOp_Fused::makeExpr(res, FUSED_DIV, expr, Scalar::all(s), true) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, '/', m, Mat(), s);
@@ -528,6 +598,9 @@ void MatOp::abs(const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( MatOp_Fused::makeExpr(res, FUSED_ABS, expr) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, 'a', m, Mat());
@@ -1086,6 +1159,31 @@ MatExpr operator > (double s, const Mat& a)
     return e;
 }
 
+static MatExpr compare(const MatExpr& e, double s, int cmpop)
+{
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_CMP, e, Scalar::all(s), false, cmpop) )
+    {
+        Mat m = e;
+        checkOperandsExist(m);
+        MatOp_Cmp::makeExpr(en, cmpop, m, s);
+    }
+    return en;
+}
+
+MatExpr operator < (const MatExpr& e, double s) { return compare(e, s, CV_CMP_LT); }
+MatExpr operator < (double s, const MatExpr& e) { return compare(e, s, CV_CMP_GT); }
+MatExpr operator <= (const MatExpr& e, double s) { return compare(e, s, CV_CMP_LE); }
+MatExpr operator <= (double s, const MatExpr& e) { return compare(e, s, CV_CMP_GE); }
+MatExpr operator == (const MatExpr& e, double s) { return compare(e, s, CV_CMP_EQ); }
+MatExpr operator == (double s, const MatExpr& e) { return compare(e, s, CV_CMP_EQ); }
+MatExpr operator != (const MatExpr& e, double s) { return compare(e, s, CV_CMP_NE); }
+MatExpr operator != (double s, const MatExpr& e) { return compare(e, s, CV_CMP_NE); }
+MatExpr operator >= (const MatExpr& e, double s) { return compare(e, s, CV_CMP_GE); }
+MatExpr operator >= (double s, const MatExpr& e) { return compare(e, s, CV_CMP_LE); }
+MatExpr operator > (const MatExpr& e, double s) { return compare(e, s, CV_CMP_GT); }
+MatExpr operator > (double s, const MatExpr& e) { return compare(e, s, CV_CMP_LT); }
+
 MatExpr min(const Mat& a, const Mat& b)
 {
     CV_INSTRUMENT_REGION();
@@ -1146,6 +1244,86 @@ MatExpr max(double s, const Mat& a)
     return e;
 }
 
+MatExpr min(const MatExpr& e, double s)
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_MIN, e, Scalar::all(s)) )
+        en = min(Mat(e), s);
+    return en;
+}
+
+MatExpr min(double s, const MatExpr& e)
+{
+    return min(e, s);
+}
+
+MatExpr min(const MatExpr& e, const Mat& m)
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_MIN, e, MatExpr(m)) )
+        en = min(Mat(e), m);
+    return en;
+}
+
+MatExpr min(const Mat& m, const MatExpr& e)
+{
+    return min(e, m);
+}
+
+MatExpr min(const MatExpr& e1, const MatExpr& e2)
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_MIN, e1, e2) )
+        en = min(Mat(e1), Mat(e2));
+    return en;
+}
+
+MatExpr max(const MatExpr& e, double s)
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_MAX, e, Scalar::all(s)) )
+        en = max(Mat(e), s);
+    return en;
+}
+
+MatExpr max(double s, const MatExpr& e)
+{
+    return max(e, s);
+}
+
+MatExpr max(const MatExpr& e, const Mat& m)
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_MAX, e, MatExpr(m)) )
+        en = max(Mat(e), m);
+    return en;
+}
+
+MatExpr max(const Mat& m, const MatExpr& e)
+{
+    return max(e, m);
+}
+
+MatExpr max(const MatExpr& e1, const MatExpr& e2)
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr en;
+    if( !MatOp_Fused::makeExpr(en, FUSED_MAX, e1, e2) )
+        en = max(Mat(e1), Mat(e2));
+    return en;
+}
+
 MatExpr operator & (const Mat& a, const Mat& b)
 {
     checkOperandsExist(a, b);
@@ -1520,6 +1698,612 @@ inline void MatOp_Cmp::makeExpr(MatExpr& res, int cmpop, const Mat& a, double al
     res = MatExpr(&g_MatOp_Cmp, cmpop, a, Mat(), Mat(), alpha, 1);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Instruction of MatOp_Fused program, a row of MatExpr::c
+struct FusedInstr
+{
+    double op, arg, v[4];
+};
+
+const int FUSED_MAX_INPUTS = 2;
+// Pixels processed by the program at once, so the intermediate values stay in L1 cache
+const int FUSED_BLOCK_PIXELS = 128;
+
+static inline bool isFusedType(int type)
+{
+    int depth = CV_MAT_DEPTH(type);
+    return CV_MAT_CN(type) <= 4 &&
+        (depth == CV_8U || depth == CV_8S || depth == CV_16U || depth == CV_16S || depth == CV_32F);
+}
+
+static inline bool isFusedOperation(const MatExpr& e)
+{
+    return isFused(e) || isAddEx(e) || isCmp(e) ||
+        (e.op == &g_MatOp_Bin && strchr("*/mMnNa", e.flags) != NULL);
+}
+
+static inline bool isSameMat(const Mat& a, const Mat& b)
+{
+    return a.data == b.data && a.type() == b.type() && a.size == b.size && a.step == b.step;
+}
+
+class FusedProgram
+{
+public:
+    FusedProgram() : type(-1) {}
+
+    void emit(int op, double arg = 0, const Scalar& v = Scalar())
+    {
+        FusedInstr instr = { (double)op, arg, { v[0], v[1], v[2], v[3] } };
+        code.push_back(instr);
+    }
+
+    bool load(const Mat& m)
+    {
+        if (m.empty() || !isFusedType(m.type()))
+            return false;
+        inputs.assign(1, m);
+        code.clear();
+        emit(FUSED_LOAD, 0);
+        type = m.type();
+        return true;
+    }
+
+    // rounds and saturates the result like the matrix of its type does
+    void saturate()
+    {
+        int depth = CV_MAT_DEPTH(type);
+        if (depth != CV_32F)
+            emit(FUSED_SAT, depth);
+    }
+
+    bool fromExpr(const MatExpr& e);
+
+    // this = this op p, the result is not saturated if saturateResult is false
+    bool apply(int op, FusedProgram& p, int arg = 0, bool saturateResult = true);
+
+    // this = this op s or s op this
+    void apply(int op, const Scalar& s, bool scalarFirst = false, int arg = 0)
+    {
+        if (scalarFirst)
+            code.insert(code.begin(), FusedInstr());
+        else
+            code.push_back(FusedInstr());
+        FusedInstr& instr = scalarFirst ? code.front() : code.back();
+        instr.op = FUSED_CONST;
+        instr.arg = 0;
+        for (int i = 0; i < 4; i++)
+            instr.v[i] = s[i];
+        emitOp(op, arg);
+    }
+
+    void toExpr(MatExpr& res) const
+    {
+        Mat c((int)code.size(), (int)(sizeof(FusedInstr)/sizeof(double)), CV_64F);
+        memcpy(c.data, code.data(), code.size()*sizeof(FusedInstr));
+        res = MatExpr(&g_MatOp_Fused, type, inputs[0], inputs.size() > 1 ? inputs[1] : Mat(), c);
+    }
+
+    void evaluate(Mat& m) const
+    {
+        MatExpr e;
+        toExpr(e);
+        e.op->assign(e, m);
+    }
+
+    std::vector<FusedInstr> code;
+    std::vector<Mat> inputs;
+    int type;
+
+protected:
+    void emitOp(int op, int arg, bool saturateResult = true)
+    {
+        if (op == FUSED_DIV)
+            arg = CV_MAT_DEPTH(type) != CV_32F;
+        emit(op, arg);
+        if (op == FUSED_CMP)
+            type = CV_8UC(CV_MAT_CN(type));
+        else if (saturateResult)
+            saturate();
+    }
+
+    bool append(const FusedProgram& p)
+    {
+        std::vector<Mat> merged = inputs;
+        int remap[FUSED_MAX_INPUTS] = { 0 };
+        for (size_t i = 0; i < p.inputs.size(); i++)
+        {
+            size_t j = 0;
+            while (j < merged.size() && !isSameMat(merged[j], p.inputs[i]))
+                j++;
+            if (j == merged.size())
+            {
+                if (merged.size() == (size_t)FUSED_MAX_INPUTS)
+                    return false;
+                merged.push_back(p.inputs[i]);
+            }
+            remap[i] = (int)j;
+        }
+        inputs.swap(merged);
+        for (size_t k = 0; k < p.code.size(); k++)
+        {
+            code.push_back(p.code[k]);
+            if (p.code[k].op == FUSED_LOAD)
+                code.back().arg = remap[(int)p.code[k].arg];
+        }
+        return true;
+    }
+};
+
+bool FusedProgram::fromExpr(const MatExpr& e)
+{
+    if (isFused(e))
+    {
+        inputs.assign(1, e.a);
+        if (e.b.data)
+            inputs.push_back(e.b);
+        const FusedInstr* instr = e.c.ptr<FusedInstr>();
+        code.assign(instr, instr + e.c.rows);
+        type = e.flags;
+        return true;
+    }
+
+    if (isAddEx(e))
+    {
+        if (!load(e.a))
+            return false;
+        if (e.alpha != 1)
+            emit(FUSED_CONST, 0, Scalar::all(e.alpha)), emit(FUSED_MUL);
+        if (e.b.data && e.beta != 0)
+        {
+            FusedProgram p;
+            if (!p.load(e.b) || p.type != type || !append(p))
+                return false;
+            if (e.beta != 1)
+                emit(FUSED_CONST, 0, Scalar::all(e.beta)), emit(FUSED_MUL);
+            emit(FUSED_ADD);
+        }
+        if (e.s != Scalar())
+            emit(FUSED_CONST, 0, e.s), emit(FUSED_ADD);
+        saturate();
+        return true;
+    }
+
+    if (isFusedOperation(e))  // MatOp_Bin or MatOp_Cmp
+    {
+        FusedProgram p;
+        if (isReciprocal(e))
+        {
+            if (!p.load(e.a))
+                return false;
+            type = p.type;
+            emit(FUSED_CONST, 0, Scalar::all(e.alpha));
+            append(p);
+            emitOp(FUSED_DIV, 0);
+            return true;
+        }
+        if (!load(e.a) || (e.b.data && !p.load(e.b)))
+            return false;
+        if (isCmp(e))
+        {
+            if (e.b.data)
+                return apply(FUSED_CMP, p, e.flags);
+            apply(FUSED_CMP, Scalar::all(e.alpha), false, e.flags);
+            return true;
+        }
+        switch (e.flags)
+        {
+        case '*':
+            if (!apply(FUSED_MUL, p, 0, e.alpha == 1))
+                return false;
+            if (e.alpha != 1)
+                apply(FUSED_MUL, Scalar::all(e.alpha));
+            return true;
+        case '/':
+            if (e.alpha != 1)
+                emit(FUSED_CONST, 0, Scalar::all(e.alpha)), emit(FUSED_MUL);
+            return apply(FUSED_DIV, p);
+        case 'm':
+            return apply(FUSED_MIN, p);
+        case 'M':
+            return apply(FUSED_MAX, p);
+        case 'n':
+            apply(FUSED_MIN, Scalar::all(e.s[0]));
+            return true;
+        case 'N':
+            apply(FUSED_MAX, Scalar::all(e.s[0]));
+            return true;
+        case 'a':
+            if (e.b.data)
+                return apply(FUSED_ABSDIFF, p);
+            apply(FUSED_ABSDIFF, e.s);
+            return true;
+        default:
+            CV_Error(cv::Error::StsError, "Unknown operation");
+        }
+    }
+
+    // other expressions are computed as usual
+    Mat m;
+    e.op->assign(e, m);
+    return load(m);
+}
+
+bool FusedProgram::apply(int op, FusedProgram& p, int arg, bool saturateResult)
+{
+    if (p.type != type || p.inputs[0].size != inputs[0].size)
+        return false;
+    if (!append(p))
+    {
+        // too many matrices, the operand with more of them is computed into a temporary matrix first
+        FusedProgram& p1 = p.inputs.size() > inputs.size() ? p : *this;
+        FusedProgram& p2 = &p1 == this ? p : *this;
+        Mat m1, m2;
+        p1.evaluate(m1);
+        p1.load(m1);
+        if (!append(p))
+        {
+            p2.evaluate(m2);
+            p2.load(m2);
+            CV_Assert(append(p));
+        }
+    }
+    emitOp(op, arg, saturateResult);
+    return true;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, int op, const MatExpr& e1, const MatExpr& e2, double scale, int arg)
+{
+    CV_INSTRUMENT_REGION();
+
+    if (!(isFusedOperation(e1) || isFusedOperation(e2)) ||
+        !isFusedType(e1.type()) || e1.type() != e2.type() || e1.size() != e2.size())
+        return false;
+
+    FusedProgram p1, p2;
+    // scale factors of the multiplication operands are applied to the result as MatOp_Bin does
+    if ((op == FUSED_MUL || op == FUSED_DIV) && isScaled(e1))
+    {
+        scale *= e1.alpha;
+        p1.load(e1.a);
+    }
+    else if (!p1.fromExpr(e1))
+        return false;
+    if ((op == FUSED_MUL || op == FUSED_DIV) && isScaled(e2))
+    {
+        scale = op == FUSED_MUL ? scale*e2.alpha : scale/e2.alpha;
+        p2.load(e2.a);
+    }
+    else if (!p2.fromExpr(e2))
+        return false;
+
+    if (op == FUSED_DIV && scale != 1)
+        p1.emit(FUSED_CONST, 0, Scalar::all(scale)), p1.emit(FUSED_MUL);
+    if (!p1.apply(op, p2, arg, !(op == FUSED_MUL && scale != 1)))
+        return false;
+    if (op == FUSED_MUL && scale != 1)
+        p1.apply(FUSED_MUL, Scalar::all(scale));
+    p1.toExpr(res);
+    return true;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, int op, const MatExpr& e, const Scalar& s, bool scalarFirst, int arg)
+{
+    CV_INSTRUMENT_REGION();
+
+    if (!isFusedOperation(e) || !isFusedType(e.type()))
+        return false;
+
+    FusedProgram p;
+    if (!p.fromExpr(e))
+        return false;
+    p.apply(op, s, scalarFirst, arg);
+    p.toExpr(res);
+    return true;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, int op, const MatExpr& e)
+{
+    CV_INSTRUMENT_REGION();
+
+    if (!isFusedOperation(e) || !isFusedType(e.type()))
+        return false;
+
+    FusedProgram p;
+    if (!p.fromExpr(e))
+        return false;
+    p.emit(op);
+    p.saturate();
+    p.toExpr(res);
+    return true;
+}
+
+void MatOp_Fused::roi(const MatExpr& e, const Range& rowRange, const Range& colRange, MatExpr& res) const
+{
+    res = e;
+    res.a = e.a(rowRange, colRange);
+    if (e.b.data)
+        res.b = e.b(rowRange, colRange);
+}
+
+void MatOp_Fused::diag(const MatExpr& e, int d, MatExpr& res) const
+{
+    res = e;
+    res.a = e.a.diag(d);
+    if (e.b.data)
+        res.b = e.b.diag(d);
+}
+
+struct FusedAdd
+{
+    float operator()(float x, float y) const { return x + y; }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_add(x, y); }
+#endif
+};
+
+struct FusedSub
+{
+    float operator()(float x, float y) const { return x - y; }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_sub(x, y); }
+#endif
+};
+
+struct FusedMul
+{
+    float operator()(float x, float y) const { return x * y; }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_mul(x, y); }
+#endif
+};
+
+struct FusedDiv
+{
+    float operator()(float x, float y) const { return x / y; }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_div(x, y); }
+#endif
+};
+
+// integer division, x/0 = 0
+struct FusedDivInt
+{
+    float operator()(float x, float y) const { return y != 0 ? x / y : 0.f; }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const
+    {
+        v_float32 z = vx_setzero_f32();
+        return v_select(v_eq(y, z), z, v_div(x, y));
+    }
+#endif
+};
+
+struct FusedMin
+{
+    float operator()(float x, float y) const { return std::min(x, y); }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_min(x, y); }
+#endif
+};
+
+struct FusedMax
+{
+    float operator()(float x, float y) const { return std::max(x, y); }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_max(x, y); }
+#endif
+};
+
+struct FusedAbsDiff
+{
+    float operator()(float x, float y) const { return std::abs(x - y); }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const { return v_absdiff(x, y); }
+#endif
+};
+
+template<int cmpop> struct FusedCmp
+{
+    float operator()(float x, float y) const
+    {
+        bool r = cmpop == CMP_EQ ? x == y : cmpop == CMP_GT ? x > y : cmpop == CMP_GE ? x >= y :
+                 cmpop == CMP_LT ? x < y : cmpop == CMP_LE ? x <= y : x != y;
+        return r ? 255.f : 0.f;
+    }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x, const v_float32& y) const
+    {
+        v_float32 mask = cmpop == CMP_EQ ? v_eq(x, y) : cmpop == CMP_GT ? v_gt(x, y) : cmpop == CMP_GE ? v_ge(x, y) :
+                         cmpop == CMP_LT ? v_lt(x, y) : cmpop == CMP_LE ? v_le(x, y) : v_ne(x, y);
+        return v_and(mask, vx_setall_f32(255.f));
+    }
+#endif
+};
+
+struct FusedAbs
+{
+    float operator()(float x) const { return std::abs(x); }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x) const { return v_abs(x); }
+#endif
+};
+
+struct FusedSat
+{
+    explicit FusedSat(int depth)
+    {
+        minval = depth == CV_8U || depth == CV_16U ? 0.f : depth == CV_8S ? -128.f : -32768.f;
+        maxval = depth == CV_8U ? 255.f : depth == CV_8S ? 127.f : depth == CV_16U ? 65535.f : 32767.f;
+    }
+    float operator()(float x) const { return (float)cvRound(std::min(std::max(x, minval), maxval)); }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 operator()(const v_float32& x) const
+    {
+        return v_cvt_f32(v_round(v_min(v_max(x, vx_setall_f32(minval)), vx_setall_f32(maxval))));
+    }
+#endif
+    float minval, maxval;
+};
+
+template<typename Op> static void fusedBinary(const float* x, const float* y, float* dst, int n, const Op& op)
+{
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_float32>::vlanes();
+    for (; i <= n - nlanes; i += nlanes)
+        v_store(dst + i, op(vx_load(x + i), vx_load(y + i)));
+#endif
+    for (; i < n; i++)
+        dst[i] = op(x[i], y[i]);
+}
+
+template<typename Op> static void fusedUnary(const float* x, float* dst, int n, const Op& op)
+{
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_float32>::vlanes();
+    for (; i <= n - nlanes; i += nlanes)
+        v_store(dst + i, op(vx_load(x + i)));
+#endif
+    for (; i < n; i++)
+        dst[i] = op(x[i]);
+}
+
+void MatOp_Fused::assign(const MatExpr& e, Mat& m, int _type) const
+{
+    CV_INSTRUMENT_REGION();
+
+    const int cn = CV_MAT_CN(e.flags);
+    CV_Assert(_type == -1 || CV_MAT_CN(_type) == cn);
+    const int ddepth = _type == -1 ? CV_MAT_DEPTH(e.flags) : CV_MAT_DEPTH(_type);
+    const FusedInstr* code = e.c.ptr<FusedInstr>();
+    const int ncode = e.c.rows;
+
+    int sp = 0, maxDepth = 0, nconst = 0;
+    for (int k = 0; k < ncode; k++)
+    {
+        int op = (int)code[k].op;
+        sp += op == FUSED_LOAD || op == FUSED_CONST ? 1 : op < FUSED_ABS ? -1 : 0;
+        maxDepth = std::max(maxDepth, sp);
+        nconst += op == FUSED_CONST;
+    }
+    CV_Assert(sp == 1);
+
+    // stack values of the current block and constants repeated along the block
+    const int blockSize = FUSED_BLOCK_PIXELS*cn;
+    AutoBuffer<float> _buf((size_t)blockSize*(maxDepth + nconst));
+    float* buf = _buf.data();
+    AutoBuffer<const float*> _consts(ncode), _stack(maxDepth);
+    const float** consts = _consts.data();
+    const float** stack = _stack.data();
+    float* constBuf = buf + blockSize*maxDepth;
+    for (int k = 0; k < ncode; k++)
+    {
+        if ((int)code[k].op != FUSED_CONST)
+            continue;
+        for (int i = 0; i < blockSize; i++)
+            constBuf[i] = (float)code[k].v[i % cn];
+        consts[k] = constBuf;
+        constBuf += blockSize;
+    }
+
+    Mat inputs[FUSED_MAX_INPUTS] = { e.a, e.b };  // keep the inputs if m is one of them
+    const int ninputs = e.b.data ? 2 : 1;
+    m.create(e.a.dims, e.a.size.p, CV_MAKETYPE(ddepth, cn));
+
+    BinaryFunc loadFunc[FUSED_MAX_INPUTS] = { 0 };
+    size_t esz[FUSED_MAX_INPUTS + 1] = { m.elemSize1() };
+    for (int i = 0; i < ninputs; i++)
+    {
+        if (inputs[i].depth() != CV_32F)
+            loadFunc[i] = getConvertFunc(inputs[i].depth(), CV_32F);
+        esz[i + 1] = inputs[i].elemSize1();
+    }
+    BinaryFunc storeFunc = ddepth != CV_32F ? getConvertFunc(CV_32F, ddepth) : 0;
+
+    const Mat* arrays[] = { &m, &inputs[0], &inputs[1], 0 };
+    uchar* ptrs[FUSED_MAX_INPUTS + 1] = {};
+    NAryMatIterator it(arrays, ptrs, ninputs + 1);
+    const size_t total = it.size*cn;
+
+    for (size_t p = 0; p < it.nplanes; p++, ++it)
+    {
+        for (size_t j = 0; j < total; j += blockSize)
+        {
+            const int n = (int)std::min((size_t)blockSize, total - j);
+            sp = 0;
+            for (int k = 0; k < ncode; k++)
+            {
+                const FusedInstr& instr = code[k];
+                const int arg = (int)instr.arg;
+                float* dst = buf + blockSize*std::max(sp - 2, 0);  // result of binary operations
+                switch ((int)instr.op)
+                {
+                case FUSED_LOAD:
+                {
+                    const uchar* src = ptrs[arg + 1] + j*esz[arg + 1];
+                    if (loadFunc[arg])
+                    {
+                        float* val = buf + blockSize*sp;
+                        loadFunc[arg](src, 0, 0, 0, (uchar*)val, 0, Size(n, 1), 0);
+                        stack[sp++] = val;
+                    }
+                    else
+                        stack[sp++] = (const float*)src;
+                    continue;
+                }
+                case FUSED_CONST: stack[sp++] = consts[k]; continue;
+                case FUSED_ADD: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedAdd()); break;
+                case FUSED_SUB: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedSub()); break;
+                case FUSED_MUL: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedMul()); break;
+                case FUSED_DIV:
+                    if (arg)
+                        fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedDivInt());
+                    else
+                        fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedDiv());
+                    break;
+                case FUSED_MIN: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedMin()); break;
+                case FUSED_MAX: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedMax()); break;
+                case FUSED_ABSDIFF: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedAbsDiff()); break;
+                case FUSED_CMP:
+                    switch (arg)
+                    {
+                    case CMP_EQ: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedCmp<CMP_EQ>()); break;
+                    case CMP_GT: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedCmp<CMP_GT>()); break;
+                    case CMP_GE: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedCmp<CMP_GE>()); break;
+                    case CMP_LT: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedCmp<CMP_LT>()); break;
+                    case CMP_LE: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedCmp<CMP_LE>()); break;
+                    case CMP_NE: fusedBinary(stack[sp - 2], stack[sp - 1], dst, n, FusedCmp<CMP_NE>()); break;
+                    default: CV_Error(cv::Error::StsBadArg, "Unknown comparison operation");
+                    }
+                    break;
+                case FUSED_ABS:
+                case FUSED_SAT:
+                    dst = buf + blockSize*(sp - 1);
+                    if ((int)instr.op == FUSED_ABS)
+                        fusedUnary(stack[sp - 1], dst, n, FusedAbs());
+                    else
+                        fusedUnary(stack[sp - 1], dst, n, FusedSat(arg));
+                    stack[sp - 1] = dst;
+                    continue;
+                default:
+                    CV_Error(cv::Error::StsError, "Unknown operation");
+                }
+                stack[sp - 2] = dst;
+                sp--;
+            }
+
+            uchar* out = ptrs[0] + j*esz[0];
+            if (storeFunc)
+                storeFunc((const uchar*)stack[0], 0, 0, 0, out, 0, Size(n, 1), 0);
+            else if ((const uchar*)stack[0] != out)
+                memcpy(out, stack[0], n*sizeof(float));
+        }
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void MatOp_T::assign(const MatExpr& e, Mat& m, int _type) const
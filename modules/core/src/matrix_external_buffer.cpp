@@ -0,0 +1,102 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "opencv2/core/utils/external_buffer.hpp"
+#include "opencv2/core/utils/logger.hpp"
+
+namespace cv { namespace utils {
+
+namespace {
+
+// Mat allocator which releases external buffers by callbacks kept in UMatData::userdata
+class ExternalBufferAllocator CV_FINAL : public MatAllocator
+{
+public:
+    UMatData* allocate(int, const int*, int, void*, size_t*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        CV_Error(Error::StsNotImplemented, "External buffer can't be allocated");
+    }
+
+    bool allocate(UMatData*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        return false;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        std::function<void()>* release = (std::function<void()>*)u->userdata;
+        delete u;
+        try
+        {
+            (*release)();
+        }
+        catch (const std::exception& e)
+        {
+            CV_LOG_ERROR(NULL, "Exception in release callback of external buffer: " << e.what());
+        }
+        catch (...)
+        {
+            CV_LOG_ERROR(NULL, "Unknown exception in release callback of external buffer");
+        }
+        delete release;
+    }
+};
+
+static ExternalBufferAllocator& getExternalBufferAllocator()
+{
+    CV_SINGLETON_LAZY_INIT_REF(ExternalBufferAllocator, new ExternalBufferAllocator())
+}
+
+}  // namespace
+
+Mat wrapExternalBuffer(void* data, int dims, const int* sizes, int type,
+                       const std::function<void()>& release, const size_t* steps)
+{
+    CV_Assert(release);
+    Mat m(dims, sizes, type, data, steps);
+    if (m.empty())
+    {
+        release();
+        return m;
+    }
+
+    std::function<void()>* callback = new std::function<void()>(release);
+    UMatData* u = NULL;
+    try
+    {
+        u = new UMatData(&getExternalBufferAllocator());
+    }
+    catch (...)
+    {
+        delete callback;
+        throw;
+    }
+    u->data = u->origdata = m.data;
+    u->size = (size_t)(m.datalimit - m.datastart);
+    u->userdata = callback;
+    u->refcount = 1;
+    m.u = u;  // Mat::allocator stays default, so getUMat() and reallocation don't use the external allocator
+    return m;
+}
+
+Mat wrapExternalBuffer(void* data, Size size, int type, const std::function<void()>& release, size_t step)
+{
+    const int sizes[] = { size.height, size.width };
+    return wrapExternalBuffer(data, 2, sizes, type, release, step != Mat::AUTO_STEP ? &step : NULL);
+}
+
+Mat wrapExternalBuffer(const std::shared_ptr<void>& owner, void* data, int dims, const int* sizes, int type,
+                       const size_t* steps)
+{
+    CV_Assert(owner);
+    // the reference is dropped with the callback
+    return wrapExternalBuffer(data, dims, sizes, type, [owner]() {}, steps);
+}
+
+}}  // namespace cv::utils
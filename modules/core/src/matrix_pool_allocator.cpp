@@ -0,0 +1,259 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "opencv2/core/bufferpool.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/tls.hpp"
+#include "opencv2/core/utils/allocator_stats.impl.hpp"
+
+#include <atomic>
+
+namespace cv { namespace utils {
+
+namespace {
+
+// Size classes: 64 bytes and 4 classes per power of two above it, up to 64Mb
+const size_t POOL_MIN_BLOCK_SIZE = 64;
+const int POOL_MIN_BLOCK_SIZE_LOG2 = 6;
+const int POOL_MAX_BLOCK_SIZE_LOG2 = 26;
+const size_t POOL_MAX_BLOCK_SIZE = (size_t)1 << POOL_MAX_BLOCK_SIZE_LOG2;
+const int POOL_SIZE_CLASSES = 1 + (POOL_MAX_BLOCK_SIZE_LOG2 - POOL_MIN_BLOCK_SIZE_LOG2) * 4;
+
+const size_t POOL_DEFAULT_MAX_RESERVED_SIZE = (size_t)256 << 20;
+
+// Returns size class of the buffer or -1 if the buffer is not pooled, blockSize is the allocated size
+static inline int getSizeClass(size_t size, size_t& blockSize)
+{
+    if (size <= POOL_MIN_BLOCK_SIZE)
+    {
+        blockSize = POOL_MIN_BLOCK_SIZE;
+        return 0;
+    }
+    if (size > POOL_MAX_BLOCK_SIZE)
+        return -1;
+    // size is in (2^e, 2^(e+1)], it is rounded up to (5 + sub) * 2^(e-2)
+    int e = POOL_MIN_BLOCK_SIZE_LOG2;
+    while (((size - 1) >> (e + 1)) != 0)
+        e++;
+    int sub = (int)((size - 1) >> (e - 2)) - 4;
+    blockSize = (size_t)(5 + sub) << (e - 2);
+    return 1 + (e - POOL_MIN_BLOCK_SIZE_LOG2) * 4 + sub;
+}
+
+static inline size_t getBlockSize(int sizeClass)
+{
+    if (sizeClass == 0)
+        return POOL_MIN_BLOCK_SIZE;
+    int e = POOL_MIN_BLOCK_SIZE_LOG2 + (sizeClass - 1) / 4, sub = (sizeClass - 1) % 4;
+    return (size_t)(5 + sub) << (e - 2);
+}
+
+// Freed buffers of a thread. The mutex is taken by other threads only to release the buffers.
+struct PoolThreadCache
+{
+    PoolThreadCache();
+    ~PoolThreadCache();
+    void releaseAll();
+
+    Mutex mutex;
+    std::vector<void*> buffers[POOL_SIZE_CLASSES];
+};
+
+class PoolMatAllocator CV_FINAL : public MatAllocator, public BufferPoolController
+{
+public:
+    PoolMatAllocator() : reservedSize(0)
+    {
+        maxReservedSize = utils::getConfigurationParameterSizeT("OPENCV_MAT_BUFFERPOOL_LIMIT", POOL_DEFAULT_MAX_RESERVED_SIZE);
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        uchar* data = data0 ? (uchar*)data0 : (uchar*)allocateBuffer(total);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+        else
+            stats.onAllocate(total);
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            stats.onFree(u->size);
+            releaseBuffer(u->origdata, u->size);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    BufferPoolController* getBufferPoolController(const char* /*id*/) const CV_OVERRIDE
+    {
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    // BufferPoolController
+    size_t getReservedSize() const CV_OVERRIDE { return reservedSize; }
+    size_t getMaxReservedSize() const CV_OVERRIDE { return maxReservedSize; }
+
+    void setMaxReservedSize(size_t size) CV_OVERRIDE
+    {
+        size_t oldMaxReservedSize = maxReservedSize.exchange(size);
+        if (size < oldMaxReservedSize)
+            freeAllReservedBuffers();
+    }
+
+    void freeAllReservedBuffers() CV_OVERRIDE
+    {
+        AutoLock lock(cachesMutex);
+        for (size_t i = 0; i < caches.size(); i++)
+            caches[i]->releaseAll();
+    }
+
+    void registerCache(PoolThreadCache* cache)
+    {
+        AutoLock lock(cachesMutex);
+        caches.push_back(cache);
+    }
+
+    void unregisterCache(PoolThreadCache* cache)
+    {
+        AutoLock lock(cachesMutex);
+        caches.erase(std::find(caches.begin(), caches.end(), cache));
+    }
+
+    void onRelease(size_t blockSize)
+    {
+        reservedSize -= blockSize;
+    }
+
+    mutable AllocatorStatistics stats;
+
+protected:
+    void* allocateBuffer(size_t size) const
+    {
+        size_t blockSize = 0;
+        int sizeClass = getSizeClass(size, blockSize);
+        if (sizeClass < 0)
+            return fastMalloc(size);
+        PoolThreadCache& cache = getCache();
+        {
+            AutoLock lock(cache.mutex);
+            std::vector<void*>& buffers = cache.buffers[sizeClass];
+            if (!buffers.empty())
+            {
+                void* ptr = buffers.back();
+                buffers.pop_back();
+                reservedSize -= blockSize;
+                return ptr;
+            }
+        }
+        return fastMalloc(blockSize);
+    }
+
+    void releaseBuffer(void* ptr, size_t size) const
+    {
+        size_t blockSize = 0;
+        int sizeClass = getSizeClass(size, blockSize);
+        if (sizeClass >= 0 && reservedSize + blockSize <= maxReservedSize)
+        {
+            PoolThreadCache& cache = getCache();
+            AutoLock lock(cache.mutex);
+            cache.buffers[sizeClass].push_back(ptr);
+            reservedSize += blockSize;
+            return;
+        }
+        fastFree(ptr);
+    }
+
+    static PoolThreadCache& getCache()
+    {
+        static TLSData<PoolThreadCache>* caches = new TLSData<PoolThreadCache>();  // don't destroy with other static objects
+        return caches->getRef();
+    }
+
+    mutable std::atomic<size_t> reservedSize;
+    std::atomic<size_t> maxReservedSize;
+
+    Mutex cachesMutex;
+    std::vector<PoolThreadCache*> caches;
+};
+
+static PoolMatAllocator& getPoolMatAllocatorImpl()
+{
+    CV_SINGLETON_LAZY_INIT_REF(PoolMatAllocator, new PoolMatAllocator())
+}
+
+PoolThreadCache::PoolThreadCache()
+{
+    getPoolMatAllocatorImpl().registerCache(this);
+}
+
+PoolThreadCache::~PoolThreadCache()
+{
+    getPoolMatAllocatorImpl().unregisterCache(this);
+    releaseAll();
+}
+
+void PoolThreadCache::releaseAll()
+{
+    PoolMatAllocator& allocator = getPoolMatAllocatorImpl();
+    AutoLock lock(mutex);
+    for (int sizeClass = 0; sizeClass < POOL_SIZE_CLASSES; sizeClass++)
+    {
+        std::vector<void*>& classBuffers = buffers[sizeClass];
+        for (size_t i = 0; i < classBuffers.size(); i++)
+            fastFree(classBuffers[i]);
+        allocator.onRelease(classBuffers.size() * getBlockSize(sizeClass));
+        std::vector<void*>().swap(classBuffers);
+    }
+}
+
+}  // namespace
+
+MatAllocator* getPoolMatAllocator()
+{
+    return &getPoolMatAllocatorImpl();
+}
+
+AllocatorStatisticsInterface& getPoolMatAllocatorStatistics()
+{
+    return getPoolMatAllocatorImpl().stats;
+}
+
+}}  // namespace cv::utils
@@ -44,8 +44,10 @@
 
 #include <opencv2/core/utils/configuration.private.hpp>
 #include <opencv2/core/utils/trace.private.hpp>
+#include <opencv2/core/utils/logger.hpp>
 
 #include "opencv2/core/parallel/parallel_backend.hpp"
+#include "opencv2/core/parallel/execution_scope.hpp"
 #include "parallel/parallel.hpp"
 
 #if defined _WIN32 || defined WINCE
@@ -151,6 +153,7 @@
 #  define CV_PARALLEL_FRAMEWORK "ms-concurrency"
 #elif defined HAVE_PTHREADS_PF
 #  define CV_PARALLEL_FRAMEWORK "pthreads"
+#  define CV_PARALLEL_FRAMEWORK_NESTED_CALLS 1  // the built-in thread pool processes nested and concurrent jobs
 #endif
 
 #include <atomic>
@@ -212,6 +215,7 @@ namespace {
 
             // propagate main thread state
             rng = cv::theRNG();
+            scope = parallel::getExecutionScopeSettings();
 #if OPENCV_SUPPORTS_FP_DENORMALS_HINT && OPENCV_IMPL_FP_HINTS
             details::saveFPDenormalsState(fp_denormals_base_state);
 #endif
@@ -262,6 +266,7 @@ namespace {
         int nstripes;
         cv::RNG rng;
         mutable bool is_rng_used;
+        const parallel::ExecutionScopeSettings* scope;
 #ifdef OPENCV_TRACE
         CV_TRACE_NS::details::Region* traceRootRegion;
         CV_TRACE_NS::details::TraceManagerThreadLocal* traceRootContext;
@@ -341,6 +346,9 @@ namespace {
 #if OPENCV_SUPPORTS_FP_DENORMALS_HINT && OPENCV_IMPL_FP_HINTS
             FPDenormalsIgnoreHintScope fp_denormals_scope(ctx.fp_denormals_base_state);
 #endif
+            const parallel::ExecutionScopeSettings* thread_scope = parallel::getExecutionScopeSettings();
+            if (thread_scope != ctx.scope)
+                parallel::setExecutionScopeSettings(ctx.scope);
 
             cv::Range r;
             cv::Range wholeRange = ctx.wholeRange;
@@ -379,6 +387,9 @@ namespace {
             }
 #endif
 
+            if (thread_scope != ctx.scope)
+                parallel::setExecutionScopeSettings(thread_scope);
+
             if (!ctx.is_rng_used && !(cv::theRNG() == ctx.rng))
                 ctx.is_rng_used = true;
         }
@@ -517,6 +528,14 @@ void parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, dou
     if (range.empty())
         return;
 
+#ifdef CV_PARALLEL_FRAMEWORK_NESTED_CALLS
+    if (!parallel::getCurrentParallelForAPI())
+    {
+        parallel_for_impl(range, body, nstripes);
+        return;
+    }
+#endif
+
     static std::atomic<bool> flagNestedParallelFor(false);
     bool isNotNestedRegion = !flagNestedParallelFor.load();
     if (isNotNestedRegion)
@@ -552,7 +571,8 @@ void parallel_for_cb(int start, int end, void* data)
 static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
 {
     using namespace cv::parallel;
-    if ((numThreads < 0 || numThreads > 1) && range.end - range.start > 1)
+    const ExecutionScopeSettings* scope = getExecutionScopeSettings();
+    if ((numThreads < 0 || numThreads > 1) && (!scope || scope->numThreads != 1) && range.end - range.start > 1)
     {
         ParallelLoopBodyWrapperContext ctx(body, range, nstripes);
         ProxyLoopBody pbody(ctx);
@@ -631,7 +651,7 @@ static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody
 }
 
 
-int getNumThreads(void)
+static int getGlobalNumThreads()
 {
     std::shared_ptr<ParallelForAPI>& api = getCurrentParallelForAPI();
     if (api)
@@ -691,6 +711,15 @@ int getNumThreads(void)
 #endif
 }
 
+int getNumThreads(void)
+{
+    int nthreads = getGlobalNumThreads();
+    const parallel::ExecutionScopeSettings* scope = parallel::getExecutionScopeSettings();
+    if (scope && scope->numThreads > 0)
+        return nthreads > 0 ? std::min(nthreads, scope->numThreads) : scope->numThreads;
+    return nthreads;
+}
+
 unsigned defaultNumberOfThreads()
 {
 #ifdef __ANDROID__
@@ -1039,6 +1068,185 @@ int getNumberOfCPUs()
 }
 #endif  // OPENCV_DISABLE_THREAD_SUPPORT
 
+namespace parallel {
+
+struct ExecutionScopeTLSData
+{
+    ExecutionScopeTLSData() : settings(NULL) {}
+    const ExecutionScopeSettings* settings;
+};
+
+static TLSData<ExecutionScopeTLSData>& getExecutionScopeTLSData()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TLSData<ExecutionScopeTLSData>, new TLSData<ExecutionScopeTLSData>())
+}
+
+const ExecutionScopeSettings* getExecutionScopeSettings()
+{
+    return getExecutionScopeTLSData().get()->settings;
+}
+
+void setExecutionScopeSettings(const ExecutionScopeSettings* settings)
+{
+    getExecutionScopeTLSData().get()->settings = settings;
+}
+
+#if defined __linux__ && defined _GNU_SOURCE \
+    && !defined(__EMSCRIPTEN__) \
+    && !defined(__ANDROID__)
+#define CV_HAVE_THREAD_AFFINITY 1
+#endif
+
+static std::atomic<bool> g_isThreadAffinityUsed(false);
+
+bool isThreadAffinityUsed()
+{
+    return g_isThreadAffinityUsed;
+}
+
+#ifdef CV_HAVE_THREAD_AFFINITY
+static cpu_set_t getInitialThreadAffinity()
+{
+    cpu_set_t mask;
+    if (0 != sched_getaffinity(0, sizeof(mask), &mask))
+    {
+        CPU_ZERO(&mask);
+        for (int i = 0; i < CPU_SETSIZE; i++)
+            CPU_SET(i, &mask);
+    }
+    return mask;
+}
+#endif
+
+bool setThreadAffinity(const std::vector<int>& cpus)
+{
+#ifdef CV_HAVE_THREAD_AFFINITY
+    // captured before the first thread is pinned
+    static cpu_set_t initialAffinity = getInitialThreadAffinity();
+    cpu_set_t mask;
+    if (cpus.empty())
+    {
+        mask = initialAffinity;
+    }
+    else
+    {
+        CPU_ZERO(&mask);
+        for (size_t i = 0; i < cpus.size(); i++)
+        {
+            if (0 <= cpus[i] && cpus[i] < CPU_SETSIZE)
+                CPU_SET(cpus[i], &mask);
+        }
+        g_isThreadAffinityUsed = true;
+    }
+    return 0 == sched_setaffinity(0, sizeof(mask), &mask);
+#else
+    CV_UNUSED(cpus);
+    return false;
+#endif
+}
+
+struct ExecutionScope::Impl
+{
+    std::shared_ptr<ExecutionScopeSettings> settings;  // shared with jobs of the pthreads pool
+    const ExecutionScopeSettings* outer;
+#ifdef CV_HAVE_THREAD_AFFINITY
+    bool restoreAffinity;
+    cpu_set_t outerAffinity;
+#endif
+};
+
+ExecutionScope::ExecutionScope(int numThreads_, const std::vector<int>& cpus)
+    : impl(std::make_shared<Impl>())
+{
+    CV_CheckGE(numThreads_, 0, "");
+    const ExecutionScopeSettings* outer = getExecutionScopeSettings();
+    impl->outer = outer;
+    impl->settings = std::make_shared<ExecutionScopeSettings>();
+    ExecutionScopeSettings& settings = *impl->settings;
+    settings.numThreads = numThreads_;
+    if (outer && outer->numThreads > 0)
+        settings.numThreads = numThreads_ > 0 ? std::min(numThreads_, outer->numThreads) : outer->numThreads;
+    settings.cpus = cpus.empty() && outer ? outer->cpus : cpus;
+    if (outer)
+        settings.outer = outer->shared_from_this();
+#ifdef CV_HAVE_THREAD_AFFINITY
+    impl->restoreAffinity = false;
+    if (!cpus.empty())
+    {
+        impl->restoreAffinity = 0 == sched_getaffinity(0, sizeof(impl->outerAffinity), &impl->outerAffinity);
+        if (!setThreadAffinity(cpus))
+            CV_LOG_WARNING(NULL, "ExecutionScope: can't set affinity of the current thread");
+    }
+#else
+    if (!cpus.empty())
+        CV_LOG_ONCE_WARNING(NULL, "ExecutionScope: thread affinity is not supported on this platform");
+#endif
+    setExecutionScopeSettings(impl->settings.get());
+}
+
+ExecutionScope::~ExecutionScope()
+{
+    CV_DbgAssert(getExecutionScopeSettings() == impl->settings.get());  // scopes are destroyed in reverse order
+    setExecutionScopeSettings(impl->outer);
+#ifdef CV_HAVE_THREAD_AFFINITY
+    if (impl->restoreAffinity)
+        sched_setaffinity(0, sizeof(impl->outerAffinity), &impl->outerAffinity);
+#endif
+}
+
+#if defined CV_CPU_GROUPS_1
+// parses string of form "0-1,3,5-7,10,13-15"
+static std::vector<int> parseCPUList(const std::string& str)
+{
+    std::vector<int> cpus;
+    const char* pos = str.c_str();
+    while (*pos)
+    {
+        int rstart = 0, rend = 0, n = 0;
+        if (sscanf(pos, "%d-%d%n", &rstart, &rend, &n) == 2)
+            pos += n;
+        else if (sscanf(pos, "%d%n", &rstart, &n) == 1)
+        {
+            pos += n;
+            rend = rstart;
+        }
+        else
+            break;
+        for (int cpu = rstart; cpu <= rend; cpu++)
+            cpus.push_back(cpu);
+        if (*pos == ',')
+            pos++;
+    }
+    return cpus;
+}
+#endif
+
+int getNumaNodesCount()
+{
+#if defined CV_CPU_GROUPS_1
+    std::vector<int> nodes = parseCPUList(getFileContents("/sys/devices/system/node/online"));
+    if (!nodes.empty())
+        return nodes.back() + 1;
+#endif
+    return 1;
+}
+
+std::vector<int> getNumaNodeCPUs(int node)
+{
+#if defined CV_CPU_GROUPS_1
+    if (node >= 0)
+    {
+        std::string filename = cv::format("/sys/devices/system/node/node%d/cpulist", node);
+        return parseCPUList(getFileContents(filename.c_str()));
+    }
+#else
+    CV_UNUSED(node);
+#endif
+    return std::vector<int>();
+}
+
+}  // namespace parallel
+
 const char* currentParallelFramework()
 {
     std::shared_ptr<ParallelForAPI>& api = getCurrentParallelForAPI();
@@ -118,7 +118,7 @@ public:
 
     unsigned num_threads;
 
-    pthread_mutex_t mutex;  // guards fields (job/threads) from non-worker threads (concurrent parallel_for calls)
+    pthread_mutex_t mutex;  // guards threads from concurrent parallel_for calls
 #if defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
     pthread_cond_t cond_thread_wake;
 #endif
@@ -128,7 +128,12 @@ public:
 
     std::vector< Ptr<WorkerThread> > threads;
 
-    Ptr<ParallelJob> job;
+    pthread_mutex_t mutex_jobs;  // guards jobs, worker threads lock it to find a job
+    std::vector< Ptr<ParallelJob> > jobs;  // jobs of all concurrent and nested parallel_for calls in order of submission
+
+    // Returns a job with a free slot for one more thread
+    Ptr<ParallelJob> acquireJob(unsigned& slot);
+    bool hasActiveJobs();
 
 #ifdef CV_PROFILE_THREADS
     double tickFreq;
@@ -204,7 +209,9 @@ public:
 
     std::atomic<bool> has_wake_signal;
 
-    Ptr<ParallelJob> job;
+    std::atomic<bool> is_busy;  // processes jobs, doesn't need wake signal to check for new jobs
+
+    std::vector<int> cpus;  // CPUs the thread is pinned to by execution scope of the current job, empty - initial affinity
 
     pthread_mutex_t mutex;
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
@@ -218,7 +225,8 @@ public:
         posix_thread(0),
         is_created(false),
         stop_thread(false),
-        has_wake_signal(false)
+        has_wake_signal(false),
+        is_busy(false)
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
         , isActive(true)
 #endif
@@ -284,20 +292,33 @@ public:
     }
 };
 
+// Tasks of a job are distributed between slots, one slot per thread working on the job.
+// A thread takes tasks from the front of its own slot and, when the slot is empty,
+// steals a half of the remaining tasks from the back of another slot.
 class ParallelJob
 {
 public:
-    ParallelJob(const ThreadPool& thread_pool_, const Range& range_, const ParallelLoopBody& body_, int nstripes_) :
+    ParallelJob(const ThreadPool& thread_pool_, const Range& range_, const ParallelLoopBody& body_, int nstripes_, unsigned max_slots) :
         thread_pool(thread_pool_),
         body(body_),
         range(range_),
         nstripes((unsigned)nstripes_),
-        is_completed(false)
+        nslots(std::max(1u, std::min(max_slots, (unsigned)range_.size()))),
+        scope(parallel::getExecutionScopeSettings() ? parallel::getExecutionScopeSettings()->shared_from_this() : nullptr),
+        is_completed(false),
+        slots(nslots)
     {
         CV_LOG_VERBOSE(NULL, 5, "ParallelJob::ParallelJob(" << (void*)this << ")");
-        current_task.store(0, std::memory_order_relaxed);
+        const int task_count = range.size();
+        for (unsigned i = 0; i < nslots; i++)
+        {
+            int start = (int)((int64)task_count * i / nslots);
+            int end = (int)((int64)task_count * (i + 1) / nslots);
+            slots[i].tasks.store(packTasks(start, end), std::memory_order_relaxed);
+        }
+        next_slot.store(1, std::memory_order_relaxed);  // slot 0 belongs to the thread which has submitted the job
+        remaining_tasks.store(task_count, std::memory_order_relaxed);
         active_thread_count.store(0, std::memory_order_relaxed);
-        completed_thread_count.store(0, std::memory_order_relaxed);
         dummy0_[0] = 0, dummy1_[0] = 0, dummy2_[0] = 0; // compiler warning
     }
 
@@ -306,60 +327,139 @@ public:
         CV_LOG_VERBOSE(NULL, 5, "ParallelJob::~ParallelJob(" << (void*)this << ")");
     }
 
-    unsigned execute(bool is_worker_thread)
+    // Returns true if the caller has completed the job
+    bool execute(unsigned slot, unsigned* executed_tasks = NULL)
     {
-        unsigned executed_tasks = 0;
-        const int task_count = range.size();
-        const int remaining_multiplier = std::min(nstripes,
-                std::max(
-                        std::min(100u, thread_pool.num_threads * 4),
-                        thread_pool.num_threads * 2
-                ));  // experimental value
+        CV_DbgAssert(slot < nslots);
+        bool completed = false;
         for (;;)
         {
-            int chunk_size = std::max(1, (task_count - current_task) / remaining_multiplier);
-            int id = current_task.fetch_add(chunk_size, std::memory_order_seq_cst);
-            if (id >= task_count)
+            int start_id = 0, end_id = 0;
+            if (!popTasks(slot, start_id, end_id))
+            {
+                if (stealTasks(slot))
+                    continue;
                 break; // no more free tasks
-
-            executed_tasks += chunk_size;
-            int start_id = id;
-            int end_id = std::min(task_count, id + chunk_size);
+            }
             CV_LOG_VERBOSE(NULL, 9, "Thread: job " << start_id << "-" << end_id);
 
-            //TODO: if (not pending exception)
-            {
-                body.operator()(Range(range.start + start_id, range.start + end_id));
-            }
-            if (is_worker_thread && is_completed)
+            body.operator()(Range(range.start + start_id, range.start + end_id));
+
+            if (executed_tasks)
+                *executed_tasks += end_id - start_id;
+            if (remaining_tasks.fetch_sub(end_id - start_id, std::memory_order_acq_rel) == end_id - start_id)
             {
-                CV_LOG_ERROR(NULL, "\t\t\t\tBUG! Job: " << (void*)this << " " << id << " " << active_thread_count << " " << completed_thread_count);
-                CV_Assert(!is_completed); // TODO Dbg this
+                CV_Assert(!is_completed);
+                is_completed = true;
+                completed = true;
             }
         }
-        return executed_tasks;
+        return completed;
     }
 
     const ThreadPool& thread_pool;
     const ParallelLoopBody& body;
     const Range range;
     const unsigned nstripes;
+    const unsigned nslots;
+    const std::shared_ptr<const parallel::ExecutionScopeSettings> scope;  // execution scope of the thread which has submitted the job
 
-    std::atomic<int> current_task;  // next free part of job
+    std::atomic<unsigned> next_slot;  // first slot which is not taken by any thread
     int64 dummy0_[8];  // avoid cache-line reusing for the same atomics
 
-    std::atomic<int> active_thread_count;  // number of threads worked on this job
+    std::atomic<int> remaining_tasks;  // number of tasks which are not finished yet
     int64 dummy1_[8];  // avoid cache-line reusing for the same atomics
 
-    std::atomic<int> completed_thread_count;  // number of threads completed any activities on this job
+    std::atomic<int> active_thread_count;  // number of worker threads joined this job
     int64 dummy2_[8];  // avoid cache-line reusing for the same atomics
 
     std::atomic<bool> is_completed;
 
+protected:
+    struct Slot
+    {
+        std::atomic<uint64> tasks;  // [start, end) range of task ids, packed by packTasks()
+        int64 dummy_[7];  // avoid cache-line reusing for the same atomics
+    };
+    std::vector<Slot> slots;
+
+    static inline uint64 packTasks(int start, int end) { return ((uint64)(unsigned)start << 32) | (unsigned)end; }
+    static inline int tasksStart(uint64 v) { return (int)(v >> 32); }
+    static inline int tasksEnd(uint64 v) { return (int)(v & 0xffffffffu); }
+
+    bool popTasks(unsigned slot, int& start_id, int& end_id)
+    {
+        std::atomic<uint64>& tasks = slots[slot].tasks;
+        uint64 v = tasks.load(std::memory_order_acquire);
+        for (;;)
+        {
+            int start = tasksStart(v), end = tasksEnd(v);
+            if (start >= end)
+                return false;
+            int chunk_size = std::max(1, (end - start) / 4);  // experimental value
+            if (tasks.compare_exchange_weak(v, packTasks(start + chunk_size, end), std::memory_order_acq_rel))
+            {
+                start_id = start;
+                end_id = start + chunk_size;
+                return true;
+            }
+        }
+    }
+
+    // Moves tasks to the own slot. It is empty, so other threads don't change it meanwhile.
+    bool stealTasks(unsigned slot)
+    {
+        for (unsigned i = 1; i < nslots; i++)
+        {
+            std::atomic<uint64>& victim = slots[(slot + i) % nslots].tasks;
+            uint64 v = victim.load(std::memory_order_acquire);
+            for (;;)
+            {
+                int start = tasksStart(v), end = tasksEnd(v);
+                if (start >= end)
+                    break;
+                int n = (end - start + 1) / 2;
+                if (victim.compare_exchange_weak(v, packTasks(start, end - n), std::memory_order_acq_rel))
+                {
+                    slots[slot].tasks.store(packTasks(end - n, end), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     // TODO exception handling
 };
 
 
+// Counts a pool thread which joins a job in the execution scope of the job and its outer scopes.
+// Fails if any of them has no free threads: the thread which has created a scope is counted as one
+// of its threads. Called under mutex_jobs, so concurrent reservations don't exceed the limits.
+static bool reserveScopeThread(const parallel::ExecutionScopeSettings* scope)
+{
+    for (const parallel::ExecutionScopeSettings* s = scope; s; s = s->outer.get())
+    {
+        if (s->numThreads > 0 && s->activeThreads.load(std::memory_order_acquire) >= s->numThreads - 1)
+            return false;
+    }
+    for (const parallel::ExecutionScopeSettings* s = scope; s; s = s->outer.get())
+    {
+        if (s->numThreads > 0)
+            s->activeThreads.fetch_add(1, std::memory_order_acq_rel);
+    }
+    return true;
+}
+
+static void releaseScopeThread(const parallel::ExecutionScopeSettings* scope)
+{
+    for (const parallel::ExecutionScopeSettings* s = scope; s; s = s->outer.get())
+    {
+        if (s->numThreads > 0)
+            s->activeThreads.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
 // Disable thread sanitization check when CV_USE_GLOBAL_WORKERS_COND_VAR is not
 // set because it triggers as the main thread reads isActive while the children
 // thread writes it (but it all works out because a mutex is locked in the main
@@ -374,6 +474,8 @@ void WorkerThread::thread_body()
 {
     (void)cv::utils::getThreadID(); // notify OpenCV about new thread
     CV_LOG_VERBOSE(NULL, 5, "Thread: new thread: " << id);
+    if (parallel::isThreadAffinityUsed())
+        parallel::setThreadAffinity(cpus);  // the thread inherits affinity of the thread which has created it
 
     bool allow_active_wait = true;
 
@@ -420,57 +522,58 @@ void WorkerThread::thread_body()
         CV_LOG_VERBOSE(NULL, 5, "Thread: checking for new job");
         if (CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT == 0)
             allow_active_wait = true;
-        Ptr<ParallelJob> j_ptr; swap(j_ptr, job);
         has_wake_signal = false;
         pthread_mutex_unlock(&mutex);
 
-        if (!stop_thread)
+        is_busy = true;
+        while (!stop_thread)
         {
-            ParallelJob* j = j_ptr;
-            if (j)
+            unsigned slot = 0;
+            Ptr<ParallelJob> j = thread_pool.acquireJob(slot);
+            if (!j)
             {
-                CV_LOG_VERBOSE(NULL, 5, "Thread: job size=" << j->range.size() << " done=" << j->current_task);
-                if (j->current_task < j->range.size())
-                {
-                    int other = j->active_thread_count.fetch_add(1, std::memory_order_seq_cst);
-                    CV_LOG_VERBOSE(NULL, 5, "Thread: processing new job (with " << other << " other threads)"); CV_UNUSED(other);
+                // jobs submitted meanwhile don't wake busy threads, so check them once again
+                is_busy = false;
+                j = thread_pool.acquireJob(slot);
+                if (!j)
+                    break;
+                is_busy = true;
+            }
+            static const std::vector<int> no_cpus;
+            const std::vector<int>& job_cpus = j->scope ? j->scope->cpus : no_cpus;
+            if (cpus != job_cpus)
+            {
+                parallel::setThreadAffinity(job_cpus);
+                cpus = job_cpus;
+            }
+            int other = j->active_thread_count.fetch_add(1, std::memory_order_seq_cst);
+            CV_LOG_VERBOSE(NULL, 5, "Thread: processing new job (with " << other << " other threads)"); CV_UNUSED(other);
 #ifdef CV_PROFILE_THREADS
-                    stat.threadExecuteStart = getTickCount();
-                    stat.executedTasks = j->execute(true);
-                    stat.threadExecuteStop = getTickCount();
+            stat.threadExecuteStart = getTickCount();
+            stat.executedTasks = 0;
+            bool completed = j->execute(slot, &stat.executedTasks);
+            stat.threadExecuteStop = getTickCount();
 #else
-                    j->execute(true);
+            bool completed = j->execute(slot);
 #endif
-                    int completed = j->completed_thread_count.fetch_add(1, std::memory_order_seq_cst) + 1;
-                    int active = j->active_thread_count.load(std::memory_order_acquire);
-                    if (CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT > 0)
-                    {
-                        allow_active_wait = true;
-                        if (active >= CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT && (id & 1) == 0) // turn off a half of threads
-                            allow_active_wait = false;
-                    }
-                    CV_LOG_VERBOSE(NULL, 5, "Thread: completed job processing: " << active << " " << completed);
-                    if (active == completed)
-                    {
-                        bool need_signal = !j->is_completed;
-                        j->is_completed = true;
-                        j = NULL; j_ptr.release();
-                        if (need_signal)
-                        {
-                            CV_LOG_VERBOSE(NULL, 5, "Thread: job finished => notifying the main thread");
-                            pthread_mutex_lock(&thread_pool.mutex_notify);  // to avoid signal miss due pre-check condition
-                            // empty
-                            pthread_mutex_unlock(&thread_pool.mutex_notify);
-                            pthread_cond_broadcast/*pthread_cond_signal*/(&thread_pool.cond_thread_task_complete);
-                        }
-                    }
-                }
-                else
-                {
-                    CV_LOG_VERBOSE(NULL, 5, "Thread: no free job tasks");
-                }
+            releaseScopeThread(j->scope.get());
+            int active = j->active_thread_count.load(std::memory_order_acquire);
+            if (CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT > 0)
+            {
+                allow_active_wait = true;
+                if (active >= CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT && (id & 1) == 0) // turn off a half of threads
+                    allow_active_wait = false;
+            }
+            if (completed)
+            {
+                CV_LOG_VERBOSE(NULL, 5, "Thread: job finished => notifying the waiting thread");
+                pthread_mutex_lock(&thread_pool.mutex_notify);  // to avoid signal miss due pre-check condition
+                // empty
+                pthread_mutex_unlock(&thread_pool.mutex_notify);
+                pthread_cond_broadcast/*pthread_cond_signal*/(&thread_pool.cond_thread_task_complete);
             }
         }
+        is_busy = false;
 #ifdef CV_PROFILE_THREADS
         stat.threadFree = getTickCount();
         stat.keepActive = allow_active_wait;
@@ -487,6 +590,7 @@ ThreadPool::ThreadPool()
     int res = 0;
     res |= pthread_mutex_init(&mutex, NULL);
     res |= pthread_mutex_init(&mutex_notify, NULL);
+    res |= pthread_mutex_init(&mutex_jobs, NULL);
 #if defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
     res |= pthread_cond_init(&cond_thread_wake, NULL);
 #endif
@@ -549,11 +653,39 @@ ThreadPool::~ThreadPool()
 #endif
     pthread_mutex_destroy(&mutex);
     pthread_mutex_destroy(&mutex_notify);
+    pthread_mutex_destroy(&mutex_jobs);
+}
+
+Ptr<ParallelJob> ThreadPool::acquireJob(unsigned& slot)
+{
+    Ptr<ParallelJob> result;
+    pthread_mutex_lock(&mutex_jobs);
+    for (size_t i = jobs.size(); i > 0; --i)  // the most recent jobs first, nested jobs block their outer jobs
+    {
+        ParallelJob& j = *jobs[i - 1];
+        if (j.remaining_tasks.load(std::memory_order_acquire) <= 0 || j.next_slot >= j.nslots)
+            continue;
+        if (!reserveScopeThread(j.scope.get()))
+            continue;  // the scope has no free threads
+        slot = j.next_slot.fetch_add(1, std::memory_order_seq_cst);
+        result = jobs[i - 1];
+        break;
+    }
+    pthread_mutex_unlock(&mutex_jobs);
+    return result;
+}
+
+bool ThreadPool::hasActiveJobs()
+{
+    pthread_mutex_lock(&mutex_jobs);
+    bool result = !jobs.empty();
+    pthread_mutex_unlock(&mutex_jobs);
+    return result;
 }
 
 void ThreadPool::run(const Range& range, const ParallelLoopBody& body, double nstripes)
 {
-    CV_LOG_VERBOSE(NULL, 1, "MainThread: new parallel job: num_threads=" << num_threads << "   range=" << range.size() << "   nstripes=" << nstripes << "   job=" << (void*)job);
+    CV_LOG_VERBOSE(NULL, 1, "MainThread: new parallel job: num_threads=" << num_threads << "   range=" << range.size() << "   nstripes=" << nstripes);
 #ifdef CV_PROFILE_THREADS
     jobSubmitTime = getTickCount();
     threads_stat[0].reset();
@@ -561,154 +693,120 @@ void ThreadPool::run(const Range& range, const ParallelLoopBody& body, double ns
     threads_stat[0].threadWake = jobSubmitTime;
 #endif
     if (getNumOfThreads() > 1 &&
-        job == NULL &&
         (range.size() * nstripes >= 2 || (range.size() > 1 && nstripes <= 0))
     )
     {
+        // Nested calls and calls from different threads are processed concurrently
+        // by all threads of the pool, including the threads which have submitted the jobs.
         pthread_mutex_lock(&mutex);
-        if (job != NULL)
-        {
-            pthread_mutex_unlock(&mutex);
-            body(range);
-            return;
-        }
-        reconfigure_(num_threads - 1);
-
+        if (!hasActiveJobs())
+            reconfigure_(num_threads - 1);  // threads can't be stopped while they process other jobs
+
+        CV_LOG_VERBOSE(NULL, 1, "MainThread: initialize parallel job: " << range.size());
+        unsigned max_slots = (unsigned)threads.size() + 1;
+        const parallel::ExecutionScopeSettings* scope = parallel::getExecutionScopeSettings();
+        if (scope && scope->numThreads > 0)
+            max_slots = std::min(max_slots, (unsigned)scope->numThreads);
+        Ptr<ParallelJob> job(new ParallelJob(*this, range, body, nstripes, max_slots));
+        pthread_mutex_lock(&mutex_jobs);
+        jobs.push_back(job);
+        pthread_mutex_unlock(&mutex_jobs);
+
+        CV_LOG_VERBOSE(NULL, 5, "MainThread: wake worker threads...");
+        size_t num_threads_to_wake = std::min(static_cast<size_t>(job->nslots - 1), threads.size());
+        for (size_t i = 0; i < threads.size() && num_threads_to_wake > 0; ++i)
         {
-            CV_LOG_VERBOSE(NULL, 1, "MainThread: initialize parallel job: " << range.size());
-            job = Ptr<ParallelJob>(new ParallelJob(*this, range, body, nstripes));
-            pthread_mutex_unlock(&mutex);
-
-            CV_LOG_VERBOSE(NULL, 5, "MainThread: wake worker threads...");
-            size_t num_threads_to_wake = std::min(static_cast<size_t>(range.size()), threads.size());
-            for (size_t i = 0; i < num_threads_to_wake; ++i)
-            {
-                if (job->current_task >= job->range.size())
-                    break;
-                WorkerThread& thread = *(threads[i].get());
-                if (
-#if defined(__clang__) && defined(__has_feature)
-#if __has_feature(thread_sanitizer)
-                        1 ||  // Robust workaround to avoid data race warning of `thread.job`
-#endif
-#endif
+            WorkerThread& thread = *(threads[i].get());
+            if (thread.is_busy)
+                continue;  // busy threads check for new jobs before going to sleep
+            pthread_mutex_lock(&thread.mutex);
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
-                        thread.isActive ||
+            bool isActive = thread.isActive;
 #endif
-                        thread.has_wake_signal
-                        || !thread.job.empty()  // #10881
-                )
-                {
-                    pthread_mutex_lock(&thread.mutex);
-                    thread.job = job;
-#if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
-                    bool isActive = thread.isActive;
-#endif
-                    thread.has_wake_signal = true;
+            thread.has_wake_signal = true;
 #ifdef CV_PROFILE_THREADS
-                    threads_stat[i + 1].reset();
+            threads_stat[i + 1].reset();
 #endif
-                    pthread_mutex_unlock(&thread.mutex);
+            pthread_mutex_unlock(&thread.mutex);
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
-                    if (!isActive)
-                    {
-                        pthread_cond_broadcast/*pthread_cond_signal*/(&thread.cond_thread_wake); // wake thread
-                    }
-#endif
-                }
-                else
-                {
-                    CV_Assert(thread.job.empty());
-                    thread.job = job;
-                    thread.has_wake_signal = true;
-#ifdef CV_PROFILE_THREADS
-                    threads_stat[i + 1].reset();
-#endif
-#if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
-                    pthread_cond_broadcast/*pthread_cond_signal*/(&thread.cond_thread_wake); // wake thread
-#endif
-                }
+            if (!isActive)
+            {
+                pthread_cond_broadcast/*pthread_cond_signal*/(&thread.cond_thread_wake); // wake thread
             }
+#endif
+            num_threads_to_wake--;
+        }
 #ifdef CV_PROFILE_THREADS
-            threads_stat[0].threadPing = getTickCount();
+        threads_stat[0].threadPing = getTickCount();
 #endif
 #if defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
-            pthread_cond_broadcast(&cond_thread_wake); // wake all threads
+        pthread_cond_broadcast(&cond_thread_wake); // wake all threads
 #endif
+        pthread_mutex_unlock(&mutex);
 #ifdef CV_PROFILE_THREADS
-            threads_stat[0].threadWake = getTickCount();
+        threads_stat[0].threadWake = getTickCount();
 #endif
-            CV_LOG_VERBOSE(NULL, 5, "MainThread: wake worker threads... (done)");
+        CV_LOG_VERBOSE(NULL, 5, "MainThread: wake worker threads... (done)");
 
-            {
-                ParallelJob& j = *(this->job);
+        {
+            ParallelJob& j = *job;
 #ifdef CV_PROFILE_THREADS
-                threads_stat[0].threadExecuteStart = getTickCount();
-                threads_stat[0].executedTasks = j.execute(false);
-                threads_stat[0].threadExecuteStop = getTickCount();
+            threads_stat[0].threadExecuteStart = getTickCount();
+            threads_stat[0].executedTasks = 0;
+            j.execute(0, &threads_stat[0].executedTasks);
+            threads_stat[0].threadExecuteStop = getTickCount();
 #else
-                j.execute(false);
+            j.execute(0);
 #endif
-                CV_Assert(j.current_task >= j.range.size());
-                CV_LOG_VERBOSE(NULL, 5, "MainThread: complete self-tasks: " << j.active_thread_count << " " << j.completed_thread_count);
-                if (job->is_completed || j.active_thread_count == 0)
-                {
-                    job->is_completed = true;
-                    CV_LOG_VERBOSE(NULL, 5, "MainThread: no WIP worker threads");
-                }
-                else
+            CV_LOG_VERBOSE(NULL, 5, "MainThread: complete self-tasks: " << j.active_thread_count << " " << j.remaining_tasks);
+            if (!j.is_completed)
+            {
+                if (CV_MAIN_THREAD_ACTIVE_WAIT > 0)
                 {
-                    if (CV_MAIN_THREAD_ACTIVE_WAIT > 0)
+                    for (int i = 0; i < CV_MAIN_THREAD_ACTIVE_WAIT; i++)  // don't spin too much in any case (inaccurate getTickCount())
                     {
-                        for (int i = 0; i < CV_MAIN_THREAD_ACTIVE_WAIT; i++)  // don't spin too much in any case (inaccurate getTickCount())
+                        if (j.is_completed)
                         {
-                            if (job->is_completed)
-                            {
-                                CV_LOG_VERBOSE(NULL, 5, "MainThread: job finalize (active wait) " << j.active_thread_count << " " << j.completed_thread_count);
-                                break;
-                            }
-                            if (CV_ACTIVE_WAIT_PAUSE_LIMIT > 0 && (i < CV_ACTIVE_WAIT_PAUSE_LIMIT || (i & 1)))
-                                CV_PAUSE(16);
-                            else
-                                CV_YIELD();
+                            CV_LOG_VERBOSE(NULL, 5, "MainThread: job finalize (active wait) " << j.active_thread_count);
+                            break;
                         }
+                        if (CV_ACTIVE_WAIT_PAUSE_LIMIT > 0 && (i < CV_ACTIVE_WAIT_PAUSE_LIMIT || (i & 1)))
+                            CV_PAUSE(16);
+                        else
+                            CV_YIELD();
                     }
-                    if (!job->is_completed)
+                }
+                if (!j.is_completed)
+                {
+                    CV_LOG_VERBOSE(NULL, 5, "MainThread: prepare wait " << j.active_thread_count << " " << j.remaining_tasks);
+                    pthread_mutex_lock(&mutex_notify);
+                    for (;;)
                     {
-                        CV_LOG_VERBOSE(NULL, 5, "MainThread: prepare wait " << j.active_thread_count << " " << j.completed_thread_count);
-                        pthread_mutex_lock(&mutex_notify);
-                        for (;;)
+                        if (j.is_completed)
                         {
-                            if (job->is_completed)
-                            {
-                                CV_LOG_VERBOSE(NULL, 5, "MainThread: job finalize (wait) " << j.active_thread_count << " " << j.completed_thread_count);
-                                break;
-                            }
-                            CV_LOG_VERBOSE(NULL, 5, "MainThread: wait completion (sleep) ...");
-                            pthread_cond_wait(&cond_thread_task_complete, &mutex_notify);
-                            CV_LOG_VERBOSE(NULL, 5, "MainThread: wake");
+                            CV_LOG_VERBOSE(NULL, 5, "MainThread: job finalize (wait) " << j.active_thread_count);
+                            break;
                         }
-                        pthread_mutex_unlock(&mutex_notify);
+                        CV_LOG_VERBOSE(NULL, 5, "MainThread: wait completion (sleep) ...");
+                        pthread_cond_wait(&cond_thread_task_complete, &mutex_notify);
+                        CV_LOG_VERBOSE(NULL, 5, "MainThread: wake");
                     }
+                    pthread_mutex_unlock(&mutex_notify);
                 }
             }
+        }
 #ifdef CV_PROFILE_THREADS
-            threads_stat[0].threadFree = getTickCount();
-            std::cout << "Job: sz=" << range.size() << " nstripes=" << nstripes << "    Time: " << (threads_stat[0].threadFree - jobSubmitTime) / tickFreq * 1e6 << " usec" << std::endl;
-            for (int i = 0; i < (int)threads.size() + 1; i++)
-            {
-                threads_stat[i].dump(i - 1, jobSubmitTime, tickFreq);
-            }
-#endif
-            if (job)
-            {
-                pthread_mutex_lock(&mutex);
-                CV_LOG_VERBOSE(NULL, 5, "MainThread: job release");
-                CV_Assert(job->is_completed);
-                job.release();
-                pthread_mutex_unlock(&mutex);
-            }
+        threads_stat[0].threadFree = getTickCount();
+        std::cout << "Job: sz=" << range.size() << " nstripes=" << nstripes << "    Time: " << (threads_stat[0].threadFree - jobSubmitTime) / tickFreq * 1e6 << " usec" << std::endl;
+        for (int i = 0; i < (int)threads.size() + 1; i++)
+        {
+            threads_stat[i].dump(i - 1, jobSubmitTime, tickFreq);
         }
+#endif
+        pthread_mutex_lock(&mutex_jobs);
+        CV_LOG_VERBOSE(NULL, 5, "MainThread: job release");
+        jobs.erase(std::find(jobs.begin(), jobs.end(), job));
+        pthread_mutex_unlock(&mutex_jobs);
     }
     else
     {
@@ -727,7 +825,7 @@ void ThreadPool::setNumOfThreads(unsigned n)
     {
         num_threads = n;
         if (n == 1)
-           if (job == NULL) reconfigure(0);  // stop worker threads immediately
+           if (!hasActiveJobs()) reconfigure(0);  // stop worker threads immediately
     }
 }
 
@@ -4,10 +4,42 @@
 #ifndef OPENCV_CORE_PARALLEL_IMPL_HPP
 #define OPENCV_CORE_PARALLEL_IMPL_HPP
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace cv {
 
 unsigned defaultNumberOfThreads();
 
+namespace parallel {
+
+// Settings of cv::parallel::ExecutionScope
+struct ExecutionScopeSettings : public std::enable_shared_from_this<ExecutionScopeSettings>
+{
+    int numThreads;  // 0 - no limit
+    std::vector<int> cpus;  // empty - no affinity
+    std::shared_ptr<const ExecutionScopeSettings> outer;  // scope which was active when this one was created
+    // Pool threads which process parallel_for_() calls of this scope and its inner scopes (with numThreads > 0 only).
+    // The thread which has created the scope is not counted.
+    mutable std::atomic<int> activeThreads;
+
+    ExecutionScopeSettings() : numThreads(0), activeThreads(0) {}
+};
+
+// Settings of the innermost scope of the current thread or NULL. Threads which process
+// parallel_for_() body get settings of the thread which has called parallel_for_().
+const ExecutionScopeSettings* getExecutionScopeSettings();
+void setExecutionScopeSettings(const ExecutionScopeSettings* settings);
+
+// Pins the current thread to the CPUs, empty vector restores the initial affinity.
+// Returns false if thread affinity is not supported.
+bool setThreadAffinity(const std::vector<int>& cpus);
+// Returns true if any thread has been pinned by a scope
+bool isThreadAffinityUsed();
+
+}  // namespace parallel
+
 void parallel_for_pthreads(const Range& range, const ParallelLoopBody& body, double nstripes);
 size_t parallel_pthreads_get_threads_num();
 void parallel_pthreads_set_threads_num(int num);
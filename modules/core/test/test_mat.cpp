@@ -10,6 +10,11 @@
 #endif
 
 #include "opencv2/core/cuda.hpp"
+#include "opencv2/core/bufferpool.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
+#include "opencv2/core/utils/external_buffer.hpp"
+
+#include <atomic>
 
 namespace opencv_test { namespace {
 
@@ -2677,4 +2682,118 @@ TEST(Mat, Recreate1DMatWithSameMeta)
     EXPECT_NO_THROW(m.create(dims, depth));
 }
 
+TEST(Mat, pool_allocator)
+{
+    MatAllocator* pool = cv::utils::getPoolMatAllocator();
+    BufferPoolController* controller = pool->getBufferPoolController();
+    ASSERT_TRUE(controller != NULL);
+    const size_t prevMaxReservedSize = controller->getMaxReservedSize();
+    controller->setMaxReservedSize(16 << 20);
+    controller->freeAllReservedBuffers();
+    EXPECT_EQ(0u, controller->getReservedSize());
+
+    const uchar* data = NULL;
+    {
+        cv::utils::MatAllocatorScope scope(pool);
+        Mat m(480, 640, CV_8UC3, Scalar::all(1));
+        EXPECT_EQ(pool, m.allocator);
+        EXPECT_GE(cv::utils::getPoolMatAllocatorStatistics().getCurrentUsage(), m.total() * m.elemSize());
+        data = m.data;
+    }
+    EXPECT_EQ(Mat::getDefaultAllocator(), Mat(4, 4, CV_8U).allocator);
+    EXPECT_GE(controller->getReservedSize(), (size_t)480 * 640 * 3);
+
+    {
+        // buffers of the same size class are reused
+        Mat m;
+        m.allocator = pool;
+        m.create(480, 639, CV_8UC3);
+        EXPECT_EQ(data, m.data);
+        m.setTo(Scalar::all(2));
+        EXPECT_EQ(0, cvtest::norm(m, Mat(480, 639, CV_8UC3, Scalar::all(2)), NORM_INF));
+    }
+
+    std::atomic<int> errors(0);
+    parallel_for_(Range(0, 64), [&](const Range& r)
+    {
+        cv::utils::MatAllocatorScope scope(pool);
+        for (int i = r.start; i < r.end; i++)
+        {
+            Mat a(16 + i, 32 + i, CV_32F, Scalar::all(i)), b;
+            cv::add(a, a, b);
+            if (b.allocator != pool || cvtest::norm(b, Mat(a.size(), CV_32F, Scalar::all(2 * i)), NORM_INF) != 0)
+                errors++;
+        }
+    });
+    EXPECT_EQ(0, errors.load());
+
+    // buffers which exceed the limit are not cached
+    controller->setMaxReservedSize(0);
+    EXPECT_EQ(0u, controller->getReservedSize());
+    {
+        Mat m;
+        m.allocator = pool;
+        m.create(100, 100, CV_8U);
+    }
+    EXPECT_EQ(0u, controller->getReservedSize());
+
+    controller->setMaxReservedSize(prevMaxReservedSize);
+}
+
+TEST(Mat, external_buffer)
+{
+    std::vector<uchar> buffer(100 * 64 * 3, 1);
+    int released = 0;
+    {
+        Mat m = cv::utils::wrapExternalBuffer(buffer.data(), Size(60, 100), CV_8UC3, [&]() { released++; }, 64 * 3);
+        EXPECT_EQ(buffer.data(), m.data);
+        EXPECT_EQ((size_t)64 * 3, m.step[0]);
+        Mat roi = m(Rect(10, 20, 30, 40)), row = m.row(5).reshape(1);
+        m.release();
+        EXPECT_EQ(0, released);
+
+        // UMat shares the buffer
+        UMat u = roi.getUMat(ACCESS_RW);
+        roi.release();
+        row.setTo(Scalar::all(7));
+        row.release();
+        EXPECT_EQ(0, released);
+        u.setTo(Scalar::all(5));
+        u.release();
+        EXPECT_EQ(1, released);
+    }
+    EXPECT_EQ(7, buffer[5 * 64 * 3]);
+    EXPECT_EQ(5, buffer[20 * 64 * 3 + 10 * 3]);
+
+    {
+        // output arrays of the same size and type are written in place, others are reallocated
+        Mat m = cv::utils::wrapExternalBuffer(buffer.data(), Size(64, 100), CV_8UC3, [&]() { released++; });
+        Mat src(100, 64, CV_8UC3, Scalar(1, 2, 3));
+        cv::add(src, src, m);
+        EXPECT_EQ(buffer.data(), m.data);
+        EXPECT_EQ(6, buffer[2]);
+        cv::add(src, src, m, noArray(), CV_16U);
+        EXPECT_NE(buffer.data(), m.data);
+        EXPECT_EQ(2, released);
+    }
+
+    {
+        std::shared_ptr<std::vector<float> > owner = std::make_shared<std::vector<float> >(24, 1.f);
+        const int sizes[] = { 2, 3, 4 };
+        Mat m = cv::utils::wrapExternalBuffer(owner, owner->data(), 3, sizes, CV_32F);
+        std::weak_ptr<std::vector<float> > ref = owner;
+        owner.reset();
+        Mat copy = m;
+        m.release();
+        ASSERT_FALSE(ref.expired());
+        EXPECT_EQ(24, cv::sum(copy)[0]);
+        copy.release();
+        EXPECT_TRUE(ref.expired());
+    }
+
+    Mat empty = cv::utils::wrapExternalBuffer(buffer.data(), Size(0, 0), CV_8U, [&]() { released++; });
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(3, released);
+}
+
 }} // namespace
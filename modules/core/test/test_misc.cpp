@@ -7,10 +7,18 @@
 #include "opencv2/core/utils/logger.hpp"
 
 #include <opencv2/core/utils/fp_control_utils.hpp>
+#include <opencv2/core/parallel/execution_scope.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <thread>
 
+#if defined __linux__ && defined _GNU_SOURCE && !defined __ANDROID__
+#include <sched.h>
+#define CV_TEST_THREAD_AFFINITY 1
+#endif
+
 namespace opencv_test { namespace {
 
 TEST(Core_OutputArrayCreate, _1997)
@@ -304,6 +312,159 @@ TEST(Core_Parallel, propagate_fp_denormals_ignore_hint)
     }
 }
 
+TEST(Core_Parallel, nested_and_concurrent_calls)
+{
+    const int prevNumThreads = cv::getNumThreads();
+    cv::setNumThreads(4);
+
+    const int outer = 16, inner = 1000;
+    auto computeSums = [&](std::vector<int>& sums)
+    {
+        sums.assign(outer, 0);
+        parallel_for_(Range(0, outer), [&](const Range& r)
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                std::atomic<int> sum(0);
+                parallel_for_(Range(0, inner), [&](const Range& r2)
+                {
+                    int s = 0;
+                    for (int j = r2.start; j < r2.end; j++)
+                        s += j % (i + 1);
+                    sum += s;
+                });
+                sums[i] = sum;
+            }
+        });
+    };
+
+    std::vector<int> ref(outer, 0);
+    for (int i = 0; i < outer; i++)
+        for (int j = 0; j < inner; j++)
+            ref[i] += j % (i + 1);
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+    std::vector<std::vector<int> > results(4);
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k < results.size(); k++)
+        threads.emplace_back(computeSums, std::ref(results[k]));
+    for (size_t k = 0; k < threads.size(); k++)
+        threads[k].join();
+    for (size_t k = 0; k < results.size(); k++)
+        EXPECT_EQ(ref, results[k]) << "thread " << k;
+#else
+    std::vector<int> result;
+    computeSums(result);
+    EXPECT_EQ(ref, result);
+#endif
+
+    cv::setNumThreads(prevNumThreads);
+}
+
+TEST(Core_Parallel, execution_scope)
+{
+    const int prevNumThreads = cv::getNumThreads();
+    cv::setNumThreads(4);
+
+    auto checkNumThreads = [](int expected)
+    {
+        std::atomic<int> mismatches(0);
+        parallel_for_(Range(0, 64), [&](const Range&)
+        {
+            // nested calls get the limit of the thread which has called parallel_for_()
+            if (cv::getNumThreads() != expected)
+                mismatches++;
+        });
+        return mismatches.load();
+    };
+
+    {
+        cv::parallel::ExecutionScope scope(2);
+        EXPECT_EQ(2, cv::getNumThreads());
+        EXPECT_EQ(0, checkNumThreads(2));
+        {
+            cv::parallel::ExecutionScope inner(1);
+            EXPECT_EQ(1, cv::getNumThreads());
+            const std::thread::id caller = std::this_thread::get_id();
+            std::atomic<int> foreign(0);
+            parallel_for_(Range(0, 64), [&](const Range&)
+            {
+                if (std::this_thread::get_id() != caller)
+                    foreign++;
+            });
+            EXPECT_EQ(0, foreign.load());
+        }
+        {
+            cv::parallel::ExecutionScope inner(8);  // can't exceed the outer scope
+            EXPECT_EQ(2, cv::getNumThreads());
+        }
+        EXPECT_EQ(2, cv::getNumThreads());
+    }
+    EXPECT_EQ(4, cv::getNumThreads());
+
+    {
+        // the budget is shared by nested calls: threads which are busy at the same time are counted
+        cv::setNumThreads(8);
+        cv::parallel::ExecutionScope scope(2);
+        std::mutex mutex;
+        std::map<std::thread::id, int> busy;
+        size_t maxBusy = 0;
+        auto work = [&]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                busy[std::this_thread::get_id()]++;
+                maxBusy = std::max(maxBusy, busy.size());
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy[std::this_thread::get_id()] == 0)
+                busy.erase(std::this_thread::get_id());
+        };
+        parallel_for_(Range(0, 8), [&](const Range& r)
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                work();
+                parallel_for_(Range(0, 8), [&](const Range& r2)
+                {
+                    for (int j = r2.start; j < r2.end; j++)
+                        work();
+                });
+            }
+        });
+        EXPECT_LE(maxBusy, (size_t)2);
+        cv::setNumThreads(4);
+    }
+    EXPECT_EQ(0, checkNumThreads(4));
+
+#ifdef CV_TEST_THREAD_AFFINITY
+    cpu_set_t initial;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(initial), &initial));
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &initial))
+        cpu++;
+    {
+        cv::parallel::ExecutionScope scope(4, std::vector<int>(1, cpu));
+        std::atomic<int> unpinned(0);
+        parallel_for_(Range(0, 64), [&](const Range&)
+        {
+            cpu_set_t mask;
+            if (0 != sched_getaffinity(0, sizeof(mask), &mask) || CPU_COUNT(&mask) != 1 || !CPU_ISSET(cpu, &mask))
+                unpinned++;
+        });
+        EXPECT_EQ(0, unpinned.load());
+    }
+    cpu_set_t restored;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(restored), &restored));
+    EXPECT_TRUE(CPU_EQUAL(&initial, &restored));
+#endif
+
+    EXPECT_GE(cv::parallel::getNumaNodesCount(), 1);
+
+    cv::setNumThreads(prevNumThreads);
+}
+
 TEST(Core_Version, consistency)
 {
     // this test verifies that OpenCV version loaded in runtime
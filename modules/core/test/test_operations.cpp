@@ -1620,4 +1620,69 @@ INSTANTIATE_TEST_CASE_P(/* */, Core_Arith_Regression24163,
     )
 );
 
+
+// results of integer expressions are rounded once per operation in single precision
+static double fusedTolerance(const Mat& ref)
+{
+    return ref.depth() == CV_32F ? 1e-4*(1 + cvtest::norm(ref, NORM_INF)) : 1;
+}
+
+TEST(Core_MatExpr, fused_elementwise_chains)
+{
+    RNG& rng = theRNG();
+    const int depths[] = { CV_8U, CV_16S, CV_32F };
+    for (int cn = 1; cn <= 3; cn += 2)
+    for (size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++)
+    {
+        const int type = CV_MAKETYPE(depths[d], cn);
+        SCOPED_TRACE(cv::format("type=%s", cv::typeToString(type).c_str()));
+        const double lo = depths[d] == CV_8U ? 0 : -100, hi = depths[d] == CV_8U ? 256 : 100;
+        Mat a(67, 131, type), b(a.size(), type), c(a.size(), type);
+        rng.fill(a, RNG::UNIFORM, lo, hi);
+        rng.fill(b, RNG::UNIFORM, lo, hi);
+        rng.fill(c, RNG::UNIFORM, lo, hi);
+        const double mean = 20.5, k = 1.5;
+        Mat r, t, ref;
+
+        r = cv::max((a - Scalar::all(mean))*k + b, 0);
+        cv::addWeighted(a, k, b, 1, -mean*k, t);
+        cv::max(t, 0, ref);
+        EXPECT_EQ(type, r.type());
+        EXPECT_LE(cvtest::norm(ref, r, NORM_INF), fusedTolerance(ref));
+
+        r = cv::abs(a.mul(b) - c);
+        cv::multiply(a, b, t);
+        cv::subtract(t, c, t);
+        cv::absdiff(t, Scalar::all(0), ref);
+        EXPECT_EQ(type, r.type());
+        EXPECT_LE(cvtest::norm(ref, r, NORM_INF), fusedTolerance(ref));
+
+        r = cv::min(a, b*2) > 10;
+        b.convertTo(t, -1, 2);
+        cv::min(a, t, t);
+        cv::compare(t, 10, ref, CMP_GT);
+        EXPECT_EQ(CV_8UC(cn), r.type());
+        EXPECT_EQ(0, cvtest::norm(ref, r, NORM_INF));
+
+        r = (cv::max(a, b) - cv::min(a, b))/2;
+        cv::absdiff(a, b, t);
+        t.convertTo(ref, -1, 0.5);
+        EXPECT_EQ(type, r.type());
+        EXPECT_LE(cvtest::norm(ref, r, NORM_INF), fusedTolerance(ref));
+
+        r = 100/cv::max(a, 1);
+        cv::max(a, 1, t);
+        cv::divide(100, t, ref);
+        EXPECT_EQ(type, r.type());
+        EXPECT_LE(cvtest::norm(ref, r, NORM_INF), fusedTolerance(ref));
+
+        // the result may be one of the operands, and the expression may be evaluated for a part of the matrix
+        ref = (a.mul(b) + c)(Rect(3, 5, 40, 30));
+        t = a.clone();
+        r = t;
+        r = (r.mul(b) + c)(Rect(3, 5, 40, 30));
+        EXPECT_LE(cvtest::norm(ref, r, NORM_INF), fusedTolerance(ref));
+    }
+}
+
 }} // namespace
@@ -1165,6 +1165,19 @@ CV__DNN_INLINE_NS_BEGIN
         static Ptr<MatMulLayer> create(const LayerParams &params);
     };
 
+    /** @brief Quantized MatMul. If the second input is constant, the layer is executed
+     *  as InnerProductLayerInt8, so create() returns instance of this layer in this case.
+     */
+    class CV_EXPORTS MatMulLayerInt8 : public MatMulLayer
+    {
+    public:
+        std::vector<float> input_sc;
+        std::vector<int> input_zp;
+        float output_sc;
+        int output_zp;
+        static Ptr<Layer> create(const LayerParams& params);
+    };
+
     class CV_EXPORTS ExpandLayer : public Layer
     {
     public:
@@ -1178,9 +1191,36 @@ CV__DNN_INLINE_NS_BEGIN
         static Ptr<InstanceNormLayer> create(const LayerParams &params);
     };
 
+    /** @brief Multi-head attention with Q, K and V projection (com.microsoft.Attention).
+     *
+     * Autoregressive decoding is supported in two ways:
+     * - optional input `past` [2, batch_size, num_heads, past_seq_len, head_size] with keys and values
+     *   of the previous tokens. Output `present` (enabled by `present` parameter or by `past` input) has
+     *   keys and values of past and new tokens, to be passed as `past` with the next tokens.
+     * - internal cache enabled by `kv_cache_size` parameter (maximum number of tokens). Memory for keys and
+     *   values is preallocated and every forward call appends them for new tokens, so each next token
+     *   is fed alone. Call resetCache() to start a new sequence. Every execution context of the network
+     *   (see Net::createExecutionContext()) has own cache, so contexts can decode independent sequences.
+     *
+     * `unidirectional` parameter enables causal mask: token attends to itself and the previous tokens only.
+     */
     class CV_EXPORTS AttentionLayer : public Layer {
      public:
         static Ptr<AttentionLayer> create(const LayerParams &params);
+
+        /** @brief Drops keys and values cached by previous forward calls (see `kv_cache_size` parameter). */
+        virtual void resetCache();
+    };
+
+    /** @brief Quantized Attention. Q, K and V projection is computed in INT8,
+     *  scaled dot-product attention of heads is computed in FP32.
+     */
+    class CV_EXPORTS AttentionLayerInt8 : public AttentionLayer
+    {
+    public:
+        int input_zp, output_zp;
+        float input_sc, output_sc;
+        static Ptr<AttentionLayerInt8> create(const LayerParams& params);
     };
 
     class CV_EXPORTS GroupNormLayer : public Layer {
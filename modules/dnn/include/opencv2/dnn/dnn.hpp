@@ -104,7 +104,7 @@ CV__DNN_INLINE_NS_BEGIN
         DNN_TARGET_CUDA_FP16,
         DNN_TARGET_HDDL,
         DNN_TARGET_NPU,
-        DNN_TARGET_CPU_FP16, // Only the ARM platform is supported. Low precision computing, accelerate model inference.
+        DNN_TARGET_CPU_FP16, // Low precision computing on ARM, accelerate model inference. On other platforms only the weights are stored in FP16.
     };
 
     /**
@@ -461,6 +461,31 @@ CV__DNN_INLINE_NS_BEGIN
         virtual ~Layer();
     };
 
+    /** @brief Profiling information of a network layer collected by the last forward call.
+     *
+     * @see Net::getLayersProfile(), Net::writeProfile()
+     */
+    struct CV_EXPORTS_W_SIMPLE LayerProfile
+    {
+        CV_PROP_RW int id;              //!< layer id
+        CV_PROP_RW String name;         //!< layer name
+        CV_PROP_RW String type;         //!< layer type
+        /** Implementation chosen by the layer, for example "winograd", "depthwise", "im2row" or "fastGemm".
+         *  The "_fp16" suffix means that the weights are kept in FP16 (see DNN_TARGET_CPU_FP16).
+         *  Backend name for layers which are run by other backend than DNN_BACKEND_OPENCV,
+         *  "fused" for layers which are fused with others (and skipped), empty if unknown.
+         */
+        CV_PROP_RW String kernel;
+        CV_PROP_RW double start;        //!< start time in milliseconds from the beginning of the forward call
+        CV_PROP_RW double time;         //!< wall time in milliseconds
+        CV_PROP_RW int thread;          //!< id of the thread which has run the layer, see cv::utils::getThreadID()
+        CV_PROP_RW int64 flops;         //!< estimated number of floating point operations, see Layer::getFLOPS()
+        CV_PROP_RW int64 bytes;         //!< estimated memory traffic in bytes: inputs, outputs and weights
+        CV_PROP_RW double gflops;       //!< achieved performance in GFLOP/s, 0 for skipped layers
+
+        CV_WRAP LayerProfile() : id(-1), start(0), time(0), thread(0), flops(0), bytes(0), gflops(0) {}
+    };
+
     /** @brief This class allows to create and manipulate comprehensive artificial neural networks.
      *
      * Neural network is presented as directed acyclic graph (DAG), where vertices are Layer instances,
@@ -526,6 +551,19 @@ CV__DNN_INLINE_NS_BEGIN
         */
         CV_WRAP void dumpToPbtxt(CV_WRAP_FILE_PATH const String& path);
 
+        /** @brief Writes the network into a binary cache file which is loaded by readNetFromCache().
+         *
+         *  The file keeps the imported graph (after framework specific graph simplification) and all
+         *  layers weights aligned in memory, so loading skips parsing and importing of the original
+         *  model and maps weights from the file with no copy.
+         *  Only the imported graph is stored. The fused graph and packed weights (Winograd transforms,
+         *  GEMM packing, FP16 copies) are not persisted: they depend on the backend, target and CPU
+         *  features, so layers build them on the first forward call as for any other network.
+         *  The cache must be loaded by the same version of OpenCV on a machine with the same byte order.
+         *  @param path path to output file
+         */
+        CV_WRAP void writeCache(CV_WRAP_FILE_PATH const String& path);
+
         /** @brief Adds new layer to the net.
          *  @param name   unique name of the adding layer.
          *  @param type   typename of the adding layer (type must be registered in LayerRegister).
@@ -617,6 +655,12 @@ CV__DNN_INLINE_NS_BEGIN
          */
         CV_WRAP void setInputsNames(const std::vector<String> &inputBlobNames);
 
+        /** @brief Returns outputs names of the network input pseudo layer.
+         *
+         * Names are set by the importer or by setInputsNames(). Empty vector means that inputs of the network are not named.
+         */
+        CV_WRAP std::vector<String> getInputsNames() const;
+
         /** @brief Specify shape of network input.
          */
         CV_WRAP void setInputShape(const String &inputName, const MatShape& shape);
@@ -633,7 +677,14 @@ CV__DNN_INLINE_NS_BEGIN
          *  @details By default runs forward pass for the whole network.
          *
          *  This is an asynchronous version of forward(const String&).
-         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend is required.
+         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend or dnn::DNN_BACKEND_OPENCV backend with CPU target is required.
+         *
+         *  With dnn::DNN_BACKEND_OPENCV requests are queued and run one by one in a worker thread on an execution context
+         *  of the network (see createExecutionContext()). Current inputs are copied, so inputs of the next request can be
+         *  set right after the call. The first request (and the first one after changing input shapes or the requested
+         *  output) creates the context in the worker thread; setInput() and forward() calls wait until it is created.
+         *  After that, forward() may run concurrently with the requests. Changing input shapes or the requested output
+         *  waits for pending requests.
          */
         CV_WRAP AsyncArray forwardAsync(const String& outputName = String());
 
@@ -874,6 +925,28 @@ CV__DNN_INLINE_NS_BEGIN
         */
         CV_WRAP void enableWinograd(bool useWinograd);
 
+        /** @brief Enables or disables concurrent execution of independent branches of the network.
+         *
+         * Layers which don't depend on each other (e.g. branches of Inception block or heads of a detector)
+         * run concurrently by the threads of parallel_for_(). The threads are split between the branches:
+         * layers of each branch use at most getNumThreads() / (number of branches) threads. Branches don't share
+         * memory, so the network may need more memory. Supported by DNN_BACKEND_OPENCV on CPU targets.
+         * @param enable true to enable. The default is false (OPENCV_DNN_PARALLEL_BRANCHES configuration parameter).
+         */
+        CV_WRAP void enableParallelBranches(bool enable);
+
+        /** @brief Enables or disables channels-last (NHWC) layout of intermediate blobs.
+         *
+         * Models of channels-last frameworks (e.g. TFLite or TensorFlow) have Permute layers which convert data
+         * between NHWC and NCHW layouts around the parts of the graph computed in NCHW layout. With this option,
+         * such parts are computed on NHWC data if they consist of 2D convolutions (including depthwise ones),
+         * max and average poolings, element-wise operations and activations, so the Permute layers only copy data.
+         * Shapes of the blobs are kept in NCHW order. Blobs which are requested by forward() are always in NCHW layout.
+         * Supported by DNN_BACKEND_OPENCV on DNN_TARGET_CPU for FP32 networks.
+         * @param enable true to enable. The default is false (OPENCV_DNN_CHANNELS_LAST configuration parameter).
+         */
+        CV_WRAP void enableChannelsLast(bool enable);
+
         /** @brief Returns overall time for inference and timings (in ticks) for layers.
          *
          * Indexes in returned vector correspond to layers ids. Some layers can be fused with others,
@@ -884,6 +957,57 @@ CV__DNN_INLINE_NS_BEGIN
          */
         CV_WRAP int64 getPerfProfile(CV_OUT std::vector<double>& timings);
 
+        /** @brief Returns peak memory in bytes required for intermediate blobs of the allocated network.
+         *
+         * Blobs of DNN_BACKEND_OPENCV on DNN_TARGET_CPU are placed into a single arena (per data type)
+         * by static memory planner: blobs lifetimes are computed over the whole graph and blobs
+         * which are never alive at the same time share memory. Network is allocated on the first forward
+         * call and reallocated on input shapes change.
+         * Planner can be disabled by OPENCV_DNN_MEMORY_PLANNER=0 configuration parameter.
+         *
+         * @return arena size in bytes or 0 if network is not allocated or memory planner is not used.
+         */
+        CV_WRAP int64 getMemoryArenaSize() const;
+
+        /** @brief Returns structured per-layer profile of the last forward call.
+         *
+         * In addition to timings returned by getPerfProfile(), reports chosen implementation,
+         * estimated FLOPs and memory traffic of each layer computed for the actual blob shapes.
+         * Network input layer is not included.
+         *
+         * @param[out] profile information for every layer of the network in order of execution.
+         */
+        CV_WRAP void getLayersProfile(CV_OUT std::vector<LayerProfile>& profile) const;
+
+        /** @brief Writes profile of the last forward call to a file.
+         *
+         * Output is JSON in Chrome trace event format: open the file at chrome://tracing or https://ui.perfetto.dev.
+         * Every layer is a complete event ("ph": "X") with kernel, FLOPs, bytes and GFLOP/s in the arguments.
+         * Layers are placed on tracks of the threads which have run them (see enableParallelBranches()).
+         *
+         * @param path path to output file with .json extension.
+         * @see getLayersProfile()
+         */
+        CV_WRAP void writeProfile(CV_WRAP_FILE_PATH const String& path) const;
+
+        /** @brief Creates a lightweight execution context of the network for concurrent inference.
+         *
+         * Network is compiled (allocated and fused) and run once for the current inputs first. The returned network
+         * shares layers with this one (weights and prepacked buffers are not duplicated) but owns
+         * input and intermediate blobs, so several contexts can run forward() from different threads
+         * at the same time. Each context must be used by one thread at a time.
+         *
+         * Contexts can't be reallocated: input shapes, preferable backend and target must not be changed.
+         * This network must not be modified or reallocated while contexts are in use.
+         * Custom layers must not modify their state in forward() calls except the first one. Attention layers with
+         * internal KV cache are not shared: the context gets own instances of them with empty caches.
+         * Supported by DNN_BACKEND_OPENCV on DNN_TARGET_CPU and DNN_TARGET_CPU_FP16 only.
+         *
+         * @param outBlobNames names of outputs which are requested from context by forward() calls.
+         * The default forward() output is used if empty.
+         */
+        CV_WRAP Net createExecutionContext(const std::vector<String>& outBlobNames = std::vector<String>());
+
 
         struct Impl;
         inline Impl* getImpl() const { return impl.get(); }
@@ -1120,6 +1244,14 @@ CV__DNN_INLINE_NS_BEGIN
      */
     CV_EXPORTS_W Net readNetFromONNX(const std::vector<uchar>& buffer);
 
+    /** @brief Reads a network from the binary cache file created by Net::writeCache().
+     *  @param path path to the cache file.
+     *  @returns Network object that ready to do forward, throw an exception in failure cases.
+     *
+     *  The file is mapped into memory and layers weights refer to the mapping.
+     */
+    CV_EXPORTS_W Net readNetFromCache(CV_WRAP_FILE_PATH const String& path);
+
     /** @brief Creates blob from .pb file.
      *  @param path to the .pb file with input tensor.
      *  @returns Mat.
@@ -1136,7 +1268,7 @@ CV__DNN_INLINE_NS_BEGIN
      *  @param swapRB flag which indicates that swap first and last channels
      *  in 3-channel image is necessary.
      *  @param crop flag which indicates whether image will be cropped after resize or not
-     *  @param ddepth Depth of output blob. Choose CV_32F or CV_8U.
+     *  @param ddepth Depth of output blob. Choose CV_32F, CV_16F or CV_8U.
      *  @details if @p crop is true, input image is resized so one side after resize is equal to corresponding
      *  dimension in @p size and another one is equal or larger. Then, crop from the center is performed.
      *  If @p crop is false, direct resize without cropping and preserving aspect ratio is performed.
@@ -1169,7 +1301,7 @@ CV__DNN_INLINE_NS_BEGIN
      *  @param swapRB flag which indicates that swap first and last channels
      *  in 3-channel image is necessary.
      *  @param crop flag which indicates whether image will be cropped after resize or not
-     *  @param ddepth Depth of output blob. Choose CV_32F or CV_8U.
+     *  @param ddepth Depth of output blob. Choose CV_32F, CV_16F or CV_8U.
      *  @details if @p crop is true, input image is resized so one side after resize is equal to corresponding
      *  dimension in @p size and another one is equal or larger. Then, crop from the center is performed.
      *  If @p crop is false, direct resize without cropping and preserving aspect ratio is performed.
@@ -1226,7 +1358,7 @@ CV__DNN_INLINE_NS_BEGIN
         CV_PROP_RW Size size;    //!< Spatial size for output image.
         CV_PROP_RW Scalar mean;  //!< Scalar with mean values which are subtracted from channels.
         CV_PROP_RW bool swapRB;  //!< Flag which indicates that swap first and last channels
-        CV_PROP_RW int ddepth;   //!< Depth of output blob. Choose CV_32F or CV_8U.
+        CV_PROP_RW int ddepth;   //!< Depth of output blob. Choose CV_32F, CV_16F or CV_8U. CV_16F is supported for Mat images only.
         CV_PROP_RW dnn::DataLayout datalayout; //!< Order of output dimensions. Choose DNN_LAYOUT_NCHW or DNN_LAYOUT_NHWC.
         CV_PROP_RW dnn::ImagePaddingMode paddingmode;   //!< Image padding mode. @see ImagePaddingMode.
         CV_PROP_RW Scalar borderValue;   //!< Value used in padding mode for padding.
@@ -1468,6 +1600,17 @@ CV__DNN_INLINE_NS_BEGIN
          CV_WRAP void setInputParams(double scale = 1.0, const Size& size = Size(),
                                      const Scalar& mean = Scalar(), bool swapRB = false, bool crop = false);
 
+         /** @brief Enables dynamic batching of concurrent requests.
+          *
+          * Frames passed from different threads to predict() and to task specific methods (classify(), detect(), etc.)
+          * are accumulated until @p maxBatchSize frames are collected or the oldest one waits for @p maxDelayMs
+          * milliseconds. Then they are processed by a single forward pass and results are returned to the callers.
+          * The first dimension of network input and outputs is used as a batch dimension.
+          *  @param[in] maxBatchSize Maximal number of frames in a batch. Values less than 2 disable batching.
+          *  @param[in] maxDelayMs Maximal time in milliseconds a frame waits for other frames.
+          */
+         CV_WRAP Model& enableBatching(int maxBatchSize, double maxDelayMs = 1.0);
+
          /** @brief Given the @p input frame, create input blob, run net and return the output @p blobs.
           *  @param[in]  frame  The input image.
           *  @param[out] outs Allocated output blobs, which will store results of the computation.
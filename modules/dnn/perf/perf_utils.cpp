@@ -23,6 +23,22 @@ PERF_TEST_P_(Utils_blobFromImage, HWC_TO_NCHW) {
     SANITY_CHECK_NOTHING();
 }
 
+PERF_TEST_P_(Utils_blobFromImage, resize_normalize_8UC3) {
+    std::vector<int> input_shape = GetParam();
+
+    Mat input(input_shape, CV_8UC3);
+    randu(input, 0, 256);
+
+    Image2BlobParams param(Scalar(1 / 58.395, 1 / 57.12, 1 / 57.375), Size(224, 224),
+                           Scalar(123.675, 116.28, 103.53), true);
+
+    TEST_CYCLE() {
+        Mat blob = blobFromImageWithParams(input, param);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 INSTANTIATE_TEST_CASE_P(/**/, Utils_blobFromImage,
     Values(std::vector<int>{  32,   32},
            std::vector<int>{  64,   64},
@@ -31,6 +31,21 @@ size_t getParam_DNN_NETWORK_DUMP();
 /// This parameter is useful to run with valgrind memory errors detection
 bool getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS();
 
+/// Place intermediate blobs into a single arena using liveness-based static memory planning
+bool getParam_DNN_MEMORY_PLANNER();
+
+/// Number of network input shapes (signatures) with cached shapes of layers
+size_t getParam_DNN_SHAPES_CACHE_SIZE();
+
+/// Plan memory of close input shapes for the bucket of them (rounded up input shapes)
+bool getParam_DNN_SHAPES_BUCKETS();
+
+/// Default value of Net::enableParallelBranches()
+bool getParam_DNN_PARALLEL_BRANCHES();
+
+/// Default value of Net::enableChannelsLast()
+bool getParam_DNN_CHANNELS_LAST();
+
 #ifdef HAVE_OPENCL
 bool getParam_DNN_OPENCL_ALLOW_ALL_DEVICES();
 #endif
@@ -42,6 +57,23 @@ bool getParam_DNN_CHECK_NAN_INF();
 bool getParam_DNN_CHECK_NAN_INF_DUMP();
 bool getParam_DNN_CHECK_NAN_INF_RAISE_ERROR();
 
+//
+// net_impl_profile.cpp
+//
+
+/// Reports implementation chosen by the running layer (e.g. "winograd") to the network profile, see Net::getLayersProfile()
+void reportKernel(const char* name);
+
+/// Collects reportKernel() calls of the current thread into @p kernel during the scope lifetime. The first reported name is kept.
+class KernelReportScope
+{
+public:
+    explicit KernelReportScope(String* kernel);
+    ~KernelReportScope();
+private:
+    String* prev;
+};
+
 
 inline namespace detail {
 
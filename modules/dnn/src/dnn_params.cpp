@@ -25,6 +25,36 @@ bool getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS()
     return DNN_DISABLE_MEMORY_OPTIMIZATIONS;
 }
 
+bool getParam_DNN_MEMORY_PLANNER()
+{
+    static bool DNN_MEMORY_PLANNER = utils::getConfigurationParameterBool("OPENCV_DNN_MEMORY_PLANNER", true);
+    return DNN_MEMORY_PLANNER;
+}
+
+bool getParam_DNN_PARALLEL_BRANCHES()
+{
+    static bool DNN_PARALLEL_BRANCHES = utils::getConfigurationParameterBool("OPENCV_DNN_PARALLEL_BRANCHES", false);
+    return DNN_PARALLEL_BRANCHES;
+}
+
+bool getParam_DNN_CHANNELS_LAST()
+{
+    static bool DNN_CHANNELS_LAST = utils::getConfigurationParameterBool("OPENCV_DNN_CHANNELS_LAST", false);
+    return DNN_CHANNELS_LAST;
+}
+
+size_t getParam_DNN_SHAPES_CACHE_SIZE()
+{
+    static size_t DNN_SHAPES_CACHE_SIZE = utils::getConfigurationParameterSizeT("OPENCV_DNN_SHAPES_CACHE_SIZE", 16);
+    return DNN_SHAPES_CACHE_SIZE;
+}
+
+bool getParam_DNN_SHAPES_BUCKETS()
+{
+    static bool DNN_SHAPES_BUCKETS = utils::getConfigurationParameterBool("OPENCV_DNN_SHAPES_BUCKETS", true);
+    return DNN_SHAPES_BUCKETS;
+}
+
 #ifdef HAVE_OPENCL
 bool getParam_DNN_OPENCL_ALLOW_ALL_DEVICES()
 {
@@ -6,6 +6,7 @@
 
 #include <opencv2/imgproc.hpp>
 #include <opencv2/core/utils/logger.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 
 
 namespace cv {
@@ -126,107 +127,291 @@ Mat blobFromImagesWithParams(InputArrayOfArrays images, const Image2BlobParams&
     return blob;
 }
 
-template<typename Tinp, typename Tout>
-void blobFromImagesNCHWImpl(const std::vector<Mat>& images, Mat& blob_, const Image2BlobParams& param)
+// Number of blob elements converted by a single stripe of blobFromImages
+static const int BLOB_ELEMS_PER_STRIPE = 1 << 16;
+
+// Resizes an image to the spatial size of a blob according to the padding mode.
+// Letterbox borders are not added: the image is placed into the blob at the returned offset
+// and the rest of the blob is filled by borderValue during conversion.
+static Mat resizeToBlobSize(const Mat& image, const Size& size, ImagePaddingMode paddingmode, Point& offset)
 {
-    int w = images[0].cols;
-    int h = images[0].rows;
-    int wh = w * h;
-    int nch = images[0].channels();
-    CV_Assert(nch == 1 || nch == 3 || nch == 4);
-    int sz[] = { (int)images.size(), nch, h, w};
-    blob_.create(4, sz, param.ddepth);
+    offset = Point();
+    Size imgSize = image.size();
+    if (size == imgSize)
+        return image;
 
-    for (size_t k = 0; k < images.size(); ++k)
+    Mat resized;
+    if (paddingmode == DNN_PMODE_CROP_CENTER)
     {
-        CV_Assert(images[k].depth() == images[0].depth());
-        CV_Assert(images[k].channels() == images[0].channels());
-        CV_Assert(images[k].size() == images[0].size());
+        float resizeFactor = std::max(size.width / (float)imgSize.width,
+                                      size.height / (float)imgSize.height);
+        resize(image, resized, Size(), resizeFactor, resizeFactor, INTER_LINEAR);
+        Rect crop(Point(0.5 * (resized.cols - size.width),
+                        0.5 * (resized.rows - size.height)),
+                  size);
+        return resized(crop);
+    }
+    else if (paddingmode == DNN_PMODE_LETTERBOX)
+    {
+        float resizeFactor = std::min(size.width / (float)imgSize.width,
+                                      size.height / (float)imgSize.height);
+        int rh = int(imgSize.height * resizeFactor);
+        int rw = int(imgSize.width * resizeFactor);
+        resize(image, resized, Size(rw, rh), 0, 0, INTER_LINEAR);
+        offset = Point((size.width - rw) / 2, (size.height - rh) / 2);
+        return resized;
+    }
+    resize(image, resized, size, 0, 0, INTER_LINEAR);
+    return resized;
+}
 
-        Tout* p_blob = blob_.ptr<Tout>() + k * nch * wh;
-        Tout* p_blob_r = p_blob;
-        Tout* p_blob_g = p_blob + wh;
-        Tout* p_blob_b = p_blob + 2 * wh;
-        Tout* p_blob_a = p_blob + 3 * wh;
+#if CV_SIMD
+template<typename Tout>
+static inline void storeBlobValues(Tout* ptr, const v_float32& v)
+{
+    float buf[VTraits<v_float32>::max_nlanes];
+    v_store(buf, v);
+    for (int i = 0; i < VTraits<v_float32>::vlanes(); i++)
+        ptr[i] = saturate_cast<Tout>(buf[i]);
+}
 
-        if (param.swapRB)
-            std::swap(p_blob_r, p_blob_b);
+static inline void storeBlobValues(float* ptr, const v_float32& v) { v_store(ptr, v); }
+static inline void storeBlobValues(hfloat* ptr, const v_float32& v) { v_pack_store(ptr, v); }
 
-        for (size_t i = 0; i < h; ++i)
-        {
-            const Tinp* p_img_row = images[k].ptr<Tinp>(i);
+// Vectorized part of convertRow() for planar blobs. Returns number of processed pixels.
+template<typename Tinp, typename Tout>
+static int convertRowToPlanes(const Tinp*, int, int, Tout**, const int*, const float*, const float*)
+{
+    return 0;
+}
 
-            if (nch == 1)
-            {
-                for (size_t j = 0; j < w; ++j)
-                {
-                    p_blob[i * w + j] = p_img_row[j];
-                }
-            }
-            else if (nch == 3)
-            {
-                for (size_t j = 0; j < w; ++j)
-                {
-                    p_blob_r[i * w + j] = p_img_row[j * 3    ];
-                    p_blob_g[i * w + j] = p_img_row[j * 3 + 1];
-                    p_blob_b[i * w + j] = p_img_row[j * 3 + 2];
-                }
-            }
-            else // if (nch == 4)
+template<typename Tout>
+static int convertRowToPlanes(const uchar* src, int width, int nch, Tout** dst,
+                              const int* srcChannel, const float* mean, const float* scale)
+{
+    if (nch != 1 && nch != 3 && nch != 4)
+        return 0;
+    const int nlanes = VTraits<v_float32>::vlanes(), nlanes8 = VTraits<v_uint8>::vlanes();
+    v_float32 vmean[4], vscale[4];
+    for (int c = 0; c < nch; c++)
+    {
+        vmean[c] = vx_setall_f32(mean[c]);
+        vscale[c] = vx_setall_f32(scale[c]);
+    }
+    int j = 0;
+    for (; j + nlanes8 <= width; j += nlanes8)
+    {
+        v_uint8 v[4];
+        if (nch == 1)
+            v[0] = vx_load(src + j);
+        else if (nch == 3)
+            v_load_deinterleave(src + j * 3, v[0], v[1], v[2]);
+        else
+            v_load_deinterleave(src + j * 4, v[0], v[1], v[2], v[3]);
+
+        for (int c = 0; c < nch; c++)
+        {
+            v_uint16 w0, w1;
+            v_uint32 d[4];
+            v_expand(v[srcChannel[c]], w0, w1);
+            v_expand(w0, d[0], d[1]);
+            v_expand(w1, d[2], d[3]);
+            for (int q = 0; q < 4; q++)
             {
-                for (size_t j = 0; j < w; ++j)
-                {
-                    p_blob_r[i * w + j] = p_img_row[j * 4    ];
-                    p_blob_g[i * w + j] = p_img_row[j * 4 + 1];
-                    p_blob_b[i * w + j] = p_img_row[j * 4 + 2];
-                    p_blob_a[i * w + j] = p_img_row[j * 4 + 3];
-                }
+                v_float32 x = v_cvt_f32(v_reinterpret_as_s32(d[q]));
+                storeBlobValues(dst[c] + j + q * nlanes, v_mul(v_sub(x, vmean[c]), vscale[c]));
             }
         }
     }
+    return j;
+}
 
-    if (param.mean == Scalar() && param.scalefactor == Scalar::all(1.0))
-        return;
-    CV_CheckTypeEQ(param.ddepth, CV_32F, "Scaling and mean substraction is supported only for CV_32F blob depth");
+template<typename Tout>
+static int convertRowToPlanes(const float* src, int width, int nch, Tout** dst,
+                              const int* srcChannel, const float* mean, const float* scale)
+{
+    if (nch != 1 && nch != 3 && nch != 4)
+        return 0;
+    const int nlanes = VTraits<v_float32>::vlanes();
+    v_float32 vmean[4], vscale[4];
+    for (int c = 0; c < nch; c++)
+    {
+        vmean[c] = vx_setall_f32(mean[c]);
+        vscale[c] = vx_setall_f32(scale[c]);
+    }
+    int j = 0;
+    for (; j + nlanes <= width; j += nlanes)
+    {
+        v_float32 v[4];
+        if (nch == 1)
+            v[0] = vx_load(src + j);
+        else if (nch == 3)
+            v_load_deinterleave(src + j * 3, v[0], v[1], v[2]);
+        else
+            v_load_deinterleave(src + j * 4, v[0], v[1], v[2], v[3]);
+
+        for (int c = 0; c < nch; c++)
+            storeBlobValues(dst[c] + j, v_mul(v_sub(v[srcChannel[c]], vmean[c]), vscale[c]));
+    }
+    return j;
+}
+#endif
+
+// Converts a row of interleaved image to blob: dst[c][j * dstStep] = (src[j][srcChannel[c]] - mean[c]) * scale[c]
+template<typename Tinp, typename Tout>
+static void convertRow(const Tinp* src, int width, int nch, Tout** dst, int dstStep,
+                       const int* srcChannel, const float* mean, const float* scale)
+{
+    int j0 = 0;
+#if CV_SIMD
+    if (dstStep == 1)
+        j0 = convertRowToPlanes(src, width, nch, dst, srcChannel, mean, scale);
+#endif
+    for (int c = 0; c < nch; c++)
+    {
+        const Tinp* s = src + srcChannel[c];
+        Tout* d = dst[c];
+        const float m = mean[c], k = scale[c];
+        for (int j = j0; j < width; j++)
+            d[j * dstStep] = saturate_cast<Tout>(((float)s[j * nch] - m) * k);
+    }
+}
 
-    for (size_t k = 0; k < images.size(); ++k)
+template<typename Tinp, typename Tout>
+static void imagesToBlob(const std::vector<Mat>& images, const std::vector<Point>& offsets,
+                         Mat& blob, const Image2BlobParams& param)
+{
+    const bool nchw = param.datalayout == DNN_LAYOUT_NCHW;
+    const int nimages = blob.size[0];
+    const int nch = nchw ? blob.size[1] : blob.size[3];
+    const int rows = nchw ? blob.size[2] : blob.size[1];
+    const int cols = nchw ? blob.size[3] : blob.size[2];
+    const int dstStep = nchw ? 1 : nch;
+
+    // blob channel c is taken from image channel srcChannel[c]
+    int srcChannel[4] = {0, 1, 2, 3};
+    if (param.swapRB && nch > 2)
+        std::swap(srcChannel[0], srcChannel[2]);
+
+    float mean[4], scale[4];
+    Tout border[4];
+    for (int c = 0; c < nch; c++)
+    {
+        mean[c] = (float)param.mean[c];
+        scale[c] = (float)param.scalefactor[c];
+        float value = (float)saturate_cast<Tinp>(param.borderValue[srcChannel[c]]);
+        border[c] = saturate_cast<Tout>((value - mean[c]) * scale[c]);
+    }
+
+    double nstripes = (double)blob.total() / BLOB_ELEMS_PER_STRIPE;
+    parallel_for_(Range(0, nimages * rows), [&](const Range& range)
     {
-        for (size_t ch = 0; ch < nch; ++ch)
+        for (int t = range.start; t < range.end; t++)
         {
-            float cur_mean = param.mean[ch];
-            float cur_scale = param.scalefactor[ch];
-            Tout* p_blob = blob_.ptr<Tout>() + k * nch * wh + ch * wh;
-            for (size_t i = 0; i < wh; ++i)
+            const int k = t / rows, y = t % rows;
+            const Mat& image = images[k];
+            Tout* dst[4];
+            for (int c = 0; c < nch; c++)
+                dst[c] = nchw ? blob.ptr<Tout>(k, c) + (size_t)y * cols : blob.ptr<Tout>(k, y) + c;
+
+            // image columns [x0, x1) of the blob row, the rest is border
+            int x0 = 0, x1 = 0;
+            const int iy = y - offsets[k].y;
+            if (0 <= iy && iy < image.rows)
+            {
+                x0 = offsets[k].x;
+                x1 = x0 + image.cols;
+                Tout* rowDst[4];
+                for (int c = 0; c < nch; c++)
+                    rowDst[c] = dst[c] + x0 * dstStep;
+                convertRow(image.ptr<Tinp>(iy), image.cols, nch, rowDst, dstStep, srcChannel, mean, scale);
+            }
+            for (int c = 0; c < nch; c++)
             {
-                p_blob[i] = (p_blob[i] - cur_mean) * cur_scale;
+                for (int x = 0; x < x0; x++)
+                    dst[c][x * dstStep] = border[c];
+                for (int x = x1; x < cols; x++)
+                    dst[c][x * dstStep] = border[c];
             }
         }
-    }
+    }, nstripes);
 }
 
 template<typename Tout>
-void blobFromImagesNCHW(const std::vector<Mat>& images, Mat& blob_, const Image2BlobParams& param)
+static void imagesToBlob(const std::vector<Mat>& images, const std::vector<Point>& offsets,
+                         Mat& blob, const Image2BlobParams& param)
 {
-    if (images[0].depth() == CV_8U)
-        blobFromImagesNCHWImpl<uint8_t, Tout>(images, blob_, param);
-    else if (images[0].depth() == CV_8S)
-        blobFromImagesNCHWImpl<int8_t, Tout>(images, blob_, param);
-    else if (images[0].depth() == CV_16U)
-        blobFromImagesNCHWImpl<uint16_t, Tout>(images, blob_, param);
-    else if (images[0].depth() == CV_16S)
-        blobFromImagesNCHWImpl<int16_t, Tout>(images, blob_, param);
-    else if (images[0].depth() == CV_32S)
-        blobFromImagesNCHWImpl<int32_t, Tout>(images, blob_, param);
-    else if (images[0].depth() == CV_32F)
-        blobFromImagesNCHWImpl<float, Tout>(images, blob_, param);
-    else if (images[0].depth() == CV_64F)
-        blobFromImagesNCHWImpl<double, Tout>(images, blob_, param);
+    switch (images[0].depth())
+    {
+    case CV_8U: imagesToBlob<uint8_t, Tout>(images, offsets, blob, param); break;
+    case CV_8S: imagesToBlob<int8_t, Tout>(images, offsets, blob, param); break;
+    case CV_16U: imagesToBlob<uint16_t, Tout>(images, offsets, blob, param); break;
+    case CV_16S: imagesToBlob<int16_t, Tout>(images, offsets, blob, param); break;
+    case CV_32S: imagesToBlob<int32_t, Tout>(images, offsets, blob, param); break;
+    case CV_32F: imagesToBlob<float, Tout>(images, offsets, blob, param); break;
+    case CV_64F: imagesToBlob<double, Tout>(images, offsets, blob, param); break;
+    default:
+        CV_Error(Error::BadDepth, "Unsupported input image depth for blobFromImages");
+    }
+}
+
+// Mat images are converted in a single pass after resize: crop, letterbox borders, channels swap,
+// mean subtraction, scaling, type and layout conversions are fused and rows of blob are processed in parallel.
+static void blobFromImagesFused(std::vector<Mat>& images, Mat& blob_, const Image2BlobParams& param)
+{
+    const int nimages = (int)images.size();
+    const int type = images[0].type(), nch = CV_MAT_CN(type);
+    CV_CheckLE(nch, 4, "Blob can be created from images with up to 4 channels");
+    if (param.swapRB && nch == 2)
+        CV_LOG_WARNING(NULL, "Red/blue color swapping requires at least three image channels.");
+    for (int i = 0; i < nimages; i++)
+    {
+        CV_Assert(images[i].dims == 2);
+        CV_CheckTypeEQ(images[i].type(), type, "All images should have the same type");
+    }
+
+    Size size = param.size == Size() ? images[0].size() : param.size;
+    std::vector<Point> offsets(nimages);
+    if (nimages == 1)
+        images[0] = resizeToBlobSize(images[0], size, param.paddingmode, offsets[0]);
+    else
+    {
+        parallel_for_(Range(0, nimages), [&](const Range& range)
+        {
+            for (int i = range.start; i < range.end; i++)
+                images[i] = resizeToBlobSize(images[i], size, param.paddingmode, offsets[i]);
+        });
+    }
+    for (int i = 0; i < nimages; i++)
+    {
+        CV_Assert(offsets[i].x >= 0 && offsets[i].x + images[i].cols <= size.width);
+        CV_Assert(offsets[i].y >= 0 && offsets[i].y + images[i].rows <= size.height);
+    }
+
+    if (param.datalayout == DNN_LAYOUT_NCHW)
+    {
+        int sz[] = { nimages, nch, size.height, size.width };
+        blob_.create(4, sz, param.ddepth);
+    }
+    else if (param.datalayout == DNN_LAYOUT_NHWC)
+    {
+        int sz[] = { nimages, size.height, size.width, nch };
+        blob_.create(4, sz, param.ddepth);
+    }
     else
-        CV_Error(Error::BadDepth, "Unsupported input image depth for blobFromImagesNCHW");
+    {
+        CV_Error(Error::StsUnsupportedFormat, "Unsupported data layout in blobFromImagesWithParams function.");
+    }
+
+    if (param.ddepth == CV_32F)
+        imagesToBlob<float>(images, offsets, blob_, param);
+    else if (param.ddepth == CV_16F)
+        imagesToBlob<hfloat>(images, offsets, blob_, param);
+    else
+        imagesToBlob<uint8_t>(images, offsets, blob_, param);
 }
 
-template<typename Tout>
-void blobFromImagesNCHW(const std::vector<UMat>& images, UMat& blob_, const Image2BlobParams& param)
+static void blobFromImagesFused(std::vector<UMat>& images, UMat& blob_, const Image2BlobParams& param)
 {
     CV_Error(Error::StsNotImplemented, "");
 }
@@ -240,8 +425,8 @@ void blobFromImagesWithParamsImpl(InputArrayOfArrays images_, Tmat& blob_, const
         CV_Error(Error::StsBadArg, error_message);
     }
 
-    CV_CheckType(param.ddepth, param.ddepth == CV_32F || param.ddepth == CV_8U,
-                 "Blob depth should be CV_32F or CV_8U");
+    CV_CheckType(param.ddepth, param.ddepth == CV_32F || param.ddepth == CV_16F || param.ddepth == CV_8U,
+                 "Blob depth should be CV_32F, CV_16F or CV_8U");
     Size size = param.size;
 
     std::vector<Tmat> images;
@@ -255,6 +440,13 @@ void blobFromImagesWithParamsImpl(InputArrayOfArrays images_, Tmat& blob_, const
         CV_Assert(param.mean == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
     }
 
+    if (std::is_same<Tmat, Mat>::value)
+    {
+        blobFromImagesFused(images, blob_, param);
+        return;
+    }
+    CV_CheckType(param.ddepth, param.ddepth != CV_16F, "CV_16F blob depth is supported for Mat images only");
+
     int nch = images[0].channels();
     Scalar scalefactor = param.scalefactor;
     Scalar mean = param.mean;
@@ -301,16 +493,6 @@ void blobFromImagesWithParamsImpl(InputArrayOfArrays images_, Tmat& blob_, const
     Tmat image0 = images[0];
     CV_Assert(image0.dims == 2);
 
-    if (std::is_same<Tmat, Mat>::value && param.datalayout == DNN_LAYOUT_NCHW)
-    {
-        // Fast implementation for HWC cv::Mat images -> NCHW cv::Mat blob
-        if (param.ddepth == CV_8U)
-            blobFromImagesNCHW<uint8_t>(images, blob_, param);
-        else
-            blobFromImagesNCHW<float>(images, blob_, param);
-        return;
-    }
-
     if (param.swapRB)
     {
         if (nch > 2)
@@ -206,6 +206,9 @@ void initializeLayerFactory()
     CV_DNN_REGISTER_LAYER_CLASS(Requantize,       RequantizeLayer);
     CV_DNN_REGISTER_LAYER_CLASS(ConvolutionInt8,  ConvolutionLayerInt8);
     CV_DNN_REGISTER_LAYER_CLASS(InnerProductInt8, InnerProductLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(MatMulInt8,       MatMulLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(GemmInt8,         InnerProductLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(AttentionInt8,    AttentionLayerInt8);
     CV_DNN_REGISTER_LAYER_CLASS(PoolingInt8,      PoolingLayerInt8);
     CV_DNN_REGISTER_LAYER_CLASS(EltwiseInt8,      EltwiseLayerInt8);
     CV_DNN_REGISTER_LAYER_CLASS(BatchNormInt8,    BatchNormLayerInt8);
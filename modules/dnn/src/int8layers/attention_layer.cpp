@@ -0,0 +1,183 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "../layers/cpu_kernels/fast_attention.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+class AttentionLayerInt8Impl CV_FINAL : public AttentionLayerInt8
+{
+public:
+    enum { VEC_ALIGN = 32 };
+    AttentionLayerInt8Impl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+
+        num_heads = params.get<int>("num_heads");
+        DictValue param_qkv_hidden_sizes = params.get("qkv_hidden_sizes");
+        CV_CheckEQ(param_qkv_hidden_sizes.size(), 3, "DNN/AttentionInt8: qkv_hidden_sizes must and only have three elements");
+        output_ndims = params.get<int>("output_ndims", 3);
+
+        input_sc = params.get<float>("input_scale");
+        input_zp = params.get<int>("input_zeropoint");
+        output_sc = params.get<float>("scales");
+        output_zp = params.get<int>("zeropoints");
+        qkv_sc = params.get<float>("qkv_scale");
+        qkv_zp = params.get<int>("qkv_zeropoint");
+
+        // blobs[0] - Q, K and V projection weights [hidden_size, input_hidden_size]
+        // blobs[1] - Bias fused with offset
+        // blobs[2] - Multipliers for output stage
+        CV_CheckEQ(blobs.size(), (size_t)3, "DNN/AttentionInt8: quantized weights, bias and multipliers are expected");
+        hidden_size = blobs[0].rows;
+        CV_Assert(blobs[1].total() == hidden_size && blobs[2].total() == hidden_size);
+
+        qkv_hidden_sizes.resize(3);
+        qkv_hidden_sizes[0] = static_cast<size_t>(param_qkv_hidden_sizes.get<int>(0));
+        qkv_hidden_sizes[1] = static_cast<size_t>(param_qkv_hidden_sizes.get<int>(1));
+        qkv_hidden_sizes[2] = hidden_size - qkv_hidden_sizes[0] - qkv_hidden_sizes[1];
+        qkv_head_sizes.resize(3);
+        for (int i = 0; i < 3; i++)
+            qkv_head_sizes[i] = qkv_hidden_sizes[i] / num_heads;
+
+        scale = 1.f / params.get<float>("scale", sqrt(qkv_head_sizes[0]));
+
+        weightsMat = blobs[0];
+        int vecsize = weightsMat.cols;
+        if (vecsize % VEC_ALIGN != 0)
+        {
+            int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN);
+            Mat weightsBuf((int)hidden_size, vecsize_aligned, weightsMat.type(), Scalar::all(0));
+            weightsMat = weightsBuf.colRange(0, vecsize);
+            blobs[0].copyTo(weightsMat);
+        }
+        biasMat = blobs[1] = blobs[1].reshape(1, 1);
+        outputMultiplier = blobs[2];
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                         const int requiredOutputs,
+                         std::vector<MatShape> &outputs,
+                         std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        CV_CheckEQ(inputs.size(), (size_t)1, "DNN/AttentionInt8: constant weight and bias are expected");
+        const auto &input_shape = inputs[0];
+        CV_CheckEQ(input_shape.size(), static_cast<size_t>(3), "DNN/AttentionInt8: invalid input dimension");
+        CV_CheckEQ(input_shape[2], weightsMat.cols, "DNN/AttentionInt8: invalid input shape");
+        CV_CheckEQ((size_t)input_shape[2], qkv_hidden_sizes[2], "DNN/AttentionInt8: V hidden size must be equal to input hidden size");
+
+        if (output_ndims == 3) {
+            outputs.assign(1, inputs[0]);
+        } else if (output_ndims == 2) {
+            MatShape output_shape{input_shape[0] * input_shape[1], input_shape[2]};
+            outputs.assign(1, output_shape);
+        } else {
+            CV_Error(Error::StsBadArg, format("DNN/AttentionInt8: invalid output dimension %zu, valid value is 2 or 3", output_ndims));
+        }
+        return false;
+    }
+
+    virtual void finalize(InputArrayOfArrays, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        opt.init();
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const Mat &input = inputs[0];
+        const int batch_size = input.size[0], seq_len = input.size[1], input_hidden_size = input.size[2];
+        const int num_rows = batch_size * seq_len;
+        const int heads = static_cast<int>(num_heads);
+
+        // Buffers of FP32 part of the layer
+        Mat gemm_buffer(1, num_rows * (int)hidden_size, CV_32F);
+        Mat attention(num_rows, (int)qkv_hidden_sizes[2], CV_32F);
+
+        float *Q = gemm_buffer.ptr<float>();
+        float *K = Q + num_rows * qkv_hidden_sizes[0];
+        float *V = K + num_rows * qkv_hidden_sizes[1];
+        float *QKV[3] = {Q, K, V}; // Q, K, V: [B, N, S, H]
+
+        // Compute Q, K and V projection in INT8 and dequantize them with splitting into heads
+        parallel_for_(Range(0, num_rows), [&](const Range &r) {
+            int vecsize_aligned = (int)alignSize(input_hidden_size, VEC_ALIGN);
+            AutoBuffer<int8_t> srcbuf(vecsize_aligned + VEC_ALIGN);
+            AutoBuffer<int> dstbuf(hidden_size);
+            int8_t* sptr = alignPtr(srcbuf.data(), (int)(VEC_ALIGN*sizeof(int8_t)));
+            int* dptr = dstbuf.data();
+
+            for (int k = input_hidden_size; k < vecsize_aligned; k++)
+                sptr[k] = 0;
+
+            for (int row = r.start; row < r.end; row++)
+            {
+                const int batch_index = row / seq_len, seq_index = row % seq_len;
+                memcpy(sptr, input.ptr<int8_t>() + (size_t)row * input_hidden_size, input_hidden_size);
+                fastGEMM1TInt8(sptr, weightsMat.ptr<int8_t>(), weightsMat.step1(), biasMat.ptr<int>(),
+                               outputMultiplier.ptr<float>(), dptr, (int)hidden_size, input_hidden_size, qkv_zp);
+
+                const int* src = dptr;
+                for (int qkv_index = 0; qkv_index < 3; qkv_index++)
+                {
+                    const size_t head_size = qkv_head_sizes[qkv_index];
+                    for (int head_index = 0; head_index < heads; head_index++)
+                    {
+                        float* dst = QKV[qkv_index] + ((batch_index * heads + head_index) * seq_len + seq_index) * head_size;
+                        for (size_t j = 0; j < head_size; j++)
+                            dst[j] = qkv_sc * (saturate_cast<int8_t>(src[j]) - qkv_zp);
+                        src += head_size;
+                    }
+                }
+            }
+        }, (double)num_rows * hidden_size * input_hidden_size * (1 / 1024.0));
+
+        // Compute Softmax(scale * MatMul(Q, K)) * V
+        fastAttention(Q, K, V, attention.ptr<float>(),
+                      batch_size, num_heads, seq_len, qkv_head_sizes[0], qkv_head_sizes[2], scale, opt);
+
+        Mat dst = outputs[0].reshape(1, num_rows);
+        attention.convertTo(dst, CV_8S, 1.f/output_sc, output_zp);
+    }
+
+private:
+    size_t num_heads;
+    size_t output_ndims;
+    size_t hidden_size;
+    std::vector<size_t> qkv_hidden_sizes; // order: {qk_hidden_size, qk_hidden_size, v_hidden_size}
+    std::vector<size_t> qkv_head_sizes; // order: {qk_head_size, qk_head_size, v_head_size}
+    float scale;
+
+    float qkv_sc;
+    int qkv_zp;
+    Mat weightsMat, biasMat, outputMultiplier;
+
+    FastGemmOpt opt;
+};
+
+Ptr<AttentionLayerInt8> AttentionLayerInt8::create(const LayerParams& params)
+{
+    return Ptr<AttentionLayerInt8>(new AttentionLayerInt8Impl(params));
+}
+
+}
+}
@@ -14,6 +14,81 @@ namespace cv
 namespace dnn
 {
 
+void fastGEMM1TInt8( const int8_t* sptr, const int8_t* wptr, size_t wstep, const int* biasptr,
+                     const float* multptr, int* dptr, int nw, int vecsize, int outZp )
+{
+#if CV_TRY_AVX512_ICL
+    if( CV_CPU_HAS_SUPPORT_AVX512_ICL )
+        opt_AVX512_ICL::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
+    else
+#endif
+#if CV_TRY_AVX512_SKX
+    if( CV_CPU_HAS_SUPPORT_AVX512_SKX )
+        opt_AVX512_SKX::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
+    else
+#endif
+#if CV_TRY_AVX2
+    if( checkHardwareSupport(CPU_AVX2) )
+        opt_AVX2::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
+    else
+#endif
+#if CV_TRY_LASX
+    if( checkHardwareSupport(CPU_LASX) )
+        opt_LASX::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
+    else
+#endif
+#if CV_TRY_RVV && CV_RVV
+    if( checkHardwareSupport(CPU_RVV) )
+        opt_RVV::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
+    else
+#endif
+#if CV_RVP052
+    if( 1 )
+        opt_RVP052::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
+    else
+#endif
+    {
+        int i = 0, k;
+#if CV_SIMD128
+        for( ; i  <= nw - 4; i += 4, wptr += 4*wstep )
+        {
+            v_int32x4 vs0 = v_setzero_s32(), vs1 = v_setzero_s32(),
+                      vs2 = v_setzero_s32(), vs3 = v_setzero_s32();
+            v_int32x4 outzp = v_setall_s32(outZp), outmin = v_setall_s32(-128), outmax = v_setall_s32(127);
+            v_int32x4 s = v_load(biasptr + i);
+            v_float32x4 mult = v_load(multptr + i);
+
+            for( k = 0; k < vecsize; k += 16 )
+            {
+                v_int8x16 v = v_load_aligned(sptr + k);
+                vs0 = v_dotprod_expand_fast(v, v_load_aligned(wptr + k), vs0);
+                vs1 = v_dotprod_expand_fast(v, v_load_aligned(wptr + wstep + k), vs1);
+                vs2 = v_dotprod_expand_fast(v, v_load_aligned(wptr + wstep*2 + k), vs2);
+                vs3 = v_dotprod_expand_fast(v, v_load_aligned(wptr + wstep*3 + k), vs3);
+            }
+
+            s = v_add(s, v_int32x4(v_reduce_sum(vs0), v_reduce_sum(vs1), v_reduce_sum(vs2), v_reduce_sum(vs3)));
+            v_int32x4 out = v_add(outzp, v_round(v_mul(v_cvt_f32(s), mult)));
+            v_store(dptr + i, v_min(v_max(out, outmin), outmax));
+        }
+#endif
+
+        for( ; i < nw; i++, wptr += wstep )
+        {
+            int s0 = biasptr[i];
+            float mult0 = multptr[i];
+
+            for( k = 0; k < vecsize; k++ )
+            {
+                int8_t v = sptr[k];
+                s0 += (int)v*wptr[k];
+            }
+            int out0 = outZp + (int)std::round(s0*mult0);
+            dptr[i] = std::min(std::max(out0, -128), 127);
+        }
+    }
+}
+
 class FullyConnectedLayerInt8Impl CV_FINAL : public InnerProductLayerInt8
 {
 public:
@@ -228,7 +303,7 @@ public:
     {
     public:
         FullyConnected() : srcMat(0), weights(0), biasMat(0), outputMultiplier(0), activationLUT(0), activ(0),
-                           dstMat(0), nstripes(0), outZp(0), useAVX2(false), useAVX512(false), useLASX(false), useRVV(false) {}
+                           dstMat(0), nstripes(0), outZp(0) {}
 
         static void run(const Mat& srcMat, const Mat& weights, const Mat& biasMat, const Mat& outputMultiplier,
                         const Mat& activationLUT, Mat& dstMat, const ActivationLayerInt8* activ, int nstripes, int outZp)
@@ -250,10 +325,6 @@ public:
             p.nstripes = nstripes;
             p.outZp = outZp;
             p.activ = !activationLUT.empty() ? activ : 0;
-            p.useAVX2 = checkHardwareSupport(CPU_AVX2);
-            p.useAVX512 = CV_CPU_HAS_SUPPORT_AVX512_SKX;
-            p.useLASX = checkHardwareSupport(CPU_LASX);
-            p.useRVV = checkHardwareSupport(CPU_RVV);
 
             parallel_for_(Range(0, nstripes), p, nstripes);
         }
@@ -289,71 +360,7 @@ public:
                 int nw = std::min(nw0 - delta, (int)(stripeEnd - ofs));
 
                 memcpy(sptr, sptr_, vecsize*sizeof(sptr[0]));
-            #if CV_TRY_AVX512_SKX
-                if( useAVX512 )
-                    opt_AVX512_SKX::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
-                else
-            #endif
-            #if CV_TRY_AVX2
-                if( useAVX2 )
-                    opt_AVX2::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
-                else
-            #endif
-            #if CV_TRY_LASX
-                if( useLASX )
-                    opt_LASX::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
-                else
-            #endif
-            #if CV_TRY_RVV && CV_RVV
-                if( useRVV )
-                    opt_RVV::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
-                else
-            #endif
-            #if CV_RVP052
-                if( 1 )
-                    opt_RVP052::fastGEMM1T( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
-                else
-            #endif
-                {
-                    int i = 0;
-            #if CV_SIMD128
-                    for( ; i  <= nw - 4; i += 4, wptr += 4*wstep )
-                    {
-                        v_int32x4 vs0 = v_setzero_s32(), vs1 = v_setzero_s32(),
-                                  vs2 = v_setzero_s32(), vs3 = v_setzero_s32();
-                        v_int32x4 outzp = v_setall_s32(outZp), outmin = v_setall_s32(-128), outmax = v_setall_s32(127);
-                        v_int32x4 s = v_load(biasptr + i);
-                        v_float32x4 mult = v_load(multptr + i);
-
-                        for( k = 0; k < vecsize; k += 16 )
-                        {
-                            v_int8x16 v = v_load_aligned(sptr + k);
-                            vs0 = v_dotprod_expand_fast(v, v_load_aligned(wptr + k), vs0);
-                            vs1 = v_dotprod_expand_fast(v, v_load_aligned(wptr + wstep + k), vs1);
-                            vs2 = v_dotprod_expand_fast(v, v_load_aligned(wptr + wstep*2 + k), vs2);
-                            vs3 = v_dotprod_expand_fast(v, v_load_aligned(wptr + wstep*3 + k), vs3);
-                        }
-
-                        s = v_add(s, v_int32x4(v_reduce_sum(vs0), v_reduce_sum(vs1), v_reduce_sum(vs2), v_reduce_sum(vs3)));
-                        v_int32x4 out = v_add(outzp, v_round(v_mul(v_cvt_f32(s), mult)));
-                        v_store(dptr + i, v_min(v_max(out, outmin), outmax));
-                    }
-            #endif
-
-                    for( ; i < nw; i++, wptr += wstep )
-                    {
-                        int s0 = biasptr[i];
-                        float mult0 = multptr[i];
-
-                        for( k = 0; k < vecsize; k++ )
-                        {
-                            int8_t v = sptr[k];
-                            s0 += (int)v*wptr[k];
-                        }
-                        int out0 = outZp + (int)std::round(s0*mult0);
-                        dptr[i] = std::min(std::max(out0, -128), 127);
-                    }
-                }
+                fastGEMM1TInt8( sptr, wptr, wstep, biasptr, multptr, dptr, nw, vecsize, outZp );
 
                 if(activ)
                     activ->forwardSlice(dptr, lutptr, dptr, 1, 1, delta, delta + nw);
@@ -366,10 +373,6 @@ public:
         const ActivationLayerInt8* activ;
         Mat* dstMat;
         int nstripes, outZp;
-        bool useAVX2;
-        bool useAVX512;
-        bool useLASX;
-        bool useRVV;
     };
 
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
@@ -37,6 +37,12 @@ void getConvPoolOutParams(const std::vector<int>& inp, const std::vector<size_t>
  void getConvPoolPaddings(const std::vector<int>& inp, const std::vector<size_t>& kernel,
                           const std::vector<size_t>& strides, const String &padMode,
                           std::vector<size_t>& pads_begin, std::vector<size_t>& pads_end);
+
+// Computes dptr[i] = outZp + multptr[i]*(biasptr[i] + dot(sptr, wptr + i*wstep)) saturated to [-128, 127]
+// for i in [0, nw) using the best kernel available on the current CPU.
+// sptr and rows of wptr must be aligned to 32 bytes and zero-padded up to a multiple of 32 elements.
+void fastGEMM1TInt8( const int8_t* sptr, const int8_t* wptr, size_t wstep, const int* biasptr,
+                     const float* multptr, int* dptr, int nw, int vecsize, int outZp );
 }
 }
 
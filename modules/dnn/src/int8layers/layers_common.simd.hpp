@@ -579,6 +579,32 @@ void fastGEMM1T( const int8_t* vec, const int8_t* weights,
         __m128i voutzp = _mm_set1_epi32(outZp);
         __m128i outmin = _mm_set1_epi32(-128), outmax = _mm_set1_epi32(127);
 
+#if CV_AVX512_ICL
+        // VNNI multiplies unsigned by signed bytes: weights are shifted to unsigned range (w + 128),
+        // the extra 128*sum(vec) term is accumulated separately and subtracted from all sums.
+        const __m256i vsignbit = _mm256_set1_epi8((char)0x80);
+        __m256i vcomp = _mm256_setzero_si256();
+
+        for( int k = 0; k < vecsize; k += 32, wptr += 32 )
+        {
+            __m256i v = _mm256_load_si256((const __m256i*)(vec + k));
+
+            vs0 = _mm256_dpbusd_epi32(vs0, _mm256_xor_si256(_mm256_load_si256((const __m256i*)wptr), vsignbit), v);
+            vs1 = _mm256_dpbusd_epi32(vs1, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep)), vsignbit), v);
+            vs2 = _mm256_dpbusd_epi32(vs2, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep*2)), vsignbit), v);
+            vs3 = _mm256_dpbusd_epi32(vs3, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep*3)), vsignbit), v);
+            vs4 = _mm256_dpbusd_epi32(vs4, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep*4)), vsignbit), v);
+            vs5 = _mm256_dpbusd_epi32(vs5, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep*5)), vsignbit), v);
+            vs6 = _mm256_dpbusd_epi32(vs6, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep*6)), vsignbit), v);
+            vs7 = _mm256_dpbusd_epi32(vs7, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(wptr + wstep*7)), vsignbit), v);
+            vcomp = _mm256_dpbusd_epi32(vcomp, vsignbit, v);
+        }
+
+        vs0 = _mm256_sub_epi32(vs0, vcomp); vs1 = _mm256_sub_epi32(vs1, vcomp);
+        vs2 = _mm256_sub_epi32(vs2, vcomp); vs3 = _mm256_sub_epi32(vs3, vcomp);
+        vs4 = _mm256_sub_epi32(vs4, vcomp); vs5 = _mm256_sub_epi32(vs5, vcomp);
+        vs6 = _mm256_sub_epi32(vs6, vcomp); vs7 = _mm256_sub_epi32(vs7, vcomp);
+#else
         for( int k = 0; k < vecsize; k += 32, wptr += 32 )
         {
             __m256i v = _mm256_load_si256((const __m256i*)(vec + k));
@@ -592,6 +618,7 @@ void fastGEMM1T( const int8_t* vec, const int8_t* weights,
             vs6 = _mm256_fmaddepi8_epi32(_mm256_load_si256((const __m256i*)(wptr + wstep*6)), v, vs6);
             vs7 = _mm256_fmaddepi8_epi32(_mm256_load_si256((const __m256i*)(wptr + wstep*7)), v, vs7);
         }
+#endif
 
         __m256i s0 = _mm256_hadd_epi32(_mm256_hadd_epi32(vs0, vs1), _mm256_hadd_epi32(vs2, vs3));
         __m256i s1 = _mm256_hadd_epi32(_mm256_hadd_epi32(vs4, vs5), _mm256_hadd_epi32(vs6, vs7));
@@ -620,7 +647,13 @@ void fastGEMM1T( const int8_t* vec, const int8_t* weights,
         for( int k = 0; k < vecsize; k += 32, wptr += 32 )
         {
             __m256i v = _mm256_load_si256((const __m256i*)(vec + k));
+#if CV_AVX512_ICL
+            const __m256i vsignbit = _mm256_set1_epi8((char)0x80);
+            vs0 = _mm256_dpbusd_epi32(vs0, _mm256_xor_si256(_mm256_load_si256((const __m256i*)wptr), vsignbit), v);
+            vs0 = _mm256_sub_epi32(vs0, _mm256_dpbusd_epi32(_mm256_setzero_si256(), vsignbit, v));
+#else
             vs0 = _mm256_fmaddepi8_epi32(_mm256_load_si256((const __m256i*)wptr), v, vs0);
+#endif
         }
 
         __m256i s0 = _mm256_hadd_epi32(_mm256_hadd_epi32(vs0, vs0), vs0);
@@ -0,0 +1,206 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "../layers/cpu_kernels/fast_gemm.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+// Y = alpha * A * B, where A is a quantized input of the layer and B is either the second input
+// or a constant blob. Constant B is packed once in finalize().
+// Zero points are not fused into the data, so the product of row a and column b is computed as
+//   sum((a - za) * (b - zb)) = sum(a * b) - za * sum(b) - zb * sum(a) + K * za * zb,
+// where sum(a * b) is computed by INT8 kernels of fully connected layer and the rest goes to the bias.
+class MatMulLayerInt8Impl CV_FINAL : public MatMulLayerInt8
+{
+public:
+    enum { VEC_ALIGN = 32 };
+    MatMulLayerInt8Impl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+
+        trans_a = params.get<bool>("transA", false);
+        trans_b = params.get<bool>("transB", false);
+        alpha = params.get<float>("alpha", 1.f);
+
+        DictValue sc = params.get("input_scales"), zp = params.get("input_zeropoints");
+        CV_CheckEQ(sc.size(), 2, "DNN/MatMulInt8: scales of two inputs are expected");
+        CV_CheckEQ(zp.size(), 2, "DNN/MatMulInt8: zero points of two inputs are expected");
+        for (int i = 0; i < 2; i++)
+        {
+            input_sc.push_back(sc.get<float>(i));
+            input_zp.push_back(zp.get<int>(i));
+        }
+        output_sc = params.get<float>("scales");
+        output_zp = params.get<int>("zeropoints");
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                         const int requiredOutputs,
+                         std::vector<MatShape> &outputs,
+                         std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        CV_CheckEQ(inputs.size() + blobs.size(), (size_t)2, "DNN/MatMulInt8: two inputs are expected");
+        const auto shape_A = inputs[0], shape_B = blobs.empty() ? inputs[1] : shape(blobs[0]);
+        CV_CheckGE(shape_A.size(), static_cast<size_t>(2), "DNN/MatMulInt8: invalid shape of input A");
+        CV_CheckGE(shape_B.size(), static_cast<size_t>(2), "DNN/MatMulInt8: invalid shape of input B");
+
+        int mA = shape_A[shape_A.size() - 2], nA = shape_A.back();
+        int mB = shape_B[shape_B.size() - 2], nB = shape_B.back();
+        int M = trans_a ? nA : mA;
+        int N = trans_b ? mB : nB;
+        CV_CheckEQ(trans_a ? mA : nA, trans_b ? nB : mB, "DNN/MatMulInt8: invalid dimension K");
+
+        // Batch dimensions are broadcasted
+        const auto &shape_more_dims = shape_A.size() > shape_B.size() ? shape_A : shape_B;
+        const auto &shape_less_dims = shape_A.size() > shape_B.size() ? shape_B : shape_A;
+        size_t diff_dims = shape_more_dims.size() - shape_less_dims.size();
+        MatShape common_shape = shape_more_dims;
+        for (size_t i = 0; i < shape_less_dims.size() - 2; i++)
+        {
+            const auto dl = shape_less_dims[i], dm = shape_more_dims[i + diff_dims];
+            if (dl != 1 && dm != 1 && dl != dm)
+                CV_Error(Error::StsBadSize, "DNN/MatMulInt8: invalid shapes for broadcasting");
+            if (dm == 1)
+                common_shape[i + diff_dims] = dl;
+        }
+        common_shape[common_shape.size() - 2] = M;
+        common_shape[common_shape.size() - 1] = N;
+
+        outputs.assign(1, common_shape);
+        return false;
+    }
+
+    virtual void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr) CV_OVERRIDE
+    {
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+        helper.compute(trans_a, trans_b, shape(inputs[0]), blobs.empty() ? shape(inputs[1]) : shape(blobs[0]), shape(outputs[0]));
+
+        if (!blobs.empty())
+            packB(blobs[0].ptr<const int8_t>(), packedB, biasB);
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const int8_t *a = inputs[0].ptr<const int8_t>();
+        int8_t *y = outputs[0].ptr<int8_t>();
+
+        const int batch = (int)helper.batch, M = helper.M, N = helper.N, K = helper.K;
+        const int K_aligned = (int)alignSize(K, VEC_ALIGN);
+        const int zb = input_zp[1];
+
+        Mat packedB_ = packedB, biasB_ = biasB;
+        if (blobs.empty())
+            packB(inputs[1].ptr<const int8_t>(), packedB_, biasB_);
+
+        std::vector<float> multiplier(N, alpha * input_sc[0] * input_sc[1] / output_sc);
+
+        parallel_for_(Range(0, batch * M), [&](const Range &r) {
+            AutoBuffer<int8_t> srcbuf(K_aligned + VEC_ALIGN);
+            AutoBuffer<int> biasbuf(N), dstbuf(N);
+            int8_t* sptr = alignPtr(srcbuf.data(), (int)(VEC_ALIGN*sizeof(int8_t)));
+            int *bias = biasbuf.data(), *dptr = dstbuf.data();
+
+            for (int k = K; k < K_aligned; k++)
+                sptr[k] = 0;
+
+            for (int i = r.start; i < r.end; i++)
+            {
+                const int batch_index = i / M, m = i % M;
+                const int8_t *aptr = a + helper.A_offsets[batch_index] + (size_t)m * helper.lda0;
+                int sum = 0;
+                for (int k = 0; k < K; k++)
+                {
+                    sptr[k] = aptr[(size_t)k * helper.lda1];
+                    sum += sptr[k];
+                }
+
+                const int *biasptr = biasB_.ptr<int>(batch_index);
+                for (int n = 0; n < N; n++)
+                    bias[n] = biasptr[n] - zb * sum;
+
+                fastGEMM1TInt8(sptr, packedB_.ptr<int8_t>(batch_index * N), packedB_.step1(), bias,
+                               multiplier.data(), dptr, N, K, output_zp);
+
+                int8_t *yptr = y + helper.C_offsets[batch_index] + (size_t)m * helper.ldc;
+                for (int n = 0; n < N; n++)
+                    yptr[n] = saturate_cast<int8_t>(dptr[n]);
+            }
+        }, (double)batch * M * N * K * (1 / 1024.0));
+    }
+
+    virtual int64 getFLOPS(const std::vector<MatShape> &inputs,
+                           const std::vector<MatShape> &outputs) const CV_OVERRIDE
+    {
+        const auto &shape_A = inputs[0];
+        int K = trans_a ? shape_A[shape_A.size() - 2] : shape_A.back();
+        return CV_BIG_INT(2) * K * total(outputs[0]);
+    }
+
+private:
+    // Packs B^T of every batch into rows aligned for INT8 kernels and precomputes
+    // the part of the bias which does not depend on rows of A.
+    void packB(const int8_t *b, Mat &packed, Mat &bias) const
+    {
+        const int batch = (int)helper.batch, N = helper.N, K = helper.K;
+        const int za = input_zp[0], zb = input_zp[1];
+        packed.create(batch * N, (int)alignSize(K, VEC_ALIGN), CV_8S);
+        packed.setTo(Scalar::all(0));
+        bias.create(batch, N, CV_32S);
+        parallel_for_(Range(0, batch * N), [&](const Range &r) {
+            for (int i = r.start; i < r.end; i++)
+            {
+                const int batch_index = i / N, n = i % N;
+                const int8_t *bptr = b + helper.B_offsets[batch_index] + (size_t)n * helper.ldb1;
+                int8_t *dst = packed.ptr<int8_t>(i);
+                int sum = 0;
+                for (int k = 0; k < K; k++)
+                {
+                    dst[k] = bptr[(size_t)k * helper.ldb0];
+                    sum += dst[k];
+                }
+                bias.ptr<int>(batch_index)[n] = K * za * zb - za * sum;
+            }
+        }, (double)batch * N * K * (1 / 1024.0));
+    }
+
+    bool trans_a;
+    bool trans_b;
+    float alpha;
+
+    MatMulHelper helper;
+    Mat packedB, biasB;  // packed constant B
+};
+
+Ptr<Layer> MatMulLayerInt8::create(const LayerParams& params)
+{
+    // Constant 2D B is quantized to weights of fully connected layer,
+    // other constant B keeps scales of both inputs
+    if (!params.blobs.empty() && !params.has("input_scales"))
+        return InnerProductLayerInt8::create(params);
+    return Ptr<Layer>(new MatMulLayerInt8Impl(params));
+}
+
+}
+}
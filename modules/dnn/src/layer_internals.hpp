@@ -93,6 +93,9 @@ struct LayerData
     std::map<int, Ptr<BackendNode>> backendNodes;
     // Flag for skip layer computation for specific backend.
     bool skip;
+    // Inputs and outputs (data, type and shape) of the last finalize() call.
+    // Empty if the layer must be finalized on the next allocation.
+    std::vector<size_t> finalizeSignature;
 
     int flag;
 
@@ -4,7 +4,8 @@
 
 #include "../precomp.hpp"
 #include "cpu_kernels/fast_gemm.hpp"
-#include "cpu_kernels/softmax.hpp"
+#include "cpu_kernels/fast_attention.hpp"
+#include "layers_common.hpp"
 
 #include <opencv2/dnn/shape_utils.hpp>
 
@@ -52,6 +53,11 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
 
         output_ndims = params.get<int>("output_ndims", 3);
 
+        unidirectional = params.get<bool>("unidirectional", false);
+        has_present = params.get<bool>("present", false);
+        kv_cache_size = static_cast<size_t>(params.get<int>("kv_cache_size", 0));
+        kv_cache_len = 0;
+
         is_prepacked = false;
     }
 
@@ -64,7 +70,7 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
                                  std::vector<MatShape> &outputs,
                                  std::vector<MatShape> &internals) const CV_OVERRIDE {
         int num_inputs = inputs.size() + blobs.size();
-        CV_CheckEQ(num_inputs, 3, "DNN/Attention: three inputs are required");
+        CV_Check(num_inputs, num_inputs == 3 || num_inputs == 4, "DNN/Attention: input, weight, bias and optional past are required");
         const auto &input_shape = inputs[0];
         const auto &weight_shape = blobs.empty() ? inputs[1] : shape(blobs.front());
         const auto &bias_shape = blobs.empty() ? inputs[2] : shape(blobs.back());
@@ -75,6 +81,9 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
         CV_CheckEQ(input_shape[2], weight_shape[0], "DNN/Attention: invalid input shape");
         CV_CheckEQ(weight_shape[1], bias_shape[0], "DNN/Attention: invalid weight or bias shape");
 
+        const bool has_past = num_inputs == 4;
+        CV_Assert(!(kv_cache_size > 0 && (has_past || has_present)) && "DNN/Attention: past and present can't be used with internal KV cache");
+
         if (output_ndims == 3) {
             outputs.assign(1, inputs[0]);
         } else if (output_ndims == 2) {
@@ -90,12 +99,26 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
                   num_heads_ = static_cast<int>(num_heads),
                   v_head_size_ = static_cast<int>((hidden_size_ - qkv_hidden_sizes[0] - qkv_hidden_sizes[1]) / num_heads);
 
-        MatShape gemm_buffer_shape{batch_size_, seq_len_, hidden_size_},
-                 attention_prob_shape{batch_size_ * num_heads_, seq_len_, seq_len_},
-                 output_buffer_shape{batch_size_ * num_heads_, seq_len_, v_head_size_};
+        if (has_past || has_present) {
+            // Keys and values of past and new tokens
+            const int qk_head_size_ = static_cast<int>(qkv_head_sizes[0]);
+            CV_CheckEQ(qk_head_size_, v_head_size_, "DNN/Attention: past and present require the same head size of K and V");
+            int total_seq_len_ = seq_len_;
+            if (has_past) {
+                const auto &past_shape = inputs.back();  // [2, batch_size, num_heads, past_seq_len, head_size]
+                CV_CheckEQ(past_shape.size(), static_cast<size_t>(5), "DNN/Attention: invalid past dimension");
+                CV_CheckTrue(past_shape[0] == 2 && past_shape[1] == batch_size_ && past_shape[2] == num_heads_ &&
+                             past_shape[4] == qk_head_size_, "DNN/Attention: invalid past shape");
+                total_seq_len_ += past_shape[3];
+            }
+            MatShape present_shape{2, batch_size_, num_heads_, total_seq_len_, qk_head_size_};
+            outputs.push_back(present_shape);
+        } else if (kv_cache_size > 0) {
+            CV_CheckLE(seq_len_, static_cast<int>(kv_cache_size), "DNN/Attention: sequence is longer than KV cache");
+        }
+
+        MatShape gemm_buffer_shape{batch_size_, seq_len_, hidden_size_};
         internals.assign(1, gemm_buffer_shape);
-        internals.push_back(attention_prob_shape);
-        internals.push_back(output_buffer_shape);
 
         return false;
     }
@@ -116,6 +139,14 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
         qkv_hidden_sizes[2] = hidden_size - qkv_hidden_sizes[0] - qkv_hidden_sizes[1];
         qkv_head_sizes[2] = static_cast<size_t>(qkv_hidden_sizes[2] / num_heads);
 
+        // Cache is preallocated once and kept on reinitialization for new input shapes
+        if (kv_cache_size > 0 && (k_cache.empty() || k_cache.size[0] != static_cast<int>(batch_size * num_heads))) {
+            const int cache_rows = static_cast<int>(batch_size * num_heads);
+            k_cache.create(std::vector<int>{cache_rows, static_cast<int>(kv_cache_size), static_cast<int>(qkv_head_sizes[1])}, CV_32F);
+            v_cache.create(std::vector<int>{cache_rows, static_cast<int>(kv_cache_size), static_cast<int>(qkv_head_sizes[2])}, CV_32F);
+            kv_cache_len = 0;
+        }
+
         if (!blobs.empty()) {
             const auto *weight_data = weight.ptr<const float>();
             packWeight(num_heads, qkv_head_sizes[0], input_hidden_size, weight_data,                                             hidden_size, packed_weight_q, opt);
@@ -155,12 +186,37 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
         float *packed_weights[3] = {packed_weight_q.data(), packed_weight_k.data(), packed_weight_v.data()};
         size_t packed_weights_size[3] = {packed_weight_q.size() / num_heads, packed_weight_k.size() / num_heads, packed_weight_v.size() / num_heads};
 
-        // Compute Q/K/V
+        // Q, K, V: [B, N, S, H]. K and V of new tokens are written to rows [past_seq_len, total_seq_len) of
+        // present output or KV cache after keys and values of the past tokens.
         auto &gemm_buffer = internals[0];
         auto *Q = gemm_buffer.ptr<float>();
         auto *K = Q + batch_size * seq_len * qkv_hidden_sizes[0];
         auto *V = K + batch_size * seq_len * qkv_hidden_sizes[1];
-        float *QKV[3] = {Q, K, V}; // Q, K, V: [B, N, S, H]
+        size_t past_seq_len = 0, total_seq_len = seq_len, kv_rows_per_head = seq_len;
+        if (outputs.size() > 1) {
+            Mat &present = outputs[1];
+            total_seq_len = kv_rows_per_head = present.size[3];
+            past_seq_len = total_seq_len - seq_len;
+            K = present.ptr<float>();
+            V = K + present.total() / 2;
+            if (past_seq_len > 0) {
+                const Mat &past = inputs.back();
+                CV_CheckTypeEQ(past.type(), CV_32F, "DNN/Attention: unsupported type of past");
+                copyPast(past.ptr<const float>(), K, past_seq_len, total_seq_len, qkv_head_sizes[1]);
+                copyPast(past.ptr<const float>() + past.total() / 2, V, past_seq_len, total_seq_len, qkv_head_sizes[2]);
+            }
+        } else if (kv_cache_size > 0) {
+            CV_CheckLE(kv_cache_len + seq_len, kv_cache_size, "DNN/Attention: KV cache is full, call resetCache() to start a new sequence");
+            CV_CheckEQ(k_cache.size[0], static_cast<int>(batch_size * num_heads), "DNN/Attention: batch size can't be changed until resetCache() is called");
+            past_seq_len = kv_cache_len;
+            total_seq_len = kv_cache_len + seq_len;
+            kv_rows_per_head = kv_cache_size;
+            K = k_cache.ptr<float>();
+            V = v_cache.ptr<float>();
+        }
+        const size_t rows_per_head[3] = {seq_len, kv_rows_per_head, kv_rows_per_head};
+        const size_t row_offset[3] = {0, past_seq_len, past_seq_len};
+        float *QKV[3] = {Q, K, V};
         {
             const auto &input = inputs[0];
             const auto &bias = blobs.empty() ? inputs[2] : blobs.back();
@@ -177,9 +233,9 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
                     auto *dst = QKV[qkv_index];
                     size_t head_size = qkv_head_sizes[qkv_index];
 
-                    int input_offset = batch_index * seq_len * input_hidden_size;
-                    int bias_offset = qkv_index * qkv_hidden_sizes[0] + head_index * head_size;
-                    int dst_offset = (batch_index * num_heads + head_index) * (seq_len * head_size);
+                    size_t input_offset = batch_index * seq_len * input_hidden_size;
+                    size_t bias_offset = qkv_index * qkv_hidden_sizes[0] + head_index * head_size;
+                    size_t dst_offset = ((batch_index * num_heads + head_index) * rows_per_head[qkv_index] + row_offset[qkv_index]) * head_size;
 
                     // broadcast bias ([NH] -> [BN, SH]) and make copy to dst
                     const auto *bias_data_src = bias_data + bias_offset;
@@ -202,77 +258,57 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
             parallel_for_(Range(0, loops), fn, nstripes);
         }
 
-        // Compute Softmax(scale * MatMul(Q, K))
-        auto &attention_prob = internals[1];
-        {
-            auto *output = attention_prob.ptr<float>();
-
-            auto loops = batch_size * num_heads;
-            auto seq_len_square = seq_len * seq_len;
-            auto qk_head_size = qkv_head_sizes[0];
-            auto qk_inner_size = seq_len * qk_head_size;
-
-            // Compute scale * matmul(Q, K)
-            opt.multi_thread = false;
-            parallel_for_(Range(0, loops), [&] (const Range r) {
-                for (int i = r.start; i < r.end; i++) {
-                    const int output_offset = i * seq_len_square;
+        // Compute Softmax(scale * MatMul(Q, K)) * V
+        fastAttention(Q, K, V, outputs[0].ptr<float>(),
+                      batch_size, num_heads, seq_len, total_seq_len, qkv_head_sizes[0], qkv_head_sizes[2],
+                      kv_rows_per_head * qkv_head_sizes[1], kv_rows_per_head * qkv_head_sizes[2], unidirectional, scale, opt);
 
-                    const auto *q = Q + qk_inner_size * i, *k = K + qk_inner_size * i;
-                    fastGemm(false, true, seq_len, qk_head_size, seq_len, qk_head_size,
-                             scale, q, qk_head_size, 1,
-                             k, qk_head_size, 1, 0.f,
-                             output + output_offset, seq_len, opt);
-                }
-            }, loops * seq_len * qk_head_size * seq_len * (1 / 1024.0));
+        if (kv_cache_size > 0)
+            kv_cache_len = total_seq_len;
+    }
 
-            // Compute softmax on the last dimension
-            softmax(attention_prob, attention_prob, shape(attention_prob).size() - 1);
-        }
+    virtual void resetCache() CV_OVERRIDE {
+        kv_cache_len = 0;
+    }
 
-        // Compute MatMul(attention_prob, V)
-        auto &output_buffer = internals[2];
-        {
-            auto *output = outputs[0].ptr<float>();
-            auto *output_buff = output_buffer.ptr<float>();
-            const auto *prob = attention_prob.ptr<const float>();
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE
+    {
+        // Q, K and V projection is quantized. Scale of its output is collected at calibration.
+        if (blobs.empty() || !params.has("qkv_scale") || kv_cache_size > 0 || has_present || unidirectional)
+            return false;
 
-            auto loops = batch_size * num_heads;
-            auto prob_inner_size = seq_len * seq_len;
-            auto v_head_size = qkv_head_sizes[2];
-            auto v_inner_size = seq_len * v_head_size;
+        float inputScale = scales[0][0], qkvScale = params.get<float>("qkv_scale");
+        int inputZp = zeropoints[0][0];
+        bool perChannel = params.get<bool>("per_channel", true);
 
-            opt.multi_thread = false;
-            parallel_for_(Range(0, loops), [&] (const Range &r) {
-                for (int i = r.start; i < r.end; i++) {
-                    const int output_offset = i * v_inner_size;
-
-                    const auto *p = prob + i * prob_inner_size, *v = V + i * v_inner_size;
-                    fastGemm(false, false, seq_len, seq_len, seq_len, v_head_size,
-                             1.f, p, seq_len, 1,
-                             v, v_head_size, 1, 0.f,
-                             output_buff + output_offset, v_head_size, opt);
-
-                    // tranpose on the fly
-                    const int batch_index = static_cast<int>(i / num_heads);
-                    const int head_index = static_cast<int>(i % num_heads);
-                    auto *src = output_buff + output_offset;
-                    auto *dst = output + (batch_index * seq_len * num_heads + head_index) * v_head_size;
-                    for (int j = 0; j < seq_len; j++) {
-                        std::memcpy(dst, src, v_head_size * sizeof(float));
-                        src += v_head_size;
-                        dst += qkv_hidden_sizes[2];
-                    }
-                }
-            }, loops * seq_len * seq_len * v_head_size * (1 / 1024.0));
-        }
+        Mat weightsT = blobs.front().t();  // [hidden_size, input_hidden_size]
+        quantizeFullyConnectedWeights(weightsT, blobs.back().reshape(1, 1), inputScale, inputZp, qkvScale, perChannel, params);
+        return true;
     }
 
  private:
+    // Copies past keys or values [B * N, past_seq_len, H] to rows of present [B * N, total_seq_len, H]
+    void copyPast(const float *past, float *present, size_t past_seq_len, size_t total_seq_len, size_t head_size) const {
+        parallel_for_(Range(0, static_cast<int>(batch_size * num_heads)), [&](const Range &r) {
+            for (int i = r.start; i < r.end; i++)
+                std::memcpy(present + i * total_seq_len * head_size, past + i * past_seq_len * head_size,
+                            past_seq_len * head_size * sizeof(float));
+        });
+    }
+
     size_t num_heads;
     std::vector<size_t> qkv_hidden_sizes; // order: {qk_hidden_size, qk_hidden_size, v_hidden_size}
     float scale;
     size_t output_ndims;
+    bool unidirectional;  // causal mask: token attends to itself and previous tokens only
+    bool has_present;     // output keys and values of past and new tokens
+
+    // Internal KV cache for incremental decoding: [B * N, kv_cache_size, H],
+    // first kv_cache_len rows of each head are filled by previous forward calls.
+    size_t kv_cache_size;
+    size_t kv_cache_len;
+    Mat k_cache, v_cache;
 
     std::vector<size_t> qkv_head_sizes; // order: {qk_head_size, qk_head_size, v_head_size}
 
@@ -289,6 +325,8 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
     FastGemmOpt opt;
 };
 
+void AttentionLayer::resetCache() {}
+
 Ptr<AttentionLayer> AttentionLayer::create(const LayerParams &params) {
     return makePtr<AttentionLayerImpl>(params);
 }
@@ -243,7 +243,7 @@ public:
 
 
 //TODO: simultaneously convolution and bias addition for cache optimization
-class ConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl
+class ConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl, public ChannelsLastLayer
 {
 public:
     enum { VEC_ALIGN = 8, DFT_TYPE = CV_32F };
@@ -452,12 +452,20 @@ public:
 
     bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
     {
-        if ((!activ.empty() && !layer.empty()) || blobs.empty())
+        if (blobs.empty())
             return false;
+        if (!activ.empty() && !layer.empty())
+        {
+            // CPU implementation applies fused operations to the output tile by tile, so they may be chained
+            if (!IS_DNN_CPU_TARGET(preferableTarget))
+                return false;
+            activ = PointwiseChainLayer::append(activ, layer);
+            reluslope.clear();
+            return true;
+        }
 
         activ = layer;
-        if (activ.empty())
-            reluslope.clear();
+        reluslope.clear();
 #ifdef HAVE_OPENCL
         newActiv = true;
         activType = OCL4DNN_CONV_FUSED_ACTIV_NONE;
@@ -1196,6 +1204,14 @@ public:
     }
 #endif
 
+    int getChannelsLastRole(const std::vector<MatShape>& inputs) const CV_OVERRIDE
+    {
+        if (blobs.empty() || inputs.size() != 1 || inputs[0].size() != 4 || kernel_size.size() != 2 ||
+            preferableTarget != DNN_TARGET_CPU)
+            return CHANNELS_LAST_UNSUPPORTED;
+        return CHANNELS_LAST_SUPPORTED;
+    }
+
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
     {
         CV_TRACE_FUNCTION();
@@ -1257,8 +1273,8 @@ public:
         int ngroups = inputs[0].size[1] / inpGroupCn;
         CV_Assert(outputs[0].size[1] % ngroups == 0);
 
-        reluslope.clear();
-        if( activ )
+        // computed once, so forward() of the compiled layer is re-entrant (see Net::createExecutionContext)
+        if( activ && reluslope.empty() )
         {
             Ptr<ReLULayer> activ_relu = activ.dynamicCast<ReLULayer>();
             if( !activ_relu.empty() )
@@ -1286,9 +1302,26 @@ public:
             if (inputs[0].dims == 5)
                 conv_dim = CONV_3D;
 
+            if (channelsLast)
+            {
+                if (!fastConvImpl || !fastConvImpl->channelsLast)
+                {
+                    // weightsMat is released after packing if the layer is not finalized again
+                    Mat wm = weightsMat.empty() ? blobs[0].reshape(1, numOutput) : weightsMat;
+                    fastConvImpl = initFastConvChannelsLast(wm, &biasvec[0], ngroups, outputs[0].size[1],
+                                                            inputs[0].size[1], kernel_size, strides, dilations,
+                                                            pads_begin, pads_end);
+                    weightsMat.release();
+                }
+                runFastConvChannelsLast(inputs[0], outputs[0], fastConvImpl, activ, fusedAdd);
+                return;
+            }
+
             // Initialization of FastCovn2d, pack weight.
-            if (!fastConvImpl || variableWeight)
+            if (!fastConvImpl || variableWeight || fastConvImpl->channelsLast)
             {
+                if (weightsMat.empty())
+                    weightsMat = blobs[0].reshape(1, numOutput);
                 int K = outputs[0].size[1];
                 int C = inputs[0].size[1];
 
@@ -0,0 +1,284 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "convolution.hpp"
+#include "fast_gemm.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv { namespace dnn {
+
+namespace {
+
+// Number of output pixels of a task of the im2row convolution. Their patches are multiplied by the weights at once.
+const int CONV_NHWC_BLOCK_ROWS = 64;
+
+// Adds bias to n channels of a pixel starting from channel c0, then applies the fused activation
+void finishPixel(float* out, int n, int c0, const float* bias, float minval, float maxval, const ActivationLayer* activ)
+{
+    int j = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_float32>::vlanes();
+    v_float32 vminval = vx_setall_f32(minval), vmaxval = vx_setall_f32(maxval);
+    for (; j <= n - nlanes; j += nlanes)
+    {
+        v_float32 v = v_add(vx_load(out + j), vx_load(bias + c0 + j));
+        v_store(out + j, v_min(v_max(v, vminval), vmaxval));
+    }
+#endif
+    for (; j < n; j++)
+        out[j] = std::min(std::max(out[j] + bias[c0 + j], minval), maxval);
+    if (activ)
+        activ->forwardSlice(out, out, 1, 1, c0, c0 + n);
+}
+
+// Output columns of a group are channels g*Kg ... (g + 1)*Kg - 1 of the NHWC output
+struct ChannelsLastEpilogue CV_FINAL : public FastGemmEpilogue
+{
+    ChannelsLastEpilogue(const float* bias_, int cn0_, float minval_, float maxval_, const ActivationLayer* activ_)
+        : bias(bias_), cn0(cn0_), minval(minval_), maxval(maxval_), activ(activ_) {}
+
+    void apply(float* c, int ldc, int m, int n, int j0) const CV_OVERRIDE
+    {
+        for (int i = 0; i < m; i++)
+            finishPixel(c + (size_t)i * ldc, n, cn0 + j0, bias, minval, maxval, activ);
+    }
+
+    const float* bias;
+    int cn0;
+    float minval, maxval;
+    const ActivationLayer* activ;
+};
+
+void runDepthwiseChannelsLast(const float* inp, float* out, int N, int H, int W, int H0, int W0,
+                              const Ptr<FastConv>& conv, bool fusedAdd,
+                              float minval, float maxval, const ActivationLayer* activ)
+{
+    const int C = conv->C, Hk = conv->Hk, Wk = conv->Wk;
+    const int stride_h = conv->stride_h, stride_w = conv->stride_w;
+    const int dilation_h = conv->dilation_h, dilation_w = conv->dilation_w;
+    const int pad_top = conv->pad_top, pad_left = conv->pad_left;
+    const float* weights = conv->weightsBuf.data();
+    const float* bias = conv->biasBuf.data();
+
+    parallel_for_(Range(0, N * H0), [&](const Range& range)
+    {
+        for (int row = range.start; row < range.end; row++)
+        {
+            const int n = row / H0, y0 = row % H0;
+            const float* inpImg = inp + (size_t)n * H * W * C;
+            for (int x0 = 0; x0 < W0; x0++)
+            {
+                // The fused addend is already in the output
+                float* outPix = out + ((size_t)row * W0 + x0) * C;
+                if (!fusedAdd)
+                    memset(outPix, 0, C * sizeof(outPix[0]));
+                for (int ky = 0; ky < Hk; ky++)
+                {
+                    const int yi = y0 * stride_h - pad_top + ky * dilation_h;
+                    if (yi < 0 || yi >= H)
+                        continue;
+                    for (int kx = 0; kx < Wk; kx++)
+                    {
+                        const int xi = x0 * stride_w - pad_left + kx * dilation_w;
+                        if (xi < 0 || xi >= W)
+                            continue;
+                        const float* inpPix = inpImg + ((size_t)yi * W + xi) * C;
+                        const float* w = weights + (ky * Wk + kx) * C;
+                        int c = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+                        const int nlanes = VTraits<v_float32>::vlanes();
+                        for (; c <= C - nlanes; c += nlanes)
+                            v_store(outPix + c, v_fma(vx_load(inpPix + c), vx_load(w + c), vx_load(outPix + c)));
+#endif
+                        for (; c < C; c++)
+                            outPix[c] += inpPix[c] * w[c];
+                    }
+                }
+                finishPixel(outPix, C, 0, bias, minval, maxval, activ);
+            }
+        }
+    });
+}
+
+}  // namespace
+
+Ptr<FastConv> initFastConvChannelsLast(
+        InputArray _weightsMat,
+        float* srcBias,
+        int ngroups,
+        int K, int C,
+        const std::vector<size_t>& kernel_size,
+        const std::vector<size_t>& strides,
+        const std::vector<size_t>& dilations,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end)
+{
+    Ptr<FastConv> conv = makePtr<FastConv>();
+    CV_Assert(ngroups > 0 && K > 0 && C > 0 && K % ngroups == 0 && C % ngroups == 0);
+    CV_Assert(kernel_size.size() == 2 && strides.size() == 2 && dilations.size() == 2 &&
+              pads_begin.size() == 2 && pads_end.size() == 2);
+
+    conv->channelsLast = true;
+    conv->conv_dim = CONV_2D;
+    conv->ngroups = ngroups;
+    conv->K = K; conv->C = C;
+    conv->Dk = 1; conv->Hk = (int)kernel_size[0]; conv->Wk = (int)kernel_size[1];
+    conv->stride_d = 1; conv->stride_h = (int)strides[0]; conv->stride_w = (int)strides[1];
+    conv->dilation_d = 1; conv->dilation_h = (int)dilations[0]; conv->dilation_w = (int)dilations[1];
+    conv->pad_front = conv->pad_behind = 0;
+    conv->pad_top = (int)pads_begin[0]; conv->pad_left = (int)pads_begin[1];
+    conv->pad_bottom = (int)pads_end[0]; conv->pad_right = (int)pads_end[1];
+    CV_Assert(conv->Hk > 0 && conv->Wk > 0 && conv->stride_h > 0 && conv->stride_w > 0 &&
+              conv->dilation_h > 0 && conv->dilation_w > 0);
+
+    Mat weightsMat = _weightsMat.getMat();
+    const int ksize = conv->Hk * conv->Wk, Kg = K / ngroups, Cg = C / ngroups;
+    CV_Assert(weightsMat.type() == CV_32F && weightsMat.rows == K && weightsMat.cols >= Cg * ksize);
+
+    if (ngroups == C && ngroups == K)
+    {
+        // Depth-wise: a row of weights per kernel position, element per channel
+        conv->conv_type = CONV_TYPE_DEPTHWISE;
+        conv->weightsBuf.resize((size_t)ksize * C);
+        for (int c = 0; c < C; c++)
+        {
+            const float* w = weightsMat.ptr<float>(c);
+            for (int k = 0; k < ksize; k++)
+                conv->weightsBuf[(size_t)k * C + c] = w[k];
+        }
+    }
+    else
+    {
+        // Rows of input patches are (ky, kx, c) ordered, so are the weights of every output channel
+        conv->conv_type = CONV_TYPE_GENERIC;
+        Mat weights({ngroups, Kg, ksize * Cg}, CV_32F);
+        for (int k = 0; k < K; k++)
+        {
+            const float* src = weightsMat.ptr<float>(k);
+            float* dst = weights.ptr<float>(k / Kg, k % Kg);
+            for (int c = 0; c < Cg; c++)
+                for (int i = 0; i < ksize; i++)
+                    dst[i * Cg + c] = src[c * ksize + i];
+        }
+        FastGemmOpt opt;
+        opt.init();
+        fastGemmPackB(weights, conv->weightsBuf, true, opt);
+    }
+
+    conv->biasBuf.resize(K);
+    for (int k = 0; k < K; k++)
+        conv->biasBuf[k] = srcBias ? srcBias[k] : 0.f;
+    return conv;
+}
+
+void runFastConvChannelsLast(InputArray _input, OutputArray _output, const Ptr<FastConv>& conv,
+                             const Ptr<ActivationLayer>& actLayer, bool fusedAdd)
+{
+    Mat input = _input.getMat();
+    Mat output = _output.getMat();
+    CV_Assert_N(conv->channelsLast, input.dims == 4, output.dims == 4,
+                input.type() == CV_32F, output.type() == CV_32F,
+                input.size[0] == output.size[0], conv->C == input.size[1], conv->K == output.size[1],
+                input.isContinuous(), output.isContinuous());
+
+    const int N = input.size[0], C = conv->C, H = input.size[2], W = input.size[3];
+    const int K = conv->K, H0 = output.size[2], W0 = output.size[3];
+    const float* inp = input.ptr<float>();
+    float* out = output.ptr<float>();
+
+    // Same choice of fused activation as in runFastConv()
+    ActivationLayer* activ = actLayer.get();
+    float minval = -FLT_MAX, maxval = FLT_MAX;
+    Ptr<ReLULayer> activ_relu = actLayer.dynamicCast<ReLULayer>();
+    Ptr<ReLU6Layer> activ_relu6 = actLayer.dynamicCast<ReLU6Layer>();
+    if (activ_relu && activ_relu->negativeSlope == 0.0f)
+    {
+        minval = 0.0f;
+        activ = nullptr;
+    }
+    else if (activ_relu6)
+    {
+        minval = activ_relu6->minValue;
+        maxval = activ_relu6->maxValue;
+        activ = nullptr;
+    }
+
+    if (conv->conv_type == CONV_TYPE_DEPTHWISE)
+    {
+        reportKernel("depthwise_nhwc");
+        runDepthwiseChannelsLast(inp, out, N, H, W, H0, W0, conv, fusedAdd, minval, maxval, activ);
+        return;
+    }
+
+    const int ngroups = conv->ngroups, Kg = K / ngroups, Cg = C / ngroups;
+    const int Hk = conv->Hk, Wk = conv->Wk, ksize = Hk * Wk, patchSize = ksize * Cg;
+    const int stride_h = conv->stride_h, stride_w = conv->stride_w;
+    const int dilation_h = conv->dilation_h, dilation_w = conv->dilation_w;
+    const int pad_top = conv->pad_top, pad_left = conv->pad_left;
+    const int rows = N * H0 * W0;
+    const float* bias = conv->biasBuf.data();
+    const float beta = fusedAdd ? 1.f : 0.f;  // the fused addend is already in the output
+
+    FastGemmOpt opt;
+    opt.init();
+    const size_t packedSize = fastGemmPackBSize(Kg, patchSize, opt);
+    const float* weights = conv->weightsBuf.data();
+
+    if (ksize == 1 && stride_h == 1 && stride_w == 1 && pad_top == 0 && pad_left == 0 &&
+        conv->pad_bottom == 0 && conv->pad_right == 0)
+    {
+        // Pixels of NHWC input are the rows of the matrix multiplication
+        reportKernel("1x1_nhwc");
+        for (int g = 0; g < ngroups; g++)
+        {
+            ChannelsLastEpilogue epilogue(bias, g * Kg, minval, maxval, activ);
+            opt.epilogue = &epilogue;
+            fastGemm(false, rows, Kg, Cg, 1.f, inp + g * Cg, C, weights + g * packedSize, beta,
+                     out + g * Kg, K, opt);
+        }
+        return;
+    }
+
+    reportKernel("im2row_nhwc");
+    opt.multi_thread = false;  // tasks are blocks of output pixels
+    const int nblocks = (rows + CONV_NHWC_BLOCK_ROWS - 1) / CONV_NHWC_BLOCK_ROWS;
+    parallel_for_(Range(0, nblocks), [&](const Range& range)
+    {
+        AutoBuffer<float> patchesBuf((size_t)CONV_NHWC_BLOCK_ROWS * patchSize);
+        float* patches = patchesBuf.data();
+        FastGemmOpt blockOpt = opt;
+        for (int block = range.start; block < range.end; block++)
+        {
+            const int r0 = block * CONV_NHWC_BLOCK_ROWS, r1 = std::min(r0 + CONV_NHWC_BLOCK_ROWS, rows);
+            for (int g = 0; g < ngroups; g++)
+            {
+                for (int r = r0; r < r1; r++)
+                {
+                    const int n = r / (H0 * W0), y0 = (r / W0) % H0, x0 = r % W0;
+                    const float* inpImg = inp + (size_t)n * H * W * C + g * Cg;
+                    float* patch = patches + (size_t)(r - r0) * patchSize;
+                    for (int ky = 0; ky < Hk; ky++)
+                    {
+                        const int yi = y0 * stride_h - pad_top + ky * dilation_h;
+                        for (int kx = 0; kx < Wk; kx++, patch += Cg)
+                        {
+                            const int xi = x0 * stride_w - pad_left + kx * dilation_w;
+                            if (yi < 0 || yi >= H || xi < 0 || xi >= W)
+                                memset(patch, 0, Cg * sizeof(patch[0]));
+                            else
+                                memcpy(patch, inpImg + ((size_t)yi * W + xi) * C, Cg * sizeof(patch[0]));
+                        }
+                    }
+                }
+                ChannelsLastEpilogue epilogue(bias, g * Kg, minval, maxval, activ);
+                blockOpt.epilogue = &epilogue;
+                fastGemm(false, r1 - r0, Kg, patchSize, 1.f, patches, patchSize, weights + g * packedSize, beta,
+                         out + (size_t)r0 * K + g * Kg, K, blockOpt);
+            }
+        }
+    });
+}
+
+}} // namespace cv::dnn
@@ -15,6 +15,7 @@
 #include "conv_block.simd.hpp"
 #include "layers/cpu_kernels/conv_block.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
 #include <opencv2/core/utils/logger.hpp>
+#include "opencv2/core/hal/hal.hpp"
 
 namespace cv { namespace dnn {
 enum { VEC_ALIGN = 32}; // Memory alignment.
@@ -191,9 +192,20 @@ Ptr<FastConv> initFastConv(
         CV_LOG_ONCE_WARNING(NULL, "DNN: the CPU does not support the instruction set required by FP16, fallback to FP32.");
     }
 #endif
+    // Without FP16 arithmetic we still can halve the memory footprint of the generic convolution weights.
+    conv->useFP16Weights = _useFP16 && !conv->useFP16 && conv->conv_type == CONV_TYPE_GENERIC;
 
     float *srcWeights = (float *)weightsMat.data;
-    if (conv->conv_type == CONV_TYPE_DEPTHWISE || conv->conv_type == CONV_TYPE_DEPTHWISE_REMAIN)
+    // 1x1 convolution with pruned weights is computed by the sparse kernel only
+    bool is1x1 = ngroups == 1 && karea == 1 && stride_d == 1 && stride_h == 1 && stride_w == 1 &&
+                 conv->pad_front == 0 && conv->pad_top == 0 && conv->pad_left == 0 &&
+                 conv->pad_behind == 0 && conv->pad_bottom == 0 && conv->pad_right == 0;
+    if (conv->conv_type == CONV_TYPE_GENERIC && !conv->useFP16 && is1x1 &&
+        packSparseWeights(weightsMat, conv->sparseWeights))
+    {
+        conv->useFP16Weights = false;
+    }
+    else if (conv->conv_type == CONV_TYPE_DEPTHWISE || conv->conv_type == CONV_TYPE_DEPTHWISE_REMAIN)
     {
         // Handle the Conv1D, Conv2D and Conv3D depth-wise.
         // for depth-wise convolutions on NCHW data we just preserve the weights in KCHW layout,
@@ -376,6 +388,11 @@ Ptr<FastConv> initFastConv(
         }
         else
 #endif
+        if (conv->useFP16Weights)
+        {
+            conv->weightsBuf_FP16.resize(nweights + VEC_ALIGN);
+        }
+        else
         {
             conv->weightsBuf.resize(nweights + VEC_ALIGN);
             weightsPtr = conv->getWeights();
@@ -424,20 +441,28 @@ Ptr<FastConv> initFastConv(
                 int startK = si * CONV_MR_FP32;
                 CV_Assert(startK < Kg_aligned);
 
-                float* packed_wptr = weightsPtr + DkHkWkCg * (startK + g * Kg_aligned);
+                float packed_strip[CONV_MR_FP32];
+                size_t packed_ofs = DkHkWkCg * (startK + g * Kg_aligned);
                 int dk = Kg - startK < CONV_MR_FP32 ? Kg - startK : CONV_MR_FP32; // check if we need zero padding.
 
                 int k_idx = g*Kg + startK;
                 for(int hwd = 0; hwd < Hk*Wk*Dk; hwd++)
                 {
-                    for(int c = 0; c < Cg; c++, packed_wptr += CONV_MR_FP32)
+                    for(int c = 0; c < Cg; c++, packed_ofs += CONV_MR_FP32)
                     {
+                        float* packed_wptr = weightsPtr ? weightsPtr + packed_ofs : packed_strip;
                         const float* wptr = srcWeights + wstep * k_idx + c*Hk*Wk*Dk + hwd;
                         int k = 0;
                         for(; k < dk; k++, wptr += wstep)
                             packed_wptr[k] = *wptr;
                         for(; k < CONV_MR_FP32; k++)
                             packed_wptr[k] = 0.f;
+                        if (!weightsPtr)
+                        {
+                            hfloat* packed_wptr_FP16 = conv->getWeightsFP16() + packed_ofs;
+                            for(k = 0; k < CONV_MR_FP32; k++)
+                                packed_wptr_FP16[k] = hfloat(packed_strip[k]);
+                        }
                     }
                 }
             }});
@@ -1122,6 +1147,7 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
     {
         // Depthwise-Convolution layer should not be followed by Add layer.
         CV_Assert((conv_dim == CONV_1D || conv_dim == CONV_2D) && !useFP16);
+        reportKernel("depthwise");
         return runDepthwise(input, output, conv, actLayer.get(), reluslope, fusedAdd);
     }
 
@@ -1166,12 +1192,27 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
     else
         activ = nullptr;
 
+    if (!conv->sparseWeights.empty())
+    {
+        CV_CheckTypeEQ(input.type(), CV_32F, "");
+        reportKernel(conv->sparseWeights.kernelName());
+        int planeSize = (int)(output.total() / ((size_t)output.size[0] * conv->K));
+        runSparseConv1x1(conv->sparseWeights, conv->biasBuf.data(), input.ptr<float>(), output.ptr<float>(),
+                         output.size[0], planeSize, fusedAdd, minval, maxval, activ);
+        return;
+    }
+
     if (conv->conv_type == CONV_TYPE_WINOGRAD3X3) // winograd
     {
         CV_Assert((!conv->weightsWinoBuf.empty() || !conv->weightsWinoBuf_FP16.empty()) && input.dims == 4 && conv_dim == CONV_2D);
         if (runWinograd63(input, fusedAddMat, output, conv, ntasks, minval, maxval, activ, ifMinMaxAct))
+        {
+            reportKernel("winograd");
             return;
+        }
     }
+    reportKernel(conv->conv_type == CONV_TYPE_DEPTHWISE_REMAIN ? "depthwise" :
+                 conv->useFP16Weights ? "im2row_fp16" : "im2row");
 
     int N = inputShape[0], C = inputShape[1];
 
@@ -1294,6 +1335,13 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
     if (!separateIm2col)
         taskbufsize += MAX_STRIPES * stripesize * esz;
 
+    // FP16 weights of the current (K_BLOCK_SIZE x C_BLOCK_SIZE) block are widened into the task buffer.
+    const bool useFP16Weights = conv->useFP16Weights;
+    const int wesz = useFP16Weights ? (int)sizeof(hfloat) : esz;
+    size_t wbufofs = taskbufsize;
+    if (useFP16Weights)
+        taskbufsize += alignSize(K_BLOCK_SIZE * C_BLOCK_SIZE, VEC_ALIGN) * sizeof(float );
+
     size_t totalbufsize_base = taskbufsize * ntasks;
     size_t totalbufsize = totalbufsize_base;
     if (separateIm2col)
@@ -1373,6 +1421,7 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
     {
         float * cbuf_task = (float *)(inpbuf_all + taskbufsize * task_id);
         char * inpbuf_task = (char*)(cbuf_task + cbufsize);
+        float * wbuf_task = (float *)(inpbuf_all + taskbufsize * task_id + wbufofs);
 
         int ngs0 = (int)((size_t)nsubtasks * task_id / ntasks);
         int ngs1 = (int)((size_t)nsubtasks * (task_id+1) / ntasks);
@@ -1432,6 +1481,12 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                 }
                 else
 #endif
+                if (useFP16Weights)
+                {
+                    CV_Assert(!conv->weightsBuf_FP16.empty());
+                    weights = (char *)conv->getWeightsFP16();
+                }
+                else
                 {
                     CV_Assert(!conv->weightsBuf.empty());
                     weights = (char *)conv->getWeights();
@@ -1489,7 +1544,7 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                 }
 
                 CV_Assert(weights);
-                weights += g * Kg_aligned * DkHkWkCg * esz;
+                weights += g * Kg_aligned * DkHkWkCg * wesz;
 
                 const float *biasptr = conv->biasBuf.data() + Kg * g;
                 int ldc = nstripes * CONV_NR;
@@ -1505,15 +1560,30 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                         const char *inptr = separateIm2col ? inpbuf_all_0 + (ng * stripes_per_plane0 + zyx0 / CONV_NR) * stripesize * esz :
                                             inpbuf_task;
                         inptr += (c0 * CONV_NR) * esz;
+
+                        char *wptr0 = weights + (k0_block * DkHkWkCg + c0 * CONV_MR) * wesz;
+                        size_t wstep = DkHkWkCg * CONV_MR * esz;
+                        if (useFP16Weights)
+                        {
+                            // widen the block once, it is reused by all the stripes below
+                            int blocksize = (c1 - c0) * CONV_MR;
+                            const hfloat* hptr = (const hfloat*)wptr0;
+                            float* wbuf = wbuf_task;
+                            for (int k = k0_block; k < k1_block; k += CONV_MR, hptr += DkHkWkCg * CONV_MR, wbuf += blocksize)
+                                hal::cvt16f32f(hptr, wbuf, blocksize);
+                            wptr0 = (char *)wbuf_task;
+                            wstep = blocksize * esz;
+                        }
+
                         for (int stripe = 0; stripe < nstripes; stripe++, inptr += stripesize * esz)
                         {
                             const int outLen = std::min(out_width - stripe * CONV_NR, CONV_NR);
 
-                            char *wptr = weights + (k0_block * DkHkWkCg + c0 * CONV_MR) * esz;
+                            char *wptr = wptr0;
                             float *cptr = cbuf_task + stripe * CONV_NR;
                             hfloat* cptr_f16 = (hfloat*)cbuf_task + stripe*CONV_NR;
                             for (int k = k0_block; k < k1_block; k += CONV_MR,
-                                    wptr += DkHkWkCg * CONV_MR * esz, cptr += CONV_MR * ldc, cptr_f16 += CONV_MR * ldc)
+                                    wptr += wstep, cptr += CONV_MR * ldc, cptr_f16 += CONV_MR * ldc)
                             {
 #if CV_TRY_AVX2
                                 if (conv->useAVX2)
@@ -7,6 +7,7 @@
 
 #include "opencv2/core/hal/intrin.hpp"
 #include "opencv2/dnn/all_layers.hpp"
+#include "sparse_gemm.hpp"
 
 #ifndef CONV_PRAM
 #define CONV_PRAM
@@ -57,9 +58,10 @@ struct FastConv
     int dilation_h, dilation_w, dilation_d;
     int pad_top, pad_bottom, pad_left, pad_right, pad_front, pad_behind;
 
-    std::vector<float> weightsBuf;     // For generic Conv 2D
+    std::vector<float> weightsBuf;     // For generic Conv 2D, packed per group for fastGemm() if channelsLast is set
     std::vector<float> weightsWinoBuf; // For Winograd F(6x6, 3x3).
     std::vector<float> biasBuf;
+    SparseWeights sparseWeights;       // For 1x1 Conv with pruned weights, used instead of weightsBuf
     float* getWeights();
     float* getWeightsWino();
 
@@ -71,6 +73,8 @@ struct FastConv
     int conv_type;
     int conv_dim;  // Flag for conv1d, conv2d, or conv3d.
     bool useFP16 = false; // Only ARMv8 is supported.
+    bool useFP16Weights = false; // Weights are stored in FP16 and widened to FP32 block by block, computation is in FP32.
+    bool channelsLast = false; // Input and output are NHWC, see initFastConvChannelsLast().
 #if CV_SIMD128
     bool useSIMD128 = true;
 #else
@@ -110,6 +114,23 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
 void runDepthwise(InputArray _input, OutputArray _output, const Ptr<FastConv>& conv, ActivationLayer* activ,
                   const std::vector<float>& reluslope, bool fusedAdd);
 
+// return a FastConv instance for 2D convolution of channels-last (NHWC) data.
+Ptr<FastConv> initFastConvChannelsLast(
+        InputArray weightsMat,
+        float* srcBias,
+        int ngroups,
+        int K, int C,
+        const std::vector<size_t>& kernel_size,
+        const std::vector<size_t>& strides,
+        const std::vector<size_t>& dilations,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end);
+
+// Input and output keep NCHW shapes, but their data is NHWC: 1x1 convolution is a single matrix multiplication,
+// other ones are computed by fastGemm() over rows of input patches, depthwise convolution is vectorized over channels.
+void runFastConvChannelsLast(InputArray _input, OutputArray _output, const Ptr<FastConv>& conv,
+                             const Ptr<ActivationLayer>& actLayer, bool fusedAdd);
+
 int runWinograd63(InputArray _input, InputArray _fusedAddMat, OutputArray _output, const Ptr<FastConv>& conv, int ntasks,
                   float minval, float maxval, ActivationLayer* activ, bool ifMinMaxAct);
 
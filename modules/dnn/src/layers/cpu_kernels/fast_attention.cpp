@@ -0,0 +1,140 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "fast_attention.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv { namespace dnn {
+
+// Updates running maximum and sum of exponents of the query row with scores of the next block of keys (online softmax).
+// Scores are replaced by exp(score - new_max), the first n of len scores are valid, the rest are set to zero.
+// Returns factor to rescale the output accumulated with the previous blocks.
+static float softmaxUpdateRow(float *scores, int n, int len, float &row_max, float &row_sum) {
+    int j = 0;
+    float block_max = -FLT_MAX;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_float32>::vlanes();
+    v_float32 vmax = vx_setall_f32(-FLT_MAX);
+    for (; j <= n - nlanes; j += nlanes)
+        vmax = v_max(vmax, vx_load(scores + j));
+    block_max = v_reduce_max(vmax);
+#endif
+    for (; j < n; j++)
+        block_max = std::max(block_max, scores[j]);
+
+    const float new_max = std::max(row_max, block_max);
+    float sum = 0.f;
+    j = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    v_float32 vsum = vx_setzero_f32(), vnew_max = vx_setall_f32(new_max);
+    for (; j <= n - nlanes; j += nlanes) {
+        v_float32 v = v_exp(v_sub(vx_load(scores + j), vnew_max));
+        vsum = v_add(vsum, v);
+        v_store(scores + j, v);
+    }
+    sum = v_reduce_sum(vsum);
+#endif
+    for (; j < n; j++) {
+        scores[j] = std::exp(scores[j] - new_max);
+        sum += scores[j];
+    }
+    for (j = n; j < len; j++)
+        scores[j] = 0.f;
+
+    const float alpha = std::exp(row_max - new_max);  // zero for the first block (row_max is -FLT_MAX)
+    row_sum = row_sum * alpha + sum;
+    row_max = new_max;
+    return alpha;
+}
+
+void fastAttention(const float *Q, const float *K, const float *V, float *output,
+                   size_t batch_size, size_t num_heads, size_t seq_len, size_t qk_head_size, size_t v_head_size,
+                   float scale, FastGemmOpt opt) {
+    fastAttention(Q, K, V, output, batch_size, num_heads, seq_len, seq_len, qk_head_size, v_head_size,
+                  seq_len * qk_head_size, seq_len * v_head_size, false, scale, opt);
+}
+
+void fastAttention(const float *Q, const float *K, const float *V, float *output,
+                   size_t batch_size, size_t num_heads, size_t q_len, size_t kv_len, size_t qk_head_size, size_t v_head_size,
+                   size_t k_head_stride, size_t v_head_stride, bool causal, float scale, FastGemmOpt opt) {
+    CV_Assert(kv_len >= q_len);
+
+    // heads and blocks of queries are processed in parallel, so gemm is single-threaded
+    opt.multi_thread = false;
+
+    // Blocks of queries and keys are small enough to keep Q, K and V blocks and block of scores in L2 cache
+    const int block_q = FAST_ATTENTION_BLOCK_Q, block_kv = FAST_ATTENTION_BLOCK_KV;
+    const int q_blocks = (int)((q_len + block_q - 1) / block_q);
+    const size_t loops = batch_size * num_heads * q_blocks;
+    const size_t past_len = kv_len - q_len;
+    const size_t v_hidden_size = num_heads * v_head_size;
+
+    parallel_for_(Range(0, (int)loops), [&] (const Range &r) {
+        AutoBuffer<float> buf(block_q * (block_kv + 2));
+        float *scores = buf.data();  // [block_q, block_kv]
+        float *row_max = scores + block_q * block_kv, *row_sum = row_max + block_q;
+
+        for (int task = r.start; task < r.end; task++) {
+            const int i = task / q_blocks;  // batch * num_heads + head
+            const int q0 = (task % q_blocks) * block_q;
+            const int q_rows = (int)std::min((size_t)block_q, q_len - q0);
+            const int batch_index = static_cast<int>(i / num_heads);
+            const int head_index = static_cast<int>(i % num_heads);
+
+            const float *q = Q + (i * q_len + q0) * qk_head_size;
+            const float *k = K + i * k_head_stride, *v = V + i * v_head_stride;
+            // output is [batch_size, q_len, num_heads * v_head_size], accumulate directly in it
+            float *out = output + (batch_index * q_len + q0) * v_hidden_size + head_index * v_head_size;
+
+            // the last query of the block attends to keys up to its position in causal mode
+            const int kv_end = causal ? (int)(past_len + q0 + q_rows) : (int)kv_len;
+            for (int j = 0; j < q_rows; j++) {
+                row_max[j] = -FLT_MAX;
+                row_sum[j] = 0.f;
+            }
+
+            for (int k0 = 0; k0 < kv_end; k0 += block_kv) {
+                const int kv_rows = std::min(block_kv, kv_end - k0);
+
+                // scores = scale * Q * K^T
+                fastGemm(false, true, q_rows, qk_head_size, kv_rows, qk_head_size,
+                         scale, q, qk_head_size, 1,
+                         k + k0 * qk_head_size, qk_head_size, 1, 0.f,
+                         scores, kv_rows, opt);
+
+                for (int j = 0; j < q_rows; j++) {
+                    float *scores_j = scores + j * kv_rows;
+                    const int n = causal ? std::min(kv_rows, (int)(past_len + q0 + j + 1) - k0) : kv_rows;
+                    if (n <= 0) {
+                        // all keys of the block are masked, accumulated output is unchanged
+                        std::fill(scores_j, scores_j + kv_rows, 0.f);
+                        continue;
+                    }
+                    const float alpha = softmaxUpdateRow(scores_j, n, kv_rows, row_max[j], row_sum[j]);
+                    if (k0 > 0 && alpha != 1.f) {
+                        float *out_j = out + j * v_hidden_size;
+                        for (size_t c = 0; c < v_head_size; c++)
+                            out_j[c] *= alpha;
+                    }
+                }
+
+                // out = out + P * V, the first block initializes output
+                fastGemm(false, false, q_rows, kv_rows, kv_rows, v_head_size,
+                         1.f, scores, kv_rows, 1,
+                         v + k0 * v_head_size, v_head_size, 1, k0 > 0 ? 1.f : 0.f,
+                         out, v_hidden_size, opt);
+            }
+
+            for (int j = 0; j < q_rows; j++) {
+                float *out_j = out + j * v_hidden_size;
+                const float inv_sum = 1.f / row_sum[j];
+                for (size_t c = 0; c < v_head_size; c++)
+                    out_j[c] *= inv_sum;
+            }
+        }
+    }, loops * block_q * kv_len * (qk_head_size + v_head_size) * (1 / 1024.0));
+}
+
+}} // cv::dnn
@@ -0,0 +1,36 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_FAST_ATTENTION_HPP
+#define OPENCV_DNN_FAST_ATTENTION_HPP
+
+#include <opencv2/dnn/shape_utils.hpp>
+#include "fast_gemm.hpp"
+
+namespace cv { namespace dnn {
+
+// Blocks of queries and keys processed at once by tiled attention
+enum { FAST_ATTENTION_BLOCK_Q = 32, FAST_ATTENTION_BLOCK_KV = 256 };
+
+// Scaled dot-product attention Softmax(scale * Q * K^T) * V of all heads, parallelized over batch and heads.
+// Q, K: [batch_size * num_heads, seq_len, qk_head_size], V: [batch_size * num_heads, seq_len, v_head_size].
+// Output is [batch_size, seq_len, num_heads * v_head_size].
+void fastAttention(const float *Q, const float *K, const float *V, float *output,
+                   size_t batch_size, size_t num_heads, size_t seq_len, size_t qk_head_size, size_t v_head_size,
+                   float scale, FastGemmOpt opt);
+
+// Attention of q_len queries to kv_len keys and values, for example, the new tokens to all tokens of KV cache.
+// Q: [batch_size * num_heads, q_len, qk_head_size]. Keys and values of head i start at K + i * k_head_stride
+// and V + i * v_head_stride, so they can be rows of a preallocated cache. If causal is set, query j attends
+// to keys [0, kv_len - q_len + j] only. Output is [batch_size, q_len, num_heads * v_head_size].
+//
+// Score matrix is not materialized: blocks of queries stream over blocks of keys with online softmax
+// (running maximum and sum of exponents per query), so memory is O(block_q * block_kv) per thread.
+void fastAttention(const float *Q, const float *K, const float *V, float *output,
+                   size_t batch_size, size_t num_heads, size_t q_len, size_t kv_len, size_t qk_head_size, size_t v_head_size,
+                   size_t k_head_stride, size_t v_head_stride, bool causal, float scale, FastGemmOpt opt);
+
+}} // cv::dnn
+
+#endif // OPENCV_DNN_FAST_ATTENTION_HPP
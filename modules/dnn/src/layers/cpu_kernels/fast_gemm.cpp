@@ -46,7 +46,8 @@ size_t fastGemmPackBSize(size_t N, size_t K, const FastGemmOpt &opt) {
     }
 }
 
-void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastGemmOpt &opt) {
+template <typename T>
+static void fast_gemm_pack_b(const Mat &B, std::vector<T> &packed_B, bool trans, FastGemmOpt &opt) {
     CV_CheckTypeEQ(B.type(), CV_32F, "fastGemmPackB: only float32 is supported for now");
 
     auto B_shape = shape(B);
@@ -58,7 +59,7 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
     }
 
     const auto *b = B.ptr<const char>();
-    int esz = B.elemSize();
+    int esz = B.elemSize(), besz = sizeof(T);
 
 #if CV_TRY_NEON
     if (opt.use_neon) {
@@ -66,9 +67,9 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
         packed_B.resize(size_packed_B * batch);
         auto *packed_b = (char*)packed_B.data();
         for (int i = 0; i < batch; i++) {
-            opt_NEON::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz);
+            opt_NEON::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz, besz);
             b += N * K * esz;
-            packed_b += size_packed_B * esz;
+            packed_b += size_packed_B * besz;
         }
     } else
 #endif
@@ -78,9 +79,9 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
         packed_B.resize(size_packed_B * batch);
         auto *packed_b = (char*)packed_B.data();
         for (int i = 0; i < batch; i++) {
-            opt_AVX2::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz);
+            opt_AVX2::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz, besz);
             b += N * K * esz;
-            packed_b += size_packed_B * esz;
+            packed_b += size_packed_B * besz;
         }
     } else
 #endif
@@ -90,9 +91,9 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
         packed_B.resize(size_packed_B * batch);
         auto *packed_b = (char*)packed_B.data();
         for (int i = 0; i < batch; i++) {
-            opt_AVX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz);
+            opt_AVX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz, besz);
             b += N * K * esz;
-            packed_b += size_packed_B * esz;
+            packed_b += size_packed_B * besz;
         }
     } else
 #endif
@@ -102,9 +103,9 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
         packed_B.resize(size_packed_B * batch);
         auto *packed_b = (char*)packed_B.data();
         for (int i = 0; i < batch; i++) {
-            opt_LASX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz);
+            opt_LASX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz, besz);
             b += N * K * esz;
-            packed_b += size_packed_B * esz;
+            packed_b += size_packed_B * besz;
         }
     } else
 #endif
@@ -113,14 +114,22 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
         packed_B.resize(size_packed_B * batch);
         auto *packed_b = (char*)packed_B.data();
         for (int i = 0; i < batch; i++) {
-            cpu_baseline::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz);
+            cpu_baseline::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, esz, besz);
             b += N * K * esz;
-            packed_b += size_packed_B * esz;
+            packed_b += size_packed_B * besz;
         }
     }
 }
 
-void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, float *packed_B, const FastGemmOpt &opt) {
+void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastGemmOpt &opt) {
+    fast_gemm_pack_b(B, packed_B, trans, opt);
+}
+
+void fastGemmPackB(const Mat &B, std::vector<hfloat> &packed_B, bool trans, FastGemmOpt &opt) {
+    fast_gemm_pack_b(B, packed_B, trans, opt);
+}
+
+static void fast_gemm_pack_b(bool trans, size_t N, size_t K, const float *B, size_t ldb, char *packed_b, int besz, const FastGemmOpt &opt) {
     size_t ldb0 = ldb, ldb1 = 1;
     if (trans) {
         std::swap(K, N);
@@ -128,37 +137,45 @@ void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, f
     }
 
     const auto &b = (const char *)B;
-    auto *packed_b = (char *)packed_B;
 
 #if CV_TRY_NEON
     if (opt.use_neon) {
-        opt_NEON::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float));
+        opt_NEON::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float), besz);
     } else
 #endif
 #if CV_TRY_AVX2
     if (opt.use_avx2) {
-        opt_AVX2::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float));
+        opt_AVX2::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float), besz);
     } else
 #endif
 #if CV_TRY_AVX
     if (opt.use_avx) {
-        opt_AVX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float));
+        opt_AVX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float), besz);
     } else
 #endif
 #if CV_TRY_LASX
     if (opt.use_lasx) {
-        opt_LASX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float));
+        opt_LASX::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float), besz);
     } else
 #endif
     {
-        cpu_baseline::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float));
+        cpu_baseline::fastGemmPackBKernel(b, packed_b, N, K, ldb0, ldb1, sizeof(float), besz);
     }
 }
 
+void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, float *packed_B, const FastGemmOpt &opt) {
+    fast_gemm_pack_b(trans, N, K, B, ldb, (char *)packed_B, sizeof(float), opt);
+}
+
+void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, hfloat *packed_B, const FastGemmOpt &opt) {
+    fast_gemm_pack_b(trans, N, K, B, ldb, (char *)packed_B, sizeof(hfloat), opt);
+}
+
 static void fast_gemm_thin(float alpha, float beta, int M, int N, int K,
                            const char *a_, int lda0, int lda1,
                            const char *b_, int ldb,
-                           char *c_, int ldc, bool multi_thread) {
+                           char *c_, int ldc, bool multi_thread,
+                           const FastGemmEpilogue *epilogue) {
     const float* a = (const float*)a_;
 
     auto fn = [&](const Range &r) {
@@ -174,6 +191,8 @@ static void fast_gemm_thin(float alpha, float beta, int M, int N, int K,
                 for(int j = 0; j < N; j++ )
                     c_i[j] += aval * b_k[j];
             }
+            if (epilogue)
+                epilogue->apply(c_i, ldc, 1, N, 0);
         }
     };
 
@@ -187,12 +206,11 @@ static void fast_gemm_thin(float alpha, float beta, int M, int N, int K,
     }
 }
 
-void fastGemm(bool trans_a, int M, int N, int K,
-              float alpha, const float *A, int lda,
-              const float *packed_B, float beta,
-              float *C, int ldc, FastGemmOpt &opt) {
+static void fast_gemm_packed(bool trans_a, int M, int N, int K,
+                             float alpha, const float *A, int lda,
+                             const char *packed_b, int besz, float beta,
+                             float *C, int ldc, FastGemmOpt &opt) {
     const char *a = (const char *)A;
-    const char *packed_b = (const char *)packed_B;
     char *c = (char *)C;
 
     int lda0 = lda, lda1 = 1;
@@ -202,32 +220,49 @@ void fastGemm(bool trans_a, int M, int N, int K,
 
 #if CV_TRY_NEON
     if (opt.use_neon) {
-        opt_NEON::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_NEON::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), besz, opt.multi_thread, opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX2
     if (opt.use_avx2) {
-        opt_AVX2::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_AVX2::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), besz, opt.multi_thread, opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX
     if (opt.use_avx) {
-        opt_AVX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_AVX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), besz, opt.multi_thread, opt.epilogue);
     } else
 #endif
 #if CV_TRY_LASX
     if (opt.use_lasx) {
-        opt_LASX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_LASX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), besz, opt.multi_thread, opt.epilogue);
     } else
 #endif
     {
-        cpu_baseline::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        cpu_baseline::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), besz, opt.multi_thread, opt.epilogue);
     }
 }
 
+void fastGemm(bool trans_a, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const float *packed_B, float beta,
+              float *C, int ldc, FastGemmOpt &opt) {
+    reportKernel("fastGemm");
+    fast_gemm_packed(trans_a, M, N, K, alpha, A, lda, (const char *)packed_B, sizeof(float), beta, C, ldc, opt);
+}
+
+void fastGemm(bool trans_a, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const hfloat *packed_B, float beta,
+              float *C, int ldc, FastGemmOpt &opt) {
+    reportKernel("fastGemm_fp16");
+    fast_gemm_packed(trans_a, M, N, K, alpha, A, lda, (const char *)packed_B, sizeof(hfloat), beta, C, ldc, opt);
+}
+
 void fastGemm(bool trans_a, bool trans_b, int ma, int na, int mb, int nb,
               float alpha, const float *A, int lda0, int lda1, const float *B, int ldb0, int ldb1,
               float beta, float *C, int ldc, FastGemmOpt &opt) {
+    reportKernel("fastGemm");
     const char *a = (const char *)A;
     const char *b = (const char *)B;
     char *c = (char *)C;
@@ -244,41 +279,41 @@ void fastGemm(bool trans_a, bool trans_b, int ma, int na, int mb, int nb,
     }
 
     if (!trans_b && ldb1 == 1 && (M <= 4 || (uint64_t)M * N * K <= 10000)) {
-        return fast_gemm_thin(alpha, beta, M, N, K, a, lda0, lda1, b, ldb0, c, ldc, opt.multi_thread);
+        return fast_gemm_thin(alpha, beta, M, N, K, a, lda0, lda1, b, ldb0, c, ldc, opt.multi_thread, opt.epilogue);
     }
 
 #if CV_TRY_NEON
     if (opt.use_neon) {
         opt_NEON::fastGemmKernel(M, N, K, alpha, a, lda0, lda1,
                                  b, ldb0, ldb1, beta,
-                                 c, ldc, sizeof(float), opt.multi_thread);
+                                 c, ldc, sizeof(float), opt.multi_thread, opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX2
     if (opt.use_avx2) {
         opt_AVX2::fastGemmKernel(M, N, K, alpha, a, lda0, lda1,
                                  b, ldb0, ldb1, beta,
-                                 c, ldc, sizeof(float), opt.multi_thread);
+                                 c, ldc, sizeof(float), opt.multi_thread, opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX
     if (opt.use_avx) {
         opt_AVX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1,
                                  b, ldb0, ldb1, beta,
-                                 c, ldc, sizeof(float), opt.multi_thread);
+                                 c, ldc, sizeof(float), opt.multi_thread, opt.epilogue);
     } else
 #endif
 #if CV_TRY_LASX
     if (opt.use_lasx) {
         opt_LASX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1,
                                  b, ldb0, ldb1, beta,
-                                 c, ldc, sizeof(float), opt.multi_thread);
+                                 c, ldc, sizeof(float), opt.multi_thread, opt.epilogue);
     } else
 #endif
     {
         cpu_baseline::fastGemmKernel(M, N, K, alpha, a, lda0, lda1,
                                      b, ldb0, ldb1, beta,
-                                     c, ldc, sizeof(float), opt.multi_thread);
+                                     c, ldc, sizeof(float), opt.multi_thread, opt.epilogue);
     }
 }
 
@@ -313,67 +348,83 @@ void fastGemm(bool trans_a, bool trans_b,
 void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                    int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
                    const float *B, int ldb0, int ldb1, float beta, float *C, int ldc, FastGemmOpt &opt) {
+    reportKernel("fastGemmBatch");
     const char *a = (const char *)A;
     const char *b = (const char *)B;
     char *c = (char *)C;
 
 #if CV_TRY_NEON
     if (opt.use_neon) {
-        opt_NEON::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float));
+        opt_NEON::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float), opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX2
     if (opt.use_avx2) {
-        opt_AVX2::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float));
+        opt_AVX2::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float), opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX
     if (opt.use_avx) {
-        opt_AVX::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float));
+        opt_AVX::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float), opt.epilogue);
     } else
 #endif
 #if CV_TRY_LASX
     if (opt.use_lasx) {
-        opt_LASX::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float));
+        opt_LASX::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float), opt.epilogue);
     } else
 #endif
     {
-        cpu_baseline::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float));
+        cpu_baseline::fastGemmBatchKernel(batch, A_offsets, B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, ldb0, ldb1, beta, c, ldc, sizeof(float), opt.epilogue);
     }
 }
 
-void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *packed_B_offsets, const size_t *C_offsets,
-                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
-                   const float *packed_B, float beta, float *C, int ldc, FastGemmOpt &opt) {
+static void fast_gemm_batch_packed(size_t batch, const size_t *A_offsets, const size_t *packed_B_offsets, const size_t *C_offsets,
+                                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
+                                   const char *b, int besz, float beta, float *C, int ldc, FastGemmOpt &opt) {
     const char *a = (const char *)A;
-    const char *b = (const char *)packed_B;
     char *c = (char *)C;
 
 #if CV_TRY_NEON
     if (opt.use_neon) {
-        opt_NEON::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float));
+        opt_NEON::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float), besz, opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX2
     if (opt.use_avx2) {
-        opt_AVX2::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float));
+        opt_AVX2::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float), besz, opt.epilogue);
     } else
 #endif
 #if CV_TRY_AVX
     if (opt.use_avx) {
-        opt_AVX::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float));
+        opt_AVX::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float), besz, opt.epilogue);
     } else
 #endif
 #if CV_TRY_LASX
     if (opt.use_lasx) {
-        opt_LASX::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float));
+        opt_LASX::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float), besz, opt.epilogue);
     } else
 #endif
     {
-        cpu_baseline::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float));
+        cpu_baseline::fastGemmBatchKernel(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, a, lda0, lda1, b, beta, c, ldc, sizeof(float), besz, opt.epilogue);
     }
 }
 
+void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *packed_B_offsets, const size_t *C_offsets,
+                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
+                   const float *packed_B, float beta, float *C, int ldc, FastGemmOpt &opt) {
+    reportKernel("fastGemmBatch");
+    fast_gemm_batch_packed(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, A, lda0, lda1,
+                           (const char *)packed_B, sizeof(float), beta, C, ldc, opt);
+}
+
+void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *packed_B_offsets, const size_t *C_offsets,
+                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
+                   const hfloat *packed_B, float beta, float *C, int ldc, FastGemmOpt &opt) {
+    reportKernel("fastGemmBatch_fp16");
+    fast_gemm_batch_packed(batch, A_offsets, packed_B_offsets, C_offsets, M, N, K, alpha, A, lda0, lda1,
+                           (const char *)packed_B, sizeof(hfloat), beta, C, ldc, opt);
+}
+
 void fastGemmBatch(bool trans_a, bool trans_b,
                    float alpha, const Mat &A, const Mat &B,
                    float beta, Mat &C, FastGemmOpt &opt) {
@@ -17,12 +17,22 @@
 
 namespace cv { namespace dnn {
 
+// Pointwise operations (bias, activations) applied to a tile of the output matrix right after
+// the tile is computed, while it's still in cache.
+struct FastGemmEpilogue {
+    virtual ~FastGemmEpilogue() {}
+
+    // c is the top left element of m x n tile which starts at column j0 of the output matrix
+    virtual void apply(float *c, int ldc, int m, int n, int j0) const = 0;
+};
+
 struct FastGemmOpt {
     bool use_avx;
     bool use_avx2;
     bool use_neon;
     bool use_lasx;
     bool multi_thread;
+    const FastGemmEpilogue *epilogue;
 
     FastGemmOpt() {
         use_avx = false;
@@ -30,6 +40,7 @@ struct FastGemmOpt {
         use_neon = false;
         use_lasx = false;
         multi_thread = false;
+        epilogue = nullptr;
     }
 
     void init() {
@@ -155,11 +166,19 @@ size_t fastGemmPackBSize(size_t N, size_t K, const FastGemmOpt &opt);
 
 void fastGemmPackB(const Mat &m, std::vector<float> &packed_B, bool trans, FastGemmOpt &opt);
 void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, float *packed_B, const FastGemmOpt &opt);
+// Same layout as above, but the packed weights are kept in FP16 to halve their memory footprint and bandwidth.
+// Computation is still done in FP32: every packed panel is widened right before it is fed into the micro-kernel.
+void fastGemmPackB(const Mat &m, std::vector<hfloat> &packed_B, bool trans, FastGemmOpt &opt);
+void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, hfloat *packed_B, const FastGemmOpt &opt);
 
 void fastGemm(bool trans_a, int M, int N, int K,
               float alpha, const float *A, int lda,
               const float *packed_B, float beta,
               float *C, int ldc, FastGemmOpt &opt);
+void fastGemm(bool trans_a, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const hfloat *packed_B, float beta,
+              float *C, int ldc, FastGemmOpt &opt);
 void fastGemm(bool trans_a, bool trans_b, int ma, int na, int mb, int nb,
               float alpha, const float *A, int lda0, int lda1, const float *B, int ldb0, int ldb1,
               float beta, float *C, int ldc, FastGemmOpt &opt);
@@ -173,6 +192,9 @@ void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *B_offset
 void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                    int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
                    const float *packed_B, float beta, float *C, int ldc, FastGemmOpt &opt);
+void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
+                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
+                   const hfloat *packed_B, float beta, float *C, int ldc, FastGemmOpt &opt);
 void fastGemmBatch(bool trans_a, bool trans_b, float alpha, const Mat &A,
                    const Mat &B, float beta, Mat &C, FastGemmOpt &opt);
 
@@ -11,6 +11,7 @@
 
 #include <opencv2/core/hal/intrin.hpp>
 #include <opencv2/core/utility.hpp> // parallel_for_
+#include "fast_gemm.hpp" // FastGemmEpilogue
 
 #define FAST_GEMM_STORAGE (1<<20) // 2^20
 #define FAST_GEMM_MAX_STACKBUF (1 << 14)
@@ -74,29 +75,38 @@ static void fast_gemm_pack##N##suffix( int m, int k, const void* A_, \
 #define FAST_GEMM_PACK_f32_8(src, dst) FAST_GEMM_PACK_COPY((src), (dst), 8)
 #define FAST_GEMM_PACK_f32_12(src, dst) FAST_GEMM_PACK_COPY((src), (dst), 12)
 
+#define FAST_GEMM_PACK_CVT_F16(src, dst, N) \
+    for (int q = 0; q < N; q++) (dst)[q] = hfloat((src)[q])
+#define FAST_GEMM_PACK_f16_12(src, dst) FAST_GEMM_PACK_CVT_F16((src), (dst), 12)
+
 namespace cv { namespace dnn { namespace cpu_baseline {
 
 int fastGemmPackBSize(int N, int K);
 
-void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz);
+void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz, int besz);
 
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
                     const char *B, int ldb0, int ldb1,
-                    float beta, char *C, int ldc, int esz, bool multi_thread);
+                    float beta, char *C, int ldc, int esz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue);
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
-                    const char *packed_B, float beta, char *C, int ldc, int esz, bool multi_thread);
+                    const char *packed_B, float beta, char *C, int ldc, int esz, int besz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue);
 
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz);
+                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz,
+                         const FastGemmEpilogue *epilogue);
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *packed_B, float beta, char *C, int ldc, int esz);
+                         const char *packed_B, float beta, char *C, int ldc, int esz, int besz,
+                         const FastGemmEpilogue *epilogue);
 
 FAST_GEMM_IMPLEMENT_PACK(8, _f32, float, float)
 FAST_GEMM_IMPLEMENT_PACK(12, _f32, float, float)
+FAST_GEMM_IMPLEMENT_PACK(12, _f16, float, hfloat)
 
 int fastGemmPackBSize(int N, int K) {
     int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
@@ -105,7 +115,7 @@ int fastGemmPackBSize(int N, int K) {
     return static_cast<int>((N + NC - 1) / NC) * NC * K;
 }
 
-void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz) {
+void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz, int besz) {
     int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
     int NC = (((GEMM_NC < N ? GEMM_NC : N) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
     int KC = std::min(FAST_GEMM_F32_PACKED_STRIDE_K, K);
@@ -114,10 +124,13 @@ void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0,
     for (int r = 0; r < n_tiles; ++r) {
         int j0 = r * NC;
         int nc = N - j0 < NC ? N - j0 : NC;
-        int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * esz;
+        int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * besz;
         for (int k = 0; k < K; k += KC) {
             int kc = K - k < KC ? K - k : KC;
-            fast_gemm_pack12_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            if (besz == esz)
+                fast_gemm_pack12_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            else
+                fast_gemm_pack12_f16(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
             packed_B += _nc * kc;
         }
     }
@@ -144,6 +157,11 @@ static inline void fast_gemm_f32(int k, const char *a_, const char *b_,
     }
 }
 
+static inline void fast_gemm_cvt_f16f32(const hfloat *src, float *dst, int len) {
+    for (int i = 0; i < len; i++)
+        dst[i] = float(src[i]);
+}
+
 static void fast_gemm_macro_kernel(int m, int n, int k,
                                    const char *packed_A, const char *packed_B,
                                    float alpha, char *c, int ldc0, int esz) {
@@ -179,7 +197,8 @@ static void fast_gemm_macro_kernel(int m, int n, int k,
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
                     const char *B, int ldb0, int ldb1,
-                    float beta, char *C, int ldc, int esz, bool multi_thread) {
+                    float beta, char *C, int ldc, int esz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -229,6 +248,9 @@ void fastGemmKernel(int M, int N, int K,
                 fast_gemm_pack12_f32(nc, kc, B + (k0 * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_b);
                 fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b, alpha, c_block, ldc_block, esz);
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -247,7 +269,8 @@ void fastGemmKernel(int M, int N, int K,
 
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
-                    const char *packed_B, float beta, char *C, int ldc, int esz, bool multi_thread) {
+                    const char *packed_B, float beta, char *C, int ldc, int esz, int besz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -258,13 +281,15 @@ void fastGemmKernel(int M, int N, int K,
     int KC = std::min(FAST_GEMM_F32_PACKED_STRIDE_K, K);
 
     size_t buff_size = KC * MC * esz;
-    bool use_stackbuff = buff_size <= FAST_GEMM_MAX_STACKBUF;
+    size_t widened_b_size = besz != esz ? KC * NC * esz : 0;
+    bool use_stackbuff = buff_size + widened_b_size <= FAST_GEMM_MAX_STACKBUF;
     int m_tiles = (M + MC - 1) / MC;
     int n_tiles = (N + NC - 1) / NC;
     int total_tiles = m_tiles * n_tiles;
 
     auto fn = [&](const Range &r) {
-        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size) : malloc(buff_size)); // TODO: use AutoBuffer
+        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size + widened_b_size) : malloc(buff_size + widened_b_size)); // TODO: use AutoBuffer
+        float* widened_b = (float*)(packed_a + buff_size);
         const char *packed_b_ = packed_B;
         int start = r.start;
         int end = r.end;
@@ -276,7 +301,7 @@ void fastGemmKernel(int M, int N, int K,
             int nc = N - j0 < NC ? N - j0 : NC;
             int ldc_block = ldc;
             char* c_block = C + (i0 * ldc + j0) * esz;
-            packed_b_ = packed_B + j0 * K * esz;
+            packed_b_ = packed_B + j0 * K * besz;
 
             if (beta == 0.f) {
                 for(int i = 0; i < mc; i++)
@@ -289,14 +314,22 @@ void fastGemmKernel(int M, int N, int K,
                 }
             }
 
-            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * esz;
+            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
             for(int k0 = 0; k0 < K; k0 += KC)
             {
                 int kc = K - k0 < KC ? K - k0 : KC;
                 fast_gemm_pack8_f32(mc, kc, A + (i0 * lda0 + k0 * lda1) * esz, lda0, lda1, packed_a);
-                fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b_, alpha, c_block, ldc_block, esz);
-                packed_b_ += _nc * kc;
+                const char *b_panel = packed_b_;
+                if (besz != esz) {
+                    fast_gemm_cvt_f16f32((const hfloat *)packed_b_, widened_b, _nc * kc);
+                    b_panel = (const char *)widened_b;
+                }
+                fast_gemm_macro_kernel(mc, nc, kc, packed_a, b_panel, alpha, c_block, ldc_block, esz);
+                packed_b_ += _nc * kc * besz;
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -315,7 +348,8 @@ void fastGemmKernel(int M, int N, int K,
 
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz) {
+                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz,
+                         const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -374,6 +408,9 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
                 // run kernel
                 fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b, alpha, c_block, ldc_block, esz);
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -389,7 +426,8 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
 
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *packed_B, float beta, char *C, int ldc, int esz) {
+                         const char *packed_B, float beta, char *C, int ldc, int esz, int besz,
+                         const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -400,13 +438,15 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
     int KC = std::min(FAST_GEMM_F32_PACKED_STRIDE_K, K);
 
     size_t buff_size = KC * MC * esz;
-    bool use_stackbuff = buff_size <= FAST_GEMM_MAX_STACKBUF;
+    size_t widened_b_size = besz != esz ? KC * NC * esz : 0;
+    bool use_stackbuff = buff_size + widened_b_size <= FAST_GEMM_MAX_STACKBUF;
     int m_tiles = (M + MC - 1) / MC;
     int n_tiles = (N + NC - 1) / NC;
     int total_tiles = m_tiles * n_tiles;
 
     auto fn = [&](const Range &r) {
-        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size) : malloc(buff_size));
+        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size + widened_b_size) : malloc(buff_size + widened_b_size));
+        float* widened_b = (float*)(packed_a + buff_size);
         const char *packed_b = packed_B;
         int start = r.start;
         int end = r.end;
@@ -422,7 +462,7 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
             int nc = N - j0 < NC ? N - j0 : NC;
             int ldc_block = ldc;
             const char *a_block = A + A_offsets[batch_index] * esz;
-            packed_b = packed_B + B_offsets[batch_index] * esz + j0 * K * esz;
+            packed_b = packed_B + (B_offsets[batch_index] + j0 * K) * besz;
             char* c_block = C + C_offsets[batch_index] * esz + (i0 * ldc + j0) * esz;
 
             if (beta == 0.f) {
@@ -436,7 +476,7 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
                 }
             }
 
-            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * esz;
+            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
             for(int k0 = 0; k0 < K; k0 += KC)
             {
                 int kc = K - k0 < KC ? K - k0 : KC;
@@ -444,9 +484,17 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
                 fast_gemm_pack8_f32(mc, kc, a_block + (i0 * lda0 + k0 * lda1) * esz, lda0, lda1, packed_a);
 
                 // run kernel
-                fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b, alpha, c_block, ldc_block, esz);
-                packed_b += _nc * kc;
+                const char *b_panel = packed_b;
+                if (besz != esz) {
+                    fast_gemm_cvt_f16f32((const hfloat *)packed_b, widened_b, _nc * kc);
+                    b_panel = (const char *)widened_b;
+                }
+                fast_gemm_macro_kernel(mc, nc, kc, packed_a, b_panel, alpha, c_block, ldc_block, esz);
+                packed_b += _nc * kc * besz;
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -487,3 +535,5 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
 #undef FAST_GEMM_PACK_COPY
 #undef FAST_GEMM_PACK_f32_8
 #undef FAST_GEMM_PACK_f32_12
+#undef FAST_GEMM_PACK_CVT_F16
+#undef FAST_GEMM_PACK_f16_12
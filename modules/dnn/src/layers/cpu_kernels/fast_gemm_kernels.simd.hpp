@@ -11,6 +11,7 @@
 
 #include <opencv2/core/hal/intrin.hpp>
 #include <opencv2/core/utility.hpp> // parallel_for_
+#include "fast_gemm.hpp" // FastGemmEpilogue
 
 #define FAST_GEMM_STORAGE (1<<20) // 2^20
 #define FAST_GEMM_MAX_STACKBUF (1 << 14)
@@ -111,28 +112,40 @@ static void fast_gemm_pack##N##suffix( int m, int k, const void* A_, \
 #define FAST_GEMM_PACK_f32_12(src, dst) FAST_GEMM_PACK_COPY((src), (dst), 12)
 #define FAST_GEMM_PACK_f32_16(src, dst) FAST_GEMM_PACK_COPY((src), (dst), 16)
 
+#define FAST_GEMM_PACK_CVT_F16(src, dst, N) \
+    for (int q = 0; q < N; q++) (dst)[q] = hfloat((src)[q])
+#define FAST_GEMM_PACK_f16_8(src, dst) FAST_GEMM_PACK_CVT_F16((src), (dst), 8)
+#define FAST_GEMM_PACK_f16_12(src, dst) FAST_GEMM_PACK_CVT_F16((src), (dst), 12)
+#define FAST_GEMM_PACK_f16_16(src, dst) FAST_GEMM_PACK_CVT_F16((src), (dst), 16)
+
 namespace cv { namespace dnn {
 
 CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
 
 int fastGemmPackBSize(int N, int K);
 
-void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz);
+// besz is the element size of packed B. If it is sizeof(hfloat), packed B is stored in FP16
+// and every KC x NC panel is widened to FP32 right before it goes into the micro-kernel.
+void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz, int besz);
 
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
                     const char *B, int ldb0, int ldb1,
-                    float beta, char *C, int ldc, int esz, bool multi_thread);
+                    float beta, char *C, int ldc, int esz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue);
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
-                    const char *packed_B, float beta, char *C, int ldc, int esz, bool multi_thread);
+                    const char *packed_B, float beta, char *C, int ldc, int esz, int besz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue);
 
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz);
+                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz,
+                         const FastGemmEpilogue *epilogue);
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *packed_B, float beta, char *C, int ldc, int esz);
+                         const char *packed_B, float beta, char *C, int ldc, int esz, int besz,
+                         const FastGemmEpilogue *epilogue);
 
 #ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 
@@ -143,6 +156,7 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
 
 FAST_GEMM_IMPLEMENT_PACK(8, _f32, float, float) // a packer
 FAST_GEMM_IMPLEMENT_PACK(12, _f32, float, float) // b packer
+FAST_GEMM_IMPLEMENT_PACK(12, _f16, float, hfloat) // FP16 b packer
 
 static inline void fast_gemm8x12_f32(int k, const char *a_, const char *b_,
                                      char *c_, int ldc, float alpha) {
@@ -227,6 +241,7 @@ static inline void fast_gemm8x12_f32(int k, const char *a_, const char *b_,
 
 FAST_GEMM_IMPLEMENT_PACK(8, _f32, float, float) // a packer
 FAST_GEMM_IMPLEMENT_PACK(12, _f32, float, float) // b packer
+FAST_GEMM_IMPLEMENT_PACK(8, _f16, float, hfloat) // FP16 b packer
 
 #if !CV_FMA3 // AVX workaround for FMA
 #undef _mm256_fmadd_ps
@@ -307,6 +322,7 @@ static inline void fast_gemm12x8_f32(int k, const char *a_, const char *b_, char
 
 FAST_GEMM_IMPLEMENT_PACK(12, _f32, float, float) // a packer
 FAST_GEMM_IMPLEMENT_PACK(16, _f32, float, float) // b packer
+FAST_GEMM_IMPLEMENT_PACK(16, _f16, float, hfloat) // FP16 b packer
 
 static inline void fast_gemm12x16_f32(int k, const char *a_, const char *b_, char *c_, int ldc, float alpha) {
     const float* a = (const float*)a_;
@@ -405,6 +421,7 @@ static inline void fast_gemm12x16_f32(int k, const char *a_, const char *b_, cha
 
 FAST_GEMM_IMPLEMENT_PACK(8, _f32, float, float) // a packer
 FAST_GEMM_IMPLEMENT_PACK(12, _f32, float, float) // b packer
+FAST_GEMM_IMPLEMENT_PACK(12, _f16, float, hfloat) // FP16 b packer
 
 static inline void fast_gemm8x12_f32(int k, const char *a_, const char *b_,
                                      char *c_, int ldc, float alpha) {
@@ -491,6 +508,17 @@ static inline void fast_gemm8x12_f32(int k, const char *a_, const char *b_,
 
 #endif
 
+static inline void fast_gemm_cvt_f16f32(const hfloat *src, float *dst, int len) {
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_float32>::vlanes();
+    for (; i <= len - nlanes; i += nlanes)
+        v_store(dst + i, vx_load_expand(src + i));
+#endif
+    for (; i < len; i++)
+        dst[i] = float(src[i]);
+}
+
 static inline void fast_gemm_macro_kernel(int m, int n, int k,
                                           const char *packed_A, const char *packed_B,
                                           float alpha, char *c, int ldc0, int esz) {
@@ -538,7 +566,7 @@ int fastGemmPackBSize(int N, int K) {
     return static_cast<int>((N + NC - 1) / NC) * NC * K;
 }
 
-void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz) {
+void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz, int besz) {
     int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
     int NC = (((GEMM_NC < N ? GEMM_NC : N) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
     int KC = std::min(FAST_GEMM_F32_PACKED_STRIDE_K, K);
@@ -547,17 +575,29 @@ void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0,
     for (int r = 0; r < n_tiles; ++r) {
         int j0 = r * NC;
         int nc = N - j0 < NC ? N - j0 : NC;
-        int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * esz;
+        int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * besz;
         for (int k = 0; k < K; k += KC) {
             int kc = K - k < KC ? K - k : KC;
 #if CV_NEON && CV_NEON_AARCH64
-            fast_gemm_pack12_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            if (besz == esz)
+                fast_gemm_pack12_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            else
+                fast_gemm_pack12_f16(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
 #elif CV_AVX
-            fast_gemm_pack8_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            if (besz == esz)
+                fast_gemm_pack8_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            else
+                fast_gemm_pack8_f16(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
 #elif CV_LASX
-            fast_gemm_pack16_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            if (besz == esz)
+                fast_gemm_pack16_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            else
+                fast_gemm_pack16_f16(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
 #elif CV_SIMD128
-            fast_gemm_pack12_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            if (besz == esz)
+                fast_gemm_pack12_f32(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
+            else
+                fast_gemm_pack12_f16(nc, kc, B + (k * ldb0 + j0 * ldb1) * esz, ldb1, ldb0, packed_B);
 #endif
             packed_B += _nc * kc;
         }
@@ -567,7 +607,8 @@ void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0,
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
                     const char *B, int ldb0, int ldb1,
-                    float beta, char *C, int ldc, int esz, bool multi_thread) {
+                    float beta, char *C, int ldc, int esz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -638,6 +679,9 @@ void fastGemmKernel(int M, int N, int K,
                 // run kernel
                 fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b, alpha, c_block, ldc_block, esz);
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -657,7 +701,8 @@ void fastGemmKernel(int M, int N, int K,
 
 void fastGemmKernel(int M, int N, int K,
                     float alpha, const char *A, int lda0, int lda1,
-                    const char *packed_B, float beta, char *C, int ldc, int esz, bool multi_thread) {
+                    const char *packed_B, float beta, char *C, int ldc, int esz, int besz, bool multi_thread,
+                    const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -668,13 +713,15 @@ void fastGemmKernel(int M, int N, int K,
     int KC = std::min(FAST_GEMM_F32_PACKED_STRIDE_K, K);
 
     size_t buff_size = KC * MC * esz;
-    bool use_stackbuff = buff_size <= FAST_GEMM_MAX_STACKBUF;
+    size_t widened_b_size = besz != esz ? KC * NC * esz : 0;
+    bool use_stackbuff = buff_size + widened_b_size <= FAST_GEMM_MAX_STACKBUF;
     int m_tiles = (M + MC - 1) / MC;
     int n_tiles = (N + NC - 1) / NC;
     int total_tiles = m_tiles * n_tiles;
 
     auto fn = [&](const Range &r) {
-        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size) : malloc(buff_size)); // TODO: use AutoBuffer
+        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size + widened_b_size) : malloc(buff_size + widened_b_size)); // TODO: use AutoBuffer
+        float* widened_b = (float*)(packed_a + buff_size);
         const char *packed_b_ = packed_B;
         int start = r.start;
         int end = r.end;
@@ -686,7 +733,7 @@ void fastGemmKernel(int M, int N, int K,
             int nc = N - j0 < NC ? N - j0 : NC;
             int ldc_block = ldc;
             char* c_block = C + (i0 * ldc + j0) * esz;
-            packed_b_ = packed_B + j0 * K * esz;
+            packed_b_ = packed_B + j0 * K * besz;
 
             if (beta == 0.f) {
                 for(int i = 0; i < mc; i++)
@@ -699,7 +746,7 @@ void fastGemmKernel(int M, int N, int K,
                 }
             }
 
-            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * esz;
+            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
             for(int k0 = 0; k0 < K; k0 += KC)
             {
                 int kc = K - k0 < KC ? K - k0 : KC;
@@ -715,9 +762,17 @@ void fastGemmKernel(int M, int N, int K,
 #endif
 
                 // run kernel
-                fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b_, alpha, c_block, ldc_block, esz);
-                packed_b_ += _nc * kc;
+                const char *b_panel = packed_b_;
+                if (besz != esz) {
+                    fast_gemm_cvt_f16f32((const hfloat *)packed_b_, widened_b, _nc * kc);
+                    b_panel = (const char *)widened_b;
+                }
+                fast_gemm_macro_kernel(mc, nc, kc, packed_a, b_panel, alpha, c_block, ldc_block, esz);
+                packed_b_ += _nc * kc * besz;
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -736,7 +791,8 @@ void fastGemmKernel(int M, int N, int K,
 
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz) {
+                         const char *B, int ldb0, int ldb1, float beta, char *C, int ldc, int esz,
+                         const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -811,6 +867,9 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
                 // run kernel
                 fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b, alpha, c_block, ldc_block, esz);
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -826,7 +885,8 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
 
 void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                          int M, int N, int K, float alpha, const char *A, int lda0, int lda1,
-                         const char *packed_B, float beta, char *C, int ldc, int esz) {
+                         const char *packed_B, float beta, char *C, int ldc, int esz, int besz,
+                         const FastGemmEpilogue *epilogue) {
     int GEMM_MC = FAST_GEMM_F32_MC,
         GEMM_NC = FAST_GEMM_F32_NC,
         GEMM_MR = FAST_GEMM_F32_MR,
@@ -837,13 +897,15 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
     int KC = std::min(FAST_GEMM_F32_PACKED_STRIDE_K, K);
 
     size_t buff_size = KC * MC * esz;
-    bool use_stackbuff = buff_size <= FAST_GEMM_MAX_STACKBUF;
+    size_t widened_b_size = besz != esz ? KC * NC * esz : 0;
+    bool use_stackbuff = buff_size + widened_b_size <= FAST_GEMM_MAX_STACKBUF;
     int m_tiles = (M + MC - 1) / MC;
     int n_tiles = (N + NC - 1) / NC;
     int total_tiles = m_tiles * n_tiles;
 
     auto fn = [&](const Range &r) {
-        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size) : malloc(buff_size));
+        char* packed_a = (char*)(use_stackbuff ? alloca(buff_size + widened_b_size) : malloc(buff_size + widened_b_size));
+        float* widened_b = (float*)(packed_a + buff_size);
         const char *packed_b = packed_B;
         int start = r.start;
         int end = r.end;
@@ -859,7 +921,7 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
             int nc = N - j0 < NC ? N - j0 : NC;
             int ldc_block = ldc;
             const char *a_block = A + A_offsets[batch_index] * esz;
-            packed_b = packed_B + B_offsets[batch_index] * esz + j0 * K * esz;
+            packed_b = packed_B + (B_offsets[batch_index] + j0 * K) * besz;
             char* c_block = C + C_offsets[batch_index] * esz + (i0 * ldc + j0) * esz;
 
             if (beta == 0.f) {
@@ -873,7 +935,7 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
                 }
             }
 
-            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * esz;
+            int _nc = static_cast<int>((nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
             for(int k0 = 0; k0 < K; k0 += KC)
             {
                 int kc = K - k0 < KC ? K - k0 : KC;
@@ -889,9 +951,17 @@ void fastGemmBatchKernel(size_t batch, const size_t *A_offsets, const size_t *B_
 #endif
 
                 // run kernel
-                fast_gemm_macro_kernel(mc, nc, kc, packed_a, packed_b, alpha, c_block, ldc_block, esz);
-                packed_b += _nc * kc;
+                const char *b_panel = packed_b;
+                if (besz != esz) {
+                    fast_gemm_cvt_f16f32((const hfloat *)packed_b, widened_b, _nc * kc);
+                    b_panel = (const char *)widened_b;
+                }
+                fast_gemm_macro_kernel(mc, nc, kc, packed_a, b_panel, alpha, c_block, ldc_block, esz);
+                packed_b += _nc * kc * besz;
             }
+
+            if (epilogue)
+                epilogue->apply((float*)c_block, ldc_block, mc, nc, j0);
         }
 
         if (!use_stackbuff) {
@@ -939,3 +1009,7 @@ CV_CPU_OPTIMIZATION_NAMESPACE_END
 #undef FAST_GEMM_PACK_f32_8
 #undef FAST_GEMM_PACK_f32_12
 #undef FAST_GEMM_PACK_f32_16
+#undef FAST_GEMM_PACK_CVT_F16
+#undef FAST_GEMM_PACK_f16_8
+#undef FAST_GEMM_PACK_f16_12
+#undef FAST_GEMM_PACK_f16_16
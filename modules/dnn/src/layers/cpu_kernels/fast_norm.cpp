@@ -4,119 +4,155 @@
 
 #include "../../precomp.hpp"
 #include "fast_norm.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv { namespace dnn {
 
-void fastNorm(const Mat &input, Mat &output, float epsilon, size_t normalized_axis, bool normalize_variance) {
-    const auto input_shape = shape(input);
-    CV_CheckLT(normalized_axis, input_shape.size(), "fastNorm: axis out of range");
-
-    size_t loops = static_cast<size_t>(total(input_shape, 0, static_cast<int>(normalized_axis))),
-           norm_size = static_cast<size_t>(total(input_shape, static_cast<int>(normalized_axis)));
-    float inv_norm_size = 1.0 / norm_size;
-
-    auto fn = [&](const Range &r) {
-        const auto *input_data = input.ptr<const float>();
-        auto *output_data = output.ptr<float>();
-        for (int i = r.start; i < r.end; i++) {
-            const auto *x = input_data + norm_size * i;
-            auto *y = output_data + norm_size * i;
-
-            float mean = 0.f, mean_square = 0.f;
-            for (int j = 0; j < norm_size; j++) {
-                float v = x[j];
-                mean += v;
-                mean_square += v * v;
-            }
+namespace {
+
+// Number of elements which are summed up in float before accumulation in double
+const size_t FAST_NORM_BLOCK_SIZE = 512;
+
+// Computes mean and 1/sqrt(variance + epsilon) of len elements in a single pass.
+// Deviations from the first element are summed up instead of the values, so the
+// variance doesn't lose precision for data with a large mean. Partial sums of blocks
+// are accumulated in double.
+static void computeMeanStdev(const float *x, size_t len, float epsilon, bool normalize_variance,
+                             float &mean, float &inv_stdev) {
+    const float shift = x[0];
+    double sum = 0, sum_square = 0;
+    for (size_t j0 = 0; j0 < len; j0 += FAST_NORM_BLOCK_SIZE) {
+        size_t j = j0, j1 = std::min(len, j0 + FAST_NORM_BLOCK_SIZE);
+        float block_sum = 0.f, block_sum_square = 0.f;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const size_t nlanes = VTraits<v_float32>::vlanes();
+        v_float32 v_shift = vx_setall_f32(shift), v_sum = vx_setzero_f32(), v_sum_square = vx_setzero_f32();
+        for (; j + nlanes <= j1; j += nlanes) {
+            v_float32 d = v_sub(vx_load(x + j), v_shift);
+            v_sum = v_add(v_sum, d);
+            v_sum_square = v_fma(d, d, v_sum_square);
+        }
+        block_sum = v_reduce_sum(v_sum);
+        block_sum_square = v_reduce_sum(v_sum_square);
+#endif
+        for (; j < j1; j++) {
+            float d = x[j] - shift;
+            block_sum += d;
+            block_sum_square += d * d;
+        }
+        sum += block_sum;
+        sum_square += block_sum_square;
+    }
+
+    double inv_len = 1.0 / len, shifted_mean = sum * inv_len;
+    double variance = std::max(0.0, sum_square * inv_len - shifted_mean * shifted_mean);
+    mean = static_cast<float>(shift + shifted_mean);
+    inv_stdev = normalize_variance ? static_cast<float>(1.0 / std::sqrt(variance + epsilon)) : 1.f;
+}
 
-            mean *= inv_norm_size;
-            mean_square = std::sqrt(std::max(0.f, mean_square * inv_norm_size - mean * mean) + epsilon);
-            float inv_stdev = normalize_variance ? 1.f / mean_square : 1.f;
+// y = x * a + b
+static void normalizeAffine(const float *x, float *y, size_t len, float a, float b) {
+    size_t j = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const size_t nlanes = VTraits<v_float32>::vlanes();
+    v_float32 v_a = vx_setall_f32(a), v_b = vx_setall_f32(b);
+    for (; j + nlanes <= len; j += nlanes)
+        v_store(y + j, v_fma(vx_load(x + j), v_a, v_b));
+#endif
+    for (; j < len; j++)
+        y[j] = x[j] * a + b;
+}
 
-            for (size_t j = 0; j < norm_size; j++) {
-                y[j] = (x[j] - mean) * inv_stdev;
-            }
+// y = (x - mean) * inv_stdev * scale + bias, bias is optional
+static void normalizeElementwise(const float *x, float *y, size_t len, float mean, float inv_stdev,
+                                 const float *scale, const float *bias) {
+    size_t j = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const size_t nlanes = VTraits<v_float32>::vlanes();
+    v_float32 v_inv_stdev = vx_setall_f32(inv_stdev), v_b = vx_setall_f32(-mean * inv_stdev);
+    if (bias) {
+        for (; j + nlanes <= len; j += nlanes) {
+            v_float32 v = v_fma(vx_load(x + j), v_inv_stdev, v_b);
+            v_store(y + j, v_fma(v, vx_load(scale + j), vx_load(bias + j)));
         }
-    };
-    double nstripes = loops * norm_size * (1 / 1024.0);
-    parallel_for_(Range(0, loops), fn, nstripes);
+    } else {
+        for (; j + nlanes <= len; j += nlanes) {
+            v_float32 v = v_fma(vx_load(x + j), v_inv_stdev, v_b);
+            v_store(y + j, v_mul(v, vx_load(scale + j)));
+        }
+    }
+#endif
+    for (; j < len; j++) {
+        float v = (x[j] - mean) * inv_stdev * scale[j];
+        y[j] = bias ? v + bias[j] : v;
+    }
 }
 
-void fastNorm(const Mat &input, const Mat &scale, Mat &output, float epsilon, size_t normalized_axis) {
+static void fastNormElementwise(const Mat &input, const float *scale_data, const float *bias_data, Mat &output,
+                                float epsilon, size_t normalized_axis, const ActivationLayer *activ) {
     const auto input_shape = shape(input);
     CV_CheckLT(normalized_axis, input_shape.size(), "fastNorm: axis out of range");
 
     size_t loops = static_cast<size_t>(total(input_shape, 0, static_cast<int>(normalized_axis))),
            norm_size = static_cast<size_t>(total(input_shape, static_cast<int>(normalized_axis)));
-    float inv_norm_size = 1.0 / norm_size;
 
     auto fn = [&](const Range &r) {
         const auto *input_data = input.ptr<const float>();
-        const auto *scale_data = scale.ptr<const float>();
         auto *output_data = output.ptr<float>();
         for (int i = r.start; i < r.end; i++) {
             const auto *x = input_data + norm_size * i;
             auto *y = output_data + norm_size * i;
 
-            float mean = 0.f, mean_square = 0.f;
-            for (int j = 0; j < norm_size; j++) {
-                float v = x[j];
-                mean += v;
-                mean_square += v * v;
-            }
-
-            mean *= inv_norm_size;
-            mean_square = std::sqrt(std::max(0.f, mean_square * inv_norm_size - mean * mean) + epsilon);
-            float inv_stdev = 1.f / mean_square;
-
-            for (size_t j = 0; j < norm_size; j++) {
-                y[j] = scale_data[j] * (x[j] - mean) * inv_stdev;
-            }
+            float mean, inv_stdev;
+            computeMeanStdev(x, norm_size, epsilon, true, mean, inv_stdev);
+            normalizeElementwise(x, y, norm_size, mean, inv_stdev, scale_data, bias_data);
+            // Activation is applied while the row is still in cache
+            if (activ)
+                activ->forwardSlice(y, y, static_cast<int>(norm_size), norm_size, 0, 1);
         }
     };
     double nstripes = loops * norm_size * (1 / 1024.0);
     parallel_for_(Range(0, loops), fn, nstripes);
 }
 
-void fastNorm(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t normalized_axis) {
+} // namespace
+
+void fastNorm(const Mat &input, Mat &output, float epsilon, size_t normalized_axis, bool normalize_variance) {
     const auto input_shape = shape(input);
     CV_CheckLT(normalized_axis, input_shape.size(), "fastNorm: axis out of range");
-    CV_CheckEQ(scale.total(), bias.total(), "fastNorm: scale and bias should have the same shape");
 
     size_t loops = static_cast<size_t>(total(input_shape, 0, static_cast<int>(normalized_axis))),
            norm_size = static_cast<size_t>(total(input_shape, static_cast<int>(normalized_axis)));
-    float inv_norm_size = 1.0 / norm_size;
 
     auto fn = [&](const Range &r) {
         const auto *input_data = input.ptr<const float>();
-        const auto *scale_data = scale.ptr<const float>();
-        const auto *bias_data = bias.ptr<const float>();
         auto *output_data = output.ptr<float>();
         for (int i = r.start; i < r.end; i++) {
             const auto *x = input_data + norm_size * i;
             auto *y = output_data + norm_size * i;
 
-            float mean = 0.f, mean_square = 0.f;
-            for (int j = 0; j < norm_size; j++) {
-                float v = x[j];
-                mean += v;
-                mean_square += v * v;
-            }
-
-            mean *= inv_norm_size;
-            mean_square = std::sqrt(std::max(0.f, mean_square * inv_norm_size - mean * mean) + epsilon);
-            float inv_stdev = 1.f / mean_square;
-
-            for (size_t j = 0; j < norm_size; j++) {
-                y[j] = scale_data[j] * (x[j] - mean) * inv_stdev + bias_data[j];
-            }
+            float mean, inv_stdev;
+            computeMeanStdev(x, norm_size, epsilon, normalize_variance, mean, inv_stdev);
+            normalizeAffine(x, y, norm_size, inv_stdev, -mean * inv_stdev);
         }
     };
     double nstripes = loops * norm_size * (1 / 1024.0);
     parallel_for_(Range(0, loops), fn, nstripes);
 }
 
-void fastNormChannel(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon) {
+void fastNorm(const Mat &input, const Mat &scale, Mat &output, float epsilon, size_t normalized_axis,
+              const ActivationLayer *activ) {
+    fastNormElementwise(input, scale.ptr<const float>(), nullptr, output, epsilon, normalized_axis, activ);
+}
+
+void fastNorm(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t normalized_axis,
+              const ActivationLayer *activ) {
+    CV_CheckEQ(scale.total(), bias.total(), "fastNorm: scale and bias should have the same shape");
+    fastNormElementwise(input, scale.ptr<const float>(), bias.ptr<const float>(), output, epsilon, normalized_axis, activ);
+}
+
+void fastNormChannel(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon,
+                     const ActivationLayer *activ) {
     const auto input_shape = shape(input);
     size_t N = input_shape[0], C = input_shape[1];
     CV_CheckEQ(scale.total(), bias.total(), "fastNormChannel: scale and bias should have the same shape");
@@ -125,7 +161,6 @@ void fastNormChannel(const Mat &input, const Mat &scale, const Mat &bias, Mat &o
 
     size_t loops = N * C,
            norm_size = static_cast<size_t>(total(input_shape, 2));
-    float inv_norm_size = 1.0 / norm_size;
 
     auto fn = [&](const Range &r) {
         const auto *input_data = input.ptr<const float>();
@@ -136,29 +171,22 @@ void fastNormChannel(const Mat &input, const Mat &scale, const Mat &bias, Mat &o
             const auto *x = input_data + norm_size * i;
             auto *y = output_data + norm_size * i;
 
-            float mean = 0.f, mean_square = 0.f;
-            for (int j = 0; j < norm_size; j++) {
-                float v = x[j];
-                mean += v;
-                mean_square += v * v;
-            }
-
-            mean *= inv_norm_size;
-            mean_square = std::sqrt(std::max(0.f, mean_square * inv_norm_size - mean * mean) + epsilon);
-            float inv_stdev = 1.f / mean_square;
+            float mean, inv_stdev;
+            computeMeanStdev(x, norm_size, epsilon, true, mean, inv_stdev);
 
-            size_t c = i % C;
-            float s = scale_data[c] * inv_stdev, b = bias_data[c];
-            for (size_t j = 0; j < norm_size; j++) {
-                y[j] = s * (x[j] - mean) + b;
-            }
+            int c = static_cast<int>(i % C);
+            float s = scale_data[c] * inv_stdev, b = bias_data[c] - mean * s;
+            normalizeAffine(x, y, norm_size, s, b);
+            if (activ)
+                activ->forwardSlice(y, y, static_cast<int>(norm_size), norm_size, c, c + 1);
         }
     };
     double nstripes = loops * norm_size * (1 / 1024.0);
     parallel_for_(Range(0, loops), fn, nstripes);
 }
 
-void fastNormGroup(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t num_groups) {
+void fastNormGroup(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t num_groups,
+                   const ActivationLayer *activ) {
     const auto input_shape = shape(input);
     size_t N = input_shape[0], C = input_shape[1];
     CV_CheckEQ(scale.total(), bias.total(), "fastNormGroup: scale and bias should have the same shape");
@@ -169,7 +197,6 @@ void fastNormGroup(const Mat &input, const Mat &scale, const Mat &bias, Mat &out
     size_t loops = N * num_groups;
     size_t norm_size = static_cast<size_t>(total(input_shape, 2) * channels_per_group);
     size_t step = norm_size / channels_per_group;
-    float inv_norm_size = 1.0 / norm_size;
 
     auto fn = [&](const Range &r) {
         const auto *input_data = input.ptr<const float>();
@@ -181,23 +208,17 @@ void fastNormGroup(const Mat &input, const Mat &scale, const Mat &bias, Mat &out
             const auto *x = input_data + norm_size * i;
             auto *y = output_data + norm_size * i;
 
-            float mean = 0.f, mean_square = 0.f;
-            for (int j = 0; j < norm_size; j++) {
-                float v = x[j];
-                mean += v;
-                mean_square += v * v;
-            }
-
-            mean *= inv_norm_size;
-            mean_square = std::sqrt(std::max(0.f, mean_square * inv_norm_size - mean * mean) + epsilon);
-            float inv_stdev = 1.f / mean_square;
+            float mean, inv_stdev;
+            computeMeanStdev(x, norm_size, epsilon, true, mean, inv_stdev);
 
-            size_t group_idx = i % num_groups * channels_per_group;
-            for (size_t j = 0; j < norm_size; j++) {
-                size_t c = group_idx + (j / step);
-                float s = scale_data[c] * inv_stdev, b = bias_data[c];
-                y[j] = s * (x[j] - mean) + b;
+            int group_idx = static_cast<int>(i % num_groups * channels_per_group);
+            for (size_t k = 0; k < channels_per_group; k++) {
+                size_t c = group_idx + k;
+                float s = scale_data[c] * inv_stdev, b = bias_data[c] - mean * s;
+                normalizeAffine(x + k * step, y + k * step, step, s, b);
             }
+            if (activ)
+                activ->forwardSlice(y, y, static_cast<int>(step), step, group_idx, group_idx + static_cast<int>(channels_per_group));
         }
     };
 
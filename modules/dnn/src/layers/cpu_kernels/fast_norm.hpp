@@ -6,6 +6,7 @@
 #define OPENCV_DNN_FAST_NORM_HPP
 
 #include <opencv2/dnn/shape_utils.hpp>
+#include <opencv2/dnn/all_layers.hpp>
 
 namespace cv { namespace dnn {
 
@@ -13,16 +14,23 @@ namespace cv { namespace dnn {
 void fastNorm(const Mat &input, Mat &output, float epsilon, size_t normalized_axis = 0, bool normalize_variance = true);
 
 // Normalization speedup by multi-threading with absent bias. Mainly for LayerNormalization.
-void fastNorm(const Mat &input, const Mat &scale, Mat &output, float epsilon, size_t normalized_axis = 0);
+// Optional activation is applied to every normalized row.
+void fastNorm(const Mat &input, const Mat &scale, Mat &output, float epsilon, size_t normalized_axis = 0,
+              const ActivationLayer *activ = nullptr);
 
 // Normalization speedup by multi-threading with scale and bias. Mainly for LayerNormalization.
-void fastNorm(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t normalized_axis = 0);
+void fastNorm(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t normalized_axis = 0,
+              const ActivationLayer *activ = nullptr);
 
 // Channel-wise Normalization speedup by multi-threading. Scale and bias should have the same shape (C). Input should have dimension >= 3.
-void fastNormChannel(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon);
+// Optional activation is applied to every normalized channel.
+void fastNormChannel(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon,
+                     const ActivationLayer *activ = nullptr);
 
 // Group-wise Normalization speedup by multi-threading. Scale and bias should have the same shape (C). Input should have dimension >= 3.
-void fastNormGroup(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t num_groups);
+// Optional activation is applied to every normalized group.
+void fastNormGroup(const Mat &input, const Mat &scale, const Mat &bias, Mat &output, float epsilon, size_t num_groups,
+                   const ActivationLayer *activ = nullptr);
 
 }} // cv::dnn
 
@@ -0,0 +1,446 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "sparse_gemm.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv { namespace dnn {
+
+namespace {
+
+const int NM_GROUP = SparseWeights::NM_GROUP;
+const int NM_BLOCK_ROWS = SparseWeights::NM_BLOCK_ROWS;
+const int MAX_BLOCK_ROWS = 8;
+
+// Share of non-zero blocks up to which the sparse kernels are faster than the dense ones
+const double SPARSE_WEIGHTS_MAX_DENSITY = 0.3;
+
+// 8x1 blocks are used if they keep at most this share of values more than 4x1 blocks:
+// they need a half of column indices and broadcasts of inputs per value.
+const double SPARSE_8x1_MAX_OVERHEAD = 1.25;
+
+// Minimal number of columns for 2:4 format. It halves multiplications, but positions of values
+// are decoded for every group and inputs are gathered, which doesn't pay off for short rows.
+const int NM_MIN_COLS = 16;
+
+// Number of block rows of a fully connected layer computed by a single task
+const int FC_BLOCK_ROWS_PER_TASK = 16;
+
+// Number of elements of a plane of 1x1 convolution computed by a single task
+const int CONV_PLANE_TILE = 128;
+
+// Calls fn(b, nonzero) for every block row b, nonzero[j] is set if column j of the block has a non-zero value
+template <typename Fn>
+void forEachBlockRow(const Mat& weights, int blockRows, Fn fn)
+{
+    std::vector<uchar> nonzero(weights.cols);
+    for (int r0 = 0, b = 0; r0 < weights.rows; r0 += blockRows, b++)
+    {
+        std::fill(nonzero.begin(), nonzero.end(), (uchar)0);
+        for (int r = r0; r < std::min(r0 + blockRows, weights.rows); r++)
+        {
+            const float* w = weights.ptr<float>(r);
+            for (int j = 0; j < weights.cols; j++)
+                nonzero[j] |= w[j] != 0.f;
+        }
+        fn(b, nonzero);
+    }
+}
+
+size_t countNonZeroBlocks(const Mat& weights, int blockRows)
+{
+    size_t count = 0;
+    forEachBlockRow(weights, blockRows, [&](int, const std::vector<uchar>& nonzero)
+    {
+        count += std::count(nonzero.begin(), nonzero.end(), (uchar)1);
+    });
+    return count;
+}
+
+void packBlocks(const Mat& weights, SparseWeights& sparse)
+{
+    const int rows = weights.rows, cols = weights.cols, blockRows = sparse.blockRows();
+    sparse.blockOfs.assign((rows + blockRows - 1) / blockRows + 1, 0);
+    forEachBlockRow(weights, blockRows, [&](int b, const std::vector<uchar>& nonzero)
+    {
+        const int r0 = b * blockRows;
+        for (int j = 0; j < cols; j++)
+        {
+            if (!nonzero[j])
+                continue;
+            sparse.colIdx.push_back(j);
+            for (int r = r0; r < r0 + blockRows; r++)
+                sparse.values.push_back(r < rows ? weights.at<float>(r, j) : 0.f);
+        }
+        sparse.blockOfs[b + 1] = (int)sparse.colIdx.size();
+    });
+}
+
+bool is2of4(const Mat& weights)
+{
+    for (int i = 0; i < weights.rows; i++)
+    {
+        const float* w = weights.ptr<float>(i);
+        for (int j0 = 0; j0 < weights.cols; j0 += NM_GROUP)
+        {
+            int nz = 0;
+            for (int j = j0; j < std::min(j0 + NM_GROUP, weights.cols); j++)
+                nz += w[j] != 0.f;
+            if (nz > 2)
+                return false;
+        }
+    }
+    return true;
+}
+
+void pack2of4(const Mat& weights, SparseWeights& sparse)
+{
+    const int rows = weights.rows, cols = weights.cols;
+    const int blocks = (rows + NM_BLOCK_ROWS - 1) / NM_BLOCK_ROWS, groups = (cols + NM_GROUP - 1) / NM_GROUP;
+    sparse.nmPositions.assign((size_t)blocks * groups * NM_BLOCK_ROWS, 0);
+    sparse.values.assign((size_t)blocks * groups * NM_BLOCK_ROWS * 2, 0.f);
+    for (int i = 0; i < rows; i++)
+    {
+        const float* w = weights.ptr<float>(i);
+        for (int g = 0; g < groups; g++)
+        {
+            const size_t ofs = (size_t)(i / NM_BLOCK_ROWS) * groups + g;
+            uchar* pos = &sparse.nmPositions[ofs * NM_BLOCK_ROWS + i % NM_BLOCK_ROWS];
+            float* v = &sparse.values[ofs * NM_BLOCK_ROWS * 2 + i % NM_BLOCK_ROWS];
+            for (int p = 0, k = 0; p < NM_GROUP && g * NM_GROUP + p < cols; p++)
+            {
+                const float val = w[g * NM_GROUP + p];
+                if (val == 0.f)
+                    continue;
+                v[k * NM_BLOCK_ROWS] = val;
+                *pos |= (uchar)(p << (2 * k));
+                k++;
+            }
+        }
+    }
+}
+
+// Computes BR outputs of a block row of block formats for the input vector x
+template <int BR>
+inline void blockRowDot(const int* colIdx, const float* values, int k, int k1, const float* x, float* s)
+{
+#if CV_SIMD128
+    v_float32x4 s0[BR / 4], s1[BR / 4];
+    for (int i = 0; i < BR / 4; i++)
+        s0[i] = s1[i] = v_setzero_f32();
+    for (; k + 1 < k1; k += 2)
+    {
+        const v_float32x4 x0 = v_setall_f32(x[colIdx[k]]), x1 = v_setall_f32(x[colIdx[k + 1]]);
+        for (int i = 0; i < BR / 4; i++)
+        {
+            s0[i] = v_fma(v_load(values + k * BR + i * 4), x0, s0[i]);
+            s1[i] = v_fma(v_load(values + (k + 1) * BR + i * 4), x1, s1[i]);
+        }
+    }
+    for (; k < k1; k++)
+    {
+        const v_float32x4 x0 = v_setall_f32(x[colIdx[k]]);
+        for (int i = 0; i < BR / 4; i++)
+            s0[i] = v_fma(v_load(values + k * BR + i * 4), x0, s0[i]);
+    }
+    for (int i = 0; i < BR / 4; i++)
+        v_store(s + i * 4, v_add(s0[i], s1[i]));
+#else
+    for (int r = 0; r < BR; r++)
+        s[r] = 0.f;
+    for (; k < k1; k++)
+    {
+        const float xk = x[colIdx[k]];
+        for (int r = 0; r < BR; r++)
+            s[r] += values[k * BR + r] * xk;
+    }
+#endif
+}
+
+// Computes NM_BLOCK_ROWS outputs of a block of rows in 2:4 format for the input vector x
+inline void blockRowDot2of4(const uchar* pos, const float* values, int groups, const float* x, float* s)
+{
+#if CV_SIMD128
+    CV_StaticAssert(NM_BLOCK_ROWS == 4, "a block of rows is processed by v_float32x4");
+    v_float32x4 s0 = v_setzero_f32(), s1 = v_setzero_f32();
+    const v_uint32x4 mask = v_setall_u32(3);
+    for (int g = 0; g < groups; g++, pos += NM_BLOCK_ROWS, values += NM_BLOCK_ROWS * 2)
+    {
+        const float* xg = x + g * NM_GROUP;
+        const v_uint32x4 p = v_load_expand_q(pos);
+        s0 = v_fma(v_load(values), v_lut(xg, v_reinterpret_as_s32(v_and(p, mask))), s0);
+        s1 = v_fma(v_load(values + NM_BLOCK_ROWS), v_lut(xg, v_reinterpret_as_s32(v_shr<2>(p))), s1);
+    }
+    v_store(s, v_add(s0, s1));
+#else
+    for (int r = 0; r < NM_BLOCK_ROWS; r++)
+        s[r] = 0.f;
+    for (int g = 0; g < groups; g++, pos += NM_BLOCK_ROWS, values += NM_BLOCK_ROWS * 2)
+    {
+        const float* xg = x + g * NM_GROUP;
+        for (int r = 0; r < NM_BLOCK_ROWS; r++)
+            s[r] += values[r] * xg[pos[r] & 3] + values[NM_BLOCK_ROWS + r] * xg[pos[r] >> 2];
+    }
+#endif
+}
+
+}  // namespace
+
+bool packSparseWeights(const Mat& weights, SparseWeights& sparse)
+{
+    sparse = SparseWeights();
+    if (weights.dims != 2 || weights.type() != CV_32F || weights.empty())
+        return false;
+
+    const int rows = weights.rows, cols = weights.cols;
+    const size_t blocks4 = countNonZeroBlocks(weights, 4);
+    if (blocks4 <= SPARSE_WEIGHTS_MAX_DENSITY * ((rows + 3) / 4) * cols)
+    {
+        const size_t blocks8 = countNonZeroBlocks(weights, 8);
+        sparse.format = blocks8 * 8 <= SPARSE_8x1_MAX_OVERHEAD * blocks4 * 4 ? SparseWeights::BLOCK_8x1
+                                                                            : SparseWeights::BLOCK_4x1;
+        packBlocks(weights, sparse);
+    }
+    else if (cols >= NM_MIN_COLS && is2of4(weights))
+    {
+        sparse.format = SparseWeights::NM_2_4;
+        pack2of4(weights, sparse);
+    }
+    else
+        return false;
+
+    sparse.rows = rows;
+    sparse.cols = cols;
+    return true;
+}
+
+void runSparseFC(const SparseWeights& weights, const float* bias, const Mat& src, Mat& dst,
+                 const ActivationLayer* activ)
+{
+    CV_Assert(!weights.empty());
+    CV_CheckTypeEQ(src.type(), CV_32F, "");
+    CV_CheckTypeEQ(dst.type(), CV_32F, "");
+    CV_CheckEQ(src.cols, weights.cols, "");
+    CV_CheckEQ(dst.cols, weights.rows, "");
+    CV_CheckEQ(src.rows, dst.rows, "");
+
+    const int nsamples = src.rows, rows = weights.rows, BR = weights.blockRows();
+    const int blockRows = (rows + BR - 1) / BR;
+    const int groups = (weights.cols + NM_GROUP - 1) / NM_GROUP;
+    const int tasksPerSample = (blockRows + FC_BLOCK_ROWS_PER_TASK - 1) / FC_BLOCK_ROWS_PER_TASK;
+    const int* blockOfs = weights.blockOfs.data();
+    const int* colIdx = weights.colIdx.data();
+    const uchar* positions = weights.nmPositions.data();
+    const float* values = weights.values.data();
+
+    parallel_for_(Range(0, nsamples * tasksPerSample), [&](const Range& range)
+    {
+        for (int t = range.start; t < range.end; t++)
+        {
+            const int i = t / tasksPerSample;
+            const int b0 = (t % tasksPerSample) * FC_BLOCK_ROWS_PER_TASK;
+            const int b1 = std::min(b0 + FC_BLOCK_ROWS_PER_TASK, blockRows);
+            const float* x = src.ptr<float>(i);
+            float* y = dst.ptr<float>(i);
+
+            for (int b = b0; b < b1; b++)
+            {
+                float s[MAX_BLOCK_ROWS];
+                if (weights.format == SparseWeights::NM_2_4)
+                {
+                    const size_t ofs = (size_t)b * groups * NM_BLOCK_ROWS;
+                    blockRowDot2of4(positions + ofs, values + ofs * 2, groups, x, s);
+                }
+                else if (weights.format == SparseWeights::BLOCK_8x1)
+                    blockRowDot<8>(colIdx, values, blockOfs[b], blockOfs[b + 1], x, s);
+                else
+                    blockRowDot<4>(colIdx, values, blockOfs[b], blockOfs[b + 1], x, s);
+
+                const int r0 = b * BR, nr = std::min(BR, rows - r0);
+                for (int r = 0; r < nr; r++)
+                    y[r0 + r] = bias ? s[r] + bias[r0 + r] : s[r];
+            }
+
+            if (activ)
+            {
+                const int r0 = b0 * BR, r1 = std::min(b1 * BR, rows);
+                activ->forwardSlice(y + r0, y + r0, 1, 1, r0, r1);
+            }
+        }
+    });
+}
+
+void runSparseConv1x1(const SparseWeights& weights, const float* bias, const float* src, float* dst,
+                      int N, int planeSize, bool accumulate, float minval, float maxval,
+                      const ActivationLayer* activ)
+{
+    CV_Assert(!weights.empty());
+
+    const int K = weights.rows, C = weights.cols, BR = weights.blockRows();
+    const int blockRows = (K + BR - 1) / BR;
+    const int groups = (C + NM_GROUP - 1) / NM_GROUP;
+    const int tiles = (planeSize + CONV_PLANE_TILE - 1) / CONV_PLANE_TILE;
+    const int* blockOfs = weights.blockOfs.data();
+    const int* colIdx = weights.colIdx.data();
+    const uchar* positions = weights.nmPositions.data();
+    const float* values = weights.values.data();
+    const bool is2of4 = weights.format == SparseWeights::NM_2_4;
+
+    parallel_for_(Range(0, N * blockRows * tiles), [&](const Range& range)
+    {
+        for (int t = range.start; t < range.end; t++)
+        {
+            const int n = t / (blockRows * tiles), b = (t / tiles) % blockRows;
+            const int j0 = (t % tiles) * CONV_PLANE_TILE, j1 = std::min(j0 + CONV_PLANE_TILE, planeSize);
+            const int r0 = b * BR, nr = std::min(BR, K - r0);
+            const int k0 = is2of4 ? 0 : blockOfs[b], k1 = is2of4 ? 0 : blockOfs[b + 1];
+            const uchar* pos = is2of4 ? positions + (size_t)b * groups * NM_BLOCK_ROWS : 0;
+            const float* vals = is2of4 ? values + (size_t)b * groups * NM_BLOCK_ROWS * 2 : values;
+            const float* inp = src + (size_t)n * C * planeSize;
+            float* out = dst + ((size_t)n * K + r0) * planeSize;
+            float b_[MAX_BLOCK_ROWS] = {0.f};
+            for (int r = 0; r < nr; r++)
+                b_[r] = bias ? bias[r0 + r] : 0.f;
+
+            int j = j0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+            const int nlanes = VTraits<v_float32>::vlanes();
+            const v_float32 vmin = vx_setall_f32(minval), vmax = vx_setall_f32(maxval);
+            if (nr == 4)
+            {
+                float* out0 = out;
+                float* out1 = out + planeSize;
+                float* out2 = out + planeSize * 2;
+                float* out3 = out + planeSize * 3;
+                for (; j + nlanes * 2 <= j1; j += nlanes * 2)
+                {
+                    v_float32 s00 = vx_setall_f32(b_[0]), s01 = s00, s10 = vx_setall_f32(b_[1]), s11 = s10;
+                    v_float32 s20 = vx_setall_f32(b_[2]), s21 = s20, s30 = vx_setall_f32(b_[3]), s31 = s30;
+                    if (accumulate)
+                    {
+                        s00 = v_add(s00, vx_load(out0 + j)); s01 = v_add(s01, vx_load(out0 + j + nlanes));
+                        s10 = v_add(s10, vx_load(out1 + j)); s11 = v_add(s11, vx_load(out1 + j + nlanes));
+                        s20 = v_add(s20, vx_load(out2 + j)); s21 = v_add(s21, vx_load(out2 + j + nlanes));
+                        s30 = v_add(s30, vx_load(out3 + j)); s31 = v_add(s31, vx_load(out3 + j + nlanes));
+                    }
+                    if (is2of4)
+                    {
+                        for (int g = 0; g < groups; g++)
+                        {
+                            const uchar* p = pos + g * NM_BLOCK_ROWS;
+                            const float* w = vals + g * NM_BLOCK_ROWS * 2;
+                            const float* x = inp + (size_t)g * NM_GROUP * planeSize + j;
+                            const float* xa = x + (p[0] & 3) * planeSize;
+                            const float* xb = x + (p[0] >> 2) * planeSize;
+                            v_float32 wa = vx_setall_f32(w[0]), wb = vx_setall_f32(w[4]);
+                            s00 = v_fma(vx_load(xa), wa, s00); s01 = v_fma(vx_load(xa + nlanes), wa, s01);
+                            s00 = v_fma(vx_load(xb), wb, s00); s01 = v_fma(vx_load(xb + nlanes), wb, s01);
+                            xa = x + (p[1] & 3) * planeSize; xb = x + (p[1] >> 2) * planeSize;
+                            wa = vx_setall_f32(w[1]); wb = vx_setall_f32(w[5]);
+                            s10 = v_fma(vx_load(xa), wa, s10); s11 = v_fma(vx_load(xa + nlanes), wa, s11);
+                            s10 = v_fma(vx_load(xb), wb, s10); s11 = v_fma(vx_load(xb + nlanes), wb, s11);
+                            xa = x + (p[2] & 3) * planeSize; xb = x + (p[2] >> 2) * planeSize;
+                            wa = vx_setall_f32(w[2]); wb = vx_setall_f32(w[6]);
+                            s20 = v_fma(vx_load(xa), wa, s20); s21 = v_fma(vx_load(xa + nlanes), wa, s21);
+                            s20 = v_fma(vx_load(xb), wb, s20); s21 = v_fma(vx_load(xb + nlanes), wb, s21);
+                            xa = x + (p[3] & 3) * planeSize; xb = x + (p[3] >> 2) * planeSize;
+                            wa = vx_setall_f32(w[3]); wb = vx_setall_f32(w[7]);
+                            s30 = v_fma(vx_load(xa), wa, s30); s31 = v_fma(vx_load(xa + nlanes), wa, s31);
+                            s30 = v_fma(vx_load(xb), wb, s30); s31 = v_fma(vx_load(xb + nlanes), wb, s31);
+                        }
+                    }
+                    else
+                    {
+                        for (int k = k0; k < k1; k++)
+                        {
+                            const float* x = inp + (size_t)colIdx[k] * planeSize + j;
+                            const float* w = vals + k * 4;
+                            v_float32 x0 = vx_load(x), x1 = vx_load(x + nlanes), w0 = vx_setall_f32(w[0]);
+                            s00 = v_fma(x0, w0, s00); s01 = v_fma(x1, w0, s01);
+                            w0 = vx_setall_f32(w[1]);
+                            s10 = v_fma(x0, w0, s10); s11 = v_fma(x1, w0, s11);
+                            w0 = vx_setall_f32(w[2]);
+                            s20 = v_fma(x0, w0, s20); s21 = v_fma(x1, w0, s21);
+                            w0 = vx_setall_f32(w[3]);
+                            s30 = v_fma(x0, w0, s30); s31 = v_fma(x1, w0, s31);
+                        }
+                    }
+                    v_store(out0 + j, v_min(v_max(s00, vmin), vmax)); v_store(out0 + j + nlanes, v_min(v_max(s01, vmin), vmax));
+                    v_store(out1 + j, v_min(v_max(s10, vmin), vmax)); v_store(out1 + j + nlanes, v_min(v_max(s11, vmin), vmax));
+                    v_store(out2 + j, v_min(v_max(s20, vmin), vmax)); v_store(out2 + j + nlanes, v_min(v_max(s21, vmin), vmax));
+                    v_store(out3 + j, v_min(v_max(s30, vmin), vmax)); v_store(out3 + j + nlanes, v_min(v_max(s31, vmin), vmax));
+                }
+            }
+            else if (nr == 8)
+            {
+                for (; j + nlanes <= j1; j += nlanes)
+                {
+                    v_float32 s0 = vx_setall_f32(b_[0]), s1 = vx_setall_f32(b_[1]);
+                    v_float32 s2 = vx_setall_f32(b_[2]), s3 = vx_setall_f32(b_[3]);
+                    v_float32 s4 = vx_setall_f32(b_[4]), s5 = vx_setall_f32(b_[5]);
+                    v_float32 s6 = vx_setall_f32(b_[6]), s7 = vx_setall_f32(b_[7]);
+                    if (accumulate)
+                    {
+                        s0 = v_add(s0, vx_load(out + j)); s1 = v_add(s1, vx_load(out + planeSize + j));
+                        s2 = v_add(s2, vx_load(out + planeSize * 2 + j)); s3 = v_add(s3, vx_load(out + planeSize * 3 + j));
+                        s4 = v_add(s4, vx_load(out + planeSize * 4 + j)); s5 = v_add(s5, vx_load(out + planeSize * 5 + j));
+                        s6 = v_add(s6, vx_load(out + planeSize * 6 + j)); s7 = v_add(s7, vx_load(out + planeSize * 7 + j));
+                    }
+                    for (int k = k0; k < k1; k++)
+                    {
+                        const v_float32 x = vx_load(inp + (size_t)colIdx[k] * planeSize + j);
+                        const float* w = vals + k * 8;
+                        s0 = v_fma(x, vx_setall_f32(w[0]), s0); s1 = v_fma(x, vx_setall_f32(w[1]), s1);
+                        s2 = v_fma(x, vx_setall_f32(w[2]), s2); s3 = v_fma(x, vx_setall_f32(w[3]), s3);
+                        s4 = v_fma(x, vx_setall_f32(w[4]), s4); s5 = v_fma(x, vx_setall_f32(w[5]), s5);
+                        s6 = v_fma(x, vx_setall_f32(w[6]), s6); s7 = v_fma(x, vx_setall_f32(w[7]), s7);
+                    }
+                    v_store(out + j, v_min(v_max(s0, vmin), vmax));
+                    v_store(out + planeSize + j, v_min(v_max(s1, vmin), vmax));
+                    v_store(out + planeSize * 2 + j, v_min(v_max(s2, vmin), vmax));
+                    v_store(out + planeSize * 3 + j, v_min(v_max(s3, vmin), vmax));
+                    v_store(out + planeSize * 4 + j, v_min(v_max(s4, vmin), vmax));
+                    v_store(out + planeSize * 5 + j, v_min(v_max(s5, vmin), vmax));
+                    v_store(out + planeSize * 6 + j, v_min(v_max(s6, vmin), vmax));
+                    v_store(out + planeSize * 7 + j, v_min(v_max(s7, vmin), vmax));
+                }
+            }
+#endif
+            for (; j < j1; j++)
+            {
+                float s[MAX_BLOCK_ROWS];
+                for (int r = 0; r < BR; r++)
+                    s[r] = b_[r] + (accumulate && r < nr ? out[r * planeSize + j] : 0.f);
+                if (is2of4)
+                {
+                    for (int g = 0; g < groups; g++)
+                    {
+                        const uchar* p = pos + g * NM_BLOCK_ROWS;
+                        const float* w = vals + g * NM_BLOCK_ROWS * 2;
+                        const float* x = inp + (size_t)g * NM_GROUP * planeSize + j;
+                        for (int r = 0; r < NM_BLOCK_ROWS; r++)
+                            s[r] += w[r] * x[(p[r] & 3) * planeSize] + w[NM_BLOCK_ROWS + r] * x[(p[r] >> 2) * planeSize];
+                    }
+                }
+                else
+                {
+                    for (int k = k0; k < k1; k++)
+                    {
+                        const float x = inp[(size_t)colIdx[k] * planeSize + j];
+                        for (int r = 0; r < BR; r++)
+                            s[r] += vals[k * BR + r] * x;
+                    }
+                }
+                for (int r = 0; r < nr; r++)
+                    out[r * planeSize + j] = std::min(std::max(s[r], minval), maxval);
+            }
+
+            if (activ)
+                activ->forwardSlice(out + j0, out + j0, j1 - j0, planeSize, r0, r0 + nr);
+        }
+    });
+}
+
+}} // cv::dnn
@@ -0,0 +1,65 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_SPARSE_GEMM_HPP
+#define OPENCV_DNN_SPARSE_GEMM_HPP
+
+#include <opencv2/core.hpp>
+#include <opencv2/dnn/all_layers.hpp>
+
+namespace cv { namespace dnn {
+
+// Pruned weights of shape rows x cols in one of the compressed formats:
+//  - BLOCK_4x1, BLOCK_8x1: blocks of 4 or 8 consecutive rows by 1 column in compressed sparse row format.
+//    Only the blocks with at least one non-zero value are stored.
+//  - NM_2_4: every row has at most 2 non-zero values in every group of 4 consecutive columns.
+//    Rows are split into blocks of 4 rows, 2 values and their positions in the group are stored
+//    for every row of a block and every group.
+struct SparseWeights
+{
+    enum Format { BLOCK_4x1, BLOCK_8x1, NM_2_4 };
+    enum { NM_GROUP = 4, NM_BLOCK_ROWS = 4 };
+
+    int format = BLOCK_4x1;
+    int rows = 0, cols = 0;
+
+    // Block formats
+    std::vector<int> blockOfs;   // offset of the first stored block for every block row, (number of block rows + 1) items
+    std::vector<int> colIdx;     // column of every stored block
+
+    // NM_2_4 format: for every block of rows and every group, NM_BLOCK_ROWS bytes with positions of the values
+    // of every row (pos0 | pos1 << 2). Positions of missing values are 0 and the values are zeros.
+    std::vector<uchar> nmPositions;
+
+    // Block formats: blockRows() values of every stored block.
+    // NM_2_4: for every block of rows and every group, first values of NM_BLOCK_ROWS rows, then second values.
+    // Rows of the last block row are padded with zeros.
+    std::vector<float> values;
+
+    bool empty() const { return rows == 0; }
+    int blockRows() const { return format == BLOCK_8x1 ? 8 : 4; }
+    const char* kernelName() const { return format == BLOCK_4x1 ? "sparse_4x1" : format == BLOCK_8x1 ? "sparse_8x1" : "sparse_2:4"; }
+};
+
+// Packs 2D weights into a sparse format. Block formats are used when the share of non-zero blocks is small
+// enough for sparse kernels to be faster than the dense ones, 8x1 blocks are preferred if they are almost as
+// dense as 4x1 ones. Otherwise 2:4 format is used if the weights follow this pattern. Returns false and leaves
+// sparse empty if none of the formats fits.
+bool packSparseWeights(const Mat& weights, SparseWeights& sparse);
+
+// Fully connected layer: dst[i] = W * src[i] + bias for every row of src, then activation.
+// Outputs are treated as channels by the activation.
+void runSparseFC(const SparseWeights& weights, const float* bias, const Mat& src, Mat& dst,
+                 const ActivationLayer* activ);
+
+// 1x1 convolution: dst[n] = W * src[n] + bias (+ dst[n] if accumulate) for every image of the batch,
+// src has shape [N, cols, planeSize] and dst has shape [N, rows, planeSize]. Then outputs are clipped
+// by [minval, maxval] and activation is applied.
+void runSparseConv1x1(const SparseWeights& weights, const float* bias, const float* src, float* dst,
+                      int N, int planeSize, bool accumulate, float minval, float maxval,
+                      const ActivationLayer* activ);
+
+}} // cv::dnn
+
+#endif // OPENCV_DNN_SPARSE_GEMM_HPP
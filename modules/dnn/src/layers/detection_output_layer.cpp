@@ -578,7 +578,7 @@ public:
     )
     {
         std::map<int, std::vector<int> > indices;
-        size_t numDetections = 0;
+        std::vector<std::pair<int, const std::vector<util::NormalizedBBox>*> > classes;  // class and its boxes
         for (int c = 0; c < (int)_numClasses; ++c)
         {
             if (c == _backgroundLabelId)
@@ -586,21 +586,36 @@ public:
             if (c >= confidenceScores.rows)
                 CV_Error_(cv::Error::StsError, ("Could not find confidence predictions for label %d", c));
 
-            const std::vector<float> scores = confidenceScores.row(c);
             int label = _shareLocation ? -1 : c;
 
             LabelBBox::const_iterator label_bboxes = decodeBBoxes.find(label);
             if (label_bboxes == decodeBBoxes.end())
                 CV_Error_(cv::Error::StsError, ("Could not find location predictions for label %d", label));
-            int limit = (getNumOfTargetClasses() == 1) ? _keepTopK : std::numeric_limits<int>::max();
-            if (_bboxesNormalized)
-                NMSFast_(label_bboxes->second, scores, _confidenceThreshold, _nmsThreshold, 1.0, _topK,
-                         indices[c], util::caffe_norm_box_overlap, limit);
-            else
-                NMSFast_(label_bboxes->second, scores, _confidenceThreshold, _nmsThreshold, 1.0, _topK,
-                         indices[c], util::caffe_box_overlap, limit);
-            numDetections += indices[c].size();
+            indices.insert(std::make_pair(c, std::vector<int>()));
+            classes.push_back(std::make_pair(c, &label_bboxes->second));
         }
+
+        // Classes are suppressed independently of each other
+        const int limit = (getNumOfTargetClasses() == 1) ? _keepTopK : std::numeric_limits<int>::max();
+        parallel_for_(Range(0, (int)classes.size()), [&](const Range& range)
+        {
+            for (int i = range.start; i < range.end; ++i)
+            {
+                const int c = classes[i].first;
+                const std::vector<float> scores = confidenceScores.row(c);
+                std::vector<int>& classIndices = indices.find(c)->second;
+                if (_bboxesNormalized)
+                    NMSFast_(*classes[i].second, scores, _confidenceThreshold, _nmsThreshold, 1.0, _topK,
+                             classIndices, util::caffe_norm_box_overlap, limit);
+                else
+                    NMSFast_(*classes[i].second, scores, _confidenceThreshold, _nmsThreshold, 1.0, _topK,
+                             classIndices, util::caffe_box_overlap, limit);
+            }
+        });
+
+        size_t numDetections = 0;
+        for (std::map<int, std::vector<int> >::const_iterator it = indices.begin(); it != indices.end(); ++it)
+            numDetections += it->second.size();
         if (_keepTopK > -1 && numDetections > (size_t)_keepTopK)
         {
             std::vector<std::pair<float, std::pair<int, int> > > scoreIndexPairs;
@@ -49,6 +49,7 @@
 #include "../op_webnn.hpp"
 #include "../op_cann.hpp"
 #include "../op_vkcom.hpp"
+#include "cpu_kernels/sparse_gemm.hpp"
 
 #include <opencv2/dnn/shape_utils.hpp>
 
@@ -97,10 +98,17 @@ public:
             CV_Assert(blobs[0].dims >= 2 && (size_t)(innerSize * numOutput) == blobs[0].total());
             CV_Assert(!bias || (blobs.size() == 2 && (size_t)numOutput == blobs[1].total()));
 
-            blobs[0].copyTo(oriMat);
+            if (isMatMul)
+                blobs[0].copyTo(oriMat);
             weightsMat = blobs[0] = blobs[0].reshape(1, numOutput);
+
+            // Pruned weights of a fully connected layer are computed by the sparse kernel.
+            // Dense kernels are not used then, so the weights are not copied into the aligned buffer.
+            if (!isMatMul)
+                packSparseWeights(weightsMat, sparseWeights);
+
             int vecsize = weightsMat.cols;
-            if (vecsize % VEC_ALIGN != 0)
+            if (vecsize % VEC_ALIGN != 0 && sparseWeights.empty())
             {
                 int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN);
                 Mat weightsBuf(weightsMat.rows, vecsize_aligned, weightsMat.type());
@@ -196,6 +204,11 @@ public:
             activ = layer;
             return !activ.empty();
         }
+        else if (IS_DNN_CPU_TARGET(preferableTarget))
+        {
+            activ = PointwiseChainLayer::append(activ, layer);
+            return true;
+        }
         else
             return false;
     }
@@ -229,6 +242,7 @@ public:
             p.useRVV = checkHardwareSupport(CPU_RVV);
             p.useLASX = checkHardwareSupport(CPU_LASX);
 
+            reportKernel("fastGEMM1T");
             parallel_for_(Range(0, nstripes), p, nstripes);
         }
 
@@ -551,6 +565,13 @@ public:
                     Mat srcMat = input[i].reshape(1, outerSize);
                     Mat dstMat = output[i].reshape(1, outerSize);
 
+                    if (!sparseWeights.empty())
+                    {
+                        reportKernel(sparseWeights.kernelName());
+                        runSparseFC(sparseWeights, biasMat.ptr<float>(), srcMat, dstMat, activ.get());
+                        continue;
+                    }
+
                     const int nstripes = getNumThreads();
                     FullyConnected::run(srcMat, weightsMat, biasMat, dstMat, activ.get(), nstripes);
                 }
@@ -829,48 +850,12 @@ public:
         if (blobs.empty())
             return false;
 
-        int numOutput = blobs[0].size[0];
         float inputScale = scales[0][0], outputScale = scales[1][0];
         int inputZp = zeropoints[0][0];
-
-        Mat weightsQuantized(weightsMat.rows, weightsMat.cols, CV_8S);
-        Mat biasQuantized(1, numOutput, CV_32S);
-        Mat outputMultiplier(1, numOutput, CV_32F);
         bool perChannel = params.get<bool>("per_channel", true);
 
-        if (perChannel) // per-Channel quantization.
-        {
-            for (int i = 0; i < numOutput; i++)
-            {
-                double weightsScale = getWeightScale(weightsMat.row(i));
-
-                weightsMat.row(i).convertTo(weightsQuantized.row(i), CV_8S, 1.f/weightsScale);
-                float biasScale = inputScale * weightsScale;
-                biasQuantized.at<int>(i) = cvRound(biasMat.at<float>(i)/biasScale) - inputZp*(cv::sum(weightsQuantized.row(i))[0]);
-                outputMultiplier.at<float>(i) = biasScale / outputScale;
-            }
-        }
-        else // per-Tensor quantization.
-        {
-            double weightsScale = getWeightScale(weightsMat);
-
-            weightsMat.convertTo(weightsQuantized, CV_8S, 1.f/weightsScale);
-            float biasScale = inputScale * weightsScale;
-
-            for (int i = 0; i < numOutput; i++)
-            {
-                biasQuantized.at<int>(i) = cvRound(biasMat.at<float>(i)/biasScale) - inputZp*(cv::sum(weightsQuantized.row(i))[0]);
-                outputMultiplier.at<float>(i) = biasScale / outputScale;
-            }
-        }
-
-        params.blobs.clear();
-        params.set("per_channel", perChannel);
-        params.blobs.push_back(weightsQuantized.reshape(1, shape(blobs[0])));
-        params.blobs.push_back(biasQuantized);
-        params.blobs.push_back(outputMultiplier);
-        params.set("input_scale", inputScale);
-        params.set("input_zeropoint", inputZp);
+        quantizeFullyConnectedWeights(weightsMat, biasMat, inputScale, inputZp, outputScale, perChannel, params);
+        params.blobs[0] = params.blobs[0].reshape(1, shape(blobs[0]));
         return true;
     }
 
@@ -938,6 +923,7 @@ public:
 
     bool bias;
     Mat weightsMat, biasMat, oriMat;
+    SparseWeights sparseWeights;
     bool transA, transB;
     bool isMatMul = false;
     Ptr<ActivationLayer> activ;
@@ -146,9 +146,14 @@ public:
     virtual void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr) CV_OVERRIDE {
         opt.init();
 
-        // pack B if it is const
+        // pack B if it is const; keep it in FP16 for DNN_TARGET_CPU_FP16 to halve weight memory
+        packed_B.clear();
+        packed_B_fp16.clear();
         if (const_B) {
-            fastGemmPackB(blobs[0], packed_B, trans_b, opt);
+            if (preferableTarget == DNN_TARGET_CPU_FP16)
+                fastGemmPackB(blobs[0], packed_B_fp16, trans_b, opt);
+            else
+                fastGemmPackB(blobs[0], packed_B, trans_b, opt);
         }
 
         // also pre-broadcast bias
@@ -167,6 +172,18 @@ public:
         }
     }
 
+    // Activations and element-wise operations with constants are applied to tiles of output by fastGemm
+    virtual bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE {
+        if (layer.empty()) {
+            activ.release();
+            return false;
+        }
+        if (!IS_DNN_CPU_TARGET(preferableTarget))
+            return false;
+        activ = PointwiseChainLayer::append(activ, layer);
+        return true;
+    }
+
     // Y = A * B + C, note that C is unidirectionaly broadcastable to (A * B).
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE {
         CV_TRACE_FUNCTION();
@@ -207,11 +224,17 @@ public:
             std::memset(ptr_y, 0, total * sizeof(float));
         }
 
+        // layer may be run by several execution contexts concurrently, so fused operations are set to a copy of options
+        FastGemmOpt gemm_opt = opt;
+        gemm_opt.epilogue = activ.get();
         if (const_B) {
-            CV_CheckGT(packed_B.size(), static_cast<size_t>(0), "DNN/Gemm: constant B is not pre-packed");
-            fastGemm(trans_a, M, N, K, alpha, A.ptr<const float>(), na, packed_B.data(), 1.f, Y.ptr<float>(), N, opt);
+            CV_CheckGT(packed_B.size() + packed_B_fp16.size(), static_cast<size_t>(0), "DNN/Gemm: constant B is not pre-packed");
+            if (!packed_B_fp16.empty())
+                fastGemm(trans_a, M, N, K, alpha, A.ptr<const float>(), na, packed_B_fp16.data(), 1.f, Y.ptr<float>(), N, gemm_opt);
+            else
+                fastGemm(trans_a, M, N, K, alpha, A.ptr<const float>(), na, packed_B.data(), 1.f, Y.ptr<float>(), N, gemm_opt);
         } else {
-            fastGemmBatch(trans_a, trans_b, alpha, A, inputs[1], 1.f, Y, opt);
+            fastGemmBatch(trans_a, trans_b, alpha, A, inputs[1], 1.f, Y, gemm_opt);
         }
     }
 
@@ -364,14 +387,47 @@ public:
     }
 #endif
 
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE {
+        // Gemm with constant B is executed as fully connected layer: Y = A * (alpha * B) + beta * C
+        if (!const_B || trans_a || (have_bias && !const_C) || scales[0].size() != 1)
+            return false;
+
+        Mat weights;  // [N, K]
+        if (trans_b)
+            blobs[0].convertTo(weights, CV_32F, alpha);
+        else
+            weights = alpha * blobs[0].t();
+        int N = weights.rows;
+
+        Mat bias;
+        if (have_bias) {
+            const auto &C = blobs.back();
+            if (C.total() == 1)  // (), (1,), (1, 1)
+                bias = Mat(1, N, CV_32F, Scalar(beta * C.ptr<const float>()[0]));
+            else if (C.total() == (size_t)N && shape(C).back() == N)  // (N,), (1, N)
+                bias = beta * C.reshape(1, 1);
+            else
+                return false;
+        }
+
+        bool perChannel = params.get<bool>("per_channel", true);
+        quantizeFullyConnectedWeights(weights, bias, scales[0][0], zeropoints[0][0], scales[1][0], perChannel, params);
+        params.set("num_output", N);
+        params.set("axis", 1);
+        return true;
+    }
+
 private:
     bool const_B;
     bool const_C;
     bool have_bias;
     std::vector<float> packed_B;
+    std::vector<hfloat> packed_B_fp16;
     std::vector<float> broadcast_C;
     int real_ndims_C;
     FastGemmOpt opt;
+    Ptr<PointwiseChainLayer> activ;
 };
 
 Ptr<GemmLayer> GemmLayer::create(const LayerParams& params) {
@@ -3,6 +3,7 @@
 // of this distribution and at http://opencv.org/license.html.
 
 #include "../precomp.hpp"
+#include "layers_common.hpp"
 #include <opencv2/dnn/shape_utils.hpp>
 #include "./cpu_kernels/fast_norm.hpp"
 
@@ -56,6 +57,17 @@ public:
         return false;
     }
 
+    bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE {
+        if (layer.empty()) {
+            activ.release();
+            return false;
+        }
+        if (!IS_DNN_CPU_TARGET(preferableTarget))
+            return false;
+        activ = PointwiseChainLayer::append(activ, layer);
+        return true;
+    }
+
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE {
         CV_TRACE_FUNCTION();
         CV_TRACE_ARG_VALUE(name, "name", name.c_str());
@@ -73,7 +85,7 @@ public:
         const auto& scale = inputs[1];
         const auto& bias = inputs[2];
 
-        fastNormGroup(input, scale, bias, outputs[0], epsilon, num_groups);
+        fastNormGroup(input, scale, bias, outputs[0], epsilon, num_groups, activ.get());
     }
 
 #ifdef HAVE_OPENCL
@@ -181,6 +193,7 @@ public:
 private:
     float epsilon;
     size_t num_groups;
+    Ptr<PointwiseChainLayer> activ;
 };
 
 Ptr<GroupNormLayer> GroupNormLayer::create(const LayerParams &params) {
@@ -3,6 +3,7 @@
 // of this distribution and at http://opencv.org/license.html.
 
 #include "../precomp.hpp"
+#include "layers_common.hpp"
 #include <opencv2/dnn/shape_utils.hpp>
 #include "./cpu_kernels/fast_norm.hpp"
 
@@ -66,6 +67,17 @@ public:
         return false;
     }
 
+    bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE {
+        if (layer.empty()) {
+            activ.release();
+            return false;
+        }
+        if (!IS_DNN_CPU_TARGET(preferableTarget))
+            return false;
+        activ = PointwiseChainLayer::append(activ, layer);
+        return true;
+    }
+
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE {
         CV_TRACE_FUNCTION();
         CV_TRACE_ARG_VALUE(name, "name", name.c_str());
@@ -87,7 +99,7 @@ public:
         const auto &scale = inputs[1];
         const auto &bias = inputs[2];
 
-        fastNormChannel(input, scale, bias, outputs[0], epsilon);
+        fastNormChannel(input, scale, bias, outputs[0], epsilon, activ.get());
     }
 
 #ifdef HAVE_OPENCL
@@ -264,6 +276,8 @@ public:
     }
 #endif // HAVE_CUDA
 
+private:
+    Ptr<PointwiseChainLayer> activ;
 };
 
 Ptr<InstanceNormLayer> InstanceNormLayer::create(const LayerParams &params) {
@@ -34,6 +34,7 @@ class LayerNormLayerImpl CV_FINAL : public LayerNormLayer
 #ifdef HAVE_OPENCL
     UMat weight_umat, bias_umat;
 #endif
+    Ptr<PointwiseChainLayer> activ;
 
 public:
     LayerNormLayerImpl(const LayerParams& params)
@@ -89,6 +90,21 @@ public:
         return false;
     }
 
+    bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
+    {
+        if (layer.empty())
+        {
+            activ.release();
+            return false;
+        }
+        // Activation is applied to the normalized rows, so it has to be the same for all the channels
+        if (!IS_DNN_CPU_TARGET(preferableTarget) ||
+            !layer.dynamicCast<ChannelsPReLULayer>().empty() || !layer.dynamicCast<BatchNormLayer>().empty())
+            return false;
+        activ = PointwiseChainLayer::append(activ, layer);
+        return true;
+    }
+
     virtual void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr) CV_OVERRIDE {
         std::vector<Mat> inputs;
         inputs_arr.getMatVector(inputs);
@@ -126,9 +142,9 @@ public:
 
         if ((inputs.size() + blobs.size()) >= 3) {
             const auto &bias = blobs.empty() ? inputs[2] : blobs.back();
-            fastNorm(input, scale, bias, output, epsilon, static_cast<size_t>(axis));
+            fastNorm(input, scale, bias, output, epsilon, static_cast<size_t>(axis), activ.get());
         } else {
-            fastNorm(input, scale, output, epsilon, static_cast<size_t>(axis));
+            fastNorm(input, scale, output, epsilon, static_cast<size_t>(axis), activ.get());
         }
     }
 
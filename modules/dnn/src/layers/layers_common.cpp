@@ -264,5 +264,176 @@ double getWeightScale(const Mat& weightsMat)
     return (realMax == realMin) ? 1.0 : std::max(-realMin, realMax)/127;
 }
 
+void quantizeFullyConnectedWeights(const Mat& weightsMat, const Mat& biasMat, float inputScale, int inputZp,
+                                   float outputScale, bool perChannel, LayerParams& params)
+{
+    CV_Assert(weightsMat.dims == 2 && weightsMat.type() == CV_32F);
+    int numOutput = weightsMat.rows;
+    CV_Assert(biasMat.empty() || (biasMat.type() == CV_32F && (int)biasMat.total() == numOutput));
+
+    Mat weightsQuantized(weightsMat.rows, weightsMat.cols, CV_8S);
+    Mat biasQuantized(1, numOutput, CV_32S);
+    Mat outputMultiplier(1, numOutput, CV_32F);
+    double weightsScale = perChannel ? 0.0 : getWeightScale(weightsMat);
+
+    for (int i = 0; i < numOutput; i++)
+    {
+        if (perChannel) // per-Channel quantization.
+            weightsScale = getWeightScale(weightsMat.row(i));
+
+        weightsMat.row(i).convertTo(weightsQuantized.row(i), CV_8S, 1.f/weightsScale);
+        float biasScale = inputScale * weightsScale;
+        float bias = biasMat.empty() ? 0.f : biasMat.ptr<float>()[i];
+        biasQuantized.at<int>(i) = cvRound(bias/biasScale) - inputZp*(cv::sum(weightsQuantized.row(i))[0]);
+        outputMultiplier.at<float>(i) = biasScale / outputScale;
+    }
+
+    params.blobs.clear();
+    params.set("per_channel", perChannel);
+    params.blobs.push_back(weightsQuantized);
+    params.blobs.push_back(biasQuantized);
+    params.blobs.push_back(outputMultiplier);
+    params.set("input_scale", inputScale);
+    params.set("input_zeropoint", inputZp);
+}
+
+
+namespace
+{
+
+template <typename Op>
+static void applyConstOperation(const float* src, float* dst, int len, const float* values, bool perElement, Op op)
+{
+    if (perElement)
+    {
+        for (int i = 0; i < len; i++)
+            dst[i] = op(src[i], values[i]);
+    }
+    else
+    {
+        const float v = values[0];
+        for (int i = 0; i < len; i++)
+            dst[i] = op(src[i], v);
+    }
+}
+
+static void applyConstOperation(int op, const float* src, float* dst, int len, const float* values, bool perElement)
+{
+    switch (op)
+    {
+    case PointwiseChainLayer::CONST_ADD:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return x + v; });
+        break;
+    case PointwiseChainLayer::CONST_SUB:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return x - v; });
+        break;
+    case PointwiseChainLayer::CONST_RSUB:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return v - x; });
+        break;
+    case PointwiseChainLayer::CONST_MUL:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return x * v; });
+        break;
+    case PointwiseChainLayer::CONST_DIV:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return x / v; });
+        break;
+    case PointwiseChainLayer::CONST_MAX:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return std::max(x, v); });
+        break;
+    case PointwiseChainLayer::CONST_MIN:
+        applyConstOperation(src, dst, len, values, perElement, [](float x, float v) { return std::min(x, v); });
+        break;
+    default:
+        CV_Error(Error::StsNotImplemented, cv::format("DNN: unsupported fused operation: %d", op));
+    }
+}
+
+}  // namespace
+
+Ptr<PointwiseChainLayer> PointwiseChainLayer::append(const Ptr<ActivationLayer>& chain, const Ptr<ActivationLayer>& activ)
+{
+    CV_Assert(activ);
+    Ptr<PointwiseChainLayer> result = makePtr<PointwiseChainLayer>();
+    result->type = "PointwiseChain";
+    for (int i = 0; i < 2; i++)
+    {
+        const Ptr<ActivationLayer>& layer = i == 0 ? chain : activ;
+        if (!layer)
+            continue;
+        Ptr<PointwiseChainLayer> layerChain = layer.dynamicCast<PointwiseChainLayer>();
+        if (layerChain)
+        {
+            result->steps.insert(result->steps.end(), layerChain->steps.begin(), layerChain->steps.end());
+        }
+        else
+        {
+            Step step;
+            step.activ = layer;
+            step.perChannel = layer.dynamicCast<ChannelsPReLULayer>() || layer.dynamicCast<BatchNormLayer>();
+            step.op = -1;
+            result->steps.push_back(step);
+        }
+        result->name = result->name.empty() ? layer->name : result->name + "+" + layer->name;
+    }
+    return result;
+}
+
+Ptr<PointwiseChainLayer> PointwiseChainLayer::create(ConstOperation op, const Mat& values)
+{
+    CV_CheckTypeEQ(values.type(), CV_32FC1, "");
+    CV_Assert(!values.empty());
+    Ptr<PointwiseChainLayer> result = makePtr<PointwiseChainLayer>();
+    result->type = "PointwiseChain";
+    Step step;
+    step.perChannel = values.total() > 1;
+    step.op = op;
+    step.values = values.isContinuous() ? values.reshape(1, 1) : values.clone().reshape(1, 1);
+    result->steps.push_back(step);
+    return result;
+}
+
+void PointwiseChainLayer::applyStep(const Step& step, const float* src, float* dst, int len, size_t planeSize, int cn0, int cn1) const
+{
+    if (step.activ)
+    {
+        step.activ->forwardSlice(src, dst, len, planeSize, cn0, cn1);
+        return;
+    }
+    CV_DbgAssert(!step.perChannel || cn1 <= (int)step.values.total());
+    const float* values = step.values.ptr<float>();
+    for (int cn = cn0; cn < cn1; cn++, src += planeSize, dst += planeSize)
+        applyConstOperation(step.op, src, dst, len, step.perChannel ? values + cn : values, false);
+}
+
+void PointwiseChainLayer::forwardSlice(const float* src, float* dst, int len, size_t planeSize, int cn0, int cn1) const
+{
+    for (size_t i = 0; i < steps.size(); i++)
+        applyStep(steps[i], i == 0 ? src : dst, dst, len, planeSize, cn0, cn1);
+}
+
+void PointwiseChainLayer::apply(float* c, int ldc, int m, int n, int j0) const
+{
+    for (int i = 0; i < m; i++)
+    {
+        float* row = c + (size_t)i * ldc;
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            const Step& step = steps[k];
+            if (step.activ)
+            {
+                // the whole row is a single plane for activations which don't depend on channel
+                if (step.perChannel)
+                    step.activ->forwardSlice(row, row, 1, 1, j0, j0 + n);
+                else
+                    step.activ->forwardSlice(row, row, n, n, 0, 1);
+            }
+            else
+            {
+                CV_DbgAssert(!step.perChannel || j0 + n <= (int)step.values.total());
+                applyConstOperation(step.op, row, row, n, step.values.ptr<float>() + (step.perChannel ? j0 : 0), step.perChannel);
+            }
+        }
+    }
+}
+
 }
 }
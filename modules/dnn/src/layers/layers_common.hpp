@@ -44,6 +44,7 @@
 #define __OPENCV_DNN_LAYERS_LAYERS_COMMON_HPP__
 #include <opencv2/dnn.hpp>
 #include <opencv2/dnn/shape_utils.hpp>
+#include <opencv2/dnn/all_layers.hpp>
 
 #define CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 // dispatched AVX/AVX2 optimizations
@@ -55,6 +56,8 @@
 #include "../ocl4dnn/include/ocl4dnn.hpp"
 #endif
 
+#include "cpu_kernels/fast_gemm.hpp"
+
 namespace cv
 {
 namespace dnn
@@ -76,6 +79,70 @@ void getConvPoolPaddings(const std::vector<int>& inp, const std::vector<size_t>&
 
 // Used in quantized model. It will return the (Max_element - Min_element)/127.
 double getWeightScale(const Mat& weightsMat);
+
+// Used in quantized model. Quantizes weights (numOutput x innerSize) of a fully connected operation,
+// fuses bias with input zero point and fills blobs and parameters of InnerProductInt8 layer.
+void quantizeFullyConnectedWeights(const Mat& weightsMat, const Mat& biasMat, float inputScale, int inputZp,
+                                   float outputScale, bool perChannel, LayerParams& params);
+
+// Layer which can run on 4D blobs in channels-last layout, see Net::enableChannelsLast(). Shapes of such
+// blobs are kept in NCHW order, while their data is stored as NHWC. The layout of the layer is chosen by
+// the network after fusion, before the first forward call.
+class ChannelsLastLayer
+{
+public:
+    enum Role
+    {
+        CHANNELS_LAST_UNSUPPORTED,
+        CHANNELS_LAST_SUPPORTED,  // inputs and outputs may be in channels-last layout
+        CHANNELS_LAST_ENTRY,      // NHWC -> NCHW permutation: output may keep NHWC data of the input
+        CHANNELS_LAST_EXIT        // NCHW -> NHWC permutation: input may already contain NHWC data
+    };
+
+    ChannelsLastLayer() : channelsLast(false) {}
+    virtual ~ChannelsLastLayer() {}
+
+    // Returns Role of the layer for given shapes of inputs
+    virtual int getChannelsLastRole(const std::vector<MatShape>& inputs) const = 0;
+
+    // Data of the layer blobs is in channels-last layout: inputs and outputs for CHANNELS_LAST_SUPPORTED,
+    // output for CHANNELS_LAST_ENTRY and input for CHANNELS_LAST_EXIT. Layers of both permutation roles just copy data.
+    bool channelsLast;
+};
+
+// Sequence of pointwise operations fused into the output of Convolution, InnerProduct, Gemm or MatMul layer.
+// The operations are activations and element-wise operations with a constant which is a scalar or has a value
+// per channel. All of them are applied to a tile of the output while it's still in cache.
+// Columns of the output are channels for the matrix multiplication layers (see FastGemmEpilogue).
+class PointwiseChainLayer CV_FINAL : public ActivationLayer, public FastGemmEpilogue
+{
+public:
+    enum ConstOperation { CONST_ADD, CONST_SUB, CONST_RSUB, CONST_MUL, CONST_DIV, CONST_MAX, CONST_MIN };
+
+    // Returns chain with `activ` applied after operations of `chain`, which may be empty, a single activation or a chain.
+    static Ptr<PointwiseChainLayer> append(const Ptr<ActivationLayer>& chain, const Ptr<ActivationLayer>& activ);
+
+    // Returns chain of a single operation `x op values` (`values op x` for CONST_RSUB).
+    // `values` has a single element or an element per channel.
+    static Ptr<PointwiseChainLayer> create(ConstOperation op, const Mat& values);
+
+    void forwardSlice(const float* src, float* dst, int len, size_t planeSize, int cn0, int cn1) const CV_OVERRIDE;
+
+    void apply(float* c, int ldc, int m, int n, int j0) const CV_OVERRIDE;
+
+private:
+    struct Step
+    {
+        Ptr<ActivationLayer> activ;
+        bool perChannel;  // activation depends on channel index
+        int op;
+        Mat values;
+    };
+
+    void applyStep(const Step& step, const float* src, float* dst, int len, size_t planeSize, int cn0, int cn1) const;
+
+    std::vector<Step> steps;
+};
 }
 }
 
@@ -5,6 +5,7 @@
 #include "../precomp.hpp"
 
 #include <opencv2/dnn/shape_utils.hpp>
+#include "layers_common.hpp"
 #include "cpu_kernels/fast_gemm.hpp"
 
 // OpenVINO backend
@@ -130,9 +131,17 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
                    C_shape = shape(outputs[0]);
         helper.compute(trans_a, trans_b, A_shape, B_shape, C_shape);
 
+        packed_input_B.clear();
+        packed_input_B_fp16.clear();
         if (!blobs.empty()) {
-            fastGemmPackB(blobs[0], packed_input_B, trans_b, opt);
-            helper.updatePackedBOffsets(packed_input_B.size());
+            // keep packed weights in FP16 for DNN_TARGET_CPU_FP16, they are widened back to FP32 inside fastGemm
+            if (preferableTarget == DNN_TARGET_CPU_FP16) {
+                fastGemmPackB(blobs[0], packed_input_B_fp16, trans_b, opt);
+                helper.updatePackedBOffsets(packed_input_B_fp16.size());
+            } else {
+                fastGemmPackB(blobs[0], packed_input_B, trans_b, opt);
+                helper.updatePackedBOffsets(packed_input_B.size());
+            }
         }
 
         // broadcast bias if needed
@@ -174,6 +183,18 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
 #endif
     }
 
+    // Activations and element-wise operations with constants are applied to tiles of output by fastGemm
+    virtual bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE {
+        if (layer.empty()) {
+            activ.release();
+            return false;
+        }
+        if (!IS_DNN_CPU_TARGET(preferableTarget))
+            return false;
+        activ = PointwiseChainLayer::append(activ, layer);
+        return true;
+    }
+
     // works like Y = numpy.matmul(A, B)
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE {
         CV_TRACE_FUNCTION();
@@ -230,16 +251,23 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
             std::memset(y, 0, Y.total() * sizeof(float));
         }
 
+        // layer may be run by several execution contexts concurrently, so fused operations are set to a copy of options
+        FastGemmOpt gemm_opt = opt;
+        gemm_opt.epilogue = activ.get();
         if (blobs.empty()) {
             const auto &B = inputs[1];
             const auto *b = B.ptr<const float>();
             fastGemmBatch(helper.batch, helper.A_offsets.data(), helper.B_offsets.data(), helper.C_offsets.data(),
                           helper.M, helper.N, helper.K, alpha, a, helper.lda0, helper.lda1,
-                          b, helper.ldb0, helper.ldb1, beta, y, helper.ldc, opt);
+                          b, helper.ldb0, helper.ldb1, beta, y, helper.ldc, gemm_opt);
+        } else if (!packed_input_B_fp16.empty()) {
+            fastGemmBatch(helper.batch, helper.A_offsets.data(), helper.packed_B_offsets.data(), helper.C_offsets.data(),
+                          helper.M, helper.N, helper.K, alpha, a, helper.lda0, helper.lda1,
+                          packed_input_B_fp16.data(), beta, y, helper.ldc, gemm_opt);
         } else {
             fastGemmBatch(helper.batch, helper.A_offsets.data(), helper.packed_B_offsets.data(), helper.C_offsets.data(),
                           helper.M, helper.N, helper.K, alpha, a, helper.lda0, helper.lda1,
-                          packed_input_B.data(), beta, y, helper.ldc, opt);
+                          packed_input_B.data(), beta, y, helper.ldc, gemm_opt);
         }
     }
 
@@ -463,6 +491,64 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
     }
 #endif // HAVE_CANN
 
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE {
+        if (blobs.empty()) {
+            // both inputs are variable, the bias is not supported
+            if (scales[0].size() != 2)
+                return false;
+            params.blobs.clear();
+            params.set("input_scales", DictValue::arrayReal(scales[0].data(), scales[0].size()));
+            params.set("input_zeropoints", DictValue::arrayInt(zeropoints[0].data(), zeropoints[0].size()));
+            return true;
+        }
+
+        if (scales[0].size() != 1)
+            return false;
+
+        if (trans_a || blobs[0].dims != 2) {
+            // constant B which can not be folded into fully connected layer
+            // is quantized per tensor and packed once by MatMulInt8, the bias is not supported
+            if (blobs.size() > 1)
+                return false;
+            float scale_B = (float)getWeightScale(blobs[0]);
+            Mat B;
+            blobs[0].convertTo(B, CV_8S, 1.f / scale_B);
+            float sc[] = {scales[0][0], scale_B};
+            int zp[] = {zeropoints[0][0], 0};
+            params.blobs.assign(1, B);
+            params.set("input_scales", DictValue::arrayReal(sc, 2));
+            params.set("input_zeropoints", DictValue::arrayInt(zp, 2));
+            return true;
+        }
+
+        // constant B is executed as fully connected layer: Y = A * (alpha * B) + beta * C
+
+        Mat weights;  // [N, K]
+        if (trans_b)
+            blobs[0].convertTo(weights, CV_32F, alpha);
+        else
+            weights = alpha * blobs[0].t();
+        int N = weights.rows;
+
+        Mat bias;
+        if (blobs.size() > 1) {
+            const auto &C = blobs.back();
+            if (C.total() == 1)  // [], [1], [1, ...]
+                bias = Mat(1, N, CV_32F, Scalar(beta * C.ptr<const float>()[0]));
+            else if (C.total() == (size_t)N && shape(C).back() == N)  // [N], [1, ..., N]
+                bias = beta * C.reshape(1, 1);
+            else
+                return false;
+        }
+
+        bool perChannel = params.get<bool>("per_channel", true);
+        quantizeFullyConnectedWeights(weights, bias, scales[0][0], zeropoints[0][0], scales[1][0], perChannel, params);
+        params.set("num_output", N);
+        params.set("axis", -1);
+        return true;
+    }
+
  private:
     bool trans_a;
     bool trans_b;
@@ -472,9 +558,11 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
     int real_ndims_C;
 
     std::vector<float> packed_input_B;
+    std::vector<hfloat> packed_input_B_fp16;
     Mat broadcast_bias;
 
     FastGemmOpt opt;
+    Ptr<PointwiseChainLayer> activ;
     MatMulHelper helper;
 };
 
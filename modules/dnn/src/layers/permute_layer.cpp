@@ -66,7 +66,7 @@ namespace cv
 {
 namespace dnn
 {
-class PermuteLayerImpl CV_FINAL : public PermuteLayer
+class PermuteLayerImpl CV_FINAL : public PermuteLayer, public ChannelsLastLayer
 {
 public:
     void checkNeedForPermutation()
@@ -83,7 +83,8 @@ public:
     }
 
     PermuteLayerImpl(const LayerParams &params)
-        : _count(0), _needsPermute(false), _numAxes(0)
+        : _count(0), _needsPermute(false), _copyOnly(false),
+          _transposeBatch(0), _transposeRows(0), _transposeCols(0), _numAxes(0)
     {
         if (!params.has("order"))
         {
@@ -195,6 +196,82 @@ public:
         _count = _oldStride[0] * shapeBefore[0];
     }
 
+    // Detects permutations which keep order of data (only axes of size 1 are moved) or
+    // swap two groups of consecutive axes, e.g. NCHW <-> NHWC or NCDHW <-> NDHWC. Such
+    // permutations are done by a memory copy or by a batch of transposed matrices.
+    void computeTransposeShape(const MatShape &shapeBefore)
+    {
+        _copyOnly = false;
+        _transposeBatch = _transposeRows = _transposeCols = 0;
+
+        std::vector<int> rank(_numAxes, -1);
+        for (size_t i = 0, r = 0; i < _numAxes; i++)
+        {
+            if (shapeBefore[i] != 1)
+                rank[i] = (int)r++;
+        }
+
+        // Non-unit axes in order of output merged into groups of consecutive input axes
+        std::vector<int> groupRank;
+        std::vector<size_t> groupSize;
+        int prevRank = -2;
+        for (size_t i = 0; i < _numAxes; i++)
+        {
+            int r = rank[_order[i]];
+            if (r < 0)
+                continue;
+            if (r == prevRank + 1)
+                groupSize.back() *= shapeBefore[_order[i]];
+            else
+            {
+                groupRank.push_back(r);
+                groupSize.push_back(shapeBefore[_order[i]]);
+            }
+            prevRank = r;
+        }
+
+        if (groupRank.size() <= 1)
+            _copyOnly = true;
+        else if (groupRank.size() == 2)
+        {
+            _transposeBatch = 1;
+            _transposeRows = groupSize[1];
+            _transposeCols = groupSize[0];
+        }
+        else if (groupRank.size() == 3 && groupRank[0] == 0)
+        {
+            _transposeBatch = groupSize[0];
+            _transposeRows = groupSize[2];
+            _transposeCols = groupSize[1];
+        }
+    }
+
+    // Transposes batch of rows x cols matrices by tiles
+    template <typename T>
+    static void transposeBatch(const T* src, T* dst, size_t batch, size_t rows, size_t cols)
+    {
+        const size_t tileSize = 32;
+        size_t rowTiles = (rows + tileSize - 1) / tileSize, colTiles = (cols + tileSize - 1) / tileSize;
+        size_t tiles = batch * rowTiles * colTiles;
+        parallel_for_(Range(0, (int)tiles), [&](const Range& r)
+        {
+            for (int t = r.start; t < r.end; t++)
+            {
+                size_t b = t / (rowTiles * colTiles), tile = t % (rowTiles * colTiles);
+                size_t i0 = (tile / colTiles) * tileSize, j0 = (tile % colTiles) * tileSize;
+                size_t i1 = std::min(i0 + tileSize, rows), j1 = std::min(j0 + tileSize, cols);
+                const T* srcb = src + b * rows * cols;
+                T* dstb = dst + b * rows * cols;
+                for (size_t j = j0; j < j1; j++)
+                {
+                    T* dstrow = dstb + j * rows;
+                    for (size_t i = i0; i < i1; i++)
+                        dstrow[i] = srcb[i * cols + j];
+                }
+            }
+        }, (double)batch * rows * cols / (1 << 16));
+    }
+
     void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr) CV_OVERRIDE
     {
         if(!_needsPermute)
@@ -210,6 +287,7 @@ public:
         CV_Assert((int)_numAxes == inp0.dims);
 
         computeStrides(shape(inputs[0]), shape(outputs[0]));
+        computeTransposeShape(shape(inputs[0]));
 
 #ifdef HAVE_OPENCL
         uorder.release();
@@ -341,6 +419,17 @@ public:
     }
 #endif
 
+    int getChannelsLastRole(const std::vector<MatShape>& inputs) const CV_OVERRIDE
+    {
+        if (_numAxes != 4 || inputs.size() != 1 || inputs[0].size() != 4 || preferableTarget != DNN_TARGET_CPU)
+            return CHANNELS_LAST_UNSUPPORTED;
+        if (_order[0] == 0 && _order[1] == 3 && _order[2] == 1 && _order[3] == 2)
+            return CHANNELS_LAST_ENTRY;
+        if (_order[0] == 0 && _order[1] == 2 && _order[2] == 3 && _order[3] == 1)
+            return CHANNELS_LAST_EXIT;
+        return CHANNELS_LAST_UNSUPPORTED;
+    }
+
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
     {
         CV_TRACE_FUNCTION();
@@ -361,13 +450,16 @@ public:
         outputs_arr.getMatVector(outputs);
 
         size_t k, ninputs = inputs.size();
-        if(!_needsPermute)
+        if (!_needsPermute || channelsLast)
         {
+            // In channels-last regions the data is already in the required layout
+            if (channelsLast)
+                reportKernel("copy");
             for (k = 0; k < ninputs; k++)
             {
                 CV_Assert(outputs[k].total() == inputs[k].total());
                 if (outputs[k].data != inputs[k].data)
-                    inputs[k].copyTo(outputs[k]);
+                    inputs[k].reshape(1, shape(outputs[k])).copyTo(outputs[k]);
             }
         }
         else
@@ -388,7 +480,19 @@ public:
                 CV_Assert(inp.isContinuous() && out.isContinuous());
                 // CV_Assert(inp.type() == CV_32F && out.type() == CV_32F);
 
-                if( numAxes == 4 )
+                if (_copyOnly)
+                {
+                    if (out.data != inp.data)
+                        std::memcpy(out.data, inp.data, inp.total() * inp.elemSize());
+                }
+                else if (_transposeRows > 0)
+                {
+                    if (inp.type() == CV_8S)
+                        transposeBatch(inp.ptr<int8_t>(), out.ptr<int8_t>(), _transposeBatch, _transposeRows, _transposeCols);
+                    else
+                        transposeBatch(inp.ptr<float>(), out.ptr<float>(), _transposeBatch, _transposeRows, _transposeCols);
+                }
+                else if( numAxes == 4 )
                 {
                     int nstripes = getNumThreads();
                     if (inp.type() == CV_8S)
@@ -634,6 +738,10 @@ public:
     std::vector<size_t> _newStride;
     bool _needsPermute;
 
+    // Permutation which is done as a copy or as transposition of matrices
+    bool _copyOnly;
+    size_t _transposeBatch, _transposeRows, _transposeCols;
+
 #ifdef HAVE_OPENCL
     UMat uorder, uold_stride, unew_stride;
 #endif
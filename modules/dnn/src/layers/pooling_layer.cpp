@@ -94,7 +94,7 @@ static inline int roundRoiSize(float v)
     return (int)(v + (v >= 0.f ? 0.5f : -0.5f));
 }
 
-class PoolingLayerImpl CV_FINAL : public PoolingLayer
+class PoolingLayerImpl CV_FINAL : public PoolingLayer, public ChannelsLastLayer
 {
 public:
     PoolingLayerImpl(const LayerParams& params)
@@ -338,6 +338,14 @@ public:
     }
 #endif
 
+    int getChannelsLastRole(const std::vector<MatShape>& inputs) const CV_OVERRIDE
+    {
+        if ((type != MAX && type != AVE && type != SUM) || computeMaxIdx || inputs.size() != 1 ||
+            inputs[0].size() != 4 || kernel_size.size() != 2 || preferableTarget != DNN_TARGET_CPU)
+            return CHANNELS_LAST_UNSUPPORTED;
+        return CHANNELS_LAST_SUPPORTED;
+    }
+
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
     {
         CV_TRACE_FUNCTION();
@@ -358,6 +366,14 @@ public:
         inputs_arr.getMatVector(inputs);
         outputs_arr.getMatVector(outputs);
 
+        if (channelsLast)
+        {
+            CV_Assert_N(inputs.size() == 1, outputs.size() == 1);
+            reportKernel("nhwc");
+            poolingChannelsLast(inputs[0], outputs[0]);
+            return;
+        }
+
         switch (type)
         {
             case MAX:
@@ -1174,6 +1190,80 @@ public:
         PoolingInvoker::run(src, rois, dst, mask, kernel_size, strides, pads_begin, pads_end, avePoolPaddedArea, type, spatialScale, computeMaxIdx, nstripes);
     }
 
+    // Same results as PoolingInvoker for 2D MAX, AVE and SUM pooling, but the data is NHWC,
+    // so every output pixel is computed for all the channels at once.
+    void poolingChannelsLast(const Mat &src, Mat &dst) const
+    {
+        CV_Assert_N(src.isContinuous(), dst.isContinuous(), src.type() == CV_32F, dst.type() == CV_32F,
+                    src.dims == 4, dst.dims == 4, src.size[0] == dst.size[0], src.size[1] == dst.size[1]);
+        const int N = src.size[0], C = src.size[1], inp_height = src.size[2], inp_width = src.size[3];
+        const int height = dst.size[2], width = dst.size[3];
+        const int kernel_h = (int)kernel_size[0], kernel_w = (int)kernel_size[1];
+        const int stride_h = (int)strides[0], stride_w = (int)strides[1];
+        const int pad_t = (int)pads_begin[0], pad_l = (int)pads_begin[1];
+        const int pad_b = (int)pads_end[0], pad_r = (int)pads_end[1];
+        const float* srcData = src.ptr<float>();
+        float* dstData = dst.ptr<float>();
+
+        parallel_for_(Range(0, N * height), [&](const Range& r)
+        {
+            for (int row = r.start; row < r.end; row++)
+            {
+                const int n = row / height, y0 = row % height;
+                int ystart = y0 * stride_h - pad_t;
+                int yend = min(ystart + kernel_h, inp_height + pad_b);
+                const int ydelta = yend - ystart;
+                ystart = max(ystart, 0);
+                yend = min(yend, inp_height);
+                for (int x0 = 0; x0 < width; x0++)
+                {
+                    int xstart = x0 * stride_w - pad_l;
+                    int xend = min(xstart + kernel_w, inp_width + (type == MAX ? 0 : pad_r));
+                    const int xdelta = xend - xstart;
+                    xstart = max(xstart, 0);
+                    xend = min(xend, inp_width);
+
+                    float* out = dstData + ((size_t)row * width + x0) * C;
+                    if (type == MAX && (xstart >= xend || ystart >= yend))
+                    {
+                        memset(out, 0, C * sizeof(out[0]));
+                        continue;
+                    }
+                    float scale = 1.f;
+                    if (type == AVE)
+                        scale = 1.f / (avePoolPaddedArea ? xdelta * ydelta : (yend - ystart) * (xend - xstart));
+
+                    int c = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+                    const int nlanes = VTraits<v_float32>::vlanes();
+                    for (; c <= C - nlanes; c += nlanes)
+                    {
+                        v_float32 s = type == MAX ? vx_setall_f32(-FLT_MAX) : vx_setzero_f32();
+                        for (int y = ystart; y < yend; y++)
+                        {
+                            const float* inp = srcData + (((size_t)n * inp_height + y) * inp_width + xstart) * C + c;
+                            for (int x = xstart; x < xend; x++, inp += C)
+                                s = type == MAX ? v_max(s, vx_load(inp)) : v_add(s, vx_load(inp));
+                        }
+                        v_store(out + c, type == MAX ? s : v_mul(s, vx_setall_f32(scale)));
+                    }
+#endif
+                    for (; c < C; c++)
+                    {
+                        float s = type == MAX ? -FLT_MAX : 0.f;
+                        for (int y = ystart; y < yend; y++)
+                        {
+                            const float* inp = srcData + (((size_t)n * inp_height + y) * inp_width + xstart) * C + c;
+                            for (int x = xstart; x < xend; x++, inp += C)
+                                s = type == MAX ? std::max(s, *inp) : s + *inp;
+                        }
+                        out[c] = type == MAX ? s : s * scale;
+                    }
+                }
+            }
+        });
+    }
+
     void roiPooling(const Mat &src, const Mat &rois, Mat &dst)
     {
         const int nstripes = getNumThreads();
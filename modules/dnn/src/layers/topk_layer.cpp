@@ -140,7 +140,7 @@ public:
                     cmp.addOffset(offset);
 
                     std::iota(buffer_index_ptr, buffer_index_ptr + dim_axis, 0);
-                    std::stable_sort(buffer_index_ptr, buffer_index_ptr + dim_axis, cmp);
+                    std::partial_sort(buffer_index_ptr, buffer_index_ptr + K, buffer_index_ptr + dim_axis, cmp);
 
                     auto *output_value_offset_ptr = output_value_ptr + offset;
                     auto *output_index_offset_ptr = output_index_ptr + offset;
@@ -169,7 +169,7 @@ public:
                         cmp.addOffset(batch_index * dim_axis * step + offset);
 
                         std::iota(buffer_index_ptr, buffer_index_ptr + dim_axis, 0);
-                        std::stable_sort(buffer_index_ptr, buffer_index_ptr + dim_axis, cmp);
+                        std::partial_sort(buffer_index_ptr, buffer_index_ptr + K, buffer_index_ptr + dim_axis, cmp);
 
                         auto *output_value_offset_ptr = output_value_ptr + batch_index * K * step + offset;
                         auto *output_index_offset_ptr = output_index_ptr + batch_index * K * step + offset;
@@ -6,6 +6,8 @@
 
 #include "legacy_backend.hpp"
 
+#include <opencv2/core/private.hpp>  // CV_MALLOC_ALIGN
+
 #include "op_halide.hpp"
 #include "op_inf_engine.hpp"
 #include "ie_ngraph.hpp"
@@ -15,6 +17,8 @@
 #include "op_timvx.hpp"
 #include "op_cann.hpp"
 
+#include <opencv2/core/utils/logger.hpp>
+
 namespace cv {
 namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
@@ -126,6 +130,144 @@ Ptr<BackendWrapper> wrapMat(int backendId, int targetId, cv::Mat& m)
 }  // wrapMat()
 
 
+void LayersDependencies::build(const std::vector<std::vector<int> >& inputs)
+{
+    const size_t numLayers = inputs.size();
+    const size_t numWords = (numLayers + 63) / 64;
+    bits.assign(numLayers, std::vector<uint64>(numWords, 0));
+    for (size_t i = 0; i < numLayers; i++)
+    {
+        std::vector<uint64>& dst = bits[i];
+        for (size_t j = 0; j < inputs[i].size(); j++)
+        {
+            const int inp = inputs[i][j];
+            CV_Assert(0 <= inp && inp < (int)i);
+            const std::vector<uint64>& src = bits[inp];
+            for (size_t k = 0; k < numWords; k++)
+                dst[k] |= src[k];
+            dst[inp >> 6] |= (uint64)1 << (inp & 63);
+        }
+    }
+}
+
+
+bool BlobManager::isAliveTogether(const LayerPin& a, const BlobLifetime& blobA,
+                                  const LayerPin& b, const BlobLifetime& blobB) const
+{
+    if (!dependencies)
+        return blobA.firstStep <= blobB.lastStep && blobB.firstStep <= blobA.lastStep;
+
+    // Order of steps doesn't matter for concurrently running layers:
+    // one blob must be used completely before the other one is produced.
+    for (int i = 0; i < 2; i++)
+    {
+        const LayerPin& first = i == 0 ? a : b;
+        const BlobLifetime& firstBlob = i == 0 ? blobA : blobB;
+        const BlobLifetime& secondBlob = i == 0 ? blobB : blobA;
+        if (firstBlob.lastStep == INT_MAX || !dependencies->dependsOn(secondBlob.producer, firstBlob.producer))
+            continue;
+        std::map<LayerPin, std::vector<int> >::const_iterator usersIt = hostUsers.find(first);
+        bool usedBefore = true;
+        if (usersIt != hostUsers.end())
+        {
+            for (size_t j = 0; j < usersIt->second.size() && usedBefore; j++)
+                usedBefore = dependencies->dependsOn(secondBlob.producer, usersIt->second[j]);
+        }
+        if (usedBefore)
+            return false;
+    }
+    return true;
+}
+
+
+void BlobManager::allocatePlannedArenas()
+{
+    CV_TRACE_FUNCTION();
+
+    refCounter.clear();
+    reuseMap.clear();
+    memHosts.clear();
+    arenas.clear();
+
+    // Greedy by size: the biggest blobs are placed first, every next blob takes the
+    // smallest gap between already placed blobs which are alive at the same time.
+    std::vector<std::pair<size_t, LayerPin> > order;
+    order.reserve(plannedBlobs.size());
+    for (std::map<LayerPin, BlobLifetime>::const_iterator it = plannedBlobs.begin(); it != plannedBlobs.end(); ++it)
+        order.push_back(std::make_pair(it->second.size, it->first));
+    std::stable_sort(order.begin(), order.end(),
+        [](const std::pair<size_t, LayerPin>& a, const std::pair<size_t, LayerPin>& b) { return a.first > b.first; });
+
+    std::map<int, std::vector<std::pair<LayerPin, const BlobLifetime*> > > placed;  // dtype -> blobs
+    std::map<int, size_t> arenaSizes;  // dtype -> number of elements
+    size_t naiveBytes = 0;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const LayerPin& pin = order[i].second;
+        BlobLifetime& blob = plannedBlobs[pin];
+        // keep each blob aligned as separately allocated one
+        const size_t esz = CV_ELEM_SIZE(blob.dtype);
+        const size_t align = std::max((size_t)1, (size_t)CV_MALLOC_ALIGN / esz);
+        const size_t size = alignSize(blob.size, (int)align);
+        naiveBytes += blob.size * esz;
+
+        std::vector<const BlobLifetime*> alive;
+        std::vector<std::pair<LayerPin, const BlobLifetime*> >& placedBlobs = placed[blob.dtype];
+        for (size_t j = 0; j < placedBlobs.size(); j++)
+        {
+            if (isAliveTogether(placedBlobs[j].first, *placedBlobs[j].second, pin, blob))
+                alive.push_back(placedBlobs[j].second);
+        }
+        std::sort(alive.begin(), alive.end(),
+            [](const BlobLifetime* a, const BlobLifetime* b) { return a->offset < b->offset; });
+
+        size_t offset = 0, bestOffset = 0, bestGap = SIZE_MAX;
+        for (size_t j = 0; j < alive.size(); j++)
+        {
+            if (alive[j]->offset >= offset + size && alive[j]->offset - offset < bestGap)
+            {
+                bestGap = alive[j]->offset - offset;
+                bestOffset = offset;
+            }
+            offset = std::max(offset, alive[j]->offset + alignSize(alive[j]->size, (int)align));
+        }
+        blob.offset = bestGap != SIZE_MAX ? bestOffset : offset;
+        placedBlobs.push_back(std::make_pair(pin, (const BlobLifetime*)&blob));
+
+        size_t& arenaSize = arenaSizes[blob.dtype];
+        arenaSize = std::max(arenaSize, blob.offset + size);
+    }
+
+    size_t arenaBytes = 0;
+    std::map<int, Mat> buffers;
+    for (std::map<int, size_t>::const_iterator it = arenaSizes.begin(); it != arenaSizes.end(); ++it)
+    {
+        CV_CheckLE(it->second, (size_t)INT_MAX, "DNN: memory arena is too large");
+        Mat& buffer = buffers[it->first];
+        std::map<int, Mat>::iterator bufIt = arenaBuffers.find(it->first);
+        if (bufIt != arenaBuffers.end() && bufIt->second.total() >= it->second)
+            buffer = bufIt->second;
+        else
+        {
+            // Grow by buckets to not reallocate the buffer for every slightly bigger input.
+            // Step is a power of two which is at most 1/8 of the size, so overhead is under 12.5%.
+            size_t step = 1;
+            while (step * 16 <= it->second)
+                step *= 2;
+            const size_t capacity = std::min(alignSize(it->second, (int)step), (size_t)INT_MAX);
+            if (bufIt != arenaBuffers.end())
+                bufIt->second.release();  // release old memory first to lower the peak
+            buffer.create(1, (int)capacity, it->first);
+        }
+        arenas[it->first] = buffer.colRange(0, (int)it->second);
+        arenaBytes += it->second * CV_ELEM_SIZE(it->first);
+    }
+    arenaBuffers.swap(buffers);
+    CV_LOG_DEBUG(NULL, "DNN: memory planner: " << plannedBlobs.size() << " blobs, peak memory " << arenaBytes
+                 << " bytes (" << naiveBytes << " bytes without reuse)");
+}
+
+
 }  // namespace detail
 CV__DNN_INLINE_NS_END
 }}  // namespace cv::dnn
@@ -106,6 +106,26 @@ private:
 #endif  // HAVE_OPENCL
 
 
+// Transitive closure of dependencies between layers.
+class LayersDependencies
+{
+public:
+    // inputs[i] - layers which must be finished before layer i is started, all of them are less than i.
+    void build(const std::vector<std::vector<int> >& inputs);
+
+    // Returns true if layer b can't be started before layer a is finished.
+    bool dependsOn(int b, int a) const
+    {
+        return a < b && b < (int)bits.size() && ((bits[b][a >> 6] >> (a & 63)) & 1) != 0;
+    }
+
+    bool empty() const { return bits.empty(); }
+    void clear() { bits.clear(); }
+
+private:
+    std::vector<std::vector<uint64> > bits;  // layer -> bitmask of all the layers it depends on
+};
+
 struct BlobManager
 {
 public:
@@ -170,6 +190,15 @@ public:
         CV_Assert(refIt != refCounter.end());
         CV_Assert(refIt->second > 0);
         refIt->second -= 1;
+        if (dependencies && arenas.empty())
+            hostUsers[refIt->first].push_back(planLayer);
+        if (refIt->second == 0 && arenas.empty())
+        {
+            // Blob is not used anymore after the current step of memory planning.
+            std::map<LayerPin, BlobLifetime>::iterator planIt = plannedBlobs.find(refIt->first);
+            if (planIt != plannedBlobs.end())
+                planIt->second.lastStep = planStep;
+        }
     }
 
     void releaseReferences(const std::vector<LayerPin>& pins)
@@ -182,6 +211,28 @@ public:
 
     void reuseOrCreate(const MatShape& shape, const LayerPin& lp, Mat& dst, const int& dtype)
     {
+        if (!arenas.empty())
+        {
+            // Static memory plan: blob is a view of the arena at the precomputed offset.
+            std::map<LayerPin, BlobLifetime>::const_iterator planIt = plannedBlobs.find(lp);
+            if (planIt != plannedBlobs.end())
+            {
+                CV_CheckEQ(planIt->second.dtype, dtype, "");
+                CV_CheckLE((size_t)total(shape), planIt->second.size, "");  // planned for the bucket of shapes
+                const Mat& arena = arenas[dtype];
+                const int offset = (int)planIt->second.offset;
+                dst = arena.colRange(offset, offset + total(shape)).reshape(1, shape);
+                dst.dims = shape.size();
+            }
+            else
+            {
+                CV_Assert(lp.lid == 0);  // network inputs are not planned
+                dst.create(shape, dtype);
+            }
+            addHost(lp, dst);
+            return;
+        }
+
         if (!getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS())
         {
             Mat bestBlob;
@@ -246,7 +297,12 @@ public:
 
         // Check that layer could work in-place.
         bool inPlace = false;
-        if (layerShapes.supportInPlace)
+        if (!arenas.empty())
+        {
+            // the same decision as made by memory planner
+            inPlace = plannedInPlace.count(ld.id) != 0;
+        }
+        else if (layerShapes.supportInPlace)
         {
             if (ld.inputBlobs.size() == 1)
             {
@@ -304,7 +360,89 @@ public:
         }
     }
 
+    // Static memory planning. Mirrors allocateBlobsForLayer() without allocation
+    // of memory: decides in-place reuse the same way and registers every other
+    // blob as a separate host with lifetime [first step, last step].
+    // Layers must be planned in the same order as they are allocated.
+    void planBlobsForLayer(const LayerData& ld, const LayerShapes& layerShapes,
+            std::vector<LayerPin>& pinsForInternalBlobs)
+    {
+        CV_TRACE_FUNCTION();
+
+        pinsForInternalBlobs.clear();
+
+        const ShapesVec &outShapes = layerShapes.out,
+                        internalShapes = layerShapes.internal;
+        const size_t numOutputs = std::max((size_t)1, outShapes.size());
+
+        bool inPlace = false;
+        if (layerShapes.supportInPlace && ld.inputBlobsId.size() == 1)
+            inPlace = numReferences(ld.inputBlobsId[0]) == 1 && isUsedBefore(ld.inputBlobsId[0], ld.id);
+        if (inPlace)
+            plannedInPlace.insert(ld.id);
+
+        for (int i = 0; i < internalShapes.size(); i++)
+        {
+            if (total(internalShapes[i]))
+                pinsForInternalBlobs.push_back(LayerPin(ld.id, numOutputs + i));
+        }
+        addReferences(pinsForInternalBlobs);
+
+        planStep++;
+        planLayer = ld.id;
+        for (int index = 0; index < outShapes.size() + internalShapes.size(); index++)
+        {
+            const MatShape& shape = index < outShapes.size() ? outShapes[index] : internalShapes[index - outShapes.size()];
+            if (!total(shape))
+                continue;
+            LayerPin blobPin(ld.id, index);
+            if (index < outShapes.size() && inPlace)
+            {
+                reuse(ld.inputBlobsId[0], blobPin);
+            }
+            else
+            {
+                CV_Assert(reuseMap.find(blobPin) == reuseMap.end());
+                reuseMap[blobPin] = blobPin;
+                // Keep network inputs out of the arena: they share memory
+                // with the user's data if no preprocessing is required (see DataLayer).
+                if (ld.id == 0)
+                    continue;
+                BlobLifetime& blob = plannedBlobs[blobPin];
+                blob.dtype = ld.dtype;
+                blob.size = total(shape);
+                blob.firstStep = planStep;
+                blob.lastStep = INT_MAX;  // updated on the last reference release
+                blob.offset = 0;
+                blob.producer = ld.id;
+            }
+        }
+    }
+
+    // Assigns offsets to the planned blobs so that blobs with overlapped
+    // lifetimes never share memory, and allocates one arena per data type.
+    // Resets references counters: allocation must be started from scratch.
+    void allocatePlannedArenas();
+
+    // Layers which don't depend on each other may run concurrently. If dependencies are set,
+    // memory planner shares memory between blobs only if all the users of one of them
+    // are finished before another one is produced. Must be set before planning.
+    void setDependencies(const LayersDependencies* deps)
+    {
+        dependencies = deps;
+    }
+
+    // Size of memory arenas in bytes (0 if static memory planning is not used).
+    size_t getArenasSize() const
+    {
+        size_t size = 0;
+        for (std::map<int, Mat>::const_iterator it = arenas.begin(); it != arenas.end(); ++it)
+            size += it->second.total() * it->second.elemSize();
+        return size;
+    }
+
     // Clear internal state. Calls before an every reallocation.
+    // Memory of arenas is kept to be reused by the next allocation.
     void reset()
     {
         CV_TRACE_FUNCTION();
@@ -312,6 +450,12 @@ public:
         refCounter.clear();
         reuseMap.clear();
         memHosts.clear();
+        plannedBlobs.clear();
+        plannedInPlace.clear();
+        hostUsers.clear();
+        arenas.clear();
+        planStep = 0;
+        dependencies = NULL;
     }
 
 private:
@@ -328,6 +472,48 @@ private:
     // For origin blobs key == value.
     std::map<LayerPin, LayerPin> reuseMap;
     std::map<LayerPin, Mat> memHosts;
+
+    // Returns true if all the layers which have used memory of the blob are finished before the layer is started.
+    bool isUsedBefore(const LayerPin& lp, int lid)
+    {
+        if (!dependencies)
+            return true;
+        std::map<LayerPin, LayerPin>::const_iterator mapIt = reuseMap.find(lp);
+        CV_Assert(mapIt != reuseMap.end());
+        std::map<LayerPin, std::vector<int> >::const_iterator usersIt = hostUsers.find(mapIt->second);
+        if (usersIt == hostUsers.end())
+            return true;
+        for (size_t i = 0; i < usersIt->second.size(); i++)
+        {
+            if (!dependencies->dependsOn(lid, usersIt->second[i]))
+                return false;
+        }
+        return true;
+    }
+
+    struct BlobLifetime
+    {
+        int dtype;
+        size_t size;  // number of elements
+        int firstStep, lastStep;
+        size_t offset;  // in elements, inside of arena of the same dtype
+        int producer;  // layer id
+    };
+
+    // Returns true if the blobs can't share memory.
+    bool isAliveTogether(const LayerPin& a, const BlobLifetime& blobA, const LayerPin& b, const BlobLifetime& blobB) const;
+
+    std::map<LayerPin, BlobLifetime> plannedBlobs;
+    std::set<int> plannedInPlace;  // layers which work in-place according to memory plan
+    std::map<LayerPin, std::vector<int> > hostUsers;  // memory host -> layers which have used it (if dependencies are set)
+    const LayersDependencies* dependencies = NULL;
+    int planLayer = 0;
+    std::map<int, Mat> arenas;  // dtype -> memory
+    // dtype -> memory which arenas are views of. It is kept between reallocations
+    // and grows to envelope the biggest input shapes, so switching of input shapes
+    // doesn't reallocate memory.
+    std::map<int, Mat> arenaBuffers;
+    int planStep = 0;
 };  // BlobManager
 
 
@@ -0,0 +1,180 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "mapped_file.hpp"
+#include <opencv2/core/utils/external_buffer.hpp>
+
+#if defined _WIN32 && !defined WINRT
+#define OPENCV_DNN_MMAP_WIN32 1
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined __linux__ || defined __APPLE__ || defined __HAIKU__ || defined __FreeBSD__ || defined __GNU__ || defined __QNX__
+#define OPENCV_DNN_MMAP_POSIX 1
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include <fstream>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+struct MappedFile::Impl
+{
+    Impl(const String& path, size_t offset, size_t length) : ptr(NULL), len(0), base(NULL), mappedSize(0)
+    {
+#if defined OPENCV_DNN_MMAP_WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            CV_Error(Error::StsError, "DNN: can't open file: " + path);
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            CV_Error(Error::StsError, "DNN: can't get size of file: " + path);
+        }
+        try
+        {
+            setRegion((size_t)fileSize.QuadPart, offset, length, path);
+        }
+        catch (...)
+        {
+            CloseHandle(file);
+            throw;
+        }
+        if (len > 0)
+        {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            const size_t alignedOffset = offset - offset % info.dwAllocationGranularity;
+            mappedSize = offset - alignedOffset + len;
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+            if (mapping)
+            {
+                base = MapViewOfFile(mapping, FILE_MAP_COPY, (DWORD)((uint64_t)alignedOffset >> 32),
+                                     (DWORD)(alignedOffset & 0xFFFFFFFF), mappedSize);
+                CloseHandle(mapping);
+            }
+            if (base)
+                ptr = (uchar*)base + (offset - alignedOffset);
+        }
+        CloseHandle(file);
+        if (len > 0 && !ptr)
+            CV_Error(Error::StsError, "DNN: can't map file into memory: " + path);
+#elif defined OPENCV_DNN_MMAP_POSIX
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            CV_Error(Error::StsError, "DNN: can't open file: " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            CV_Error(Error::StsError, "DNN: can't get size of file: " + path);
+        }
+        try
+        {
+            setRegion((size_t)st.st_size, offset, length, path);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+        if (len > 0)
+        {
+            const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+            const size_t alignedOffset = offset - offset % pageSize;
+            mappedSize = offset - alignedOffset + len;
+            void* p = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t)alignedOffset);
+            if (p != MAP_FAILED)
+            {
+                base = p;
+                ptr = (uchar*)base + (offset - alignedOffset);
+            }
+        }
+        ::close(fd);
+        if (len > 0 && !ptr)
+            CV_Error(Error::StsError, cv::format("DNN: can't map file into memory (errno=%d): %s", errno, path.c_str()));
+#else
+        std::ifstream ifs(path.c_str(), std::ios::in | std::ios::binary);
+        if (!ifs.is_open())
+            CV_Error(Error::StsError, "DNN: can't open file: " + path);
+        ifs.seekg(0, std::ios::end);
+        setRegion((size_t)ifs.tellg(), offset, length, path);
+        ifs.seekg(offset, std::ios::beg);
+        buffer.allocate(len);
+        ifs.read((char*)buffer.data(), len);
+        if (!ifs)
+            CV_Error(Error::StsError, "DNN: can't read file: " + path);
+        ptr = buffer.data();
+#endif
+    }
+
+    ~Impl()
+    {
+#if defined OPENCV_DNN_MMAP_WIN32
+        if (base)
+            UnmapViewOfFile(base);
+#elif defined OPENCV_DNN_MMAP_POSIX
+        if (base)
+            munmap(base, mappedSize);
+#endif
+    }
+
+    void setRegion(size_t fileSize, size_t offset, size_t length, const String& path)
+    {
+        if (offset > fileSize || (length > 0 && length > fileSize - offset))
+            CV_Error(Error::StsOutOfRange, cv::format("DNN: region [%zu, %zu) is out of file (%zu bytes): %s",
+                                                      offset, offset + length, fileSize, path.c_str()));
+        len = length > 0 ? length : fileSize - offset;
+    }
+
+    uchar* ptr;  // beginning of the requested region
+    size_t len;
+    void* base;  // beginning of the mapping, aligned on page or allocation granularity
+    size_t mappedSize;
+#if !defined OPENCV_DNN_MMAP_WIN32 && !defined OPENCV_DNN_MMAP_POSIX
+    AutoBuffer<uchar, 1> buffer;
+#endif
+};
+
+
+MappedFile::MappedFile(const String& path, size_t offset, size_t length)
+    : impl(std::make_shared<Impl>(path, offset, length))
+{
+}
+
+const uchar* MappedFile::data() const
+{
+    return impl ? impl->ptr : NULL;
+}
+
+size_t MappedFile::size() const
+{
+    return impl ? impl->len : 0;
+}
+
+Mat MappedFile::getMat(size_t offset, int dims, const int* sizes, int type) const
+{
+    CV_Assert(impl);
+    Mat m(dims, sizes, type, impl->ptr + offset);
+    CV_Assert((size_t)m.data % m.elemSize1() == 0);
+    CV_CheckLE(offset + m.total() * m.elemSize(), impl->len, "DNN: data is out of range of mapped file");
+    return m.empty() ? m : utils::wrapExternalBuffer(impl, impl->ptr + offset, dims, sizes, type);
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -0,0 +1,50 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef __OPENCV_DNN_SRC_MAPPED_FILE_HPP__
+#define __OPENCV_DNN_SRC_MAPPED_FILE_HPP__
+
+#include <memory>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+/** @brief Read-only file (or region of file) mapped into memory.
+ *
+ * Pages are mapped privately (copy-on-write), so data may be modified in place
+ * without affecting the file. Copies of the object share the same mapping, which
+ * is released with the last copy or Mat created by getMat().
+ * Platforms without memory mapping support read the data into memory.
+ */
+class MappedFile
+{
+public:
+    MappedFile() {}
+
+    /** @param path path to the file
+     *  @param offset offset of the region in bytes
+     *  @param length length of the region in bytes, the rest of the file if 0
+     */
+    explicit MappedFile(const String& path, size_t offset = 0, size_t length = 0);
+
+    bool empty() const { return size() == 0; }
+    const uchar* data() const;
+    size_t size() const;
+
+    /** @brief Returns Mat which refers to the mapped memory with no copy.
+     *
+     * Mat keeps the mapping alive, so it may outlive this object.
+     * @param offset offset of the data in bytes from the beginning of the region.
+     */
+    Mat getMat(size_t offset, int dims, const int* sizes, int type) const;
+
+    struct Impl;
+private:
+    std::shared_ptr<Impl> impl;
+};
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
+#endif  // __OPENCV_DNN_SRC_MAPPED_FILE_HPP__
@@ -11,9 +11,127 @@
 
 #include <opencv2/imgproc.hpp>
 
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace cv {
 namespace dnn {
 
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+// Accumulates single frame requests from multiple threads and processes them
+// as one batch when the batch is full or the oldest request is expired.
+class BatchingQueue
+{
+public:
+    typedef std::function<void(const std::vector<Mat>& blobs, std::vector<std::vector<Mat> >& outs)> BatchProcessor;
+
+    BatchingQueue(int maxBatchSize_, double maxDelayMs, const BatchProcessor& processor_)
+        : maxBatchSize(maxBatchSize_)
+        , maxDelay(std::chrono::microseconds((int64)(maxDelayMs * 1000)))
+        , processor(processor_)
+        , stop(false)
+    {
+        worker = std::thread(&BatchingQueue::run, this);
+    }
+
+    ~BatchingQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cond.notify_all();
+        worker.join();  // pending requests are processed before exit
+    }
+
+    std::future<std::vector<Mat> > submit(const Mat& blob)
+    {
+        Request request;
+        request.blob = blob;
+        request.deadline = clock::now() + maxDelay;
+        std::future<std::vector<Mat> > result = request.result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(std::move(request));
+        }
+        cond.notify_all();
+        return result;
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct Request
+    {
+        Mat blob;
+        clock::time_point deadline;
+        std::promise<std::vector<Mat> > result;
+    };
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            cond.wait(lock, [this]() { return stop || !requests.empty(); });
+            if (requests.empty())
+                return;
+            const clock::time_point deadline = requests.front().deadline;
+            cond.wait_until(lock, deadline, [this]() { return stop || (int)requests.size() >= maxBatchSize; });
+
+            const size_t batchSize = std::min(requests.size(), (size_t)maxBatchSize);
+            std::vector<Request> batch(std::make_move_iterator(requests.begin()),
+                                       std::make_move_iterator(requests.begin() + batchSize));
+            requests.erase(requests.begin(), requests.begin() + batchSize);
+
+            lock.unlock();
+            process(batch);
+            lock.lock();
+        }
+    }
+
+    void process(std::vector<Request>& batch)
+    {
+        std::vector<Mat> blobs(batch.size());
+        for (size_t i = 0; i < batch.size(); i++)
+            blobs[i] = batch[i].blob;
+
+        std::vector<std::vector<Mat> > outs;
+        try
+        {
+            processor(blobs, outs);
+            CV_Assert(outs.size() == batch.size());
+        }
+        catch (...)
+        {
+            std::exception_ptr e = std::current_exception();
+            for (size_t i = 0; i < batch.size(); i++)
+                batch[i].result.set_exception(e);
+            return;
+        }
+        for (size_t i = 0; i < batch.size(); i++)
+            batch[i].result.set_value(outs[i]);
+    }
+
+    const int maxBatchSize;
+    const clock::duration maxDelay;
+    BatchProcessor processor;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Request> requests;
+    bool stop;
+    std::thread worker;
+};
+#endif  // OPENCV_DISABLE_THREAD_SUPPORT
+
 struct Model::Impl
 {
 //protected:
@@ -26,9 +144,17 @@ struct Model::Impl
     bool   crop = false;
     Mat    blob;
     std::vector<String> outNames;
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+    std::unique_ptr<BatchingQueue> batching;
+#endif
 
 public:
-    virtual ~Impl() {}
+    virtual ~Impl()
+    {
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        batching.reset();  // finish pending requests while the network is alive
+#endif
+    }
     Impl() {}
     Impl(const Impl&) = delete;
     Impl(Impl&&) = delete;
@@ -96,6 +222,26 @@ public:
         outNames = outNames_;
     }
 
+    /*virtual*/
+    void enableBatching(int maxBatchSize, double maxDelayMs)
+    {
+        CV_CheckGE(maxDelayMs, 0.0, "");
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        batching.reset();
+        if (maxBatchSize > 1)
+        {
+            batching.reset(new BatchingQueue(maxBatchSize, maxDelayMs,
+                [this](const std::vector<Mat>& blobs, std::vector<std::vector<Mat> >& outs)
+                {
+                    processBatch(blobs, outs);
+                }));
+        }
+#else
+        if (maxBatchSize > 1)
+            CV_Error(Error::StsNotImplemented, "Batching requires thread support (OPENCV_DISABLE_THREAD_SUPPORT)");
+#endif
+    }
+
     /*virtual*/
     void processFrame(InputArray frame, OutputArrayOfArrays outs)
     {
@@ -114,6 +260,16 @@ public:
         }
         Mat blob = dnn::blobFromImageWithParams(frame, param); // [1, 10, 10, 4]
 
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        if (batching)
+        {
+            std::vector<Mat> result = batching->submit(blob).get();
+            outs.create((int)result.size(), 1, CV_32F/*FIXIT*/, -1);  // allocate vector
+            outs.assign(result);
+            return;
+        }
+#endif
+
         net.setInput(blob);
 
         // Faster-RCNN or R-FCN
@@ -125,6 +281,81 @@ public:
 
         net.forward(outs, outNames);
     }
+
+    // Runs single forward pass for several frames and splits outputs by frames
+    void processBatch(const std::vector<Mat>& blobs, std::vector<std::vector<Mat> >& outs)
+    {
+        CV_TRACE_FUNCTION();
+        const int batchSize = (int)blobs.size();
+        CV_Assert(batchSize > 0);
+
+        MatShape batchShape = shape(blobs[0]);
+        CV_CheckEQ(batchShape[0], 1, "");
+        batchShape[0] = batchSize;
+        Mat batch(batchShape, blobs[0].type());
+        for (int i = 0; i < batchSize; i++)
+        {
+            CV_Assert(shape(blobs[i]) == shape(blobs[0]));
+            blobs[i].reshape(1, 1).copyTo(batch.reshape(1, batchSize).row(i));
+        }
+
+        net.setInput(batch);
+
+        // Faster-RCNN or R-FCN
+        if (net.getLayer(0)->outputNameToIndex("im_info") != -1)
+        {
+            Mat imInfo(Matx13f(size.height, size.width, 1.6f));
+            net.setInput(imInfo, "im_info");
+        }
+
+        std::vector<Mat> batchOuts;
+        net.forward(batchOuts, outNames);
+
+        outs.assign(batchSize, std::vector<Mat>(batchOuts.size()));
+        for (size_t j = 0; j < batchOuts.size(); j++)
+        {
+            const Mat& out = batchOuts[j];
+            if (batchSize > 1 && out.dims == 4 && out.size[0] == 1 && out.size[1] == 1 && out.size[3] == 7)
+            {
+                // DetectionOutput: [1, 1, N, 7] with image id in the first column
+                std::vector<std::vector<int> > rows(batchSize);
+                for (int r = 0; r < out.size[2]; r++)
+                {
+                    const float* det = out.ptr<float>(0, 0, r);
+                    const int imageId = (int)det[0];
+                    if (imageId >= 0 && imageId < batchSize)
+                        rows[imageId].push_back(r);
+                }
+                for (int i = 0; i < batchSize; i++)
+                {
+                    Mat dst(std::vector<int>{1, 1, (int)rows[i].size(), 7}, out.type());
+                    for (size_t r = 0; r < rows[i].size(); r++)
+                    {
+                        const float* det = out.ptr<float>(0, 0, rows[i][r]);
+                        float* dstDet = dst.ptr<float>(0, 0, (int)r);
+                        std::copy(det, det + 7, dstDet);
+                        dstDet[0] = 0;
+                    }
+                    outs[i][j] = dst;
+                }
+            }
+            else
+            {
+                CV_Assert(out.dims > 0);
+                if (out.size[0] % batchSize != 0)
+                    CV_Error(Error::StsNotImplemented, cv::format("Batched output %d can't be split by frames: first dimension is %d, batch size is %d",
+                                                                  (int)j, out.size[0], batchSize));
+                // Outputs of the next batch may reuse memory, so copy results
+                const int step = out.size[0] / batchSize;
+                std::vector<Range> ranges(out.dims, Range::all());
+                for (int i = 0; i < batchSize; i++)
+                {
+                    ranges[0] = Range(i * step, (i + 1) * step);
+                    outs[i][j] = out(ranges).clone();
+                }
+            }
+        }
+    }
 };
 
 Model::Model()
@@ -223,6 +454,13 @@ void Model::setInputParams(double scale, const Size& size, const Scalar& mean,
     impl->setInputParams(scale, size, mean, swapRB, crop);
 }
 
+Model& Model::enableBatching(int maxBatchSize, double maxDelayMs)
+{
+    CV_DbgAssert(impl);
+    impl->enableBatching(maxBatchSize, maxDelayMs);
+    return *this;
+}
+
 void Model::predict(InputArray frame, OutputArrayOfArrays outs) const
 {
     CV_DbgAssert(impl);
@@ -165,6 +165,13 @@ void Net::setInputsNames(const std::vector<String>& inputBlobNames)
     return impl->setInputsNames(inputBlobNames);
 }
 
+std::vector<String> Net::getInputsNames() const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->getInputsNames();
+}
+
 void Net::setInputShape(const String& inputName, const MatShape& shape)
 {
     CV_TRACE_FUNCTION();
@@ -226,6 +233,14 @@ void Net::dumpToPbtxt(const String& path)
     file.close();
 }
 
+void Net::writeCache(const String& path)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    CV_Assert(!empty());
+    impl->writeCache(path);
+}
+
 Ptr<Layer> Net::getLayer(int layerId) const
 {
     CV_Assert(impl);
@@ -413,6 +428,20 @@ void Net::enableWinograd(bool useWinograd)
     return impl->enableWinograd(useWinograd);
 }
 
+void Net::enableParallelBranches(bool enable)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->enableParallelBranches(enable);
+}
+
+void Net::enableChannelsLast(bool enable)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->enableChannelsLast(enable);
+}
+
 void Net::setHalideScheduler(const String& scheduler)
 {
     CV_TRACE_FUNCTION();
@@ -428,5 +457,33 @@ int64 Net::getPerfProfile(std::vector<double>& timings)
     return impl->getPerfProfile(timings);
 }
 
+int64 Net::getMemoryArenaSize() const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->getMemoryArenaSize();
+}
+
+void Net::getLayersProfile(std::vector<LayerProfile>& profile) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->getLayersProfile(profile);
+}
+
+void Net::writeProfile(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->writeProfile(path);
+}
+
+Net Net::createExecutionContext(const std::vector<String>& outBlobNames)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->createExecutionContext(outBlobNames);
+}
+
 CV__DNN_INLINE_NS_END
 }}  // namespace cv::dnn
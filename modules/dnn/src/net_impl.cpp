@@ -32,6 +32,7 @@ std::string detail::NetImplBase::getDumpFileNameBase() const
 
 Net::Impl::~Impl()
 {
+    asyncExecutor.release();  // finish pending requests
 #ifdef HAVE_VULKAN
     if (context)
         context->reset();
@@ -59,6 +60,10 @@ Net::Impl::Impl()
     preferableTarget = DNN_TARGET_CPU;
     hasDynamicShapes = false;
     useWinograd = true;
+    isExecutionContext = false;
+    parallelBranches = getParam_DNN_PARALLEL_BRANCHES();
+    channelsLast = getParam_DNN_CHANNELS_LAST();
+    forwardStartTicks = 0;
 }
 
 
@@ -72,6 +77,10 @@ void Net::Impl::clear()
 {
     CV_TRACE_FUNCTION();
 
+    // Layers are shared with the context of asynchronous requests, so wait for them to finish
+    waitAsyncContext();
+    asyncExecutor.release();
+
     MapIdToLayerData::iterator it;
     for (it = layers.begin(); it != layers.end(); it++)
     {
@@ -92,6 +101,10 @@ void Net::Impl::clear()
     }
     netWasAllocated = false;
     layersTimings.clear();
+    layersStarts.clear();
+    layersThreads.clear();
+    layersKernels.clear();
+    branchesSchedule.clear();
 }
 
 
@@ -135,8 +148,24 @@ void Net::Impl::setUpNet(const std::vector<LayerPin>& blobsToKeep_)
 
     validateBackendAndTarget();
 
+    if (isExecutionContext)
+    {
+        // Layers are shared with the compiled network: reallocation is not allowed
+        if (!netWasAllocated)
+            CV_Error(Error::StsError, "DNN: execution context can't be reallocated. Input shapes and backend/target must match the compiled network");
+        for (size_t i = 0; i < blobsToKeep_.size(); i++)
+        {
+            if (std::find(blobsToKeep.begin(), blobsToKeep.end(), blobsToKeep_[i]) == blobsToKeep.end())
+                CV_Error(Error::StsError, "DNN: requested output is not kept by execution context. Specify it in Net::createExecutionContext()");
+        }
+        return;
+    }
+
     if (!netWasAllocated || this->blobsToKeep != blobsToKeep_)
     {
+        // Layers are shared with the context of asynchronous requests, so wait for them to finish
+        asyncExecutor.release();
+
         if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_OPENCL_TARGET(preferableTarget))
 #ifndef HAVE_OPENCL
         {
@@ -384,6 +413,7 @@ int Net::Impl::addLayer(const String& name, const String& type, const int& dtype
     id = ++lastLayerId;
     layerNameToId.insert(std::make_pair(name, id));
     layers.insert(std::make_pair(id, LayerData(id, name, type, dtype, params)));
+    clearLayersShapesCache();
     if (params.get<bool>("has_dynamic_shapes", false))
         hasDynamicShapes = true;
 
@@ -412,6 +442,7 @@ void Net::Impl::connect(int outLayerId, int outNum, int inLayerId, int inNum)
     addLayerInput(ldInp, inNum, LayerPin(outLayerId, outNum));
     ldOut.requiredOutputs.insert(outNum);
     ldOut.consumers.push_back(LayerPin(inLayerId, outNum));
+    clearLayersShapesCache();
 
     CV_LOG_VERBOSE(NULL, 0, "DNN: connect(" << outLayerId << ":" << outNum << " ==> " << inLayerId << ":" << inNum << ")");
 }
@@ -450,6 +481,72 @@ int Net::Impl::registerOutput(const std::string& outputName, int layerId, int ou
 }
 
 
+// Rounds changed network input dimensions up to a power of two step which is at most 1/8 of the dimension,
+// so memory planned for the bucket exceeds memory of the input shapes by less than 12.5% per dimension.
+static ShapesVec getShapesBucket(const ShapesVec& shapes, const ShapesVec& changedDims)
+{
+    ShapesVec bucket = shapes;
+    for (size_t i = 0; i < bucket.size(); i++)
+    {
+        for (size_t j = 0; j < bucket[i].size(); j++)
+        {
+            if (!changedDims[i][j])
+                continue;
+            int step = 1;
+            while (step * 16 <= bucket[i][j])
+                step *= 2;
+            bucket[i][j] = alignSize(bucket[i][j], step);
+        }
+    }
+    return bucket;
+}
+
+// Checks that every blob of layers fits into memory planned for the blob with shapes of bucket.
+static bool isEnvelopedByShapes(const Net::Impl::LayersShapesMap& shapes, const Net::Impl::LayersShapesMap& bucket)
+{
+    for (Net::Impl::LayersShapesMap::const_iterator it = shapes.begin(); it != shapes.end(); ++it)
+    {
+        Net::Impl::LayersShapesMap::const_iterator bucketIt = bucket.find(it->first);
+        if (bucketIt == bucket.end())
+            return false;
+        const LayerShapes& a = it->second;
+        const LayerShapes& b = bucketIt->second;
+        if (a.out.size() != b.out.size() || a.internal.size() != b.internal.size() ||
+            a.supportInPlace != b.supportInPlace)
+            return false;
+        for (size_t i = 0; i < a.out.size() + a.internal.size(); i++)
+        {
+            const size_t size = total(i < a.out.size() ? a.out[i] : a.internal[i - a.out.size()]);
+            const size_t bucketSize = total(i < b.out.size() ? b.out[i] : b.internal[i - b.out.size()]);
+            if ((size == 0) != (bucketSize == 0) || size > bucketSize)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Data, type and shape of the arguments of Layer::finalize()
+static std::vector<size_t> getFinalizeSignature(const std::vector<Mat>& inputs, const std::vector<Mat>& outputs, int target)
+{
+    std::vector<size_t> signature(1, (size_t)target);
+    for (int k = 0; k < 2; k++)
+    {
+        const std::vector<Mat>& blobs = k == 0 ? inputs : outputs;
+        signature.push_back(blobs.size());
+        for (size_t i = 0; i < blobs.size(); i++)
+        {
+            const Mat& m = blobs[i];
+            signature.push_back((size_t)m.data);
+            signature.push_back((size_t)m.type());
+            signature.push_back((size_t)m.dims);
+            for (int j = 0; j < m.dims; j++)
+                signature.push_back((size_t)m.size[j]);
+        }
+    }
+    return signature;
+}
+
+
 void Net::Impl::allocateLayer(int lid, const LayersShapesMap& layersShapes)
 {
     CV_TRACE_FUNCTION();
@@ -534,8 +631,19 @@ void Net::Impl::allocateLayer(int lid, const LayersShapesMap& layersShapes)
         {
             inps[i] = *ld.inputBlobs[i];
         }
-        layerPtr->finalize(inps, ld.outputBlobs);
+        // finalize() may prepare weights for the target (e.g. FP16 packing for DNN_TARGET_CPU_FP16)
         layerPtr->preferableTarget = preferableTarget;
+        // Layers of CPU backend are not finalized again for the same inputs and outputs,
+        // e.g. if network input shapes are switched within a bucket or back and forth.
+        std::vector<size_t> signature;
+        if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget))
+            signature = getFinalizeSignature(inps, ld.outputBlobs, preferableTarget);
+        if (signature.empty() || signature != ld.finalizeSignature)
+        {
+            ld.finalizeSignature.clear();
+            layerPtr->finalize(inps, ld.outputBlobs);
+            ld.finalizeSignature.swap(signature);
+        }
 #if 0
         std::cout << "\toutputs:";
         size_t noutputs = ld.outputBlobs.size();
@@ -555,6 +663,28 @@ void Net::Impl::allocateLayer(int lid, const LayersShapesMap& layersShapes)
 }
 
 
+void Net::Impl::planLayerMemory(int lid, const LayersShapesMap& layersShapes, std::set<int>& plannedLayers)
+{
+    // Must follow the order of allocateLayer() calls.
+    if (!plannedLayers.insert(lid).second)
+        return;
+
+    LayerData& ld = layers[lid];
+    for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        ld.inputLayersId.insert(ld.inputBlobsId[i].lid);
+    for (std::set<int>::const_iterator i = ld.inputLayersId.begin(); i != ld.inputLayersId.end(); i++)
+        planLayerMemory(*i, layersShapes, plannedLayers);
+
+    LayersShapesMap::const_iterator layerShapesIt = layersShapes.find(lid);
+    CV_Assert(layerShapesIt != layersShapes.end());
+
+    std::vector<LayerPin> pinsForInternalBlobs;
+    blobManager.planBlobsForLayer(ld, layerShapesIt->second, pinsForInternalBlobs);
+    blobManager.releaseReferences(ld.inputBlobsId);
+    blobManager.releaseReferences(pinsForInternalBlobs);
+}
+
+
 void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
 {
     CV_TRACE_FUNCTION();
@@ -576,8 +706,39 @@ void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
         }
         inputShapes.push_back(shape(inp));
     }
-    LayersShapesMap layersShapes;
-    getLayersShapes(inputShapes, layersShapes);
+
+    const bool useMemoryPlanner = preferableBackend == DNN_BACKEND_OPENCV &&
+            (preferableTarget == DNN_TARGET_CPU || preferableTarget == DNN_TARGET_CPU_FP16) &&
+            !getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS() && getParam_DNN_MEMORY_PLANNER();
+
+    // Memory is planned for the bucket of close input shapes. Switching between them keeps
+    // blobs at the same place, so layers with unchanged shapes are not finalized again.
+    bool sameRanks = firstInputShapes.size() == inputShapes.size();
+    for (size_t i = 0; sameRanks && i < inputShapes.size(); i++)
+        sameRanks = firstInputShapes[i].size() == inputShapes[i].size();
+    if (!sameRanks)
+    {
+        firstInputShapes = inputShapes;
+        changedInputDims.assign(inputShapes.size(), MatShape());
+        for (size_t i = 0; i < inputShapes.size(); i++)
+            changedInputDims[i].assign(inputShapes[i].size(), 0);
+    }
+    for (size_t i = 0; i < inputShapes.size(); i++)
+    {
+        for (size_t j = 0; j < inputShapes[i].size(); j++)
+            changedInputDims[i][j] |= (int)(inputShapes[i][j] != firstInputShapes[i][j]);
+    }
+    LayersShapesMap bucketShapes;
+    if (useMemoryPlanner && !hasDynamicShapes && getParam_DNN_SHAPES_BUCKETS())
+    {
+        const ShapesVec bucket = getShapesBucket(inputShapes, changedInputDims);
+        if (bucket != inputShapes)
+            bucketShapes = getCachedLayersShapes(bucket, true);  // copy, the next lookup may evict it
+    }
+    const LayersShapesMap& layersShapes = getCachedLayersShapes(inputShapes);
+    if (!bucketShapes.empty() && !isEnvelopedByShapes(layersShapes, bucketShapes))
+        bucketShapes.clear();
+    const LayersShapesMap& plannedShapes = bucketShapes.empty() ? layersShapes : bucketShapes;
 
     blobManager.reset();
     backendWrappers.clear();
@@ -590,18 +751,45 @@ void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
         ld.internalBlobsWrappers.clear();
     }
 
-    // Fake references to input blobs.
-    for (int i = 0; i < layers[0].outputBlobs.size(); ++i)
-        blobManager.addReference(LayerPin(0, i));
-    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    // Concurrent branches must not share memory: planner needs dependencies between layers.
+    // Layers with dynamic shapes may reallocate their outputs, so they are run sequentially.
+    const bool runBranches = useMemoryPlanner && parallelBranches && !hasDynamicShapes;
+    layersDependencies.clear();
+    if (runBranches)
     {
-        const LayerData& ld = it->second;
-        blobManager.addReferences(ld.inputBlobsId);
+        std::vector<std::vector<int> > inputs(lastLayerId + 1);
+        for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            for (size_t i = 0; i < it->second.inputBlobsId.size(); i++)
+                inputs[it->first].push_back(it->second.inputBlobsId[i].lid);
+        }
+        layersDependencies.build(inputs);
+        blobManager.setDependencies(&layersDependencies);
     }
-
-    for (int i = 0; i < blobsToKeep_.size(); i++)
+    for (int pass = useMemoryPlanner ? 0 : 1; pass < 2; pass++)
     {
-        blobManager.addReference(blobsToKeep_[i]);
+        // Fake references to input blobs.
+        for (int i = 0; i < layers[0].outputBlobs.size(); ++i)
+            blobManager.addReference(LayerPin(0, i));
+        for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            const LayerData& ld = it->second;
+            blobManager.addReferences(ld.inputBlobsId);
+        }
+
+        for (int i = 0; i < blobsToKeep_.size(); i++)
+        {
+            blobManager.addReference(blobsToKeep_[i]);
+        }
+
+        if (pass == 0)
+        {
+            // Compute lifetimes of all the blobs over the whole graph and place them into a single arena.
+            std::set<int> plannedLayers;
+            for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); it++)
+                planLayerMemory(it->first, plannedShapes, plannedLayers);
+            blobManager.allocatePlannedArenas();
+        }
     }
 
     for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); it++)
@@ -611,18 +799,50 @@ void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
     }
 
     layersTimings.resize(lastLayerId + 1, 0);
+    layersStarts.resize(lastLayerId + 1, 0);
+    layersThreads.resize(lastLayerId + 1, 0);
+    layersKernels.resize(lastLayerId + 1);
     fuseLayers(blobsToKeep_);
+    propagateChannelsLast(blobsToKeep_);
+
+    // Fusion changes the state of layers which absorb their consumers, so they are finalized again.
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+    {
+        LayerData& ld = it->second;
+        for (size_t i = 0; i < ld.consumers.size(); i++)
+        {
+            if (layers[ld.consumers[i].lid].skip)
+            {
+                ld.finalizeSignature.clear();
+                break;
+            }
+        }
+    }
+
+    branchesSchedule.clear();
+    if (runBranches)
+        buildBranchesSchedule();
 }
 
 
 void Net::Impl::forwardLayer(LayerData& ld)
 {
     CV_TRACE_FUNCTION();
+    CV_TRACE_ARG_VALUE(name, "name", ld.name.c_str());
 
     Ptr<Layer> layer = ld.layerInstance;
 
+    if (ld.id < (int)layersKernels.size())
+        layersKernels[ld.id].clear();
+    if (ld.id < (int)layersStarts.size())
+    {
+        layersStarts[ld.id] = getTickCount() - forwardStartTicks;
+        layersThreads[ld.id] = cv::utils::getThreadID();
+    }
+
     if (!ld.skip)
     {
+        KernelReportScope kernelReportScope(ld.id < (int)layersKernels.size() ? &layersKernels[ld.id] : NULL);
         TickMeter tm;
         tm.start();
 
@@ -848,6 +1068,10 @@ void Net::Impl::forwardLayer(LayerData& ld)
         tm.stop();
         int64 t = tm.getTimeTicks();
         layersTimings[ld.id] = (t > 0) ? t : t + 1;  // zero for skipped layers only
+        if (ld.id < (int)layersKernels.size() && !layersKernels[ld.id].empty())
+        {
+            CV_TRACE_ARG_VALUE(kernel, "kernel", layersKernels[ld.id].c_str());
+        }
     }
     else
     {
@@ -866,12 +1090,19 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
     {
         for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
             it->second.flag = 0;
+        forwardStartTicks = getTickCount();
     }
 
     // already was forwarded
     if (ld.flag)
         return;
 
+    if (!branchesSchedule.empty() && !isAsync && getNumThreads() > 1)
+    {
+        forwardBranches(ld);
+        return;
+    }
+
     // forward parents
     for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end() && (it->second.id < ld.id); ++it)
     {
@@ -894,6 +1125,7 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
 Mat Net::Impl::forward(const String& outputName)
 {
     CV_Assert(!empty());
+    waitAsyncContext();
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     String layerName = outputName;
@@ -916,6 +1148,7 @@ Mat Net::Impl::forward(const String& outputName)
 AsyncArray Net::Impl::forwardAsync(const String& outputName)
 {
     CV_Assert(!empty());
+    waitAsyncContext();
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     String layerName = outputName;
@@ -930,8 +1163,11 @@ AsyncArray Net::Impl::forwardAsync(const String& outputName)
     std::vector<LayerPin> pins(1, getPinByAlias(layerName));
     setUpNet(pins);
 
+    if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget))
+        return forwardAsyncCPU(layerName);
+
     if (preferableBackend != DNN_BACKEND_INFERENCE_ENGINE_NGRAPH)
-        CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward is supported for Inference Engine backend only");
+        CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward is supported for Inference Engine backend and DNN_BACKEND_OPENCV on CPU only");
 
     isAsync = true;
     forwardToLayer(getLayerData(layerName));
@@ -944,6 +1180,7 @@ AsyncArray Net::Impl::forwardAsync(const String& outputName)
 void Net::Impl::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
 {
     CV_Assert(!empty());
+    waitAsyncContext();
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     String layerName = outputName;
@@ -1027,6 +1264,7 @@ void Net::Impl::forward(OutputArrayOfArrays outputBlobs,
         const std::vector<String>& outBlobNames)
 {
     CV_Assert(!empty());
+    waitAsyncContext();
     if (outBlobNames.empty())
         CV_Error(Error::StsBadArg, "in Net::forward(), outBlobNames cannot be empty");
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
@@ -1058,6 +1296,7 @@ void Net::Impl::forward(std::vector<std::vector<Mat>>& outputBlobs,
         const std::vector<String>& outBlobNames)
 {
     CV_Assert(!empty());
+    waitAsyncContext();
     if (outBlobNames.empty())
         CV_Error(Error::StsBadArg, "in Net::forward(), outBlobNames cannot be empty");
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
@@ -1252,6 +1491,54 @@ void Net::Impl::getLayersShapes(const ShapesVec& netInputShapes,
     }
 }
 
+const Net::Impl::LayersShapesMap& Net::Impl::getCachedLayersShapes(const ShapesVec& netInputShapes, bool mayFail)
+{
+    for (std::list<std::pair<ShapesVec, LayersShapesMap> >::iterator it = layersShapesCache.begin();
+         it != layersShapesCache.end(); ++it)
+    {
+        if (it->first == netInputShapes)
+        {
+            // Failed shape inference is repeated to report the error
+            if (it->second.empty() && !mayFail)
+            {
+                layersShapesCache.erase(it);
+                break;
+            }
+            layersShapesCache.splice(layersShapesCache.begin(), layersShapesCache, it);
+            return layersShapesCache.front().second;
+        }
+    }
+
+    LayersShapesMap layersShapes;
+    try
+    {
+        getLayersShapes(netInputShapes, layersShapes);
+    }
+    catch (const cv::Exception& e)
+    {
+        if (!mayFail)
+            throw;
+        CV_LOG_DEBUG(NULL, "DNN: network doesn't accept " << toString(netInputShapes, "input shapes") << ": " << e.what());
+        layersShapes.clear();
+    }
+    layersShapesCache.push_front(std::make_pair(netInputShapes, LayersShapesMap()));
+    layersShapesCache.front().second.swap(layersShapes);
+    const size_t maxSize = std::max(getParam_DNN_SHAPES_CACHE_SIZE(), (size_t)1);
+    while (layersShapesCache.size() > maxSize)
+        layersShapesCache.pop_back();
+    return layersShapesCache.front().second;
+}
+
+void Net::Impl::clearLayersShapesCache()
+{
+    layersShapesCache.clear();
+    firstInputShapes.clear();
+    changedInputDims.clear();
+    // Layers or their parameters are changed, so they are finalized again
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        it->second.finalizeSignature.clear();
+}
+
 void Net::Impl::getLayerShapes(const ShapesVec& netInputShapes,
         const int layerId,
         LayerShapes& shapes)
@@ -1284,6 +1571,22 @@ void Net::Impl::updateLayersShapes()
         inputShapes.push_back(shape(inp));
     }
     CV_LOG_DEBUG(NULL, toString(inputShapes, "Network input shapes"));
+
+    for (std::list<std::pair<ShapesVec, LayersShapesMap> >::const_iterator it = layersShapesCache.begin();
+         it != layersShapesCache.end(); ++it)
+    {
+        if (it->first != inputShapes || it->second.empty())
+            continue;
+        // Shapes are known, update state of layers only
+        for (LayersShapesMap::const_iterator shapesIt = it->second.begin(); shapesIt != it->second.end(); ++shapesIt)
+        {
+            if (shapesIt->first != 0)
+                getLayerInstance(layers[shapesIt->first])->updateMemoryShapes(shapesIt->second.in);
+        }
+        CV_LOG_DEBUG(NULL, "updateLayersShapes() - DONE (cached)");
+        return;
+    }
+
     LayersShapesMap layersShapes;
     layersShapes[0].in = inputShapes;
     for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
@@ -1387,6 +1690,13 @@ void Net::Impl::setInputsNames(const std::vector<String>& inputBlobNames)
 }
 
 
+std::vector<String> Net::Impl::getInputsNames() const
+{
+    CV_Assert(netInputLayer);
+    return netInputLayer->outNames;
+}
+
+
 void Net::Impl::setInputShape(const String& inputName, const MatShape& shape)
 {
     CV_Assert(netInputLayer);
@@ -1396,6 +1706,7 @@ void Net::Impl::setInputShape(const String& inputName, const MatShape& shape)
 
 void Net::Impl::setInput(InputArray blob, const String& name, double scalefactor, const Scalar& mean)
 {
+    waitAsyncContext();
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     LayerPin pin;
@@ -1474,6 +1785,7 @@ void Net::Impl::setParam(int layer, int numParam, const Mat& blob)
     CV_Assert(numParam < (int)layerBlobs.size());
     // we don't make strong checks, use this function carefully
     layerBlobs[numParam] = blob;
+    clearLayersShapesCache();
 }
 
 
@@ -2276,6 +2588,12 @@ void Net::Impl::getMemoryConsumption(
 }
 
 
+int64 Net::Impl::getMemoryArenaSize() const
+{
+    return netWasAllocated ? (int64)blobManager.getArenasSize() : 0;
+}
+
+
 int64 Net::Impl::getPerfProfile(std::vector<double>& timings) const
 {
     timings = std::vector<double>(layersTimings.begin() + 1, layersTimings.end());
@@ -26,6 +26,8 @@
 
 #include "legacy_backend.hpp"  // wrapMat BlobManager OpenCLBackendWrapper
 
+#include <list>
+
 namespace cv {
 namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
@@ -33,6 +35,8 @@ CV__DNN_INLINE_NS_BEGIN
 using std::make_pair;
 using std::string;
 
+class AsyncForwardExecutor;  // see net_impl_async.cpp
+
 // NB: Implementation is divided between of multiple .cpp files
 struct Net::Impl : public detail::NetImplBase
 {
@@ -66,7 +70,47 @@ struct Net::Impl : public detail::NetImplBase
     bool fusion;
     bool isAsync;  // FIXIT: drop
     bool useWinograd;
+    bool isExecutionContext;  // shares layers with the compiled network, see createExecutionContext()
     std::vector<int64> layersTimings;
+    std::vector<int64> layersStarts;  // in ticks from forwardStartTicks
+    std::vector<int> layersThreads;  // cv::utils::getThreadID() of threads which have run layers
+    std::vector<String> layersKernels;  // implementations reported by layers, see reportKernel()
+    int64 forwardStartTicks;
+    // Shapes inference results for recently used network input shapes, the most recent first
+    std::list<std::pair<ShapesVec, LayersShapesMap> > layersShapesCache;
+    // Network input shapes of the first allocation and their dimensions which have changed since then (1 if changed).
+    // Only changed dimensions are rounded up to buckets of shapes.
+    ShapesVec firstInputShapes, changedInputDims;
+
+    // Concurrent execution of independent branches, see enableParallelBranches()
+    struct BranchesSchedule
+    {
+        // Consecutive layers in order of ids. Layers of parallel segment run concurrently
+        // with respect to dependencies, other segments consist of a single layer.
+        struct Segment
+        {
+            std::vector<int> layers;
+            int width;  // number of branches, threads of parallel_for_() are split between them
+            bool parallel;
+        };
+        std::vector<Segment> segments;
+        std::vector<std::vector<int> > predecessors;  // layer id -> layers it depends on directly
+        std::vector<std::vector<int> > successors;  // layer id -> layers which depend on it directly
+
+        bool empty() const { return segments.empty(); }
+        void clear()
+        {
+            segments.clear();
+            predecessors.clear();
+            successors.clear();
+        }
+    };
+    bool parallelBranches;
+    BranchesSchedule branchesSchedule;
+    bool channelsLast;  // see enableChannelsLast()
+    LayersDependencies layersDependencies;  // dependencies between layers for memory planning
+    // Runs forwardAsync() requests of DNN_BACKEND_OPENCV on CPU in execution context. Released by clear()
+    Ptr<AsyncForwardExecutor> asyncExecutor;
 
 
     virtual bool empty() const;
@@ -152,6 +196,7 @@ struct Net::Impl : public detail::NetImplBase
 
 
     void setInputsNames(const std::vector<String>& inputBlobNames);
+    std::vector<String> getInputsNames() const;
     void setInputShape(const String& inputName, const MatShape& shape);
     virtual void setInput(InputArray blob, const String& name, double scalefactor, const Scalar& mean);
     Mat getParam(int layer, int numParam) const;
@@ -209,12 +254,15 @@ struct Net::Impl : public detail::NetImplBase
 #endif
 
     void allocateLayer(int lid, const LayersShapesMap& layersShapes);
+    void planLayerMemory(int lid, const LayersShapesMap& layersShapes, std::set<int>& plannedLayers);
 
     // TODO add getter
     void enableFusion(bool fusion_);
 
     virtual void fuseLayers(const std::vector<LayerPin>& blobsToKeep_);
     void enableWinograd(bool useWinograd_);
+    void enableParallelBranches(bool enable);
+    void enableChannelsLast(bool enable);
 
     void allocateLayers(const std::vector<LayerPin>& blobsToKeep_);
 
@@ -222,8 +270,20 @@ struct Net::Impl : public detail::NetImplBase
 
     void forwardToLayer(LayerData& ld, bool clearFlags = true);
 
+    // Chooses layout of the layers which support channels-last data (after allocation and fusion)
+    void propagateChannelsLast(const std::vector<LayerPin>& blobsToKeep_);
+
+    // Splits network into segments of layers which may run concurrently (after allocation and fusion)
+    void buildBranchesSchedule();
+    // Runs layers up to the specified one according to branchesSchedule
+    void forwardBranches(LayerData& ld);
+
     Mat forward(const String& outputName);
     AsyncArray forwardAsync(const String& outputName);
+    // Queues forward pass up to the layer for the current inputs to asyncExecutor
+    AsyncArray forwardAsyncCPU(const String& layerName);
+    // Waits until asyncExecutor creates its execution context
+    void waitAsyncContext();
     void forward(OutputArrayOfArrays outputBlobs, const String& outputName);
     void forward(OutputArrayOfArrays outputBlobs,
             const std::vector<String>& outBlobNames);
@@ -242,6 +302,11 @@ struct Net::Impl : public detail::NetImplBase
     void getLayersShapes(const ShapesVec& netInputShapes,
             LayersShapesMap& inOutShapes);
 
+    // Returns shapes of layers for network input shapes from cache of recently used shapes or computes them.
+    // If mayFail is set, failed shape inference is cached too and an empty map is returned.
+    const LayersShapesMap& getCachedLayersShapes(const ShapesVec& netInputShapes, bool mayFail = false);
+    void clearLayersShapesCache();
+
     void getLayerShapes(const ShapesVec& netInputShapes,
             const int layerId,
             LayerShapes& shapes);
@@ -265,6 +330,11 @@ struct Net::Impl : public detail::NetImplBase
             std::vector<int>& layerIds, std::vector<size_t>& weights,
             std::vector<size_t>& blobs) /*const*/;
     int64 getPerfProfile(std::vector<double>& timings) const;
+    int64 getMemoryArenaSize() const;
+    void getLayersProfile(std::vector<LayerProfile>& profile) const;
+    void writeProfile(const String& path) const;
+
+    Net createExecutionContext(const std::vector<String>& outBlobNames);
 
     // TODO drop
     LayerPin getLatestLayerPin(const std::vector<LayerPin>& pins) const;
@@ -282,6 +352,9 @@ struct Net::Impl : public detail::NetImplBase
 
     void dumpNetworkToFile() const;
 
+    void writeCache(const String& path) const;
+    void readCache(const String& path);
+
     // FIXIT drop from inference API
     Net quantize(Net& net, InputArrayOfArrays calibData, int inputsDtype, int outputsDtype, bool perChannel) /*const*/;
     void getInputDetails(std::vector<float>& scales, std::vector<int>& zeropoints) /*const*/;
@@ -0,0 +1,206 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include <opencv2/core/detail/async_promise.hpp>
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+// Runs forward passes of an execution context in a worker thread in order of requests.
+// Each request keeps a copy of network inputs, so the caller may set inputs of the next
+// frame right after forwardAsync() returns. The context is created by the worker thread too,
+// the network must not be used until it is done (see waitContext()).
+class AsyncForwardExecutor
+{
+public:
+    AsyncForwardExecutor(Net::Impl& net_, const String& outputName_)
+        : outputName(outputName_), net(net_), contextCreated(false)
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        , stop(false)
+#endif
+    {
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        worker = std::thread(&AsyncForwardExecutor::run, this);
+#else
+        createContext();
+#endif
+    }
+
+    ~AsyncForwardExecutor()
+    {
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cond.notify_all();
+        worker.join();  // pending requests are processed before exit
+#endif
+    }
+
+    AsyncArray submit(const DataLayer& inputLayer)
+    {
+        Request request;
+        request.inputs.resize(inputLayer.inputsData.size());
+        for (size_t i = 0; i < inputLayer.inputsData.size(); i++)
+            request.inputs[i] = inputLayer.inputsData[i].clone();
+        request.scaleFactors = inputLayer.scaleFactors;
+        request.means = inputLayer.means;
+        AsyncArray result = request.result.getArrayResult();
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(std::move(request));
+        }
+        cond.notify_all();
+#else
+        process(request);
+#endif
+        return result;
+    }
+
+    // Blocks until the execution context is created. The creation compiles and runs the network,
+    // so methods of the network which access its state must wait for it.
+    void waitContext()
+    {
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this]() { return contextCreated; });
+#endif
+    }
+
+    const String outputName;
+
+private:
+    struct Request
+    {
+        std::vector<Mat> inputs;
+        std::vector<double> scaleFactors;
+        std::vector<Scalar> means;
+        AsyncPromise result;
+    };
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+    void run()
+    {
+        createContext();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            cond.wait(lock, [this]() { return stop || !requests.empty(); });
+            if (requests.empty())
+                return;
+            Request request = std::move(requests.front());
+            requests.pop_front();
+
+            lock.unlock();
+            process(request);
+            lock.lock();
+        }
+    }
+#endif
+
+    void createContext()
+    {
+        try
+        {
+            context = net.createExecutionContext(std::vector<String>(1, outputName));
+        }
+        catch (...)
+        {
+            contextError = std::current_exception();
+        }
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            contextCreated = true;
+        }
+        cond.notify_all();
+#else
+        contextCreated = true;
+#endif
+    }
+
+    void process(Request& request)
+    {
+        try
+        {
+            if (contextError)
+                std::rethrow_exception(contextError);
+
+            Net::Impl& ctx = context.getImplRef();
+            DataLayer& inputLayer = *ctx.netInputLayer;
+            CV_Assert(inputLayer.inputsData.size() == request.inputs.size());
+            for (size_t i = 0; i < request.inputs.size(); i++)
+                request.inputs[i].copyTo(inputLayer.inputsData[i]);  // shapes are the same, memory is kept
+            inputLayer.scaleFactors = request.scaleFactors;
+            inputLayer.means = request.means;
+
+            Mat output = context.forward(outputName);
+            request.result.setValue(output);
+        }
+        catch (...)
+        {
+            try {
+                request.result.setException(std::current_exception());
+            } catch(...) {
+                CV_LOG_ERROR(NULL, "DNN: Exception occurred during async inference exception propagation");
+            }
+        }
+    }
+
+    Net::Impl& net;
+    Net context;
+    std::exception_ptr contextError;
+    bool contextCreated;
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Request> requests;
+    bool stop;
+    std::thread worker;
+#endif
+};
+
+
+AsyncArray Net::Impl::forwardAsyncCPU(const String& layerName)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(!isExecutionContext);
+
+    // Network is reallocated (input shapes, backend or outputs are changed) since the context was created
+    if (asyncExecutor && (asyncExecutor->outputName != layerName || !netWasAllocated))
+        asyncExecutor.release();
+
+    // Context is created by the worker thread, the first request waits for it
+    if (!asyncExecutor)
+        asyncExecutor = Ptr<AsyncForwardExecutor>(new AsyncForwardExecutor(*this, layerName));
+    return asyncExecutor->submit(*netInputLayer);
+}
+
+
+void Net::Impl::waitAsyncContext()
+{
+    if (asyncExecutor)
+        asyncExecutor->waitContext();
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -191,6 +191,7 @@ void Net::Impl::setPreferableBackend(Net& net, int backendId)
     if (preferableBackend != backendId)
     {
         clear();
+        clearLayersShapesCache();
         if (backendId == DNN_BACKEND_INFERENCE_ENGINE_NGRAPH)
         {
 #if defined(HAVE_INF_ENGINE)
@@ -259,12 +260,14 @@ void Net::Impl::setPreferableTarget(int targetId)
 #if !defined(__arm64__) || !__arm64__
         if (targetId == DNN_TARGET_CPU_FP16)
         {
-            CV_LOG_WARNING(NULL, "DNN: fall back to DNN_TARGET_CPU. Only ARM v8 CPU is supported by DNN_TARGET_CPU_FP16.");
+            CV_LOG_WARNING(NULL, "DNN: FP16 arithmetic of DNN_TARGET_CPU_FP16 is supported by ARM v8 CPU only. "
+                                 "Only the packed Gemm/MatMul/Convolution weights are kept in FP16, computations are done in FP32.");
             targetId = DNN_TARGET_CPU;
         }
 #endif
 
         clear();
+        clearLayersShapesCache();
 
         if (targetId == DNN_TARGET_CPU_FP16)
         {
@@ -0,0 +1,317 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+#include "mapped_file.hpp"
+
+#include <fstream>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+// Layout of the network cache file:
+//   header
+//   graph: layers, parameters and connections serialized by FileStorage (YAML)
+//   weights: raw data of layers blobs, every blob is aligned on CACHE_ALIGN bytes from the beginning of the file
+// Results of layers fusion and weights packing are not stored: they are kept by layer instances,
+// which have no serialization interface, and depend on the backend, target and CPU features.
+namespace {
+
+struct CacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t graphSize;
+};
+
+static const char CACHE_MAGIC[8] = {'C', 'V', 'D', 'N', 'N', 'N', 'E', 'T'};
+static const uint32_t CACHE_VERSION = 1;
+static const uint32_t CACHE_BYTE_ORDER_MARK = 0x01020304;
+static const size_t CACHE_ALIGN = 64;
+
+static void writePadding(std::ofstream& ofs, size_t& pos, size_t alignment)
+{
+    static const char zeros[CACHE_ALIGN] = {0};
+    size_t aligned = alignSize(pos, (int)alignment);
+    ofs.write(zeros, aligned - pos);
+    pos = aligned;
+}
+
+static void writeParam(FileStorage& fs, const String& name, const DictValue& value)
+{
+    fs << "{:";
+    fs.write("name", name);
+    if (value.isInt())
+    {
+        fs << "type" << "int" << "value" << "[:";
+        for (int i = 0; i < value.size(); i++)
+            fs << (int64_t)value.get<int64>(i);
+    }
+    else if (value.isReal())
+    {
+        fs << "type" << "real" << "value" << "[:";
+        for (int i = 0; i < value.size(); i++)
+            fs << value.get<double>(i);
+    }
+    else
+    {
+        CV_Assert(value.isString());
+        fs << "type" << "string" << "value" << "[:";
+        for (int i = 0; i < value.size(); i++)
+            fs.write(String(), value.get<String>(i));
+    }
+    fs << "]" << "}";
+}
+
+static DictValue readParam(const FileNode& node)
+{
+    const String type = (String)node["type"];
+    FileNode valueNode = node["value"];
+    CV_Assert(valueNode.isSeq());
+    if (type == "int")
+    {
+        std::vector<int64> values;
+        for (FileNodeIterator it = valueNode.begin(); it != valueNode.end(); ++it)
+            values.push_back((int64_t)*it);
+        return DictValue::arrayInt(values.begin(), (int)values.size());
+    }
+    if (type == "real")
+    {
+        std::vector<double> values;
+        for (FileNodeIterator it = valueNode.begin(); it != valueNode.end(); ++it)
+            values.push_back((double)*it);
+        return DictValue::arrayReal(values.begin(), (int)values.size());
+    }
+    if (type == "string")
+    {
+        std::vector<String> values;
+        for (FileNodeIterator it = valueNode.begin(); it != valueNode.end(); ++it)
+            values.push_back((String)*it);
+        return DictValue::arrayString(values.begin(), (int)values.size());
+    }
+    CV_Error(Error::StsParseError, "DNN: unknown type of layer parameter in network cache: " + type);
+}
+
+}  // namespace
+
+
+void Net::Impl::writeCache(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(netInputLayer);
+
+    std::vector<Mat> blobs;  // in order of the weights section
+    size_t weightsSize = 0;
+
+    FileStorage fs(".yml", FileStorage::WRITE | FileStorage::MEMORY);
+    fs << "opencv_version" << CV_VERSION;
+    fs << "has_dynamic_shapes" << (int)hasDynamicShapes;
+
+    fs << "inputs" << "[";
+    for (size_t i = 0; i < netInputLayer->outNames.size(); i++)
+        fs.write(String(), netInputLayer->outNames[i]);
+    fs << "]";
+    fs << "input_shapes" << "[";
+    for (size_t i = 0; i < netInputLayer->outNames.size(); i++)
+    {
+        fs << "[:";
+        if (i < netInputLayer->shapes.size())
+        {
+            for (size_t j = 0; j < netInputLayer->shapes[i].size(); j++)
+                fs << netInputLayer->shapes[i][j];
+        }
+        fs << "]";
+    }
+    fs << "]";
+
+    fs << "layers" << "[";
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        if (ld.id == 0)
+            continue;  // network input layer
+        fs << "{";
+        fs << "id" << ld.id;
+        fs.write("name", ld.name);
+        fs.write("type", ld.type);
+        fs << "dtype" << ld.dtype;
+
+        fs << "inputs" << "[:";
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+            fs << ld.inputBlobsId[i].lid << ld.inputBlobsId[i].oid;
+        fs << "]";
+
+        fs << "params" << "[";
+        for (std::map<String, DictValue>::const_iterator p = ld.params.begin(); p != ld.params.end(); ++p)
+            writeParam(fs, p->first, p->second);
+        fs << "]";
+
+        fs << "blobs" << "[";
+        for (size_t i = 0; i < ld.params.blobs.size(); i++)
+        {
+            Mat blob = ld.params.blobs[i];
+            if (!blob.empty() && !blob.isContinuous())
+                blob = blob.clone();
+            weightsSize = alignSize(weightsSize, (int)CACHE_ALIGN);
+            fs << "{:" << "type" << blob.type() << "shape" << "[:";
+            for (int d = 0; d < blob.dims; d++)
+                fs << blob.size[d];
+            fs << "]" << "offset" << (int64_t)weightsSize << "}";
+            weightsSize += blob.total() * blob.elemSize();
+            blobs.push_back(blob);
+        }
+        fs << "]";
+        fs << "}";
+    }
+    fs << "]";
+
+    fs << "outputs" << "[";
+    for (std::map<std::string, int>::const_iterator it = outputNameToId.begin(); it != outputNameToId.end(); ++it)
+    {
+        fs << "{:";
+        fs.write("name", it->first);
+        fs << "id" << it->second << "}";
+    }
+    fs << "]";
+
+    const std::string graph = fs.releaseAndGetString();
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.byteOrder = CACHE_BYTE_ORDER_MARK;
+    header.graphSize = graph.size();
+
+    std::ofstream ofs(path.c_str(), std::ios::out | std::ios::binary);
+    if (!ofs.is_open())
+        CV_Error(Error::StsError, "DNN: can't open file for writing: " + path);
+    ofs.write((const char*)&header, sizeof(header));
+    ofs.write(graph.data(), graph.size());
+    size_t pos = sizeof(header) + graph.size();
+    writePadding(ofs, pos, CACHE_ALIGN);
+
+    const size_t weightsOffset = pos;
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        writePadding(ofs, pos, CACHE_ALIGN);
+        const size_t nbytes = blobs[i].total() * blobs[i].elemSize();
+        ofs.write((const char*)blobs[i].data, nbytes);
+        pos += nbytes;
+    }
+    CV_Assert(pos == weightsOffset + weightsSize);
+    if (!ofs)
+        CV_Error(Error::StsError, "DNN: can't write network cache: " + path);
+}
+
+
+void Net::Impl::readCache(const String& path)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(layers.size() == 1);  // empty network
+
+    MappedFile file(path);
+    CacheHeader header;
+    if (file.size() < sizeof(header))
+        CV_Error(Error::StsParseError, "DNN: invalid network cache file: " + path);
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0)
+        CV_Error(Error::StsParseError, "DNN: file is not a network cache: " + path);
+    CV_CheckEQ((int)header.byteOrder, (int)CACHE_BYTE_ORDER_MARK, "DNN: network cache was written on a machine with different byte order");
+    CV_CheckEQ((int)header.version, (int)CACHE_VERSION, "DNN: unsupported version of network cache");
+    CV_CheckLE((size_t)header.graphSize, file.size() - sizeof(header), "DNN: network cache file is truncated");
+    const size_t weightsOffset = alignSize(sizeof(header) + (size_t)header.graphSize, (int)CACHE_ALIGN);
+
+    FileStorage fs(std::string((const char*)file.data() + sizeof(header), (size_t)header.graphSize),
+                   FileStorage::READ | FileStorage::MEMORY);
+    CV_Assert(fs.isOpened());
+
+    const String version = (String)fs["opencv_version"];
+    if (version != CV_VERSION)
+        CV_LOG_WARNING(NULL, "DNN: network cache was written by OpenCV " << version << ", current version is " << CV_VERSION);
+
+    std::vector<String> inputs;
+    fs["inputs"] >> inputs;
+    setInputsNames(inputs);
+    FileNode shapesNode = fs["input_shapes"];
+    CV_Assert(shapesNode.isSeq() && shapesNode.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        MatShape inputShape;
+        shapesNode[(int)i] >> inputShape;
+        if (!inputShape.empty())
+            setInputShape(inputs[i], inputShape);
+    }
+
+    std::map<int, int> idMap;  // ids of layers in the cache -> ids in this network
+    idMap[0] = 0;
+    FileNode layersNode = fs["layers"];
+    for (FileNodeIterator it = layersNode.begin(); it != layersNode.end(); ++it)
+    {
+        const FileNode& layerNode = *it;
+        LayerParams params;
+        params.name = (String)layerNode["name"];
+        params.type = (String)layerNode["type"];
+
+        FileNode paramsNode = layerNode["params"];
+        for (FileNodeIterator p = paramsNode.begin(); p != paramsNode.end(); ++p)
+            params.set((String)(*p)["name"], readParam(*p));
+
+        FileNode blobsNode = layerNode["blobs"];
+        for (FileNodeIterator b = blobsNode.begin(); b != blobsNode.end(); ++b)
+        {
+            std::vector<int> blobShape;
+            (*b)["shape"] >> blobShape;
+            const int type = (int)(*b)["type"];
+            const size_t offset = (size_t)(int64_t)(*b)["offset"];
+            if (blobShape.empty())
+                params.blobs.push_back(Mat());
+            else
+                params.blobs.push_back(file.getMat(weightsOffset + offset, (int)blobShape.size(), blobShape.data(), type));
+        }
+
+        const int id = addLayer(params.name, params.type, (int)layerNode["dtype"], params);
+        idMap[(int)layerNode["id"]] = id;
+
+        std::vector<int> pins;
+        layerNode["inputs"] >> pins;
+        CV_Assert(pins.size() % 2 == 0);
+        for (size_t i = 0; i < pins.size(); i += 2)
+        {
+            if (pins[i] < 0)
+                continue;  // not connected
+            std::map<int, int>::const_iterator lid = idMap.find(pins[i]);
+            CV_Assert(lid != idMap.end());
+            connect(lid->second, pins[i + 1], id, (int)(i / 2));
+        }
+    }
+
+    FileNode outputsNode = fs["outputs"];
+    for (FileNodeIterator it = outputsNode.begin(); it != outputsNode.end(); ++it)
+    {
+        std::map<int, int>::const_iterator lid = idMap.find((int)(*it)["id"]);
+        CV_Assert(lid != idMap.end());
+        outputNameToId.insert(std::make_pair((std::string)(*it)["name"], lid->second));
+    }
+
+    if ((int)fs["has_dynamic_shapes"] != 0)
+        hasDynamicShapes = true;
+}
+
+
+Net readNetFromCache(const String& path)
+{
+    CV_TRACE_FUNCTION();
+    Net net;
+    net.getImplRef().readCache(path);
+    return net;
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
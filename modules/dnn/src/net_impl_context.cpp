@@ -0,0 +1,191 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+namespace {
+
+// Maps blobs of the compiled network to own memory of execution context.
+// Blobs which share memory in the compiled network (reused or in-place blobs,
+// views of memory arena) share memory in the context too.
+class BlobsRemapper
+{
+public:
+    Mat remap(const Mat& m)
+    {
+        if (m.empty())
+            return m;
+        if (!m.u || !m.isContinuous())
+            return m.clone();
+
+        const size_t esz = m.elemSize();
+        Mat& buffer = buffers[m.u];
+        if (buffer.empty())
+        {
+            // Copy content too: some blobs are not updated on each forward call (e.g. constants)
+            CV_Assert(m.u->size % esz == 0);
+            Mat src(1, (int)(m.u->size / esz), m.type(), m.u->data);
+            buffer = src.clone();
+        }
+        CV_CheckEQ(buffer.elemSize(), esz, "DNN: blobs with different element size share memory");
+
+        const size_t offset = m.data - m.u->data;
+        CV_Assert(offset % esz == 0);
+        const int start = (int)(offset / esz);
+        Mat dst = buffer.colRange(start, start + (int)m.total()).reshape(m.channels(), m.dims, m.size.p);
+        dst.dims = m.dims;
+        if (dst.type() != m.type())
+            dst = dst.reinterpret(m.type());
+        return dst;
+    }
+
+    void remap(std::vector<Mat>& mats)
+    {
+        for (size_t i = 0; i < mats.size(); i++)
+            mats[i] = remap(mats[i]);
+    }
+
+private:
+    std::map<UMatData*, Mat> buffers;
+};
+
+// Layers which keep state between forward calls (KV cache of Attention layer) can't be shared
+// by contexts which process independent sequences.
+static bool hasLayerState(const LayerData& ld)
+{
+    return !ld.layerInstance.dynamicCast<AttentionLayer>().empty() && ld.params.get<int>("kv_cache_size", 0) > 0;
+}
+
+}  // namespace
+
+
+Net Net::Impl::createExecutionContext(const std::vector<String>& outBlobNames)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(!empty());
+    CV_Assert(!isExecutionContext);
+
+    std::vector<LayerPin> pins;
+    if (outBlobNames.empty())
+    {
+        // the same output as Net::forward() returns by default
+        std::vector<String> layerNames = getLayerNames();
+        pins.push_back(getPinByAlias(layerNames.back()));
+    }
+    for (size_t i = 0; i < outBlobNames.size(); i++)
+        pins.push_back(getPinByAlias(outBlobNames[i]));
+
+    // Compile network: allocate, finalize and fuse layers.
+    setUpNet(pins);
+
+    if (preferableBackend != DNN_BACKEND_OPENCV ||
+        (preferableTarget != DNN_TARGET_CPU && preferableTarget != DNN_TARGET_CPU_FP16))
+        CV_Error(Error::StsNotImplemented, "DNN: execution contexts are supported by DNN_BACKEND_OPENCV on CPU targets only");
+
+    // Context gets own instances of layers with state. They are created before the warm-up call below,
+    // so it runs with them and doesn't change state of the network.
+    std::map<int, Ptr<Layer> > ownLayers;
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        LayerData& ld = it->second;
+        if (ld.skip || !hasLayerState(ld))
+            continue;
+        Ptr<Layer> layer = createLayerInstance(ld);
+        std::vector<Mat> inps(ld.inputBlobs.size());
+        for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+            inps[i] = *ld.inputBlobs[i];
+        layer->finalize(inps, ld.outputBlobs);
+        layer->preferableTarget = preferableTarget;
+        ownLayers[ld.id] = layer;
+    }
+
+    // Some layers finish initialization on the first forward call (e.g. pack weights after fusion).
+    // Run it once here, so shared layers are not modified by contexts.
+    for (std::map<int, Ptr<Layer> >::iterator it = ownLayers.begin(); it != ownLayers.end(); ++it)
+        std::swap(layers[it->first].layerInstance, it->second);
+    try
+    {
+        FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
+        forwardToLayer(getLayerData(getLatestLayerPin(pins).lid));
+    }
+    catch (...)
+    {
+        for (std::map<int, Ptr<Layer> >::iterator it = ownLayers.begin(); it != ownLayers.end(); ++it)
+            std::swap(layers[it->first].layerInstance, it->second);
+        throw;
+    }
+    for (std::map<int, Ptr<Layer> >::iterator it = ownLayers.begin(); it != ownLayers.end(); ++it)
+    {
+        std::swap(layers[it->first].layerInstance, it->second);
+        it->second.dynamicCast<AttentionLayer>()->resetCache();
+    }
+
+    Net net;
+    Net::Impl& ctx = *net.impl;
+
+    ctx.basePtr_ = basePtr_;
+    ctx.netInputLayer = makePtr<DataLayer>(*netInputLayer);
+    ctx.blobsToKeep = blobsToKeep;
+    ctx.layers = layers;
+    ctx.layerNameToId = layerNameToId;
+    ctx.outputNameToId = outputNameToId;
+    ctx.preferableBackend = preferableBackend;
+    ctx.preferableTarget = preferableTarget;
+    ctx.hasDynamicShapes = hasDynamicShapes;
+    ctx.lastLayerId = lastLayerId;
+    ctx.netWasAllocated = true;
+    ctx.netWasQuantized = netWasQuantized;
+    ctx.fusion = fusion;
+    ctx.useWinograd = useWinograd;
+    ctx.parallelBranches = parallelBranches;
+    ctx.channelsLast = channelsLast;
+    ctx.branchesSchedule = branchesSchedule;  // blobs of context share memory the same way
+    ctx.isExecutionContext = true;
+    ctx.layersTimings.resize(layersTimings.size(), 0);
+    ctx.layersStarts.resize(layersStarts.size(), 0);
+    ctx.layersThreads.resize(layersThreads.size(), 0);
+    ctx.layersKernels.resize(layersKernels.size());
+
+    // Layers (weights, packed buffers) are shared, blobs are owned by context.
+    BlobsRemapper remapper;
+    std::map<const Mat*, Mat*> outputsMap;
+    for (MapIdToLayerData::iterator it = ctx.layers.begin(); it != ctx.layers.end(); ++it)
+    {
+        LayerData& ld = it->second;
+        LayerData& compiled = layers[ld.id];
+        remapper.remap(ld.outputBlobs);
+        remapper.remap(ld.internals);
+        std::map<int, Ptr<Layer> >::const_iterator ownIt = ownLayers.find(ld.id);
+        if (ownIt != ownLayers.end())
+            ld.layerInstance = ownIt->second;
+        for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+            outputsMap[&compiled.outputBlobs[i]] = &ld.outputBlobs[i];
+        ld.flag = 0;
+    }
+    remapper.remap(ctx.netInputLayer->inputsData);
+    ctx.layers[0].layerInstance = ctx.netInputLayer;
+
+    for (MapIdToLayerData::iterator it = ctx.layers.begin(); it != ctx.layers.end(); ++it)
+    {
+        LayerData& ld = it->second;
+        for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+        {
+            std::map<const Mat*, Mat*>::const_iterator inpIt = outputsMap.find(ld.inputBlobs[i]);
+            CV_Assert(inpIt != outputsMap.end());
+            ld.inputBlobs[i] = inpIt->second;
+        }
+    }
+    return net;
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -6,6 +6,8 @@
 
 #include "net_impl.hpp"
 
+#include "layers/layers_common.hpp"  // PointwiseChainLayer
+
 #ifdef HAVE_CUDA
 #include "cuda4dnn/primitives/eltwise.hpp"  // required by fuseLayers
 #endif
@@ -32,6 +34,43 @@ void Net::Impl::enableFusion(bool fusion_)
 #endif
 
 
+// Returns element-wise operation of the layer output and constant `c` which may be fused into the layer.
+// The constant must be a scalar or a vector along the channels axis of the output.
+static Ptr<ActivationLayer> createConstOperation(const String& operation, bool constIsSecond, const Mat& c,
+                                                 const MatShape& outShape, int channelsAxis)
+{
+    if (c.empty() || c.type() != CV_32F || !c.isContinuous())
+        return Ptr<ActivationLayer>();
+    MatShape constShape = shape(c);
+    if (constShape.size() > outShape.size())
+        return Ptr<ActivationLayer>();
+    const int offset = (int)(outShape.size() - constShape.size());
+    for (int i = 0; i < (int)constShape.size(); i++)
+    {
+        if (constShape[i] != 1 && (i + offset != channelsAxis || constShape[i] != outShape[channelsAxis]))
+            return Ptr<ActivationLayer>();
+    }
+
+    PointwiseChainLayer::ConstOperation op;
+    const String name = toLowerCase(operation);
+    if (name == "add" || name == "sum")
+        op = PointwiseChainLayer::CONST_ADD;
+    else if (name == "sub")
+        op = constIsSecond ? PointwiseChainLayer::CONST_SUB : PointwiseChainLayer::CONST_RSUB;
+    else if (name == "mul")
+        op = PointwiseChainLayer::CONST_MUL;
+    else if (name == "div" && constIsSecond)
+        op = PointwiseChainLayer::CONST_DIV;
+    else if (name == "max")
+        op = PointwiseChainLayer::CONST_MAX;
+    else if (name == "min")
+        op = PointwiseChainLayer::CONST_MIN;
+    else
+        return Ptr<ActivationLayer>();
+    return PointwiseChainLayer::create(op, Mat(1, (int)c.total(), CV_32F, (void*)c.data));
+}
+
+
 void Net::Impl::fuseLayers(const std::vector<LayerPin>& blobsToKeep_)
 {
     CV_TRACE_FUNCTION();
@@ -74,6 +113,8 @@ void Net::Impl::fuseLayers(const std::vector<LayerPin>& blobsToKeep_)
         {
             LayerData* nextData = &layers[ld.consumers[0].lid];
             LayerPin lpNext(ld.consumers[0].lid, 0);
+            // output of the layer is allocated apart from memory planned for the network
+            bool privateOutput = false;
             while (nextData)
             {
 #ifdef HAVE_INF_ENGINE
@@ -336,6 +377,7 @@ void Net::Impl::fuseLayers(const std::vector<LayerPin>& blobsToKeep_)
 
                                     nextAct->outputBlobs = ld.outputBlobs;
                                     nextAct->outputBlobsWrappers = ld.outputBlobsWrappers;
+                                    finalData = nextAct;
                                 }
                             }
 
@@ -353,12 +395,94 @@ void Net::Impl::fuseLayers(const std::vector<LayerPin>& blobsToKeep_)
                                     }
                                 }
                             }
+
+                            // the following pointwise operations may be fused too
+                            privateOutput = true;
+                            lpNext = LayerPin(finalData->id, 0);
+                            if (finalData->consumers.size() == 1 && pinsToKeep.count(lpNext) == 0)
+                                nextData = &layers[finalData->consumers[0].lid];
+                            else
+                                nextData = 0;
                         }
                     }
                 }
                 break;
             }
 
+            // CPU: fuse chain of pointwise operations into Convolution, InnerProduct, Gemm or MatMul layer.
+            // Besides activations, these are element-wise operations with a constant (bias, scale, clipping), e.g.
+            // conv + add + relu + mul or matmul + add + gelu. All of them are applied to the output tile
+            // right after it's computed, so intermediate results don't go through memory.
+            LayerData* chainData = 0;
+            while (nextData && preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget) &&
+                   (ld.type == "Convolution" || ld.type == "Gemm" || ld.type == "MatMul" ||
+                    (ld.type == "InnerProduct" && !currLayer->blobs.empty())))
+            {
+                int chainInput = 0;
+                Ptr<ActivationLayer> op = nextData->layerInstance.dynamicCast<ActivationLayer>();
+                if (op.empty())
+                {
+                    if (nextData->type != "NaryEltwise" || nextData->inputBlobsId.size() != 2 ||
+                        nextData->outputBlobs.size() != 1 || ld.outputBlobs.size() != 1)
+                        break;
+                    chainInput = layers[nextData->inputBlobsId[0].lid].type == "Const" ? 1 : 0;
+                    const LayerData& constData = layers[nextData->inputBlobsId[1 - chainInput].lid];
+                    const MatShape outShape = shape(ld.outputBlobs[0]);
+                    if (constData.type != "Const" || constData.layerInstance->blobs.size() != 1 ||
+                        shape(nextData->outputBlobs[0]) != outShape)
+                        break;
+                    // channels are columns of the output for matrix multiplication layers
+                    const int channelsAxis = ld.type == "Convolution" ? 1 : (int)outShape.size() - 1;
+                    op = createConstOperation(nextData->params.get<String>("operation", "sum"), chainInput == 0,
+                                              constData.layerInstance->blobs[0], outShape, channelsAxis);
+                    if (op.empty())
+                        break;
+                }
+                if (pinsToKeep.count(nextData->inputBlobsId[chainInput]) != 0 || !currLayer->setActivation(op))
+                    break;
+
+                printf_(("\tfused with %s\n", nextData->name.c_str()));
+                nextData->skip = true;
+                if (!privateOutput && nextData->outputBlobs[0].data != ld.outputBlobs[0].data)
+                {
+                    // Operation is not in-place. The output of the fused layer may reuse memory of the layer input,
+                    // so the output is allocated separately.
+                    ld.outputBlobs[0] = Mat(shape(ld.outputBlobs[0]), ld.outputBlobs[0].type());
+                    ld.outputBlobsWrappers[0] = wrap(ld.outputBlobs[0]);
+                    privateOutput = true;
+                }
+                if (privateOutput)
+                {
+                    nextData->outputBlobs = ld.outputBlobs;
+                    nextData->outputBlobsWrappers = ld.outputBlobsWrappers;
+                }
+                else
+                {
+                    ld.outputBlobs = nextData->outputBlobs;
+                    ld.outputBlobsWrappers = nextData->outputBlobsWrappers;
+                }
+                chainData = nextData;
+                if (nextData->consumers.size() == 1)
+                    nextData = &layers[nextData->consumers[0].lid];
+                else
+                    nextData = 0;
+            }
+            if (chainData && privateOutput)
+            {
+                for (size_t i = 0; i < chainData->consumers.size(); ++i)
+                {
+                    LayerData& consumer = layers[chainData->consumers[i].lid];
+                    for (size_t j = 0; j < consumer.inputBlobsId.size(); ++j)
+                    {
+                        if (consumer.inputBlobsId[j].lid == chainData->id)
+                        {
+                            consumer.inputBlobs[j] = &ld.outputBlobs[0];
+                            consumer.inputBlobsWrappers[j] = ld.outputBlobsWrappers[0];
+                        }
+                    }
+                }
+            }
+
             // OpenCL: fuse convolution layer followed by eltwise + relu
             // CUDA: fuse convolution layer followed by eltwise/naryEltwise (and optional activation)
             while (nextData &&
@@ -0,0 +1,169 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include "layers/layers_common.hpp"  // ChannelsLastLayer
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+namespace {
+
+// Layers which compute every output element from the input elements at the same position.
+// They don't depend on layout if all their inputs and outputs have the same shape.
+static bool isPointwiseLayer(const String& type)
+{
+    static const char* const types[] = {
+        "ReLU", "ReLU6", "Sigmoid", "TanH", "Swish", "Mish", "ELU", "BNLL", "AbsVal", "Power", "Exp",
+        "Ceil", "Floor", "Log", "Round", "Sqrt", "Cos", "Cosh", "Erf", "HardSwish", "Sin", "Sinh", "Sign",
+        "Shrink", "Celu", "HardSigmoid", "Selu", "ThresholdedRelu", "Gelu", "GeluApproximation",
+        "Reciprocal", "Dropout", "Identity", "Split", "Eltwise", "NaryEltwise"
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        if (type == types[i])
+            return true;
+    }
+    return false;
+}
+
+static bool haveSameShapes4D(const LayerData& ld)
+{
+    if (ld.inputBlobs.empty() || ld.inputBlobs[0]->dims != 4)
+        return false;
+    const MatShape shape0 = shape(*ld.inputBlobs[0]);
+    for (size_t i = 1; i < ld.inputBlobs.size(); i++)
+    {
+        if (shape(*ld.inputBlobs[i]) != shape0)
+            return false;
+    }
+    for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+    {
+        if (shape(ld.outputBlobs[i]) != shape0)
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+
+void Net::Impl::enableChannelsLast(bool enable)
+{
+    if (channelsLast != enable)
+    {
+        channelsLast = enable;
+        clear();
+    }
+}
+
+
+// Channels-last regions are the connected parts of the graph which start at NHWC -> NCHW permutations and
+// consist of layers supporting channels-last layout. All the consumers of the region layers are in the region
+// or are NCHW -> NHWC permutations, so blobs of the region are never seen in NCHW layout. Layers are removed
+// from the candidates until these conditions hold for all of them.
+void Net::Impl::propagateChannelsLast(const std::vector<LayerPin>& blobsToKeep_)
+{
+    CV_TRACE_FUNCTION();
+
+    const bool enabled = channelsLast && preferableBackend == DNN_BACKEND_OPENCV &&
+                         preferableTarget == DNN_TARGET_CPU && !hasDynamicShapes;
+
+    std::vector<int> roles(lastLayerId + 1, ChannelsLastLayer::CHANNELS_LAST_UNSUPPORTED);
+    std::vector<uchar> inRegion(lastLayerId + 1, 0);
+    for (int pass = 0; enabled && pass < 2; pass++)
+    {
+        // Skipped layers are checked after the layers they are fused into
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            LayerData& ld = it->second;
+            if (ld.id == 0 || ld.skip != (pass == 1) || ld.dtype != CV_32F || ld.outputBlobs.empty())
+                continue;
+
+            int& role = roles[ld.id];
+            ChannelsLastLayer* layer = dynamic_cast<ChannelsLastLayer*>(ld.layerInstance.get());
+            if (layer)
+            {
+                std::vector<MatShape> inputs(ld.inputBlobs.size());
+                for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+                    inputs[i] = shape(*ld.inputBlobs[i]);
+                role = layer->getChannelsLastRole(inputs);
+            }
+            else if (isPointwiseLayer(ld.type) && haveSameShapes4D(ld))
+                role = ChannelsLastLayer::CHANNELS_LAST_SUPPORTED;
+
+            // Operations fused into a layer which supports channels-last layout are done by that layer
+            for (size_t i = 0; ld.skip && i < ld.inputBlobsId.size(); i++)
+            {
+                int lid = ld.inputBlobsId[i].lid;
+                while (layers[lid].skip && !layers[lid].inputBlobsId.empty())
+                    lid = layers[lid].inputBlobsId[0].lid;
+                if (roles[lid] == ChannelsLastLayer::CHANNELS_LAST_SUPPORTED)
+                    role = ChannelsLastLayer::CHANNELS_LAST_SUPPORTED;
+            }
+            inRegion[ld.id] = role == ChannelsLastLayer::CHANNELS_LAST_SUPPORTED ||
+                              role == ChannelsLastLayer::CHANNELS_LAST_ENTRY;
+        }
+    }
+
+    std::set<LayerPin> pinsToKeep(blobsToKeep_.begin(), blobsToKeep_.end());
+    for (bool changed = enabled; changed; )
+    {
+        changed = false;
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            const LayerData& ld = it->second;
+            if (!inRegion[ld.id])
+                continue;
+
+            bool valid = true;
+            if (roles[ld.id] == ChannelsLastLayer::CHANNELS_LAST_SUPPORTED)
+            {
+                // Constant operands of fused operations are not blobs of the region
+                for (size_t i = 0; valid && i < ld.inputBlobsId.size(); i++)
+                {
+                    const LayerData& producer = layers[ld.inputBlobsId[i].lid];
+                    valid = inRegion[producer.id] || (ld.skip && producer.type == "Const");
+                }
+            }
+            for (size_t i = 0; valid && i < ld.outputBlobs.size(); i++)
+                valid = pinsToKeep.count(LayerPin(ld.id, (int)i)) == 0;
+            for (size_t i = 0; valid && i < ld.consumers.size(); i++)
+            {
+                const int lid = ld.consumers[i].lid;
+                valid = inRegion[lid] || roles[lid] == ChannelsLastLayer::CHANNELS_LAST_EXIT;
+            }
+            if (!valid)
+            {
+                inRegion[ld.id] = 0;
+                changed = true;
+            }
+        }
+    }
+
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        ChannelsLastLayer* layer = dynamic_cast<ChannelsLastLayer*>(ld.layerInstance.get());
+        if (!layer)
+            continue;
+        if (roles[ld.id] == ChannelsLastLayer::CHANNELS_LAST_EXIT)
+            layer->channelsLast = inRegion[ld.inputBlobsId[0].lid] != 0;
+        else
+            layer->channelsLast = inRegion[ld.id] != 0;
+        if (layer->channelsLast)
+        {
+            CV_LOG_DEBUG(NULL, "DNN: layer " << ld.name << " (" << ld.type << ") runs in channels-last layout");
+        }
+    }
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -0,0 +1,206 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include <opencv2/core/utils/tls.hpp>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+namespace {
+
+struct KernelReportSlot
+{
+    KernelReportSlot() : kernel(NULL) {}
+    String* kernel;
+};
+
+static TLSData<KernelReportSlot>& getKernelReportSlot()
+{
+    static TLSData<KernelReportSlot>* slot = new TLSData<KernelReportSlot>();
+    return *slot;
+}
+
+static const char* getBackendName(int backendId)
+{
+    switch (backendId)
+    {
+        case DNN_BACKEND_HALIDE: return "Halide";
+        case DNN_BACKEND_INFERENCE_ENGINE:  // fallthru
+        case DNN_BACKEND_INFERENCE_ENGINE_NN_BUILDER_2019:  // fallthru
+        case DNN_BACKEND_INFERENCE_ENGINE_NGRAPH: return "OpenVINO";
+        case DNN_BACKEND_VKCOM: return "Vulkan";
+        case DNN_BACKEND_CUDA: return "CUDA";
+        case DNN_BACKEND_WEBNN: return "WebNN";
+        case DNN_BACKEND_TIMVX: return "TimVX";
+        case DNN_BACKEND_CANN: return "CANN";
+    }
+    return "";
+}
+
+static size_t getBytes(const Mat& m)
+{
+    return m.empty() ? 0 : m.total() * m.elemSize();
+}
+
+static void writeJSONString(std::ostream& out, const String& str)
+{
+    out << '"';
+    for (size_t i = 0; i < str.size(); i++)
+    {
+        const char c = str[i];
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if ((uchar)c < 0x20)
+            out << cv::format("\\u%04x", (int)(uchar)c);
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+}  // namespace
+
+
+void reportKernel(const char* name)
+{
+    String* kernel = getKernelReportSlot().get()->kernel;
+    if (kernel && kernel->empty())
+        *kernel = name;
+}
+
+KernelReportScope::KernelReportScope(String* kernel)
+{
+    KernelReportSlot* slot = getKernelReportSlot().get();
+    prev = slot->kernel;
+    slot->kernel = kernel;
+}
+
+KernelReportScope::~KernelReportScope()
+{
+    getKernelReportSlot().get()->kernel = prev;
+}
+
+
+void Net::Impl::getLayersProfile(std::vector<LayerProfile>& profile) const
+{
+    CV_TRACE_FUNCTION();
+    profile.clear();
+    if (layersTimings.empty())
+        return;
+
+    const double msPerTick = 1000.0 / getTickFrequency();
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        if (ld.id == 0 || ld.id >= (int)layersTimings.size())
+            continue;
+
+        LayerProfile p;
+        p.id = ld.id;
+        p.name = ld.name;
+        p.type = ld.type;
+        p.time = layersTimings[ld.id] * msPerTick;
+        if (ld.id < (int)layersStarts.size())
+        {
+            p.start = layersStarts[ld.id] * msPerTick;
+            p.thread = layersThreads[ld.id];
+        }
+
+        std::vector<MatShape> inputs, outputs;
+        size_t bytes = 0;
+        for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+        {
+            if (!ld.inputBlobs[i])
+                continue;
+            inputs.push_back(shape(*ld.inputBlobs[i]));
+            bytes += getBytes(*ld.inputBlobs[i]);
+        }
+        for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+        {
+            outputs.push_back(shape(ld.outputBlobs[i]));
+            bytes += getBytes(ld.outputBlobs[i]);
+        }
+
+        const Ptr<Layer>& layer = ld.layerInstance;
+        if (layer)
+        {
+            for (size_t i = 0; i < layer->blobs.size(); i++)
+                bytes += getBytes(layer->blobs[i]);
+            if (!inputs.empty() && !outputs.empty() && !outputs[0].empty())
+                p.flops = layer->getFLOPS(inputs, outputs);
+        }
+        p.bytes = (int64)bytes;
+
+        if (ld.skip)
+            p.kernel = "fused";
+        else if (ld.id < (int)layersKernels.size() && !layersKernels[ld.id].empty())
+            p.kernel = layersKernels[ld.id];
+        else if (preferableBackend != DNN_BACKEND_OPENCV)
+        {
+            std::map<int, Ptr<BackendNode> >::const_iterator node = ld.backendNodes.find(preferableBackend);
+            if (node != ld.backendNodes.end() && !node->second.empty())
+                p.kernel = getBackendName(preferableBackend);
+        }
+        else if (IS_DNN_OPENCL_TARGET(preferableTarget))
+            p.kernel = "OpenCL";
+
+        if (!ld.skip && p.time > 0)
+            p.gflops = p.flops / (p.time * 1e6);
+        profile.push_back(p);
+    }
+}
+
+void Net::Impl::writeProfile(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+    std::vector<LayerProfile> profile;
+    getLayersProfile(profile);
+
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open())
+        CV_Error(Error::StsError, "DNN: can't open file for writing: " + path);
+
+    // Every thread which has run layers gets own track: layers of concurrent branches
+    // (see enableParallelBranches()) are run by several threads.
+    std::vector<int> threads;
+    for (size_t i = 0; i < profile.size(); i++)
+    {
+        if (std::find(threads.begin(), threads.end(), profile[i].thread) == threads.end())
+            threads.push_back(profile[i].thread);
+    }
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        out << (i > 0 ? ",\n" : "\n");
+        out << cv::format("  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}}",
+                          threads[i], threads[i]);
+    }
+    for (size_t i = 0; i < profile.size(); i++)
+    {
+        const LayerProfile& p = profile[i];
+        out << ",\n  {\"name\": ";
+        writeJSONString(out, p.name);
+        out << ", \"cat\": ";
+        writeJSONString(out, p.type);
+        out << cv::format(", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                          p.thread, p.start * 1000, p.time * 1000);
+        out << cv::format(", \"args\": {\"id\": %d, \"kernel\": ", p.id);
+        writeJSONString(out, p.kernel);
+        out << cv::format(", \"flops\": %lld, \"bytes\": %lld, \"gflops\": %.3f}}",
+                          (long long)p.flops, (long long)p.bytes, p.gflops);
+    }
+    out << "\n]}\n";
+    if (!out)
+        CV_Error(Error::StsError, "DNN: can't write profile to file: " + path);
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -0,0 +1,368 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include <opencv2/core/parallel/execution_scope.hpp>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+namespace {
+
+typedef std::pair<const uchar*, const uchar*> MemoryRange;
+
+static void addMemoryRange(const Mat& m, std::vector<MemoryRange>& ranges)
+{
+    if (m.empty())
+        return;
+    const uchar* end = m.isContinuous() ? m.data + m.total() * m.elemSize() : m.dataend;
+    ranges.push_back(std::make_pair((const uchar*)m.data, end));
+}
+
+static bool isOverlapped(const std::vector<MemoryRange>& a, const std::vector<MemoryRange>& b)
+{
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        for (size_t j = 0; j < b.size(); j++)
+        {
+            if (a[i].first < b[j].second && b[j].first < a[i].second)
+                return true;
+        }
+    }
+    return false;
+}
+
+// Runs layers of a parallel segment. A layer is run by the thread which finishes the last of its
+// dependencies, so threads never wait for each other: if several layers become ready at once,
+// they are submitted as a nested parallel_for_() job and the thread takes part in it.
+// Every layer uses at most threadsPerLayer threads for its own parallel_for_() calls.
+class BranchesExecutor
+{
+public:
+    BranchesExecutor(Net::Impl& impl_, const std::vector<int>& layers, const std::vector<std::vector<int> >& predecessors,
+                     const std::vector<std::vector<int> >& successors_, int threadsPerLayer_)
+        : impl(impl_), successors(successors_), layersData(successors_.size(), NULL),
+          pending(successors_.size(), -1), threadsPerLayer(threadsPerLayer_), failed(false)
+    {
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            layersData[layers[i]] = &impl.layers[layers[i]];
+            pending[layers[i]] = 0;
+        }
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            const int lid = layers[i];
+            for (size_t j = 0; j < predecessors[lid].size(); j++)
+            {
+                if (pending[predecessors[lid][j]] >= 0)
+                    pending[lid]++;
+            }
+            if (pending[lid] == 0)
+                ready.push_back(lid);
+        }
+    }
+
+    void run()
+    {
+        runLayers(ready);
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    void runLayers(const std::vector<int>& lids)
+    {
+        if (lids.size() == 1)
+        {
+            runBranch(lids[0]);
+            return;
+        }
+        parallel_for_(Range(0, (int)lids.size()), [&](const Range& range)
+        {
+            for (int i = range.start; i < range.end; i++)
+                runBranch(lids[i]);
+        }, (double)lids.size());
+    }
+
+    // Runs the layer and then the layers which become ready after it.
+    void runBranch(int lid)
+    {
+        std::vector<int> next;
+        for (;;)
+        {
+            if (failed)
+                return;
+            try
+            {
+                parallel::ExecutionScope scope(threadsPerLayer);
+                impl.forwardLayer(*layersData[lid]);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failed)
+                    error = std::current_exception();
+                failed = true;
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                const std::vector<int>& succ = successors[lid];
+                for (size_t i = 0; i < succ.size(); i++)
+                {
+                    if (pending[succ[i]] > 0 && --pending[succ[i]] == 0)
+                        next.push_back(succ[i]);
+                }
+            }
+            if (next.size() != 1)
+                break;
+            lid = next[0];
+            next.clear();
+        }
+        if (!next.empty())
+            runLayers(next);
+    }
+
+    Net::Impl& impl;
+    const std::vector<std::vector<int> >& successors;
+    std::vector<LayerData*> layersData;
+    std::vector<int> pending;  // number of unfinished dependencies, -1 for layers which are not run
+    std::vector<int> ready;  // layers without dependencies in the segment
+    const int threadsPerLayer;
+    std::atomic<bool> failed;
+    std::exception_ptr error;
+    std::mutex mutex;
+};
+
+}  // namespace
+
+
+void Net::Impl::enableParallelBranches(bool enable)
+{
+    if (parallelBranches != enable)
+    {
+        parallelBranches = enable;
+        clear();
+    }
+}
+
+
+void Net::Impl::buildBranchesSchedule()
+{
+    CV_TRACE_FUNCTION();
+
+    BranchesSchedule& schedule = branchesSchedule;
+    schedule.clear();
+
+    // Network input layer is always run first.
+    std::vector<int> ids;
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        if (it->first != 0)
+            ids.push_back(it->first);
+    }
+    if (ids.size() < 2)
+        return;
+
+    // Layers are run in order of ids sequentially. To keep the result, a layer must wait for
+    // previous ones which produce its inputs or access the same memory (reused and in-place blobs,
+    // outputs of fused layers).
+    const int numIds = lastLayerId + 1;
+    std::vector<std::vector<MemoryRange> > reads(numIds), writes(numIds);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        const LayerData& ld = layers[ids[i]];
+        if (ld.skip)
+            continue;
+        for (size_t j = 0; j < ld.inputBlobs.size(); j++)
+            addMemoryRange(*ld.inputBlobs[j], reads[ld.id]);
+        for (size_t j = 0; j < ld.outputBlobs.size(); j++)
+            addMemoryRange(ld.outputBlobs[j], writes[ld.id]);
+        for (size_t j = 0; j < ld.internals.size(); j++)
+            addMemoryRange(ld.internals[j], writes[ld.id]);
+    }
+
+    std::vector<std::vector<int> > predecessors(numIds);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        const LayerData& ld = layers[ids[i]];
+        std::set<int> deps;
+        for (size_t j = 0; j < ld.inputBlobsId.size(); j++)
+        {
+            if (ld.inputBlobsId[j].lid != 0)
+                deps.insert(ld.inputBlobsId[j].lid);
+        }
+        for (size_t j = 0; j < i; j++)
+        {
+            const int prev = ids[j];
+            if (isOverlapped(writes[prev], reads[ld.id]) || isOverlapped(writes[prev], writes[ld.id]) ||
+                isOverlapped(reads[prev], writes[ld.id]))
+                deps.insert(prev);
+        }
+        predecessors[ld.id].assign(deps.begin(), deps.end());
+    }
+    LayersDependencies dependencies;
+    dependencies.build(predecessors);
+
+    // Layer which depends on all the previous layers and all the next layers depend on it
+    // can't run concurrently with others, so it splits network into segments.
+    std::vector<int> numDependencies(numIds, 0), numDependent(numIds, 0);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        for (size_t j = 0; j < i; j++)
+        {
+            if (dependencies.dependsOn(ids[i], ids[j]))
+            {
+                numDependencies[ids[i]]++;
+                numDependent[ids[j]]++;
+            }
+        }
+    }
+
+    // Estimated cost of layers to decide if concurrent execution is worth it.
+    std::vector<int64> cost(numIds, 0);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        LayerData& ld = layers[ids[i]];
+        if (ld.skip)
+            continue;
+        std::vector<MatShape> inputShapes, outputShapes;
+        for (size_t j = 0; j < ld.inputBlobs.size(); j++)
+            inputShapes.push_back(shape(*ld.inputBlobs[j]));
+        int64 outputsTotal = 0;
+        for (size_t j = 0; j < ld.outputBlobs.size(); j++)
+        {
+            outputShapes.push_back(shape(ld.outputBlobs[j]));
+            outputsTotal += ld.outputBlobs[j].total();
+        }
+        cost[ld.id] = std::max(getLayerInstance(ld)->getFLOPS(inputShapes, outputShapes), outputsTotal);
+    }
+
+    std::vector<int> segment;
+    for (size_t i = 0; i <= ids.size(); i++)
+    {
+        const bool isBarrier = i == ids.size() ||
+            (numDependencies[ids[i]] == (int)i && numDependent[ids[i]] == (int)(ids.size() - 1 - i));
+        if (isBarrier && !segment.empty())
+        {
+            // Threads are split between concurrent branches, so a branch runs slower than alone.
+            // A segment runs concurrently if its critical path is not much longer than the average branch.
+            // Otherwise a heavy branch with a fraction of threads is slower than running the layers
+            // one by one with all the threads.
+            int64 total = 0, criticalPath = 0;
+            int width = 0;
+            std::map<int, int64> pathCost;
+            for (size_t j = 0; j < segment.size(); j++)
+            {
+                const int lid = segment[j];
+                int64 start = 0;
+                bool isSource = true;
+                for (size_t k = 0; k < predecessors[lid].size(); k++)
+                {
+                    std::map<int, int64>::const_iterator it = pathCost.find(predecessors[lid][k]);
+                    if (it != pathCost.end())
+                    {
+                        start = std::max(start, it->second);
+                        isSource = false;
+                    }
+                }
+                pathCost[lid] = start + cost[lid];
+                criticalPath = std::max(criticalPath, pathCost[lid]);
+                total += cost[lid];
+                width += isSource;
+            }
+            BranchesSchedule::Segment s;
+            s.layers = segment;
+            s.width = width;
+            s.parallel = width > 1 && criticalPath * width <= total * 2;
+            schedule.segments.push_back(s);
+            CV_LOG_DEBUG(NULL, "DNN: branches schedule: " << segment.size() << " layers from " << segment.front()
+                         << " to " << segment.back() << " in " << width << " branches"
+                         << (s.parallel ? " run concurrently" : " run sequentially")
+                         << " (critical path " << criticalPath << " of " << total << ")");
+            segment.clear();
+        }
+        if (i == ids.size())
+            break;
+        if (isBarrier)
+        {
+            BranchesSchedule::Segment s;
+            s.layers.assign(1, ids[i]);
+            s.width = 1;
+            s.parallel = false;
+            schedule.segments.push_back(s);
+        }
+        else
+            segment.push_back(ids[i]);
+    }
+
+    bool hasParallelSegments = false;
+    for (size_t i = 0; i < schedule.segments.size(); i++)
+        hasParallelSegments |= schedule.segments[i].parallel;
+    if (!hasParallelSegments)
+    {
+        schedule.clear();
+        return;
+    }
+
+    schedule.predecessors.swap(predecessors);
+    schedule.successors.resize(numIds);
+    for (int lid = 0; lid < numIds; lid++)
+    {
+        for (size_t j = 0; j < schedule.predecessors[lid].size(); j++)
+            schedule.successors[schedule.predecessors[lid][j]].push_back(lid);
+    }
+}
+
+
+void Net::Impl::forwardBranches(LayerData& ld)
+{
+    CV_TRACE_FUNCTION();
+
+    LayerData& inputLayer = layers[0];
+    if (!inputLayer.flag)
+        forwardLayer(inputLayer);
+
+    const int numThreads = getNumThreads();
+    for (size_t i = 0; i < branchesSchedule.segments.size(); i++)
+    {
+        const BranchesSchedule::Segment& segment = branchesSchedule.segments[i];
+        if (segment.layers.front() > ld.id)
+            break;
+
+        std::vector<int> layersToRun;
+        for (size_t j = 0; j < segment.layers.size(); j++)
+        {
+            const int lid = segment.layers[j];
+            if (lid <= ld.id && !layers[lid].flag)
+                layersToRun.push_back(lid);
+        }
+
+        if (!segment.parallel || layersToRun.size() < 2 || numThreads < 2)
+        {
+            for (size_t j = 0; j < layersToRun.size(); j++)
+                forwardLayer(layers[layersToRun[j]]);
+            continue;
+        }
+
+        const int threadsPerLayer = std::max(1, numThreads / std::min(numThreads, segment.width));
+        BranchesExecutor executor(*this, layersToRun, branchesSchedule.predecessors, branchesSchedule.successors,
+                                  threadsPerLayer);
+        executor.run();
+    }
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -89,6 +89,16 @@ Net Net::Impl::quantize(Net& net, InputArrayOfArrays calibData, int inputsDtype,
             layer->forward(inps, ld.outputBlobs, ld.internals);
         }
 
+        // Attention quantizes Q, K and V projection, its range is taken from the internal buffer
+        if (ld.type == "Attention" && !ld.skip && !ld.internals.empty())
+        {
+            std::vector<float> qkv_sc;
+            std::vector<int> qkv_zp;
+            getQuantizationParams(ld.internals[0], qkv_sc, qkv_zp);
+            ld.params.set("qkv_scale", qkv_sc[0]);
+            ld.params.set("qkv_zeropoint", qkv_zp[0]);
+        }
+
         std::vector<float> sc;
         std::vector<int> zp;
         if (ld.type == "TanH")
@@ -9,6 +9,7 @@
 #include "nms.inl.hpp"
 
 #include <opencv2/imgproc.hpp>
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv { namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
@@ -19,13 +20,145 @@ static inline float rectOverlap(const T& a, const T& b)
     return 1.f - static_cast<float>(jaccardDistance(a, b));
 }
 
+// Margin of the overlap estimated in float. Boxes with the estimate above (threshold - margin)
+// are checked with rectOverlap(), so the result doesn't depend on rounding errors of the estimate.
+static const float NMS_OVERLAP_MARGIN = 1e-3f;
+
+// Boxes kept by greedy NMS. Coordinates are stored in separate arrays, so overlaps
+// of a candidate box with many kept boxes are estimated at once with SIMD.
+template <typename Rect_t>
+class KeptRects
+{
+public:
+    explicit KeptRects(const std::vector<Rect_t>& bboxes_) : bboxes(bboxes_) {}
+
+    void add(int idx)
+    {
+        const Rect_t& r = bboxes[idx];
+        indices.push_back(idx);
+        x1.push_back((float)r.x);
+        y1.push_back((float)r.y);
+        x2.push_back((float)(r.x + r.width));
+        y2.push_back((float)(r.y + r.height));
+        area.push_back((float)r.area());
+    }
+
+    // Returns true if overlap of the box with any of the kept boxes is above the threshold
+    bool overlaps(int idx, float threshold) const
+    {
+        const Rect_t& r = bboxes[idx];
+        const float bx1 = (float)r.x, by1 = (float)r.y;
+        const float bx2 = (float)(r.x + r.width), by2 = (float)(r.y + r.height);
+        const float barea = (float)r.area(), thr = threshold - NMS_OVERLAP_MARGIN;
+        const int n = (int)indices.size();
+        int k = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const int nlanes = VTraits<v_float32>::vlanes();
+        const v_float32 vx1 = vx_setall_f32(bx1), vy1 = vx_setall_f32(by1);
+        const v_float32 vx2 = vx_setall_f32(bx2), vy2 = vx_setall_f32(by2);
+        const v_float32 varea = vx_setall_f32(barea), vthr = vx_setall_f32(thr), vzero = vx_setzero_f32();
+        for (; k + nlanes <= n; k += nlanes)
+        {
+            v_float32 w = v_max(v_sub(v_min(vx_load(&x2[k]), vx2), v_max(vx_load(&x1[k]), vx1)), vzero);
+            v_float32 h = v_max(v_sub(v_min(vx_load(&y2[k]), vy2), v_max(vx_load(&y1[k]), vy1)), vzero);
+            v_float32 inter = v_mul(w, h);
+            v_float32 uni = v_sub(v_add(vx_load(&area[k]), varea), inter);
+            if (v_check_any(v_ge(inter, v_mul(uni, vthr))))
+            {
+                for (int j = k; j < k + nlanes; j++)
+                {
+                    if (rectOverlap(r, bboxes[indices[j]]) > threshold)
+                        return true;
+                }
+            }
+        }
+#endif
+        for (; k < n; k++)
+        {
+            float w = std::max(std::min(x2[k], bx2) - std::max(x1[k], bx1), 0.f);
+            float h = std::max(std::min(y2[k], by2) - std::max(y1[k], by1), 0.f);
+            float inter = w * h;
+            if (inter >= (area[k] + barea - inter) * thr && rectOverlap(r, bboxes[indices[k]]) > threshold)
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<int> indices;
+
+private:
+    const std::vector<Rect_t>& bboxes;
+    std::vector<float> x1, y1, x2, y2, area;
+};
+
+// Float estimate of overlap is used for boxes with non-negative sizes only. The areas are either
+// zero or above epsilon, so jaccardDistance() doesn't treat a pair of non-empty boxes as the same.
+// Rounding of corners to float changes overlap by up to 4 * maxCoord * FLT_EPSILON / minSide,
+// so boxes which are far from the origin relative to their sizes are processed without the estimate.
+template <typename Rect_t>
+static bool isOverlapEstimateApplicable(const std::vector<Rect_t>& bboxes)
+{
+    double maxCoord = 0, minSide = DBL_MAX;
+    for (size_t i = 0; i < bboxes.size(); i++)
+    {
+        const Rect_t& r = bboxes[i];
+        if (r.width < 0 || r.height < 0)
+            return false;
+        const typename Rect_t::value_type area = r.area();
+        if (area != 0 && area <= std::numeric_limits<typename Rect_t::value_type>::epsilon())
+            return false;
+        maxCoord = std::max(maxCoord, std::max(std::abs((double)r.x), std::abs((double)r.y)));
+        maxCoord = std::max(maxCoord, std::max(std::abs((double)r.x + r.width), std::abs((double)r.y + r.height)));
+        if (r.width > 0)
+            minSide = std::min(minSide, (double)r.width);
+        if (r.height > 0)
+            minSide = std::min(minSide, (double)r.height);
+    }
+    return maxCoord * 4 * FLT_EPSILON <= minSide * NMS_OVERLAP_MARGIN;
+}
+
+// The same as NMSFast_() with rectOverlap() for candidates sorted by score
+template <typename Rect_t>
+static void NMSRects_(const std::vector<Rect_t>& bboxes, const std::pair<float, int>* candidates, size_t count,
+                      const float nms_threshold, const float eta, std::vector<int>& indices)
+{
+    KeptRects<Rect_t> kept(bboxes);
+    float adaptive_threshold = nms_threshold;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int idx = candidates[i].second;
+        if (kept.overlaps(idx, adaptive_threshold))
+            continue;
+        kept.add(idx);
+        if (eta < 1 && adaptive_threshold > 0.5) {
+          adaptive_threshold *= eta;
+        }
+    }
+    indices.swap(kept.indices);
+}
+
+template <typename Rect_t>
+static void NMSBoxesImpl(const std::vector<Rect_t>& bboxes, const std::vector<float>& scores,
+                         const float score_threshold, const float nms_threshold,
+                         std::vector<int>& indices, const float eta, const int top_k)
+{
+    if (!isOverlapEstimateApplicable(bboxes))
+    {
+        NMSFast_(bboxes, scores, score_threshold, nms_threshold, eta, top_k, indices, rectOverlap);
+        return;
+    }
+    std::vector<std::pair<float, int> > score_index_vec;
+    GetMaxScoreIndex(scores, score_threshold, top_k, score_index_vec);
+    NMSRects_(bboxes, score_index_vec.data(), score_index_vec.size(), nms_threshold, eta, indices);
+}
+
 void NMSBoxes(const std::vector<Rect>& bboxes, const std::vector<float>& scores,
                           const float score_threshold, const float nms_threshold,
                           std::vector<int>& indices, const float eta, const int top_k)
 {
     CV_Assert_N(bboxes.size() == scores.size(), score_threshold >= 0,
         nms_threshold >= 0, eta > 0);
-    NMSFast_(bboxes, scores, score_threshold, nms_threshold, eta, top_k, indices, rectOverlap);
+    NMSBoxesImpl(bboxes, scores, score_threshold, nms_threshold, indices, eta, top_k);
 }
 
 void NMSBoxes(const std::vector<Rect2d>& bboxes, const std::vector<float>& scores,
@@ -34,7 +167,7 @@ void NMSBoxes(const std::vector<Rect2d>& bboxes, const std::vector<float>& score
 {
     CV_Assert_N(bboxes.size() == scores.size(), score_threshold >= 0,
         nms_threshold >= 0, eta > 0);
-    NMSFast_(bboxes, scores, score_threshold, nms_threshold, eta, top_k, indices, rectOverlap);
+    NMSBoxesImpl(bboxes, scores, score_threshold, nms_threshold, indices, eta, top_k);
 }
 
 static inline float rotatedRectIOU(const RotatedRect& a, const RotatedRect& b)
@@ -64,6 +197,50 @@ static inline void NMSBoxesBatchedImpl(const std::vector<Rect_t>& bboxes,
                                        const float score_threshold, const float nms_threshold,
                                        std::vector<int>& indices, const float eta, const int top_k)
 {
+    // Boxes of different classes don't suppress each other, so classes are processed in parallel.
+    // Adaptive threshold is shared by all the classes, so it requires sequential processing.
+    if (eta >= 1 && isOverlapEstimateApplicable(bboxes))
+    {
+        std::vector<std::pair<float, int> > score_index_vec;
+        GetMaxScoreIndex(scores, score_threshold, top_k, score_index_vec);
+
+        std::map<int, int> classToGroup;
+        std::vector<std::vector<std::pair<float, int> > > groups;
+        for (size_t i = 0; i < score_index_vec.size(); i++)
+        {
+            const int class_id = class_ids[score_index_vec[i].second];
+            std::map<int, int>::iterator it = classToGroup.find(class_id);
+            if (it == classToGroup.end())
+            {
+                it = classToGroup.insert(std::make_pair(class_id, (int)groups.size())).first;
+                groups.push_back(std::vector<std::pair<float, int> >());
+            }
+            groups[it->second].push_back(score_index_vec[i]);
+        }
+
+        std::vector<std::vector<int> > groupIndices(groups.size());
+        parallel_for_(Range(0, (int)groups.size()), [&](const Range& range)
+        {
+            for (int g = range.start; g < range.end; g++)
+                NMSRects_(bboxes, groups[g].data(), groups[g].size(), nms_threshold, eta, groupIndices[g]);
+        });
+
+        // Indices are ordered by score as if all the classes are processed together
+        std::vector<uchar> isKept(bboxes.size(), 0);
+        for (size_t g = 0; g < groupIndices.size(); g++)
+        {
+            for (size_t i = 0; i < groupIndices[g].size(); i++)
+                isKept[groupIndices[g][i]] = 1;
+        }
+        indices.clear();
+        for (size_t i = 0; i < score_index_vec.size(); i++)
+        {
+            if (isKept[score_index_vec[i].second])
+                indices.push_back(score_index_vec[i].second);
+        }
+        return;
+    }
+
     double x1, y1, x2, y2, max_coord = 0;
     for (int i = 0; i < bboxes.size(); i++)
     {
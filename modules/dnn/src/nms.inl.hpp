@@ -16,11 +16,10 @@ namespace dnn {
 namespace
 {
 
-template <typename T>
-static inline bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2)
+static inline bool SortScoreIndexPairDescend(const std::pair<float, int>& pair1,
+                                             const std::pair<float, int>& pair2)
 {
-    return pair1.first > pair2.first;
+    return pair1.first > pair2.first || (pair1.first == pair2.first && pair1.second < pair2.second);
 }
 
 } // namespace
@@ -43,15 +42,19 @@ inline void GetMaxScoreIndex(const std::vector<float>& scores, const float thres
         }
     }
 
-    // Sort the score pair according to the scores in descending order
-    std::stable_sort(score_index_vec.begin(), score_index_vec.end(),
-                     SortScorePairDescend<int>);
-
-    // Keep top_k scores if needed.
+    // Sort the score pair according to the scores in descending order.
+    // Pairs with the same score keep order of indices, like with stable sort.
+    // Keep top_k scores if needed: only the top_k pairs are selected and sorted (heap based partial sort).
     if (top_k > 0 && top_k < (int)score_index_vec.size())
     {
+        std::partial_sort(score_index_vec.begin(), score_index_vec.begin() + top_k, score_index_vec.end(),
+                          SortScoreIndexPairDescend);
         score_index_vec.resize(top_k);
     }
+    else
+    {
+        std::sort(score_index_vec.begin(), score_index_vec.end(), SortScoreIndexPairDescend);
+    }
 }
 
 // Do non maximum suppression given bboxes and scores.
@@ -10,8 +10,11 @@
 #ifdef HAVE_PROTOBUF
 #include "../graph_simplifier.hpp"
 #include "onnx_graph_simplifier.hpp"
+#include "../mapped_file.hpp"
 
+#include <opencv2/core/utils/external_buffer.hpp>
 #include <opencv2/core/utils/logger.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
 #include <queue>
 #include <limits>
 
@@ -1701,12 +1704,113 @@ void simplifySubgraphs(opencv_onnx::GraphProto& net)
     simplifySubgraphs(Ptr<ImportGraphWrapper>(new ONNXGraphWrapper(net)), subgraphs);
 }
 
+// Fields of TensorProto which describe external data (https://onnx.ai/onnx/repo-docs/ExternalData.html).
+// They are not declared in opencv-onnx.proto, so they are kept by parser as unknown fields.
+enum
+{
+    TENSOR_PROTO_EXTERNAL_DATA = 13,  // repeated StringStringEntryProto external_data
+    TENSOR_PROTO_DATA_LOCATION = 14,  // optional DataLocation data_location
+    TENSOR_PROTO_DATA_LOCATION_EXTERNAL = 1
+};
+
+static bool isExternalTensor(const opencv_onnx::TensorProto& tensor_proto)
+{
+    const ::google::protobuf::UnknownFieldSet& fields = tensor_proto.unknown_fields();
+    for (int i = 0; i < fields.field_count(); i++)
+    {
+        const ::google::protobuf::UnknownField& field = fields.field(i);
+        if (field.number() == TENSOR_PROTO_DATA_LOCATION && field.type() == ::google::protobuf::UnknownField::TYPE_VARINT)
+            return field.varint() == TENSOR_PROTO_DATA_LOCATION_EXTERNAL;
+    }
+    return false;
+}
+
+// Maps region of file with data of external tensor
+static MappedFile mapExternalTensor(const opencv_onnx::TensorProto& tensor_proto)
+{
+    std::string location;
+    size_t offset = 0, length = 0;
+    const ::google::protobuf::UnknownFieldSet& fields = tensor_proto.unknown_fields();
+    for (int i = 0; i < fields.field_count(); i++)
+    {
+        const ::google::protobuf::UnknownField& field = fields.field(i);
+        if (field.number() != TENSOR_PROTO_EXTERNAL_DATA || field.type() != ::google::protobuf::UnknownField::TYPE_LENGTH_DELIMITED)
+            continue;
+        opencv_onnx::StringStringEntryProto entry;
+        if (!entry.ParseFromString(field.length_delimited()))
+            CV_Error(Error::StsParseError, "DNN/ONNX: can't parse external data of tensor: " + tensor_proto.name());
+        if (entry.key() == "location")
+            location = entry.value();
+        else if (entry.key() == "offset")
+            offset = (size_t)std::stoull(entry.value());
+        else if (entry.key() == "length")
+            length = (size_t)std::stoull(entry.value());
+    }
+    if (location.empty())
+        CV_Error(Error::StsParseError, "DNN/ONNX: location of external data is not specified for tensor: " + tensor_proto.name());
+    CV_LOG_DEBUG(NULL, "DNN/ONNX: mapping external data of tensor '" << tensor_proto.name() << "' from " << location
+                 << " (offset=" << offset << ", length=" << length << ")");
+    return MappedFile(location, offset, length);
+}
+
+// Location of external data must be a relative path inside of the model directory,
+// as required by ONNX checker (https://onnx.ai/onnx/repo-docs/ExternalData.html).
+static void checkExternalDataLocation(const std::string& location, const std::string& tensorName)
+{
+    const bool isAbsolute = !location.empty() &&
+        (location[0] == '/' || location[0] == '\\' || location.find(':') != std::string::npos);
+    if (isAbsolute)
+        CV_Error(Error::StsParseError, "DNN/ONNX: location of external data must be a relative path, tensor: " + tensorName);
+    size_t start = 0;
+    while (start <= location.size())
+    {
+        size_t end = location.find_first_of("/\\", start);
+        if (end == std::string::npos)
+            end = location.size();
+        if (location.compare(start, end - start, "..") == 0)
+            CV_Error(Error::StsParseError, "DNN/ONNX: location of external data must be inside of the model directory, tensor: " + tensorName);
+        start = end + 1;
+    }
+}
+
+void setExternalDataDir(opencv_onnx::GraphProto& graph_proto, const std::string& baseDir)
+{
+    for (int i = 0; i < graph_proto.initializer_size(); i++)
+    {
+        opencv_onnx::TensorProto& tensor_proto = *graph_proto.mutable_initializer(i);
+        if (!isExternalTensor(tensor_proto))
+            continue;
+        ::google::protobuf::UnknownFieldSet& fields = *tensor_proto.mutable_unknown_fields();
+        for (int j = 0; j < fields.field_count(); j++)
+        {
+            ::google::protobuf::UnknownField& field = *fields.mutable_field(j);
+            if (field.number() != TENSOR_PROTO_EXTERNAL_DATA || field.type() != ::google::protobuf::UnknownField::TYPE_LENGTH_DELIMITED)
+                continue;
+            opencv_onnx::StringStringEntryProto entry;
+            if (entry.ParseFromString(field.length_delimited()) && entry.key() == "location")
+            {
+                checkExternalDataLocation(entry.value(), tensor_proto.name());
+                if (baseDir.empty())
+                    continue;
+                entry.set_value(utils::fs::join(baseDir, entry.value()));
+                field.set_length_delimited(entry.SerializeAsString());
+            }
+        }
+    }
+}
+
 Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
 {
-    if (tensor_proto.raw_data().empty() && tensor_proto.float_data().empty() &&
+    // Tensors with external data which don't need conversion refer to the mapped file with no copy
+    MappedFile externalData;
+    if (isExternalTensor(tensor_proto))
+        externalData = mapExternalTensor(tensor_proto);
+    else if (tensor_proto.raw_data().empty() && tensor_proto.float_data().empty() &&
         tensor_proto.double_data().empty() && tensor_proto.int64_data().empty() &&
         tensor_proto.int32_data().empty())
         return Mat();
+    const char* rawData = externalData.empty() ? tensor_proto.raw_data().c_str() : (const char*)externalData.data();
+    const size_t rawSize = externalData.empty() ? tensor_proto.raw_data().size() : externalData.size();
 
     opencv_onnx::TensorProto_DataType datatype = tensor_proto.data_type();
     Mat blob;
@@ -1716,14 +1820,24 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
     }
     if (sizes.empty())
         sizes.assign(1, 1);
+
+    auto mapExternalData = [&](int type) -> bool
+    {
+        if (externalData.empty() || (size_t)externalData.data() % CV_ELEM_SIZE1(type) != 0)
+            return false;
+        CV_CheckLE((size_t)total(sizes) * CV_ELEM_SIZE(type), rawSize, "DNN/ONNX: external data of tensor is truncated");
+        blob = externalData.getMat(0, (int)sizes.size(), sizes.data(), type);
+        return true;
+    };
+
     if (datatype == opencv_onnx::TensorProto_DataType_FLOAT) {
 
         if (!tensor_proto.float_data().empty()) {
             const ::google::protobuf::RepeatedField<float> field = tensor_proto.float_data();
             Mat(sizes, CV_32FC1, (void*)field.data()).copyTo(blob);
         }
-        else {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+        else if (!mapExternalData(CV_32FC1)) {
+            char* val = const_cast<char*>(rawData);
             Mat(sizes, CV_32FC1, val).copyTo(blob);
         }
     }
@@ -1756,13 +1870,13 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
         }
         else
         {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
 #if CV_STRONG_ALIGNMENT
             // Aligned pointer is required.
             AutoBuffer<hfloat, 16> aligned_val;
             if (!isAligned<sizeof(hfloat)>(val))
             {
-                size_t sz = tensor_proto.raw_data().size();
+                size_t sz = rawSize;
                 aligned_val.allocate(divUp(sz, sizeof(hfloat)));
                 memcpy(aligned_val.data(), val, sz);
                 val = (char*)aligned_val.data();
@@ -1778,14 +1892,14 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
         if (!field.empty())
             val = (char *)field.data();
         else
-            val = const_cast<char*>(tensor_proto.raw_data().c_str()); // sometime, the double will be stored at raw_data.
+            val = const_cast<char*>(rawData); // sometime, the double will be stored at raw_data.
 
 #if CV_STRONG_ALIGNMENT
         // Aligned pointer is required.
         AutoBuffer<double, 16> aligned_val;
         if (!isAligned<sizeof(double)>(val))
         {
-            size_t sz = tensor_proto.raw_data().size();
+            size_t sz = rawSize;
             aligned_val.allocate(divUp(sz, sizeof(double)));
             memcpy(aligned_val.data(), val, sz);
             val = (char*)aligned_val.data();
@@ -1800,9 +1914,9 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
             const ::google::protobuf::RepeatedField<int32_t> field = tensor_proto.int32_data();
             Mat(sizes, CV_32SC1, (void*)field.data()).copyTo(blob);
         }
-        else
+        else if (!mapExternalData(CV_32SC1))
         {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
             Mat(sizes, CV_32SC1, val).copyTo(blob);
         }
     }
@@ -1817,14 +1931,14 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
         }
         else
         {
-            const char* val = tensor_proto.raw_data().c_str();
+            const char* val = rawData;
 #if CV_STRONG_ALIGNMENT
             // Aligned pointer is required: https://github.com/opencv/opencv/issues/16373
             // this doesn't work: typedef int64_t CV_DECL_ALIGNED(1) unaligned_int64_t;
             AutoBuffer<int64_t, 16> aligned_val;
             if (!isAligned<sizeof(int64_t)>(val))
             {
-                size_t sz = tensor_proto.raw_data().size();
+                size_t sz = rawSize;
                 aligned_val.allocate(divUp(sz, sizeof(int64_t)));
                 memcpy(aligned_val.data(), val, sz);
                 val = (const char*)aligned_val.data();
@@ -1846,9 +1960,9 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
             const ::google::protobuf::RepeatedField<int32_t> field = tensor_proto.int32_data();
             Mat(sizes, CV_32SC1, (void*)field.data()).convertTo(blob, CV_8S, 1.0, offset);
         }
-        else
+        else if (depth != CV_8S || !mapExternalData(CV_8SC1))
         {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
             Mat(sizes, depth, val).convertTo(blob, CV_8S, 1.0, offset);
         }
     }
@@ -1869,6 +1983,39 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
     return blob;
 }
 
+Mat extractMatFromTensor(opencv_onnx::TensorProto& tensor_proto)
+{
+    // Raw data of tensors which don't need conversion is moved into Mat with no copy
+    int type = -1;
+    if (tensor_proto.data_type() == opencv_onnx::TensorProto_DataType_FLOAT)
+        type = CV_32FC1;
+    else if (tensor_proto.data_type() == opencv_onnx::TensorProto_DataType_INT32)
+        type = CV_32SC1;
+    else if (tensor_proto.data_type() == opencv_onnx::TensorProto_DataType_INT8)
+        type = CV_8SC1;
+
+    std::vector<int> sizes;
+    for (int i = 0; i < tensor_proto.dims_size(); i++)
+        sizes.push_back(tensor_proto.dims(i));
+    if (sizes.empty())
+        sizes.assign(1, 1);
+
+    const std::string& raw_data = tensor_proto.raw_data();
+    if (type < 0 || raw_data.empty() || (size_t)raw_data.data() % CV_ELEM_SIZE1(type) != 0 ||
+        raw_data.size() != (size_t)total(sizes) * CV_ELEM_SIZE(type))
+    {
+        Mat blob = getMatFromTensor(tensor_proto);
+        tensor_proto.clear_raw_data();
+        return blob;
+    }
+
+    std::shared_ptr<std::string> data(tensor_proto.release_raw_data());
+    Mat blob = utils::wrapExternalBuffer(data, &(*data)[0], (int)sizes.size(), sizes.data(), type);
+    if (tensor_proto.dims_size() == 0)
+        blob.dims = 1;  // To force 1-dimensional cv::Mat for scalars.
+    return blob;
+}
+
 CV__DNN_INLINE_NS_END
 }}  // namespace cv::dnn
 #endif  // HAVE_PROTOBUF
@@ -32,8 +32,24 @@ void convertInt64ToInt32(const T1& src, T2& dst, int size)
     }
 }
 
+/** @brief Converts tensor to Mat.
+ *
+ * Data of external tensors is mapped from file. If it doesn't need conversion, Mat refers to the mapping with no copy.
+ */
 Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto);
 
+/** @brief Converts tensor to Mat and releases data of the tensor.
+ *
+ * Raw data which doesn't need conversion is moved into Mat with no copy.
+ */
+Mat extractMatFromTensor(opencv_onnx::TensorProto& tensor_proto);
+
+/** @brief Resolves relative locations of external data of initializers against the directory of the model file.
+ *
+ * Throws if a location is an absolute path or refers outside of the directory.
+ */
+void setExternalDataDir(opencv_onnx::GraphProto& graph_proto, const std::string& baseDir);
+
 CV__DNN_INLINE_NS_END
 }}  // namespace dnn, namespace cv
 
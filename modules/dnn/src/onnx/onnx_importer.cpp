@@ -18,6 +18,7 @@
 #include <opencv2/core/utils/logger.hpp>
 
 #include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
 
 
 #ifdef HAVE_PROTOBUF
@@ -282,6 +283,11 @@ ONNXImporter::ONNXImporter(Net& net, const char *onnxFile)
     {
         CV_Error(Error::StsUnsupportedFormat, cv::format("Failed to parse ONNX model: %s", onnxFile));
     }
+    input.close();
+
+    // external data is located relative to the model file
+    if (model_proto.has_graph())
+        setExternalDataDir(*model_proto.mutable_graph(), utils::fs::getParent(onnxFile));
 
     populateNet();
 }
@@ -310,6 +316,10 @@ ONNXImporter::ONNXImporter(Net& net, const char* buffer, size_t sizeBuffer)
     if (!model_proto.ParseFromIstream(&input))
         CV_Error(Error::StsUnsupportedFormat, "Failed to parse onnx model from in-memory byte array.");
 
+    // external data is located relative to the current directory
+    if (model_proto.has_graph())
+        setExternalDataDir(*model_proto.mutable_graph(), std::string());
+
     populateNet();
 }
 
@@ -369,13 +379,6 @@ void dumpTensorProto(int i, const opencv_onnx::TensorProto& tensorProto, const s
     CV_LOG_VERBOSE(NULL, 0, "DNN/ONNX: " << prefix << "[" << i << " as '" << tensorProto.name() << "'] shape=" << toString(shape) << " data_type=" << (int)tensorProto.data_type());
 }
 
-void releaseONNXTensor(opencv_onnx::TensorProto& tensor_proto)
-{
-    if (!tensor_proto.raw_data().empty()) {
-        delete tensor_proto.release_raw_data();
-    }
-}
-
 void runLayer(LayerParams& params, const std::vector<Mat>& inputs,
               std::vector<Mat>& outputs)
 {
@@ -418,8 +421,7 @@ std::map<std::string, Mat> ONNXImporter::getGraphTensors(
     {
         const opencv_onnx::TensorProto& tensor_proto = graph_proto.initializer(i);
         dumpTensorProto(i, tensor_proto, "initializer");
-        Mat mat = getMatFromTensor(tensor_proto);
-        releaseONNXTensor(const_cast<opencv_onnx::TensorProto&>(tensor_proto));  // drop already loaded data
+        Mat mat = extractMatFromTensor(const_cast<opencv_onnx::TensorProto&>(tensor_proto));  // drop already loaded data
 
         if (DNN_DIAGNOSTICS_RUN && mat.empty())
             continue;
@@ -531,7 +533,7 @@ LayerParams ONNXImporter::getLayerParams(const opencv_onnx::NodeProto& node_prot
             else if (attribute_proto.has_t())
             {
                 opencv_onnx::TensorProto tensor = attribute_proto.t();
-                Mat blob = getMatFromTensor(tensor);
+                Mat blob = extractMatFromTensor(tensor);
                 lp.blobs.push_back(blob);
                 lp.set("original_dims_of_mat", tensor.dims_size());
             }
@@ -3878,12 +3880,21 @@ void ONNXImporter::parseAttention(LayerParams& params, const opencv_onnx::NodePr
     auto param_qkv_hidden_sizes = params.get("qkv_hidden_sizes");
     CV_CheckEQ(param_qkv_hidden_sizes.size(), 3, "ONNXImporter/parseAttention: qkv_hidden_sizes is must and only have three elements");
 
-    for (size_t i = 1; i < node_proto.input_size(); i++) {
+    // Inputs: input, weights, bias, mask_index (optional), past (optional). Outputs: output, present (optional).
+    CV_CheckGE(node_proto.input_size(), 3, "ONNXImporter/parseAttention: input, weights and bias are required");
+    CV_CheckTrue(node_proto.input_size() < 4 || node_proto.input(3).empty(), "ONNXImporter/parseAttention: mask_index is not supported");
+    CV_CheckTrue(node_proto.input_size() < 6, "ONNXImporter/parseAttention: only input, weights, bias and past inputs are supported");
+    for (size_t i = 1; i < 3; i++) {
         if (constBlobs.find(node_proto.input(i)) != constBlobs.end()) {
             Mat blob = getBlob(node_proto, i);
             params.blobs.push_back(blob);
         }
     }
+    if (node_proto.input_size() == 5 && !node_proto.input(4).empty()) {
+        CV_CheckTrue(constBlobs.find(node_proto.input(4)) == constBlobs.end(), "ONNXImporter/parseAttention: constant past is not supported");
+    }
+    if (node_proto.output_size() > 1 && !node_proto.output(1).empty())
+        params.set("present", true);
 
     addLayer(params, node_proto);
 }
@@ -4029,9 +4040,7 @@ Mat readTensorFromONNX(const String& path)
     {
         CV_Error(Error::StsUnsupportedFormat, cv::format("Failed to parse ONNX data: %s", path.c_str()));
     }
-    Mat mat = getMatFromTensor(tensor_proto);
-    releaseONNXTensor(tensor_proto);
-    return mat;
+    return extractMatFromTensor(tensor_proto);
 }
 
 #else  // HAVE_PROTOBUF
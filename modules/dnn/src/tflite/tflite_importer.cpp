@@ -14,6 +14,8 @@
 #define CV_LOG_STRIP_LEVEL CV_LOG_LEVEL_VERBOSE + 1
 #include <opencv2/core/utils/logger.hpp>
 
+#include "../mapped_file.hpp"
+
 namespace cv {
 namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
@@ -25,12 +27,16 @@ using namespace opencv_tflite;
 class TFLiteImporter {
 public:
     TFLiteImporter(Net& net, const char* modelBuffer, size_t bufSize);
+    TFLiteImporter(Net& net, const MappedFile& modelFile);
 
 private:
+    TFLiteImporter(Net& net, const char* modelBuffer, size_t bufSize, const MappedFile& modelFile);
+
     const opencv_tflite::Model* model;
     const flatbuffers::Vector<flatbuffers::Offset<opencv_tflite::Tensor> >* modelTensors;
     std::map<int, Mat> allTensors;
     Net& dstNet;
+    MappedFile modelFile;  // tensors refer to the mapped model file with no copy if it's not empty
 
     // This is a vector of pairs (layerId, outputId) where we iterate over
     // indices from TFLite notation and get created OpenCV layers.
@@ -122,15 +128,29 @@ Mat TFLiteImporter::parseTensor(const Tensor& tensor)
     default:
         CV_Error(Error::StsNotImplemented, format("Parse tensor with type %s", EnumNameTensorType(tensor.type())));
     }
-    Mat res = Mat(shape, dtype, const_cast<void*>(data));
+    Mat res;
+    if (!modelFile.empty() && (size_t)data % CV_ELEM_SIZE1(dtype) == 0)
+        res = modelFile.getMat((const uchar*)data - modelFile.data(), (int)shape.size(), shape.data(), dtype);
+    else
+        res = Mat(shape, dtype, const_cast<void*>(data));
     // workaround for scalars support
     if (!tensor_shape || shape.size() == 1)
         res.dims = 1;
     return res;
 }
 
+TFLiteImporter::TFLiteImporter(Net& dstNet, const MappedFile& modelFile)
+    : TFLiteImporter(dstNet, (const char*)modelFile.data(), modelFile.size(), modelFile)
+{
+}
+
 TFLiteImporter::TFLiteImporter(Net& dstNet, const char* modelBuffer, size_t bufSize)
-    : dstNet(dstNet), dispatch(buildDispatchMap())
+    : TFLiteImporter(dstNet, modelBuffer, bufSize, MappedFile())
+{
+}
+
+TFLiteImporter::TFLiteImporter(Net& dstNet, const char* modelBuffer, size_t bufSize, const MappedFile& modelFile_)
+    : dstNet(dstNet), modelFile(modelFile_), dispatch(buildDispatchMap())
 {
     flatbuffers::Verifier verifier((const uint8_t*)modelBuffer, bufSize);
     if (!VerifyModelBuffer(verifier)) {
@@ -1310,23 +1330,19 @@ void TFLiteImporter::getQuantParams(const Operator& op, float& inpScale, int& in
 Net readNetFromTFLite(const String &modelPath) {
     Net net;
 
-    std::vector<char> content;
-
-    const std::ios::openmode mode = std::ios::in | std::ios::binary;
-    std::ifstream ifs(modelPath, mode);
-    if (!ifs.is_open())
-        CV_Error(Error::StsError, cv::format("DNN/TFLite: can't open model file '%s'", modelPath.c_str()));
-
-    ifs.seekg(0, std::ios::end);
-    const size_t sz = ifs.tellg();
-    CV_Assert(sz > 0);
-    content.resize(sz);
-    ifs.seekg(0, std::ios::beg);
-
-    ifs.read(content.data(), sz);
-    CV_Assert(!ifs.bad());
+    // Model file is mapped into memory, so constant tensors refer to it with no copy
+    MappedFile modelFile;
+    try
+    {
+        modelFile = MappedFile(modelPath);
+    }
+    catch (const cv::Exception& e)
+    {
+        CV_Error(Error::StsError, cv::format("DNN/TFLite: can't open model file '%s': %s", modelPath.c_str(), e.what()));
+    }
+    CV_Assert(!modelFile.empty());
 
-    TFLiteImporter(net, content.data(), content.size());
+    TFLiteImporter(net, modelFile);
     return net;
 }
 
@@ -100,6 +100,32 @@ public:
             normAssert(refs[i], outs_dequantized[i], basename.c_str(), l1, lInf);
         }
     }
+
+    // Compares quantized and FP32 outputs of the network with a single layer
+    void testLayer(Net& net, const std::vector<Mat>& inps, const String& int8Type, double l1, double lInf)
+    {
+        std::vector<String> inpNames;
+        for (size_t i = 0; i < inps.size(); i++)
+            inpNames.push_back(cv::format("%zu", i));
+        net.setInputsNames(inpNames);
+        for (size_t i = 0; i < inps.size(); i++)
+            net.setInput(inps[i], inpNames[i]);
+        Mat ref = net.forward().clone();
+
+        for (int perChannel = 1; perChannel >= 0; perChannel--)
+        {
+            SCOPED_TRACE(perChannel ? "Per-channel quantize" : "Per-tensor quantize");
+            Net qnet = net.quantize(inps, CV_32F, CV_32F, perChannel != 0);
+            qnet.setPreferableBackend(backend);
+            qnet.setPreferableTarget(target);
+            EXPECT_EQ(int8Type, qnet.getLayer(qnet.getLayerId("layer"))->type);
+
+            for (size_t i = 0; i < inps.size(); i++)
+                qnet.setInput(inps[i], inpNames[i]);
+            Mat out = qnet.forward();
+            normAssert(ref, out, int8Type.c_str(), l1, lInf);
+        }
+    }
 };
 
 TEST_P(Test_Int8_layers, Convolution1D)
@@ -397,6 +423,114 @@ TEST_P(Test_Int8_layers, InnerProduct)
     }
 }
 
+TEST_P(Test_Int8_layers, MatMul)
+{
+    if (backend != DNN_BACKEND_OPENCV)
+        throw SkipTestException("Only OpenCV backend is supported");
+
+    RNG& rng = TS::ptr()->get_rng();
+    const int K = 37, N = 19;
+    Mat A({2, 3, K}, CV_32F), B(K, N, CV_32F), C(1, N, CV_32F);
+    rng.fill(A, RNG::UNIFORM, -1, 1);
+    rng.fill(B, RNG::UNIFORM, -1, 1);
+    rng.fill(C, RNG::UNIFORM, -1, 1);
+
+    {
+        SCOPED_TRACE("Constant B");
+        LayerParams lp;
+        lp.type = "MatMul";
+        lp.name = "layer";
+        lp.blobs.push_back(B);
+        lp.blobs.push_back(C);
+        lp.set("real_ndims_C", 1);
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        testLayer(net, std::vector<Mat>{A}, "MatMulInt8", 0.03, 0.1);
+    }
+    {
+        SCOPED_TRACE("Constant batched B");
+        Mat B3({2, K, N}, CV_32F);
+        rng.fill(B3, RNG::UNIFORM, -1, 1);
+
+        LayerParams lp;
+        lp.type = "MatMul";
+        lp.name = "layer";
+        lp.blobs.push_back(B3);
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        testLayer(net, std::vector<Mat>{A}, "MatMulInt8", 0.03, 0.1);
+    }
+    {
+        SCOPED_TRACE("Two inputs");
+        Mat A2({2, 1, 5, K}, CV_32F), B2({3, N, K}, CV_32F);
+        rng.fill(A2, RNG::UNIFORM, -1, 1);
+        rng.fill(B2, RNG::UNIFORM, -1, 1);
+
+        LayerParams lp;
+        lp.type = "MatMul";
+        lp.name = "layer";
+        lp.set("transB", true);
+        Net net;
+        int id = net.addLayer(lp.name, lp.type, lp);
+        net.connect(0, 0, id, 0);
+        net.connect(0, 1, id, 1);
+        testLayer(net, std::vector<Mat>{A2, B2}, "MatMulInt8", 0.03, 0.1);
+    }
+}
+
+TEST_P(Test_Int8_layers, Gemm)
+{
+    if (backend != DNN_BACKEND_OPENCV)
+        throw SkipTestException("Only OpenCV backend is supported");
+
+    RNG& rng = TS::ptr()->get_rng();
+    const int M = 5, K = 40, N = 24;
+    Mat A(M, K, CV_32F), B(N, K, CV_32F), C(1, N, CV_32F);
+    rng.fill(A, RNG::UNIFORM, -1, 1);
+    rng.fill(B, RNG::UNIFORM, -1, 1);
+    rng.fill(C, RNG::UNIFORM, -1, 1);
+
+    LayerParams lp;
+    lp.type = "Gemm";
+    lp.name = "layer";
+    lp.blobs.push_back(B);
+    lp.blobs.push_back(C);
+    lp.set("transB", true);
+    lp.set("alpha", 0.5f);
+    lp.set("constB", true);
+    lp.set("constC", true);
+    lp.set("have_bias", true);
+    lp.set("real_ndims_C", 2);
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    testLayer(net, std::vector<Mat>{A}, "GemmInt8", 0.02, 0.06);
+}
+
+TEST_P(Test_Int8_layers, Attention)
+{
+    if (backend != DNN_BACKEND_OPENCV)
+        throw SkipTestException("Only OpenCV backend is supported");
+
+    RNG& rng = TS::ptr()->get_rng();
+    const int batch = 2, seq_len = 7, hidden_size = 24, num_heads = 4;
+    Mat input({batch, seq_len, hidden_size}, CV_32F), weight(hidden_size, 3 * hidden_size, CV_32F), bias(1, 3 * hidden_size, CV_32F);
+    rng.fill(input, RNG::UNIFORM, -1, 1);
+    rng.fill(weight, RNG::UNIFORM, -0.5, 0.5);
+    rng.fill(bias, RNG::UNIFORM, -0.5, 0.5);
+
+    LayerParams lp;
+    lp.type = "Attention";
+    lp.name = "layer";
+    lp.blobs.push_back(weight);
+    lp.blobs.push_back(bias.reshape(1, std::vector<int>{3 * hidden_size}));
+    lp.set("num_heads", num_heads);
+    int qkv_hidden_sizes[] = {hidden_size, hidden_size, hidden_size};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv_hidden_sizes, 3));
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    testLayer(net, std::vector<Mat>{input}, "AttentionInt8", 0.02, 0.06);
+}
+
 TEST_P(Test_Int8_layers, Reshape)
 {
     testLayer("reshape_layer", "TensorFlow", 0.0032, 0.0082);
@@ -1844,6 +1844,56 @@ TEST(Layer_Test_ReduceMean, accuracy_input_0)
 }
 
 
+// Permutations which are done as transpositions (NCHW <-> NHWC), copies and in a general way
+TEST(Layer_Test_Permute, channels_last)
+{
+    typedef std::pair<std::vector<int>, std::vector<int> > ShapeOrder;
+    std::vector<ShapeOrder> cases;
+    cases.push_back(ShapeOrder({1, 3, 5, 7}, {0, 2, 3, 1}));
+    cases.push_back(ShapeOrder({2, 33, 17, 40}, {0, 3, 1, 2}));
+    cases.push_back(ShapeOrder({1, 4, 3, 5, 6}, {0, 2, 3, 4, 1}));
+    cases.push_back(ShapeOrder({2, 6, 5, 4, 3}, {0, 4, 1, 2, 3}));
+    cases.push_back(ShapeOrder({3, 40, 70}, {0, 2, 1}));
+    cases.push_back(ShapeOrder({2, 8, 1, 1}, {0, 2, 3, 1}));
+    cases.push_back(ShapeOrder({5, 6, 7, 8}, {1, 0, 2, 3}));
+    cases.push_back(ShapeOrder({2, 3, 4, 5}, {0, 3, 2, 1}));
+
+    for (size_t i = 0; i < cases.size(); i++)
+    {
+        const std::vector<int>& inpShape = cases[i].first;
+        const std::vector<int>& order = cases[i].second;
+        const int dims = (int)inpShape.size();
+
+        Mat input(inpShape, CV_32F);
+        randu(input, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.type = "Permute";
+        lp.name = "testPermute";
+        lp.set("order", DictValue::arrayInt(order.data(), dims));
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat output = net.forward();
+
+        std::vector<int> outShape(dims);
+        for (int j = 0; j < dims; j++)
+            outShape[j] = inpShape[order[j]];
+        ASSERT_EQ(MatShape(outShape), shape(output));
+
+        std::vector<int> outIdx(dims, 0), inpIdx(dims);
+        for (size_t k = 0; k < output.total(); k++)
+        {
+            for (int j = 0; j < dims; j++)
+                inpIdx[order[j]] = outIdx[j];
+            ASSERT_EQ(input.at<float>(inpIdx.data()), output.at<float>(outIdx.data())) << "case " << i;
+            for (int j = dims - 1; j >= 0 && ++outIdx[j] == outShape[j]; j--)
+                outIdx[j] = 0;
+        }
+    }
+}
+
 // Check if relu is not fused to convolution if we requested it's output
 TEST(Layer_Test_Convolution, relu_fusion)
 {
@@ -1876,6 +1926,536 @@ TEST(Layer_Test_Convolution, relu_fusion)
     normAssert(input, output);
 }
 
+// DNN_TARGET_CPU_FP16 keeps packed weights in FP16 even if the CPU has no FP16 arithmetic
+TEST(Layer_Test_Convolution, fp16_weights)
+{
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("stride", 2);
+    lp.set("pad", 1);
+    lp.set("num_output", 35);
+    lp.set("bias_term", false);
+    lp.type = "Convolution";
+    lp.name = "testConv";
+
+    int weightsShape[] = {35, 17, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    lp.blobs.push_back(weights);
+
+    int sz[] = {1, 17, 23, 29};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Mat ref, out;
+    for (int i = 0; i < 2; i++)
+    {
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(i == 0 ? DNN_TARGET_CPU : DNN_TARGET_CPU_FP16);
+        (i == 0 ? ref : out) = net.forward().clone();
+        if (i == 1 && !checkHardwareSupport(CPU_NEON_FP16))
+        {
+            // the output alone doesn't show that the FP16 weights are used
+            std::vector<LayerProfile> profile;
+            net.getLayersProfile(profile);
+            ASSERT_EQ(1u, profile.size());
+            EXPECT_EQ("im2row_fp16", profile[0].kernel);
+        }
+    }
+    normAssert(ref, out, "", 2e-3, 1e-2);
+}
+
+TEST(Layer_Test_Gemm, fp16_weights)
+{
+    LayerParams lp;
+    lp.type = "Gemm";
+    lp.name = "testGemm";
+    lp.set("constB", true);
+    lp.set("transB", true);
+
+    int M = 7, N = 333, K = 259;
+    Mat B(N, K, CV_32F);
+    randu(B, -1.0f, 1.0f);
+    lp.blobs.push_back(B);
+
+    Mat A(M, K, CV_32F);
+    randu(A, -1.0f, 1.0f);
+
+    Mat ref, out;
+    for (int i = 0; i < 2; i++)
+    {
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInput(A);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(i == 0 ? DNN_TARGET_CPU : DNN_TARGET_CPU_FP16);
+        (i == 0 ? ref : out) = net.forward().clone();
+
+        std::vector<LayerProfile> profile;
+        net.getLayersProfile(profile);
+        ASSERT_EQ(1u, profile.size());
+        EXPECT_EQ(i == 0 ? "fastGemm" : "fastGemm_fp16", profile[0].kernel);
+    }
+    normAssert(ref, out, "", 4e-3, 2e-2);
+}
+
+// Keeps about a given share of blockRows x 1 blocks of weights (consecutive outputs by 1 input) and zeros others
+static void pruneWeightsBlocks(Mat& weights, int numOutputs, int blockRows, double keep)
+{
+    Mat w = weights.reshape(1, numOutputs);
+    RNG& rng = theRNG();
+    for (int i = 0; i < w.rows; i += blockRows)
+    {
+        for (int j = 0; j < w.cols; j++)
+        {
+            if (rng.uniform(0.0, 1.0) >= keep)
+                w(Range(i, std::min(i + blockRows, w.rows)), Range(j, j + 1)).setTo(0);
+        }
+    }
+}
+
+// Keeps 2 random values in every group of 4 consecutive inputs of every output
+static void pruneWeights2of4(Mat& weights, int numOutputs)
+{
+    Mat w = weights.reshape(1, numOutputs);
+    RNG& rng = theRNG();
+    for (int i = 0; i < w.rows; i++)
+    {
+        for (int j = 0; j < w.cols; j += 4)
+        {
+            int keep0 = rng.uniform(0, 4), keep1 = (keep0 + rng.uniform(1, 4)) % 4;
+            for (int k = j; k < std::min(j + 4, w.cols); k++)
+            {
+                if (k - j != keep0 && k - j != keep1)
+                    w.at<float>(i, k) = 0;
+            }
+        }
+    }
+}
+
+// Prunes weights for the sparse format with a given kernel name
+static void pruneWeights(Mat& weights, int numOutputs, const std::string& kernel)
+{
+    if (kernel == "sparse_4x1")
+        pruneWeightsBlocks(weights, numOutputs, 4, 0.1);
+    else if (kernel == "sparse_8x1")
+        pruneWeightsBlocks(weights, numOutputs, 8, 0.15);
+    else
+        pruneWeights2of4(weights, numOutputs);
+}
+
+static std::string getLayerKernel(const Net& net, const std::string& name)
+{
+    std::vector<LayerProfile> profile;
+    net.getLayersProfile(profile);
+    for (const LayerProfile& p : profile)
+    {
+        if (p.name == name)
+            return p.kernel;
+    }
+    return std::string();
+}
+
+TEST(Layer_Test_FullyConnected, sparse_weights)
+{
+    const int numSamples = 3, numInputs = 102, numOutputs = 50;
+    const std::string kernels[] = {"sparse_4x1", "sparse_8x1", "sparse_2:4"};
+    for (const std::string& kernel : kernels)
+    {
+        SCOPED_TRACE(kernel);
+        Mat weights(numOutputs, numInputs, CV_32F), bias(1, numOutputs, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+        pruneWeights(weights, numOutputs, kernel);
+
+        LayerParams lp;
+        lp.set("num_output", numOutputs);
+        lp.set("bias_term", true);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        Net net;
+        int fcId = net.addLayer("fc", "InnerProduct", lp);
+        net.connect(0, 0, fcId, 0);
+        LayerParams reluParams;
+        int reluId = net.addLayer("relu", "ReLU", reluParams);
+        net.connect(fcId, 0, reluId, 0);
+
+        Mat input(numSamples, numInputs, CV_32F);
+        randu(input, -1.0f, 1.0f);
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat out = net.forward();
+        EXPECT_EQ(kernel, getLayerKernel(net, "fc"));
+
+        Mat ref = input * weights.t() + repeat(bias, numSamples, 1);
+        ref = max(ref, 0.0f);
+        normAssert(ref, out, "", 1e-5, 1e-4);
+    }
+}
+
+TEST(Layer_Test_Convolution, sparse_weights_1x1)
+{
+    const int inpChannels = 42, outChannels = 30, height = 7, width = 9;
+    const std::string kernels[] = {"sparse_4x1", "sparse_8x1", "sparse_2:4"};
+    for (const std::string& kernel : kernels)
+    {
+        SCOPED_TRACE(kernel);
+        int weightsShape[] = {outChannels, inpChannels, 1, 1};
+        Mat weights(4, &weightsShape[0], CV_32F), bias(1, outChannels, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+        pruneWeights(weights, outChannels, kernel);
+
+        LayerParams lp;
+        lp.set("kernel_size", 1);
+        lp.set("num_output", outChannels);
+        lp.set("bias_term", true);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        Net net;
+        int convId = net.addLayer("conv", "Convolution", lp);
+        net.connect(0, 0, convId, 0);
+        LayerParams reluParams;
+        reluParams.set("negative_slope", 0.1f);
+        int reluId = net.addLayer("relu", "ReLU", reluParams);
+        net.connect(convId, 0, reluId, 0);
+
+        int sz[] = {2, inpChannels, height, width};
+        Mat input(4, &sz[0], CV_32F);
+        randu(input, -1.0f, 1.0f);
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat out = net.forward();
+        EXPECT_EQ(kernel, getLayerKernel(net, "conv"));
+
+        Mat w = weights.reshape(1, outChannels);
+        for (int n = 0; n < sz[0]; n++)
+        {
+            Mat inp(inpChannels, height * width, CV_32F, input.ptr<float>(n));
+            Mat ref = w * inp + repeat(bias.t(), 1, height * width);
+            ref = max(ref, 0.0f) + min(ref, 0.0f) * 0.1f;
+            normAssert(ref, Mat(outChannels, height * width, CV_32F, out.ptr<float>(n)), "", 1e-5, 1e-4);
+        }
+    }
+}
+
+static int addConvolution(Net& net, const std::string& name, int prevId, int inpChannels, int outChannels,
+                          int kernel, int stride, int pad, int group)
+{
+    int weightsShape[] = {outChannels, inpChannels / group, kernel, kernel};
+    Mat weights(4, &weightsShape[0], CV_32F), bias(1, outChannels, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+
+    LayerParams lp;
+    lp.set("kernel_size", kernel);
+    lp.set("stride", stride);
+    lp.set("pad", pad);
+    lp.set("group", group);
+    lp.set("num_output", outChannels);
+    lp.set("bias_term", true);
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+    int id = net.addLayer(name, "Convolution", lp);
+    net.connect(prevId, 0, id, 0);
+    return id;
+}
+
+static int addPermute(Net& net, const std::string& name, int prevId, const int* order)
+{
+    LayerParams lp;
+    lp.set("order", DictValue::arrayInt(order, 4));
+    int id = net.addLayer(name, "Permute", lp);
+    net.connect(prevId, 0, id, 0);
+    return id;
+}
+
+static int addPooling(Net& net, const std::string& name, int prevId, const std::string& type, int kernel, int stride, int pad)
+{
+    LayerParams lp;
+    lp.set("pool", type);
+    lp.set("kernel_size", kernel);
+    lp.set("stride", stride);
+    lp.set("pad", pad);
+    int id = net.addLayer(name, "Pooling", lp);
+    net.connect(prevId, 0, id, 0);
+    return id;
+}
+
+TEST(Layer_Test_Convolution, channels_last)
+{
+    // The part of the graph between the permutations is computed on NHWC data
+    const int toNCHW[] = {0, 3, 1, 2}, toNHWC[] = {0, 2, 3, 1};
+    Net net;
+    int id = addPermute(net, "to_nchw", 0, toNCHW);
+    id = addConvolution(net, "conv", id, 8, 16, 3, 1, 1, 1);
+    LayerParams reluParams;
+    id = net.addLayerToPrev("relu", "ReLU", reluParams);
+    int dwId = addConvolution(net, "depthwise", id, 16, 16, 3, 2, 1, 16);
+    LayerParams relu6Params;
+    dwId = net.addLayerToPrev("relu6", "ReLU6", relu6Params);
+    id = addConvolution(net, "conv_1x1", dwId, 16, 16, 1, 1, 0, 1);
+    LayerParams addParams;
+    id = net.addLayerToPrev("add", "Eltwise", addParams);
+    net.connect(dwId, 0, id, 1);
+    LayerParams sigmoidParams;
+    id = net.addLayerToPrev("sigmoid", "Sigmoid", sigmoidParams);
+    id = addPooling(net, "max_pool", id, "max", 3, 1, 1);
+    int poolId = addPooling(net, "ave_pool", id, "ave", 2, 2, 0);
+    int sideId = addConvolution(net, "side_conv", poolId, 16, 8, 1, 1, 0, 1);
+    id = addConvolution(net, "group_conv", poolId, 16, 8, 3, 1, 1, 4);
+    LayerParams sumParams;
+    sumParams.set("operation", "add");
+    id = net.addLayerToPrev("sum", "NaryEltwise", sumParams);  // fused into group_conv
+    net.connect(sideId, 0, id, 1);
+    LayerParams eluParams;
+    id = net.addLayerToPrev("elu", "ELU", eluParams);
+    addPermute(net, "to_nhwc", id, toNHWC);
+
+    int sz[] = {2, 10, 12, 8};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.enableChannelsLast(false);
+    Mat ref = net.forward().clone();
+    std::vector<Mat> refOuts;
+    net.forward(refOuts, std::vector<String>{"to_nhwc", "max_pool"});
+
+    net.enableChannelsLast(true);
+    Mat out = net.forward();
+    normAssert(ref, out, "", 1e-5, 1e-4);
+    EXPECT_EQ("copy", getLayerKernel(net, "to_nchw"));
+    EXPECT_EQ("im2row_nhwc", getLayerKernel(net, "conv"));
+    EXPECT_EQ("depthwise_nhwc", getLayerKernel(net, "depthwise"));
+    EXPECT_EQ("1x1_nhwc", getLayerKernel(net, "conv_1x1"));
+    EXPECT_EQ("nhwc", getLayerKernel(net, "max_pool"));
+    EXPECT_EQ("nhwc", getLayerKernel(net, "ave_pool"));
+    EXPECT_EQ("1x1_nhwc", getLayerKernel(net, "side_conv"));
+    EXPECT_EQ("im2row_nhwc", getLayerKernel(net, "group_conv"));
+    EXPECT_EQ("fused", getLayerKernel(net, "sum"));
+    EXPECT_EQ("copy", getLayerKernel(net, "to_nhwc"));
+
+    // Blobs requested by user are in NCHW layout
+    std::vector<Mat> outs;
+    net.forward(outs, std::vector<String>{"to_nhwc", "max_pool"});
+    ASSERT_EQ(2u, outs.size());
+    normAssert(refOuts[0], outs[0], "to_nhwc", 1e-5, 1e-4);
+    normAssert(refOuts[1], outs[1], "max_pool", 1e-5, 1e-4);
+    EXPECT_NE("nhwc", getLayerKernel(net, "max_pool"));
+}
+
+TEST(Layer_Test_Attention, kv_cache)
+{
+    const int num_heads = 2, hidden_size = 8, seq_len = 5, prompt_len = 3;
+
+    LayerParams lp;
+    lp.type = "Attention";
+    lp.name = "testAttention";
+    lp.set("num_heads", num_heads);
+    int qkv_hidden_sizes[] = {hidden_size, hidden_size, hidden_size};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv_hidden_sizes, 3));
+    lp.set("unidirectional", true);
+    Mat weight(hidden_size, 3 * hidden_size, CV_32F), bias(1, 3 * hidden_size, CV_32F);
+    randu(weight, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    lp.blobs.push_back(weight);
+    lp.blobs.push_back(bias.reshape(1, std::vector<int>{3 * hidden_size}));
+
+    Mat input(std::vector<int>{1, seq_len, hidden_size}, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    // Whole sequence with causal mask
+    Mat ref;
+    {
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        ref = net.forward().clone();
+    }
+    const Mat ref2d = ref.reshape(1, seq_len);
+
+    // Internal cache: prompt, then tokens one by one
+    {
+        LayerParams params = lp;
+        params.set("kv_cache_size", 8);
+        Net net;
+        net.addLayerToPrev(params.name, params.type, params);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        for (int iter = 0; iter < 2; iter++)
+        {
+            Ptr<AttentionLayer> layer = net.getLayer(params.name).dynamicCast<AttentionLayer>();
+            ASSERT_FALSE(layer.empty());
+            layer->resetCache();
+
+            net.setInput(input(std::vector<Range>{Range::all(), Range(0, prompt_len), Range::all()}).clone());
+            Mat out = net.forward();
+            normAssert(out.reshape(1, prompt_len), ref2d.rowRange(0, prompt_len), "prompt");
+            for (int i = prompt_len; i < seq_len; i++)
+            {
+                net.setInput(input(std::vector<Range>{Range::all(), Range(i, i + 1), Range::all()}).clone());
+                out = net.forward();
+                normAssert(out.reshape(1, 1), ref2d.row(i), cv::format("token %d", i).c_str());
+            }
+        }
+        EXPECT_ANY_THROW(for (int i = 0; i < 8; i++) net.forward());  // cache overflow
+    }
+
+    // Past and present inputs and outputs
+    {
+        Mat present;
+        {
+            LayerParams params = lp;
+            params.set("present", true);
+            Net net;
+            net.addLayerToPrev(params.name, params.type, params);
+            net.setInput(input(std::vector<Range>{Range::all(), Range(0, prompt_len), Range::all()}).clone());
+            net.setPreferableBackend(DNN_BACKEND_OPENCV);
+            std::vector<Mat> outs;
+            net.forward(outs, params.name);
+            ASSERT_EQ(2u, outs.size());
+            EXPECT_EQ((MatShape{2, 1, num_heads, prompt_len, hidden_size / num_heads}), shape(outs[1]));
+            normAssert(outs[0].reshape(1, prompt_len), ref2d.rowRange(0, prompt_len), "prompt");
+            present = outs[1].clone();
+        }
+
+        Net net;
+        net.setInputsNames(std::vector<String>{"input", "past"});
+        int id = net.addLayer(lp.name, lp.type, lp);
+        net.connect(0, 0, id, 0);
+        net.connect(0, 1, id, 1);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        for (int i = prompt_len; i < seq_len; i++)
+        {
+            net.setInput(input(std::vector<Range>{Range::all(), Range(i, i + 1), Range::all()}).clone(), "input");
+            net.setInput(present, "past");
+            std::vector<Mat> outs;
+            net.forward(outs, lp.name);
+            ASSERT_EQ(2u, outs.size());
+            normAssert(outs[0].reshape(1, 1), ref2d.row(i), cv::format("token %d", i).c_str());
+            present = outs[1].clone();
+        }
+        EXPECT_EQ(seq_len, present.size[3]);
+    }
+}
+
+// Execution contexts decode independent sequences token by token
+TEST(Layer_Test_Attention, kv_cache_execution_contexts)
+{
+    const int num_heads = 2, hidden_size = 8, seq_len = 4;
+
+    LayerParams lp;
+    lp.type = "Attention";
+    lp.name = "testAttention";
+    lp.set("num_heads", num_heads);
+    int qkv_hidden_sizes[] = {hidden_size, hidden_size, hidden_size};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv_hidden_sizes, 3));
+    lp.set("unidirectional", true);
+    Mat weight(hidden_size, 3 * hidden_size, CV_32F), bias(1, 3 * hidden_size, CV_32F);
+    randu(weight, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    lp.blobs.push_back(weight);
+    lp.blobs.push_back(bias.reshape(1, std::vector<int>{3 * hidden_size}));
+
+    Mat inputs[2];
+    Mat refs[2];
+    for (int s = 0; s < 2; s++)
+    {
+        inputs[s].create(std::vector<int>{1, seq_len, hidden_size}, CV_32F);
+        randu(inputs[s], -1.0f, 1.0f);
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInput(inputs[s]);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        refs[s] = net.forward().clone().reshape(1, seq_len);
+    }
+    auto token = [&](int s, int i) -> Mat
+    {
+        return inputs[s](std::vector<Range>{Range::all(), Range(i, i + 1), Range::all()}).clone();
+    };
+
+    LayerParams params = lp;
+    params.set("kv_cache_size", seq_len);
+    Net net;
+    net.addLayerToPrev(params.name, params.type, params);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setInput(token(0, 0));
+    Net contexts[2] = {net.createExecutionContext(), net.createExecutionContext()};
+
+    // Contexts don't share caches with each other and the network
+    for (int i = 0; i < seq_len; i++)
+    {
+        for (int s = 0; s < 2; s++)
+        {
+            contexts[s].setInput(token(s, i));
+            Mat out = contexts[s].forward();
+            normAssert(out.reshape(1, 1), refs[s].row(i), cv::format("sequence %d, token %d", s, i).c_str());
+        }
+        net.setInput(token(0, i));
+        Mat out = net.forward();
+        normAssert(out.reshape(1, 1), refs[0].row(i), cv::format("network, token %d", i).c_str());
+    }
+}
+
+// Sequence is longer than blocks of tiled attention
+typedef testing::TestWithParam<bool> Layer_Test_Attention_long;
+TEST_P(Layer_Test_Attention_long, Accuracy)
+{
+    const bool unidirectional = GetParam();
+    const int num_heads = 2, hidden_size = 16, head_size = hidden_size / num_heads, seq_len = 300;
+
+    LayerParams lp;
+    lp.type = "Attention";
+    lp.name = "testAttention";
+    lp.set("num_heads", num_heads);
+    int qkv_hidden_sizes[] = {hidden_size, hidden_size, hidden_size};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv_hidden_sizes, 3));
+    lp.set("unidirectional", unidirectional);
+    Mat weight(hidden_size, 3 * hidden_size, CV_32F), bias(1, 3 * hidden_size, CV_32F);
+    randu(weight, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    lp.blobs.push_back(weight);
+    lp.blobs.push_back(bias.reshape(1, std::vector<int>{3 * hidden_size}));
+
+    Mat input(std::vector<int>{1, seq_len, hidden_size}, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    // Reference: Softmax(Q * K^T / sqrt(head_size)) * V with materialized scores
+    Mat qkv = input.reshape(1, seq_len) * weight;
+    qkv += repeat(bias, seq_len, 1);
+    Mat ref(seq_len, hidden_size, CV_32F);
+    for (int h = 0; h < num_heads; h++)
+    {
+        Mat q = qkv.colRange(h * head_size, (h + 1) * head_size);
+        Mat k = qkv.colRange(hidden_size + h * head_size, hidden_size + (h + 1) * head_size);
+        Mat v = qkv.colRange(2 * hidden_size + h * head_size, 2 * hidden_size + (h + 1) * head_size);
+        Mat scores = q * k.t() / std::sqrt((float)head_size);
+        for (int i = 0; i < seq_len; i++)
+        {
+            Mat row = scores.row(i);
+            if (unidirectional)
+                row.colRange(i + 1, seq_len).setTo(-FLT_MAX);
+            double maxVal;
+            minMaxLoc(row, NULL, &maxVal);
+            exp(row - maxVal, row);
+            row /= sum(row)[0];
+        }
+        Mat(scores * v).copyTo(ref.colRange(h * head_size, (h + 1) * head_size));
+    }
+
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setInput(input);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    Mat out = net.forward();
+    normAssert(out.reshape(1, seq_len), ref, "", 1e-5, 1e-4);
+}
+INSTANTIATE_TEST_CASE_P(/**/, Layer_Test_Attention_long, testing::Bool());
+
 typedef testing::TestWithParam<tuple<bool, tuple<Backend, Target> > > Layer_Test_Eltwise_unequal;
 TEST_P(Layer_Test_Eltwise_unequal, accuracy_input_0_truncate)
 {
@@ -2788,4 +3368,219 @@ INSTANTIATE_TEST_CASE_P(TestLayerFusion, ConvolutionActivationEltwiseFusion, Com
                         TestLayerFusion::dnnBackendsAndTargetsForFusionTests()
 ));
 
+static int addConstEltwise(Net& net, const std::string& name, const std::string& op, const Mat& value, int inpId, bool constFirst = false)
+{
+    LayerParams constParams;
+    constParams.blobs.push_back(value);
+    int constId = net.addLayer(name + "_const", "Const", constParams);
+
+    LayerParams eltwiseParams;
+    eltwiseParams.set("operation", op);
+    int eltwiseId = net.addLayer(name, "NaryEltwise", eltwiseParams);
+    net.connect(inpId, 0, eltwiseId, constFirst ? 1 : 0);
+    net.connect(constId, 0, eltwiseId, constFirst ? 0 : 1);
+    return eltwiseId;
+}
+
+TEST(ConvolutionPointwiseChainFusion, Accuracy)
+{
+    //   input -> convolution -> add(const) -> relu -> mul(const) -> sub(const) -> output
+    // element-wise operations take per-channel constants, except the last one which is const - x
+    const int batch_size = 2, in_channels = 16;
+    int inputShape[] = {batch_size, in_channels, 16, 16};
+    Mat input(4, &inputShape[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    LayerParams convParams;
+    TestLayerFusion::makeDefaultTestConvolutionLayer(convParams, in_channels, in_channels, true);
+
+    Mat bias(std::vector<int>{in_channels, 1, 1}, CV_32F), scale(std::vector<int>{1, in_channels, 1, 1}, CV_32F);
+    randu(bias, -1.0f, 1.0f);
+    randu(scale, 0.5f, 2.0f);
+
+    Net net;
+    int convId = net.addLayer(convParams.name, convParams.type, convParams);
+    net.connect(0, 0, convId, 0);
+    int addId = addConstEltwise(net, "add", "add", bias, convId);
+    LayerParams reluParams;
+    int reluId = net.addLayer("relu", "ReLU", reluParams);
+    net.connect(addId, 0, reluId, 0);
+    int mulId = addConstEltwise(net, "mul", "mul", scale, reluId);
+    int subId = addConstEltwise(net, "sub", "sub", Mat(1, 1, CV_32F, Scalar(0.5f)), mulId, true);
+
+    std::vector<int> expectedFusedLayers;
+    expectedFusedLayers.push_back(addId);
+    expectedFusedLayers.push_back(reluId);
+    expectedFusedLayers.push_back(mulId);
+    expectedFusedLayers.push_back(subId);
+    TestLayerFusion::test(input, net, DNN_BACKEND_OPENCV, DNN_TARGET_CPU, expectedFusedLayers);
+}
+
+TEST(MatMulPointwiseChainFusion, Accuracy)
+{
+    //   input -> matmul -> add(const) -> gelu -> mul(const) -> output
+    // bias is a vector along columns of the output, scale is a scalar
+    const int M = 37, K = 64, N = 96;
+    Mat input(std::vector<int>{2, M, K}, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    LayerParams matmulParams;
+    Mat weights(K, N, CV_32F);
+    randu(weights, -0.2f, 0.2f);
+    matmulParams.blobs.push_back(weights);
+
+    Mat bias(1, N, CV_32F);
+    randu(bias, -1.0f, 1.0f);
+
+    Net net;
+    int matmulId = net.addLayer("matmul", "MatMul", matmulParams);
+    net.connect(0, 0, matmulId, 0);
+    int addId = addConstEltwise(net, "add", "add", bias, matmulId);
+    LayerParams geluParams;
+    int geluId = net.addLayer("gelu", "Gelu", geluParams);
+    net.connect(addId, 0, geluId, 0);
+    int mulId = addConstEltwise(net, "mul", "mul", Mat(1, 1, CV_32F, Scalar(0.7f)), geluId);
+
+    std::vector<int> expectedFusedLayers;
+    expectedFusedLayers.push_back(addId);
+    expectedFusedLayers.push_back(geluId);
+    expectedFusedLayers.push_back(mulId);
+    TestLayerFusion::test(input, net, DNN_BACKEND_OPENCV, DNN_TARGET_CPU, expectedFusedLayers);
+}
+
+TEST(LayerNormActivationFusion, Accuracy)
+{
+    //   input -> layer_norm -> relu -> swish -> output
+    // input has a large mean to check that variance is computed without cancellation
+    const int rows = 6, norm_size = 1000;
+    Mat input(std::vector<int>{2, rows / 2, norm_size}, CV_32F);
+    randu(input, 1000.0f, 1002.0f);
+
+    LayerParams lnParams;
+    lnParams.set("axis", 2);
+    lnParams.set("epsilon", 1e-5f);
+    Mat weight(norm_size, 1, CV_32F), bias(norm_size, 1, CV_32F);
+    randu(weight, 0.5f, 1.5f);
+    randu(bias, -0.5f, 0.5f);
+    lnParams.blobs.push_back(weight);
+    lnParams.blobs.push_back(bias);
+
+    Net net;
+    int lnId = net.addLayer("layer_norm", "LayerNormalization", lnParams);
+    net.connect(0, 0, lnId, 0);
+    LayerParams reluParams;
+    int reluId = net.addLayer("relu", "ReLU", reluParams);
+    net.connect(lnId, 0, reluId, 0);
+    LayerParams swishParams;
+    int swishId = net.addLayer("swish", "Swish", swishParams);
+    net.connect(reluId, 0, swishId, 0);
+
+    std::vector<int> expectedFusedLayers;
+    expectedFusedLayers.push_back(reluId);
+    expectedFusedLayers.push_back(swishId);
+    TestLayerFusion::test(input, net, DNN_BACKEND_OPENCV, DNN_TARGET_CPU, expectedFusedLayers);
+
+    Mat ref(rows, norm_size, CV_32F);
+    Mat x = input.reshape(1, rows);
+    for (int i = 0; i < rows; i++)
+    {
+        double mean = 0, variance = 0;
+        for (int j = 0; j < norm_size; j++)
+            mean += x.at<float>(i, j);
+        mean /= norm_size;
+        for (int j = 0; j < norm_size; j++)
+            variance += (x.at<float>(i, j) - mean) * (x.at<float>(i, j) - mean);
+        variance /= norm_size;
+        for (int j = 0; j < norm_size; j++)
+        {
+            double v = (x.at<float>(i, j) - mean) / std::sqrt(variance + 1e-5) * weight.at<float>(j) + bias.at<float>(j);
+            v = std::max(v, 0.0);
+            ref.at<float>(i, j) = (float)(v / (1.0 + std::exp(-v)));
+        }
+    }
+    net.setInput(input);
+    Mat out = net.forward();
+    normAssert(ref, out.reshape(1, rows), "", 1e-4, 1e-3);
+}
+
+// Checks fusion of per-channel PReLU and TanH into GroupNormalization (num_groups < C)
+// or InstanceNormalization (num_groups == 0) on input with a large mean.
+static void testNormChannelsActivationFusion(int num_groups)
+{
+    const int N = 2, C = 6, H = 5, W = 7, planeSize = H * W;
+    Mat input(std::vector<int>{N, C, H, W}, CV_32F);
+    randu(input, 1000.0f, 1002.0f);
+
+    Mat scale(C, 1, CV_32F), bias(C, 1, CV_32F), slope(C, 1, CV_32F);
+    randu(scale, 0.5f, 1.5f);
+    randu(bias, -0.5f, 0.5f);
+    randu(slope, 0.1f, 0.9f);
+
+    Net net;
+    LayerParams scaleParams, biasParams;
+    scaleParams.blobs.push_back(scale);
+    biasParams.blobs.push_back(bias);
+    int scaleId = net.addLayer("scale", "Const", scaleParams);
+    int biasId = net.addLayer("bias", "Const", biasParams);
+
+    LayerParams normParams;
+    normParams.set("epsilon", 1e-5f);
+    if (num_groups > 0)
+        normParams.set("num_groups", num_groups);
+    int normId = net.addLayer("norm", num_groups > 0 ? "GroupNormalization" : "InstanceNormalization", normParams);
+    net.connect(0, 0, normId, 0);
+    net.connect(scaleId, 0, normId, 1);
+    net.connect(biasId, 0, normId, 2);
+    LayerParams preluParams;
+    preluParams.blobs.push_back(slope);
+    int preluId = net.addLayer("prelu", "PReLU", preluParams);
+    net.connect(normId, 0, preluId, 0);
+    LayerParams tanhParams;
+    int tanhId = net.addLayer("tanh", "TanH", tanhParams);
+    net.connect(preluId, 0, tanhId, 0);
+
+    std::vector<int> expectedFusedLayers;
+    expectedFusedLayers.push_back(preluId);
+    expectedFusedLayers.push_back(tanhId);
+    TestLayerFusion::test(input, net, DNN_BACKEND_OPENCV, DNN_TARGET_CPU, expectedFusedLayers);
+
+    const int groupSize = num_groups > 0 ? C / num_groups : 1;
+    Mat ref(N * C, planeSize, CV_32F);
+    Mat x = input.reshape(1, N * C);
+    for (int i = 0; i < N * C; i += groupSize)
+    {
+        const int normSize = groupSize * planeSize;
+        double mean = 0, variance = 0;
+        for (int j = 0; j < normSize; j++)
+            mean += x.ptr<float>(i)[j];
+        mean /= normSize;
+        for (int j = 0; j < normSize; j++)
+            variance += (x.ptr<float>(i)[j] - mean) * (x.ptr<float>(i)[j] - mean);
+        variance /= normSize;
+        for (int k = i; k < i + groupSize; k++)
+        {
+            const int c = k % C;
+            for (int j = 0; j < planeSize; j++)
+            {
+                double v = (x.at<float>(k, j) - mean) / std::sqrt(variance + 1e-5) * scale.at<float>(c) + bias.at<float>(c);
+                v = v < 0 ? v * slope.at<float>(c) : v;
+                ref.at<float>(k, j) = (float)std::tanh(v);
+            }
+        }
+    }
+    net.setInput(input);
+    Mat out = net.forward();
+    normAssert(ref, out.reshape(1, N * C), "", 1e-4, 1e-3);
+}
+
+TEST(GroupNormActivationFusion, Accuracy)
+{
+    testNormChannelsActivationFusion(3);
+}
+
+TEST(InstanceNormActivationFusion, Accuracy)
+{
+    testNormChannelsActivationFusion(0);
+}
+
 }} // namespace
@@ -10,6 +10,8 @@
 #include <opencv2/core/ocl.hpp>
 #include <opencv2/core/opencl/ocl_defs.hpp>
 #include <opencv2/dnn/layer.details.hpp>  // CV_DNN_REGISTER_LAYER_CLASS
+#include <atomic>
+#include <thread>
 
 namespace opencv_test { namespace {
 
@@ -242,6 +244,78 @@ TEST(blobFromImagesWithParams_4ch, multi_image)
     EXPECT_EQ(0, cvtest::norm(2 * blob0, blob1, NORM_INF));
 }
 
+TEST(blobFromImagesWithParams, fused_preprocessing)
+{
+    std::vector<Mat> images(3);
+    for (int i = 0; i < (int)images.size(); i++)
+    {
+        images[i].create(37 + i * 11, 53, CV_8UC3);
+        randu(images[i], 0, 256);
+    }
+    Size size(40, 32);
+    Scalar mean(10, 50, 140), scalefactor(1 / 58., 1 / 57., 1 / 56.), borderValue(1, 2, 3);
+
+    for (int mode = DNN_PMODE_NULL; mode <= DNN_PMODE_LETTERBOX; mode++)
+    for (int layout : {DNN_LAYOUT_NCHW, DNN_LAYOUT_NHWC})
+    for (int swapRB = 0; swapRB < 2; swapRB++)
+    for (int ddepth : {CV_32F, CV_16F})
+    {
+        Image2BlobParams param(scalefactor, size, mean, swapRB != 0, ddepth, (DataLayout)layout,
+                               (ImagePaddingMode)mode, borderValue);
+        Mat blob = blobFromImagesWithParams(images, param);
+        ASSERT_EQ(ddepth, blob.depth());
+
+        // reference: separate passes
+        int sz_nchw[] = {(int)images.size(), 3, size.height, size.width};
+        int sz_nhwc[] = {(int)images.size(), size.height, size.width, 3};
+        Mat ref(4, layout == DNN_LAYOUT_NCHW ? sz_nchw : sz_nhwc, CV_32F);
+        for (int i = 0; i < (int)images.size(); i++)
+        {
+            Mat img;
+            Size imgSize = images[i].size();
+            if (mode == DNN_PMODE_CROP_CENTER)
+            {
+                float factor = std::max(size.width / (float)imgSize.width, size.height / (float)imgSize.height);
+                cv::resize(images[i], img, Size(), factor, factor, INTER_LINEAR);
+                img = img(Rect(Point(0.5 * (img.cols - size.width), 0.5 * (img.rows - size.height)), size));
+            }
+            else if (mode == DNN_PMODE_LETTERBOX)
+            {
+                float factor = std::min(size.width / (float)imgSize.width, size.height / (float)imgSize.height);
+                int rh = int(imgSize.height * factor), rw = int(imgSize.width * factor);
+                cv::resize(images[i], img, Size(rw, rh), 0, 0, INTER_LINEAR);
+                int top = (size.height - rh) / 2, left = (size.width - rw) / 2;
+                cv::copyMakeBorder(img, img, top, size.height - rh - top, left, size.width - rw - left,
+                               BORDER_CONSTANT, borderValue);
+            }
+            else
+                cv::resize(images[i], img, size, 0, 0, INTER_LINEAR);
+
+            img.convertTo(img, CV_32F);
+            if (swapRB)
+                cv::cvtColor(img, img, COLOR_BGR2RGB);
+            std::vector<Mat> ch;
+            cv::split(img, ch);
+            for (int c = 0; c < 3; c++)
+            {
+                cv::subtract(ch[c], mean[c], ch[c]);
+                cv::multiply(ch[c], scalefactor[c], ch[c]);
+                if (layout == DNN_LAYOUT_NCHW)
+                    ch[c].copyTo(Mat(size, CV_32F, ref.ptr(i, c)));
+            }
+            if (layout == DNN_LAYOUT_NHWC)
+            {
+                cv::merge(ch, img);
+                img.copyTo(Mat(size, CV_32FC3, ref.ptr(i)));
+            }
+        }
+
+        blob.convertTo(blob, CV_32F);
+        EXPECT_LE(cvtest::norm(ref, blob, NORM_INF), ddepth == CV_16F ? 5e-3 : 1e-5)
+            << "mode=" << mode << " layout=" << layout << " swapRB=" << swapRB << " ddepth=" << ddepth;
+    }
+}
+
 TEST(readNet, Regression)
 {
     Net net = readNet(findDataFile("dnn/squeezenet_v1.1.prototxt"),
@@ -615,6 +689,638 @@ TEST(Net, forwardAndRetrieve)
     normAssert(outBlobs[0][1], inp.rowRange(2, 4), "second part");
 }
 
+TEST(Net, memory_planner)
+{
+    const int numChannels = 4;
+    Net net;
+    for (int i = 0; i < 4; ++i)
+    {
+        // 1x1 convolution which doubles the input
+        Mat weights = Mat::eye(numChannels, numChannels, CV_32F) * 2;
+        LayerParams lp;
+        lp.type = "Convolution";
+        lp.name = format("conv%d", i);
+        lp.set("kernel_size", 1);
+        lp.set("num_output", numChannels);
+        lp.set("bias_term", false);
+        lp.blobs.push_back(weights.reshape(1, std::vector<int>{numChannels, numChannels, 1, 1}));
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    EXPECT_EQ(0, net.getMemoryArenaSize());
+
+    for (int size = 8; size <= 16; size *= 2)
+    {
+        Mat inp(std::vector<int>{1, numChannels, size, size}, CV_32F);
+        randu(inp, -1, 1);
+        net.setInput(inp);
+        Mat out = net.forward();
+        normAssert(out, inp * 16, "", 1e-6, 1e-5);
+
+        // conv0 and conv2 outputs are never alive at the same time, same for conv1 and conv3 (network output)
+        const int64 blobSize = inp.total() * inp.elemSize();
+        int64 arenaSize = net.getMemoryArenaSize();
+        if (arenaSize == 0)
+            throw SkipTestException("Memory planner is disabled");
+        EXPECT_EQ(2 * blobSize, arenaSize);
+    }
+}
+
+TEST(Net, input_shapes_switch)
+{
+    const int numChannels = 3;
+    Net net;
+    for (int i = 0; i < 2; ++i)
+    {
+        // 1x1 convolution which doubles the input
+        Mat weights = Mat::eye(numChannels, numChannels, CV_32F) * 2;
+        LayerParams lp;
+        lp.type = "Convolution";
+        lp.name = format("conv%d", i);
+        lp.set("kernel_size", 1);
+        lp.set("num_output", numChannels);
+        lp.set("bias_term", false);
+        lp.blobs.push_back(weights.reshape(1, std::vector<int>{numChannels, numChannels, 1, 1}));
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams reluParams;
+        reluParams.type = "ReLU";
+        reluParams.name = format("relu%d", i);
+        net.addLayerToPrev(reluParams.name, reluParams.type, reluParams);
+    }
+    LayerParams poolParams;
+    poolParams.type = "Pooling";
+    poolParams.name = "pool";
+    poolParams.set("pool", "max");
+    poolParams.set("kernel_size", 2);
+    poolParams.set("stride", 2);
+    net.addLayerToPrev(poolParams.name, poolParams.type, poolParams);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    // Shapes of every input are computed once, memory is allocated for the biggest one
+    const int sizes[] = {16, 8, 16, 12, 8};
+    for (int i = 0; i < 5; ++i)
+    {
+        Mat inp(std::vector<int>{1, numChannels, sizes[i], sizes[i]}, CV_32F);
+        randu(inp, -1, 1);
+        net.setInput(inp);
+        Mat out = net.forward();
+
+        Mat ref;
+        max(inp * 4, 0, ref);
+        Mat refPool(std::vector<int>{1, numChannels, sizes[i] / 2, sizes[i] / 2}, CV_32F);
+        // rows of all the channels one after another
+        Mat src = ref.reshape(1, numChannels * sizes[i]);
+        Mat dst = refPool.reshape(1, numChannels * sizes[i] / 2);
+        for (int y = 0; y < dst.rows; ++y)
+            for (int x = 0; x < dst.cols; ++x)
+            {
+                float v = std::max(src.at<float>(2 * y, 2 * x), src.at<float>(2 * y, 2 * x + 1));
+                v = std::max(v, src.at<float>(2 * y + 1, 2 * x));
+                dst.at<float>(y, x) = std::max(v, src.at<float>(2 * y + 1, 2 * x + 1));
+            }
+        normAssert(out, refPool, format("size=%d", sizes[i]).c_str(), 1e-6, 1e-5);
+    }
+}
+
+class FinalizeCounterLayer CV_FINAL : public Layer
+{
+public:
+    FinalizeCounterLayer(const LayerParams &params) : Layer(params) {}
+
+    static Ptr<Layer> create(LayerParams& params)
+    {
+        return Ptr<Layer>(new FinalizeCounterLayer(params));
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs, const int,
+                         std::vector<MatShape> &outputs, std::vector<MatShape> &) const CV_OVERRIDE
+    {
+        outputs.assign(1, inputs[0]);
+        return false;
+    }
+
+    void finalize(InputArrayOfArrays, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        ++numFinalized;
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+        inputs[0].copyTo(outputs[0]);
+    }
+
+    static int numFinalized;
+};
+int FinalizeCounterLayer::numFinalized = 0;
+
+TEST(Net, input_shapes_bucket)
+{
+    // Layers after global pooling have the same shapes for all the inputs
+    CV_DNN_REGISTER_LAYER_CLASS(FinalizeCounter, FinalizeCounterLayer);
+    try
+    {
+        Net net;
+        LayerParams convParams;
+        convParams.set("kernel_size", 1);
+        convParams.set("num_output", 3);
+        convParams.set("bias_term", false);
+        convParams.blobs.push_back(Mat(Mat::eye(3, 3, CV_32F)).reshape(1, std::vector<int>{3, 3, 1, 1}));
+        net.addLayerToPrev("conv", "Convolution", convParams);
+        LayerParams poolParams;
+        poolParams.set("pool", "ave");
+        poolParams.set("global_pooling", true);
+        net.addLayerToPrev("pool", "Pooling", poolParams);
+        LayerParams counterParams;
+        net.addLayerToPrev("counter", "FinalizeCounter", counterParams);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(DNN_TARGET_CPU);
+
+        // Once the input size is changed, inputs from 33x33 to 36x36 are in the same bucket. The blobs
+        // are kept at the same place, so the counter with unchanged shapes is not finalized again
+        FinalizeCounterLayer::numFinalized = 0;
+        const int sizes[] = {33, 35, 34, 36, 33};
+        for (int i = 0; i < 5; ++i)
+        {
+            Mat inp(std::vector<int>{1, 3, sizes[i], sizes[i]}, CV_32F);
+            randu(inp, -1, 1);
+            net.setInput(inp);
+            Mat out = net.forward();
+
+            Mat ref(std::vector<int>{1, 3, 1, 1}, CV_32F);
+            for (int c = 0; c < 3; ++c)
+                ref.ptr<float>()[c] = (float)mean(inp.reshape(1, 3).row(c))[0];
+            normAssert(out, ref, format("size=%d", sizes[i]).c_str(), 1e-6, 1e-5);
+        }
+        EXPECT_EQ(2, FinalizeCounterLayer::numFinalized);
+    }
+    catch (...)
+    {
+        LayerFactory::unregisterLayer("FinalizeCounter");
+        throw;
+    }
+    LayerFactory::unregisterLayer("FinalizeCounter");
+}
+
+TEST(Net, execution_contexts)
+{
+    const int numChannels = 3;
+    Net net;
+    for (int i = 0; i < 3; ++i)
+    {
+        LayerParams lp;
+        lp.type = "Convolution";
+        lp.name = format("conv%d", i);
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", numChannels);
+        lp.set("bias_term", false);
+        Mat weights(std::vector<int>{numChannels, numChannels, 3, 3}, CV_32F);
+        randu(weights, -1, 1);
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams reluParams;
+        reluParams.type = "ReLU";
+        reluParams.name = format("relu%d", i);
+        net.addLayerToPrev(reluParams.name, reluParams.type, reluParams);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numContexts = 3;
+    std::vector<Mat> inputs(numContexts), refs(numContexts);
+    for (int i = 0; i < numContexts; ++i)
+    {
+        inputs[i].create(std::vector<int>{1, numChannels, 10, 10}, CV_32F);
+        randu(inputs[i], -1, 1);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    std::vector<Net> contexts(numContexts);
+    for (int i = 0; i < numContexts; ++i)
+    {
+        contexts[i] = net.createExecutionContext();
+        // weights are shared
+        EXPECT_EQ(net.getLayer("conv1").get(), contexts[i].getLayer("conv1").get());
+    }
+
+    std::vector<Mat> outs(numContexts);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numContexts; ++i)
+    {
+        threads.push_back(std::thread([&, i]() {
+            for (int iter = 0; iter < 10; ++iter)
+            {
+                contexts[i].setInput(inputs[i]);
+                outs[i] = contexts[i].forward().clone();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    for (int i = 0; i < numContexts; ++i)
+        normAssert(outs[i], refs[i], format("context %d", i).c_str());
+
+    // contexts can't be reallocated
+    contexts[0].setInput(Mat(std::vector<int>{1, numChannels, 12, 12}, CV_32F, Scalar(0)));
+    EXPECT_ANY_THROW(contexts[0].forward());
+}
+
+TEST(Net, forwardAsync_cpu)
+{
+    const int numChannels = 3;
+    Net net;
+    for (int i = 0; i < 2; ++i)
+    {
+        LayerParams lp;
+        lp.type = "Convolution";
+        lp.name = format("conv%d", i);
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", numChannels);
+        lp.set("bias_term", false);
+        Mat weights(std::vector<int>{numChannels, numChannels, 3, 3}, CV_32F);
+        randu(weights, -1, 1);
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams reluParams;
+        reluParams.type = "ReLU";
+        reluParams.name = format("relu%d", i);
+        net.addLayerToPrev(reluParams.name, reluParams.type, reluParams);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int sizes[] = {10, 10, 10, 12};
+    const int numInputs = sizeof(sizes) / sizeof(sizes[0]);
+    std::vector<Mat> inputs(numInputs), refs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        inputs[i].create(std::vector<int>{1, numChannels, sizes[i], sizes[i]}, CV_32F);
+        randu(inputs[i], -1, 1);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    // Several requests in flight, inputs are set right after the previous request is queued.
+    // The last one changes input shape, so the network is reallocated.
+    std::vector<AsyncArray> outs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        net.setInput(inputs[i]);
+        outs[i] = net.forwardAsync();
+        ASSERT_TRUE(outs[i].valid());
+    }
+    for (int i = 0; i < numInputs; ++i)
+    {
+        Mat result;
+        outs[i].get(result);
+        normAssert(result, refs[i], format("Index: %d", i).c_str());
+    }
+
+    // Intermediate output
+    net.setInput(inputs[0]);
+    Mat ref = net.forward("relu0").clone();
+    Mat result;
+    net.forwardAsync("relu0").get(result);
+    normAssert(result, ref, "relu0");
+
+    // Synchronous forward while a request is pending
+    net.setInput(inputs[1]);
+    AsyncArray pending = net.forwardAsync();
+    net.setInput(inputs[0]);
+    Mat out = net.forward();
+    normAssert(out, refs[0], "sync");
+    pending.get(result);
+    normAssert(result, refs[1], "async");
+}
+
+// Copies the input and tracks how many such layers run at the same time. Every layer
+// waits for another one to start for a while, so layers of concurrent branches overlap.
+class ConcurrencyProbeLayer CV_FINAL : public Layer
+{
+public:
+    ConcurrencyProbeLayer(const LayerParams &params) : Layer(params) {}
+
+    static Ptr<Layer> create(LayerParams& params)
+    {
+        return Ptr<Layer>(new ConcurrencyProbeLayer(params));
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs, const int,
+                         std::vector<MatShape> &outputs, std::vector<MatShape> &) const CV_OVERRIDE
+    {
+        outputs.assign(1, inputs[0]);
+        return false;
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const int active = ++numActive;
+        int maxValue = maxActive;
+        while (active > maxValue && !maxActive.compare_exchange_weak(maxValue, active)) {}
+        for (int i = 0; i < 1000 && maxActive < 2; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        inputs[0].copyTo(outputs[0]);
+        --numActive;
+    }
+
+    static std::atomic<int> numActive, maxActive;
+};
+std::atomic<int> ConcurrencyProbeLayer::numActive(0), ConcurrencyProbeLayer::maxActive(0);
+
+TEST(Net, parallel_branches)
+{
+    //             input
+    //        /      |      \
+    //    branch0 branch1 branch2  (conv 3x3, relu, conv 3x3)
+    //        \      |      /
+    //             concat
+    //          /         \
+    //       conv_a      conv_b
+    //          \         /
+    //             add
+    const int numChannels = 4;
+    const int numBranches = 3;
+    std::vector<Mat> weights;
+    for (int i = 0; i < 2 * numBranches + 2; ++i)
+    {
+        const int ksize = i < 2 * numBranches ? 3 : 1;
+        const int inpChannels = i < 2 * numBranches ? numChannels : numChannels * numBranches;
+        weights.push_back(Mat(std::vector<int>{numChannels, inpChannels, ksize, ksize}, CV_32F));
+        randu(weights.back(), -1, 1);
+    }
+
+    auto addConv = [&](Net& net, const String& name, int weightsId, int inpId) -> int
+    {
+        LayerParams lp;
+        lp.set("kernel_size", weights[weightsId].size[2]);
+        lp.set("pad", weights[weightsId].size[2] / 2);
+        lp.set("num_output", numChannels);
+        lp.set("bias_term", false);
+        lp.blobs.push_back(weights[weightsId]);
+        int id = net.addLayer(name, "Convolution", lp);
+        net.connect(inpId, 0, id, 0);
+        return id;
+    };
+
+    auto createNet = [&]() -> Net
+    {
+        Net net;
+        std::vector<int> branchIds;
+        for (int i = 0; i < numBranches; ++i)
+        {
+            int id = addConv(net, format("conv%d_0", i), 2 * i, 0);
+            LayerParams reluParams;
+            int reluId = net.addLayer(format("relu%d", i), "ReLU", reluParams);
+            net.connect(id, 0, reluId, 0);
+            branchIds.push_back(addConv(net, format("conv%d_1", i), 2 * i + 1, reluId));
+        }
+        LayerParams concatParams;
+        concatParams.set("axis", 1);
+        int concatId = net.addLayer("concat", "Concat", concatParams);
+        for (int i = 0; i < numBranches; ++i)
+            net.connect(branchIds[i], 0, concatId, i);
+        int convA = addConv(net, "conv_a", 2 * numBranches, concatId);
+        int convB = addConv(net, "conv_b", 2 * numBranches + 1, concatId);
+        LayerParams addParams;
+        addParams.set("operation", "sum");
+        int addId = net.addLayer("add", "Eltwise", addParams);
+        net.connect(convA, 0, addId, 0);
+        net.connect(convB, 0, addId, 1);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(DNN_TARGET_CPU);
+        return net;
+    };
+
+    Mat inp(std::vector<int>{1, numChannels, 10, 10}, CV_32F);
+    randu(inp, -1, 1);
+
+    Net refNet = createNet();
+    refNet.enableParallelBranches(false);
+    refNet.setInput(inp);
+    Mat ref = refNet.forward();
+
+    const int numThreads = getNumThreads();
+    setNumThreads(4);
+    try
+    {
+        Net net = createNet();
+        net.enableParallelBranches(true);
+        for (int iter = 0; iter < 3; ++iter)
+        {
+            net.setInput(inp);
+            Mat out = net.forward();
+            normAssert(out, ref, format("iter %d", iter).c_str());
+
+            std::vector<Mat> outs;
+            net.forward(outs, std::vector<String>{"conv1_1", "add"});
+            ASSERT_EQ(2u, outs.size());
+            normAssert(outs[1], ref, format("iter %d", iter).c_str());
+        }
+
+        // input -> probe0, probe1 -> add: both probes must run at the same time
+        CV_DNN_REGISTER_LAYER_CLASS(ConcurrencyProbe, ConcurrencyProbeLayer);
+        Net probeNet;
+        LayerParams probeParams;
+        int probe0 = probeNet.addLayer("probe0", "ConcurrencyProbe", probeParams);
+        int probe1 = probeNet.addLayer("probe1", "ConcurrencyProbe", probeParams);
+        probeNet.connect(0, 0, probe0, 0);
+        probeNet.connect(0, 0, probe1, 0);
+        LayerParams addParams;
+        addParams.set("operation", "sum");
+        int addId = probeNet.addLayer("add", "Eltwise", addParams);
+        probeNet.connect(probe0, 0, addId, 0);
+        probeNet.connect(probe1, 0, addId, 1);
+        probeNet.setPreferableBackend(DNN_BACKEND_OPENCV);
+        probeNet.enableParallelBranches(true);
+        ConcurrencyProbeLayer::maxActive = 0;
+        probeNet.setInput(inp);
+        Mat out = probeNet.forward();
+        LayerFactory::unregisterLayer("ConcurrencyProbe");
+        normAssert(out, inp * 2, "probes");
+        EXPECT_EQ(2, ConcurrencyProbeLayer::maxActive.load());
+
+        // Profile has real start times and threads of the probes
+        std::vector<LayerProfile> profile;
+        probeNet.getLayersProfile(profile);
+        ASSERT_EQ(3u, profile.size());
+        EXPECT_NE(profile[0].thread, profile[1].thread);
+        EXPECT_LT(profile[0].start, profile[1].start + profile[1].time);
+        EXPECT_LT(profile[1].start, profile[0].start + profile[0].time);
+    }
+    catch (...)
+    {
+        LayerFactory::unregisterLayer("ConcurrencyProbe");
+        setNumThreads(numThreads);
+        throw;
+    }
+    setNumThreads(numThreads);
+}
+
+TEST(Net, cache)
+{
+    Net net;
+    net.setInputsNames(std::vector<String>{"data"});
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("num_output", 4);
+        lp.set("bias_term", true);
+        Mat weights(std::vector<int>{4, 3, 3, 3}, CV_32F), bias(1, 4, CV_32F);
+        randu(weights, -1, 1);
+        randu(bias, -1, 1);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        int id = net.addLayer("conv", "Convolution", lp);
+        net.connect(0, 0, id, 0);
+    }
+    {
+        LayerParams lp;
+        lp.set("pool", "ave");
+        lp.set("kernel_size", 2);
+        lp.set("stride", 2);
+        net.addLayerToPrev("pool", "Pooling", lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("negative_slope", 0.1);
+        net.addLayerToPrev("relu", "ReLU", lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("num_output", 5);
+        Mat weights(5, 4 * 4 * 4, CV_32F), bias(1, 5, CV_32F);
+        randu(weights, -1, 1);
+        randu(bias, -1, 1);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev("fc", "InnerProduct", lp);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    Mat input(std::vector<int>{2, 3, 10, 10}, CV_32F);
+    randu(input, -1, 1);
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+
+    const std::string path = cv::tempfile(".bin");
+    net.writeCache(path);
+    {
+        Net cached = readNetFromCache(path);
+        ASSERT_FALSE(cached.empty());
+        EXPECT_EQ(net.getLayerNames(), cached.getLayerNames());
+        EXPECT_EQ(net.getLayer("pool")->type, cached.getLayer("pool")->type);
+
+        cached.setPreferableBackend(DNN_BACKEND_OPENCV);
+        cached.setInput(input, "data");
+        normAssert(cached.forward(), ref, "", 0, 0);
+    }
+    remove(path.c_str());
+
+    // not a cache file
+    {
+        std::ofstream ofs(path.c_str(), std::ios::out | std::ios::binary);
+        ofs << "not a network cache, but long enough";
+    }
+    EXPECT_ANY_THROW(readNetFromCache(path));
+    remove(path.c_str());
+}
+
+TEST(Net, layers_profile)
+{
+    Net net;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("stride", 2);
+        lp.set("num_output", 4);
+        lp.set("bias_term", false);
+        Mat weights(std::vector<int>{4, 3, 3, 3}, CV_32F);
+        randu(weights, -1, 1);
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev("conv", "Convolution", lp);
+    }
+    {
+        LayerParams lp;
+        net.addLayerToPrev("relu", "ReLU", lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("num_output", 5);
+        lp.set("bias_term", false);
+        Mat weights(5, 4 * 7 * 7, CV_32F);
+        randu(weights, -1, 1);
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev("fc", "InnerProduct", lp);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    Mat input(std::vector<int>{1, 3, 16, 16}, CV_32F);
+    randu(input, -1, 1);
+    net.setInput(input);
+    net.forward();
+
+    std::vector<LayerProfile> profile;
+    net.getLayersProfile(profile);
+    ASSERT_EQ(3u, profile.size());
+
+    EXPECT_EQ("conv", profile[0].name);
+    EXPECT_EQ("im2row", profile[0].kernel);
+    EXPECT_EQ(4 * 7 * 7 * (2 * 3 * 3 * 3 + 1), profile[0].flops);
+    EXPECT_GE(profile[0].bytes, (int64)sizeof(float) * (3 * 16 * 16 + 4 * 7 * 7 + 4 * 3 * 3 * 3));
+    EXPECT_GT(profile[0].time, 0);
+    EXPECT_GT(profile[0].gflops, 0);
+
+    EXPECT_EQ("relu", profile[1].name);
+    EXPECT_EQ("fused", profile[1].kernel);
+    EXPECT_EQ(0, profile[1].gflops);
+
+    EXPECT_EQ("fc", profile[2].name);
+    EXPECT_EQ("fastGEMM1T", profile[2].kernel);
+    EXPECT_GT(profile[2].flops, 0);
+
+    // Layers are run one after another by the calling thread
+    for (size_t i = 0; i < profile.size(); i++)
+    {
+        EXPECT_EQ(cv::utils::getThreadID(), profile[i].thread);
+        EXPECT_GE(profile[i].start, 0);
+    }
+    EXPECT_GE(profile[2].start, profile[0].start + profile[0].time);
+
+    std::vector<double> timings;
+    net.getPerfProfile(timings);
+    ASSERT_EQ(timings.size(), profile.size());
+    for (size_t i = 0; i < profile.size(); i++)
+        EXPECT_NEAR(timings[i] * 1000.0 / getTickFrequency(), profile[i].time, 1e-6);
+
+    const std::string path = cv::tempfile(".json");
+    net.writeProfile(path);
+    {
+        std::ifstream ifs(path.c_str());
+        std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        EXPECT_NE(std::string::npos, json.find("\"traceEvents\""));
+        EXPECT_NE(std::string::npos, json.find("\"name\": \"conv\", \"cat\": \"Convolution\", \"ph\": \"X\""));
+        EXPECT_NE(std::string::npos, json.find("\"kernel\": \"fastGEMM1T\""));
+        EXPECT_NE(std::string::npos, json.find(cv::format("\"ph\": \"M\", \"pid\": 0, \"tid\": %d", cv::utils::getThreadID())));
+    }
+    remove(path.c_str());
+}
+
 #ifdef HAVE_INF_ENGINE
 static const std::chrono::milliseconds async_timeout(10000);
 
@@ -1035,10 +1741,12 @@ TEST_P(Test_two_inputs, basic)
     randu(firstInp, 0, 100);
     randu(secondInp, 0, 100);
 
+    EXPECT_TRUE(net.getInputsNames().empty());
     std::vector<String> input_names;
     input_names.push_back("data");
     input_names.push_back("second_input");
     net.setInputsNames(input_names);
+    EXPECT_EQ(input_names, net.getInputsNames());
     net.setInput(firstInp, "data", kScale);
     net.setInput(secondInp, "second_input", kScaleInv);
     net.setPreferableBackend(backendId);
@@ -5,6 +5,7 @@
 #include "test_precomp.hpp"
 #include <opencv2/dnn/shape_utils.hpp>
 #include "npy_blob.hpp"
+#include <thread>
 namespace opencv_test { namespace {
 
 template<typename TString>
@@ -835,4 +836,59 @@ TEST_P(Test_Model, TextDetectionByEAST)
 
 INSTANTIATE_TEST_CASE_P(/**/, Test_Model, dnnBackendsAndTargets());
 
+TEST(Test_Model_Batching, classify)
+{
+    const int numClasses = 10, inpSize = 8;
+
+    // Convolution with kernel of input size is a fully connected layer
+    LayerParams lp;
+    lp.type = "Convolution";
+    lp.name = "fc";
+    lp.set("kernel_size", inpSize);
+    lp.set("num_output", numClasses);
+    lp.set("bias_term", false);
+    Mat weights(std::vector<int>{numClasses, 3, inpSize, inpSize}, CV_32F);
+    randu(weights, -1, 1);
+    lp.blobs.push_back(weights);
+
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numThreads = 4, numIters = 5;
+    std::vector<Mat> frames(numThreads * numIters);
+    std::vector<std::pair<int, float> > refs(frames.size());
+    ClassificationModel refModel(net);
+    refModel.setInputParams(1.0 / 255, Size(inpSize, inpSize));
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        frames[i].create(inpSize, inpSize, CV_8UC3);
+        randu(frames[i], 0, 255);
+        refs[i] = refModel.classify(frames[i]);
+    }
+
+    ClassificationModel model(net);
+    model.setInputParams(1.0 / 255, Size(inpSize, inpSize));
+    model.enableBatching(numThreads, 100);
+
+    std::vector<std::pair<int, float> > results(frames.size());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.push_back(std::thread([&, t]() {
+            for (int i = 0; i < numIters; i++)
+                results[t * numIters + i] = model.classify(frames[t * numIters + i]);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        EXPECT_EQ(refs[i].first, results[i].first) << i;
+        EXPECT_NEAR(refs[i].second, results[i].second, 1e-4) << i;
+    }
+}
+
 }} // namespace
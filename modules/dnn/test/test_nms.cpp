@@ -104,4 +104,92 @@ TEST(SoftNMS, Accuracy)
     }
 }
 
+// Greedy NMS by definition: candidates in order of scores, every one is compared with all the kept boxes
+template <typename Rect_t>
+static std::vector<int> referenceNMS(const std::vector<Rect_t>& bboxes, const std::vector<float>& scores,
+                                     const std::vector<int>& class_ids, float score_threshold,
+                                     float nms_threshold, float eta, int top_k)
+{
+    std::vector<std::pair<float, int> > candidates;
+    for (size_t i = 0; i < scores.size(); i++)
+    {
+        if (scores[i] > score_threshold)
+            candidates.push_back(std::make_pair(scores[i], (int)i));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; });
+    if (top_k > 0 && top_k < (int)candidates.size())
+        candidates.resize(top_k);
+
+    std::vector<int> indices;
+    float threshold = nms_threshold;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        const int idx = candidates[i].second;
+        bool keep = true;
+        for (size_t k = 0; k < indices.size() && keep; k++)
+        {
+            if (class_ids[idx] == class_ids[indices[k]])
+                keep = 1.f - (float)jaccardDistance(bboxes[idx], bboxes[indices[k]]) <= threshold;
+        }
+        if (keep)
+        {
+            indices.push_back(idx);
+            if (eta < 1 && threshold > 0.5)
+                threshold *= eta;
+        }
+    }
+    return indices;
+}
+
+TEST(NMS, random_boxes)
+{
+    RNG& rng = theRNG();
+    const int numBoxes = 3000, numClasses = 5;
+    std::vector<Rect> boxes(numBoxes);
+    std::vector<Rect2d> boxes2d(numBoxes), boxes2dFar(numBoxes);
+    std::vector<float> scores(numBoxes);
+    std::vector<int> classIds(numBoxes), sameClass(numBoxes, 0);
+    for (int i = 0; i < numBoxes; i++)
+    {
+        // Many overlapping boxes, some of them are the same and some are empty
+        boxes[i] = Rect(rng.uniform(0, 600), rng.uniform(0, 600), rng.uniform(0, 100), rng.uniform(0, 100));
+        if (i % 50 == 1)
+            boxes[i] = boxes[i - 1];
+        boxes2d[i] = Rect2d(boxes[i].x * 0.01, boxes[i].y * 0.01, boxes[i].width * 0.01, boxes[i].height * 0.01);
+        // Small boxes far from the origin, float rounding of their corners is comparable with overlaps
+        boxes2dFar[i] = Rect2d(1e6 + rng.uniform(0., 60.), 1e6 + rng.uniform(0., 60.), rng.uniform(1., 10.), rng.uniform(1., 10.));
+        scores[i] = (float)rng.uniform(0, 100) * 0.01f;
+        classIds[i] = rng.uniform(0, numClasses);
+    }
+
+    const float etas[] = {1.f, 0.9f};
+    const int topKs[] = {0, 500};
+    for (int e = 0; e < 2; e++)
+    {
+        for (int t = 0; t < 2; t++)
+        {
+            const std::string params = format("eta=%g top_k=%d", etas[e], topKs[t]);
+            std::vector<int> indices;
+            NMSBoxes(boxes, scores, 0.1f, 0.5f, indices, etas[e], topKs[t]);
+            EXPECT_EQ(referenceNMS(boxes, scores, sameClass, 0.1f, 0.5f, etas[e], topKs[t]), indices) << params;
+
+            NMSBoxes(boxes2d, scores, 0.1f, 0.5f, indices, etas[e], topKs[t]);
+            EXPECT_EQ(referenceNMS(boxes2d, scores, sameClass, 0.1f, 0.5f, etas[e], topKs[t]), indices) << params;
+
+            NMSBoxes(boxes2dFar, scores, 0.1f, 0.5f, indices, etas[e], topKs[t]);
+            EXPECT_EQ(referenceNMS(boxes2dFar, scores, sameClass, 0.1f, 0.5f, etas[e], topKs[t]), indices) << params;
+
+            if (etas[e] == 1.f)  // adaptive threshold is shared by all the classes otherwise
+            {
+                NMSBoxesBatched(boxes, scores, classIds, 0.1f, 0.5f, indices, etas[e], topKs[t]);
+                EXPECT_EQ(referenceNMS(boxes, scores, classIds, 0.1f, 0.5f, etas[e], topKs[t]), indices) << params;
+
+                NMSBoxesBatched(boxes2dFar, scores, classIds, 0.1f, 0.5f, indices, etas[e], topKs[t]);
+                EXPECT_EQ(referenceNMS(boxes2dFar, scores, classIds, 0.1f, 0.5f, etas[e], topKs[t]), indices) << params;
+            }
+        }
+    }
+}
+
 }} // namespace
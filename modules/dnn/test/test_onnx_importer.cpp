@@ -3235,4 +3235,107 @@ TEST_P(Test_ONNX_layers, TopK) {
 
 INSTANTIATE_TEST_CASE_P(/**/, Test_ONNX_nets, dnnBackendsAndTargets());
 
+// Minimal writer of protobuf wire format to create ONNX models in tests
+struct ProtoWriter
+{
+    std::string buf;
+
+    ProtoWriter& varint(int field, uint64_t value) { key(field, 0); writeVarint(value); return *this; }
+    ProtoWriter& bytes(int field, const std::string& value) { key(field, 2); writeVarint(value.size()); buf += value; return *this; }
+    ProtoWriter& message(int field, const ProtoWriter& value) { return bytes(field, value.buf); }
+
+private:
+    void key(int field, int wireType) { writeVarint(((uint64_t)field << 3) | wireType); }
+    void writeVarint(uint64_t value)
+    {
+        for (; value >= 0x80; value >>= 7)
+            buf += (char)((value & 0x7F) | 0x80);
+        buf += (char)value;
+    }
+};
+
+// y = x + w, where x: [1, 4] and w: [1, 4] is an initializer with external data
+static void writeExternalDataModel(const std::string& modelPath, const std::string& location, int offset)
+{
+    ProtoWriter shape;
+    shape.message(1, ProtoWriter().varint(1, 1)).message(1, ProtoWriter().varint(1, 4));
+    ProtoWriter type;
+    type.message(1, ProtoWriter().varint(1, 1 /*FLOAT*/).message(2, shape));
+
+    ProtoWriter initializer;
+    initializer.varint(1, 1).varint(1, 4).varint(2, 1 /*FLOAT*/).bytes(8, "w")
+               .message(13, ProtoWriter().bytes(1, "location").bytes(2, location))
+               .message(13, ProtoWriter().bytes(1, "offset").bytes(2, std::to_string(offset)))
+               .message(13, ProtoWriter().bytes(1, "length").bytes(2, "16"))
+               .varint(14, 1 /*EXTERNAL*/);
+    ProtoWriter node;
+    node.bytes(1, "x").bytes(1, "w").bytes(2, "y").bytes(3, "add").bytes(4, "Add");
+    ProtoWriter graph;
+    graph.message(1, node).bytes(2, "graph").message(5, initializer)
+         .message(11, ProtoWriter().bytes(1, "x").message(2, type))
+         .message(12, ProtoWriter().bytes(1, "y").message(2, type));
+    ProtoWriter model;
+    model.varint(1, 7).message(7, graph).message(8, ProtoWriter().varint(2, 13));
+
+    std::ofstream ofs(modelPath.c_str(), std::ios::out | std::ios::binary);
+    ofs << model.buf;
+}
+
+TEST(Test_ONNX_importer, external_data)
+{
+    const std::string weightsPath = cv::tempfile(".bin");
+    const std::string modelPath = cv::tempfile(".onnx");
+    const std::string location = weightsPath.substr(weightsPath.find_last_of("/\\") + 1);
+
+    // Weights are placed at non page aligned offset
+    const int offset = 64;
+    Mat weights(1, 4, CV_32F);
+    randu(weights, -1, 1);
+    {
+        std::ofstream ofs(weightsPath.c_str(), std::ios::out | std::ios::binary);
+        ofs << std::string(offset, '\0');
+        ofs.write(weights.ptr<char>(), weights.total() * weights.elemSize());
+    }
+    writeExternalDataModel(modelPath, location, offset);
+
+    {
+        Net net = readNetFromONNX(modelPath);
+        ASSERT_FALSE(net.empty());
+
+        // Weights refer to the mapped file: their memory is not allocated by OpenCV
+        int numMapped = 0;
+        std::vector<String> names = net.getLayerNames();
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            const std::vector<Mat>& blobs = net.getLayer(names[i])->blobs;
+            for (size_t j = 0; j < blobs.size(); j++)
+            {
+                if (blobs[j].u && blobs[j].u->currAllocator != Mat::getStdAllocator() &&
+                    blobs[j].u->currAllocator != Mat::getDefaultAllocator() &&
+                    blobs[j].total() == weights.total() && cv::norm(blobs[j].reshape(1, 1), weights, NORM_INF) == 0)
+                    numMapped++;
+            }
+        }
+        EXPECT_EQ(1, numMapped);
+
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat input(1, 4, CV_32F);
+        randu(input, -1, 1);
+        net.setInput(input);
+        Mat out = net.forward();
+        normAssert(out.reshape(1, 1), input + weights);
+    }
+
+    // Locations outside of the model directory are rejected
+    const std::string badLocations[] = {"../" + location, "data/../../" + location, weightsPath};
+    for (size_t i = 0; i < sizeof(badLocations) / sizeof(badLocations[0]); i++)
+    {
+        writeExternalDataModel(modelPath, badLocations[i], offset);
+        EXPECT_ANY_THROW(readNetFromONNX(modelPath)) << badLocations[i];
+    }
+
+    remove(modelPath.c_str());
+    remove(weightsPath.c_str());
+}
+
 }} // namespace
@@ -15,6 +15,8 @@ Test for TFLite models loading
 
 #ifdef OPENCV_TEST_DNN_TFLITE
 
+#include "schema_generated.h"
+
 namespace opencv_test { namespace {
 
 using namespace cv;
@@ -285,6 +287,68 @@ TEST_P(Test_TFLite, face_blendshapes)
 
 INSTANTIATE_TEST_CASE_P(/**/, Test_TFLite, dnnBackendsAndTargets());
 
+TEST(Test_TFLite_importer, mapped_model)
+{
+    using namespace opencv_tflite;
+    const std::string modelPath = cv::tempfile(".tflite");
+
+    // y = x + w, where x: [1, 4] and w: [1, 4] is a constant tensor
+    Mat weights(1, 4, CV_32F);
+    randu(weights, -1, 1);
+    {
+        flatbuffers::FlatBufferBuilder fbb;
+        const std::vector<int32_t> shape = {1, 4};
+        const std::vector<uint8_t> data(weights.ptr<uint8_t>(), weights.ptr<uint8_t>() + weights.total() * weights.elemSize());
+        const std::vector<flatbuffers::Offset<Buffer> > buffers = {CreateBuffer(fbb), CreateBufferDirect(fbb, &data)};
+        const std::vector<flatbuffers::Offset<Tensor> > tensors = {
+            CreateTensorDirect(fbb, &shape, TensorType_FLOAT32, 0, "x"),
+            CreateTensorDirect(fbb, &shape, TensorType_FLOAT32, 1, "w"),
+            CreateTensorDirect(fbb, &shape, TensorType_FLOAT32, 0, "y")
+        };
+        const std::vector<int32_t> inputs = {0}, outputs = {2}, opInputs = {0, 1};
+        const std::vector<flatbuffers::Offset<Operator> > operators = {
+            CreateOperatorDirect(fbb, 0, &opInputs, &outputs, BuiltinOptions_AddOptions, CreateAddOptions(fbb).Union())
+        };
+        const std::vector<flatbuffers::Offset<SubGraph> > subgraphs = {CreateSubGraphDirect(fbb, &tensors, &inputs, &outputs, &operators)};
+        const std::vector<flatbuffers::Offset<OperatorCode> > opCodes = {
+            CreateOperatorCode(fbb, BuiltinOperator_ADD, 0, 1, BuiltinOperator_ADD)
+        };
+        FinishModelBuffer(fbb, CreateModelDirect(fbb, 3, &opCodes, &subgraphs, "", &buffers));
+
+        std::ofstream ofs(modelPath.c_str(), std::ios::out | std::ios::binary);
+        ofs.write((const char*)fbb.GetBufferPointer(), fbb.GetSize());
+    }
+
+    {
+        Net net = readNetFromTFLite(modelPath);
+        ASSERT_FALSE(net.empty());
+
+        // The constant refers to the mapped model file: its memory is not allocated by OpenCV
+        int numMapped = 0;
+        std::vector<String> names = net.getLayerNames();
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            const std::vector<Mat>& blobs = net.getLayer(names[i])->blobs;
+            for (size_t j = 0; j < blobs.size(); j++)
+            {
+                if (blobs[j].u && blobs[j].u->currAllocator != Mat::getStdAllocator() &&
+                    blobs[j].u->currAllocator != Mat::getDefaultAllocator() &&
+                    blobs[j].total() == weights.total() && cv::norm(blobs[j].reshape(1, 1), weights, NORM_INF) == 0)
+                    numMapped++;
+            }
+        }
+        EXPECT_EQ(1, numMapped);
+
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat input(1, 4, CV_32F);
+        randu(input, -1, 1);
+        net.setInput(input);
+        Mat out = net.forward();
+        normAssert(out.reshape(1, 1), input + weights);
+    }
+    remove(modelPath.c_str());
+}
+
 }}  // namespace
 
 #endif  // OPENCV_TEST_DNN_TFLITE